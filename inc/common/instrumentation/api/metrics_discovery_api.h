@@ -37,7 +37,7 @@ SPDX-License-Identifier: MIT
 //////////////////////////////////////////////////////////////////////////////////
 // API build number:
 //////////////////////////////////////////////////////////////////////////////////
-#define MD_API_BUILD_NUMBER_CURRENT 189
+#define MD_API_BUILD_NUMBER_CURRENT 190
 
 namespace MetricsDiscovery
 {
@@ -73,7 +73,8 @@ namespace MetricsDiscovery
         MD_API_MINOR_NUMBER_14      = 14, // Offline calculation support
         MD_API_MINOR_NUMBER_15      = 15, // Change IO Stream state
         MD_API_MINOR_NUMBER_16      = 16, // Metrics Aggregation Support
-        MD_API_MINOR_NUMBER_CURRENT = MD_API_MINOR_NUMBER_16,
+        MD_API_MINOR_NUMBER_17      = 17, // Calculation of selected metrics only, columnar calculation output
+        MD_API_MINOR_NUMBER_CURRENT = MD_API_MINOR_NUMBER_17,
         MD_API_MINOR_NUMBER_CEIL    = 0xFFFFFFFF
     } MD_API_MINOR_VERSION;
 
@@ -171,6 +172,7 @@ namespace MetricsDiscovery
     class IMetricSet_1_11;
     class IMetricSet_1_13;
     class IMetricSet_1_16;
+    class IMetricSet_1_17;
 
     //////////////////////////////////////////////////////////////////////////////////
     // Abstract interface for the metric that is sampled.
@@ -202,6 +204,17 @@ namespace MetricsDiscovery
     // Abstract interface for the calculation context object.
     //////////////////////////////////////////////////////////////////////////////////
     class ICalculationContext_1_16;
+    class ICalculationContext_1_17;
+
+    //////////////////////////////////////////////////////////////////////////////////
+    // Abstract interface for the stream calculation object.
+    //////////////////////////////////////////////////////////////////////////////////
+    class IStreamCalculation_1_17;
+
+    //////////////////////////////////////////////////////////////////////////////////
+    // Abstract interface for the range index object.
+    //////////////////////////////////////////////////////////////////////////////////
+    class IRangeIndex_1_17;
 
     //////////////////////////////////////////////////////////////////////////////////
     // Value types:
@@ -1164,6 +1177,31 @@ namespace MetricsDiscovery
         uint32_t InformationCount;
     } TCalculationContextParams_1_16;
 
+    ///////////////////////////////////////////////////////////////////////////////
+    // Calculated metric column:
+    // One value per calculated report, typed by the metric result type:
+    // float (RESULT_FLOAT), uint64_t (RESULT_UINT64), uint32_t (RESULT_UINT32)
+    // or a bitset (RESULT_BOOL), where report n is bit n % 8 of byte n / 8.
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef struct SMetricColumn_1_17
+    {
+        void*    Data; // Column values
+        uint32_t Size; // Size of the column values buffer in bytes
+    } TMetricColumn_1_17;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Calculation output descriptor:
+    // Calculated reports written to typed columns, one column per metric.
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef struct SCalculationOutputDescriptor_1_17
+    {
+        TMetricColumn_1_17* MetricColumns;      // Array of metric columns, one per metric (per projected metric, if calculation projection is set)
+        TMetricColumn_1_17* MaxValueColumns;    // (Optional) Array of max value columns, typed as metric columns
+        uint32_t            MetricColumnCount;  // Number of metric columns, and max value columns if provided
+        TTypedValue_1_0*    OutInformation;     // (Optional) Calculated information, InformationCount values per report
+        uint32_t            OutInformationSize; // Size of the information buffer in bytes
+    } TCalculationOutputDescriptor_1_17;
+
     ///////////////////////////////////////////////////////////////////////////////
     //
     // Class:
@@ -1330,6 +1368,9 @@ namespace MetricsDiscovery
     // New:
     // - SetApiFiltering:                       To filter available metrics/information for the given API. Use TMetricApiType to build the mask.
     // - CalculateMetrics:                      To calculate normalized metrics/information from the raw data.
+    //                                          Calls on the same metric set may overlap. Sequential calls continue one stream,
+    //                                          an overlapping call starts a new one. Use stream calculations
+    //                                          (IMetricSet_1_17::CreateStreamCalculation) to continue several streams concurrently.
     // - CalculateIoMeasurementInformation:     To calculate additional information for stream measurements.
     //
     ///////////////////////////////////////////////////////////////////////////////
@@ -1377,6 +1418,9 @@ namespace MetricsDiscovery
     // - CalculateMetrics:                  CalculateMetrics extended with max values calculation.
     //                                      optional param 'outMaxValues' should have a memory
     //                                      for at least 'MetricCount * RawReportCount' values, can be nullptr.
+    //                                      Calls on the same metric set may overlap. Sequential calls continue one stream,
+    //                                      an overlapping call starts a new one. Use stream calculations
+    //                                      (IMetricSet_1_17::CreateStreamCalculation) to continue several streams concurrently.
     //
     ///////////////////////////////////////////////////////////////////////////////
     class IMetricSet_1_5 : public IMetricSet_1_4
@@ -1500,6 +1544,106 @@ namespace MetricsDiscovery
         virtual TMetricSetParams_1_16* GetParams( void );
     };
 
+    ///////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //   IMetricSet_1_17
+    //
+    // Description:
+    //   Updated 1.16 version to use with 1.17 interface version.
+    //   Adds an ability to calculate only selected metrics.
+    //
+    // New:
+    // - SetCalculationProjection: To select metrics written to calculated reports by their indices.
+    //                             Metrics the selected ones depend on are calculated, but not written.
+    //                             Calculated reports contain selected metrics in the given order followed by
+    //                             all information. Pass nullptr or 0 count to calculate all metrics again.
+    // - SetCalculationProjectionByNames: To select metrics written to calculated reports by their symbol names,
+    //                             see SetCalculationProjection.
+    // - CalculateMetricColumns:   To calculate metrics from raw data into typed columns.
+    // - SetCalculationThreadCount: To calculate raw reports in chunks on multiple threads. Results are the same
+    //                              as from a single thread. Pass 0 to use all hardware threads, 1 (default) to
+    //                              calculate on the calling thread only.
+    // - CreateStreamCalculation:   To create a stream calculation object calculating IoStream raw data pushed
+    //                              in consecutive portions, see IStreamCalculation_1_17. Each object keeps its
+    //                              own stream, so different objects may be used on different threads at once.
+    //                              Sequential Calculate* calls through the metric set continue a single stream,
+    //                              a call overlapping another one starts a new stream.
+    // - DestroyStreamCalculation:  To destroy a stream calculation object created by CreateStreamCalculation.
+    // - CreateRangeIndex:          To create a range index object calculating metrics between any two timestamps
+    //                              of the given IoStream raw data, see IRangeIndex_1_17.
+    // - DestroyRangeIndex:         To destroy a range index object created by CreateRangeIndex.
+    //
+    ///////////////////////////////////////////////////////////////////////////////
+    class IMetricSet_1_17 : public IMetricSet_1_16
+    {
+    public:
+        virtual ~IMetricSet_1_17();
+
+        // New.
+        virtual TCompletionCode SetCalculationProjection( const uint32_t* metricIndices, uint32_t metricIndicesCount );
+        virtual TCompletionCode SetCalculationProjectionByNames( const char** symbolNames, uint32_t symbolNamesCount );
+        virtual TCompletionCode CalculateMetricColumns( const uint8_t* rawData, uint32_t rawDataSize, TCalculationOutputDescriptor_1_17* outDescriptor, uint32_t* outReportCount );
+        virtual TCompletionCode SetCalculationThreadCount( uint32_t threadCount );
+        virtual TCompletionCode CreateStreamCalculation( bool calculateMaxValues, IStreamCalculation_1_17** streamCalculation );
+        virtual TCompletionCode DestroyStreamCalculation( IStreamCalculation_1_17* streamCalculation );
+        virtual TCompletionCode CreateRangeIndex( const uint8_t* rawData, uint32_t rawDataSize, bool calculateMaxValues, IRangeIndex_1_17** rangeIndex );
+        virtual TCompletionCode DestroyRangeIndex( IRangeIndex_1_17* rangeIndex );
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //   IStreamCalculation_1_17
+    //
+    // Description:
+    //   Abstract interface for incremental calculation of IoStream raw data.
+    //   Owns the last raw report carried over between portions and calculated
+    //   reports, so raw data read from the stream can be pushed as it comes.
+    //
+    // New:
+    // - Push:  To calculate normalized metrics/information from the next portion of raw data.
+    //          Returned reports (and max values) are valid until the next Push or Reset.
+    // - Reset: To discard the carried over raw report and start a new stream.
+    //
+    ///////////////////////////////////////////////////////////////////////////////
+    class IStreamCalculation_1_17
+    {
+    public:
+        virtual ~IStreamCalculation_1_17();
+
+        virtual TCompletionCode Push( const uint8_t* rawData, uint32_t rawDataSize, const TTypedValue_1_0** out, const TTypedValue_1_0** outMaxValues, uint32_t* outReportCount );
+        virtual void            Reset( void );
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //   IRangeIndex_1_17
+    //
+    // Description:
+    //   Abstract interface for repeated range queries over the same IoStream raw data.
+    //   Cumulative counters at each raw report are computed once, so metrics between
+    //   any two timestamps are calculated from two reports interpolated at them.
+    //   Raw data isn't kept after the range index is created.
+    //
+    // New:
+    // - GetTimeRange:   To get timestamps (in ns) of the first and the last raw report.
+    // - CalculateRange: To calculate normalized metrics/information between two timestamps (in ns),
+    //                   clamped to the time range. As with any two raw reports, counter deltas
+    //                   can't exceed counter sizes in the raw report. The returned report (and
+    //                   max values) is valid until the next CalculateRange.
+    //
+    ///////////////////////////////////////////////////////////////////////////////
+    class IRangeIndex_1_17
+    {
+    public:
+        virtual ~IRangeIndex_1_17();
+
+        virtual TCompletionCode GetTimeRange( uint64_t* outStartTimestamp, uint64_t* outEndTimestamp );
+        virtual TCompletionCode CalculateRange( uint64_t startTimestamp, uint64_t endTimestamp, const TTypedValue_1_0** out, const TTypedValue_1_0** outMaxValues );
+    };
+
     ///////////////////////////////////////////////////////////////////////////////
     //
     // Class:
@@ -1913,6 +2057,34 @@ namespace MetricsDiscovery
         virtual TCompletionCode CalculateSingleWindowMetrics( const uint8_t** rawData, const uint32_t* rawDataSizes, uint32_t* outProcessedRawDataCount, TTypedValue_1_0* out, uint32_t outSize, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize, bool lastDataPortion );
     };
 
+    ///////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //   ICalculationContext_1_17
+    //
+    // Description:
+    //   Updated 1.16 version to use with 1.17 interface version.
+    //
+    // New:
+    // - CalculateMetricColumns:        To calculate normalized metrics/information from the raw data into typed columns
+    // - SetCalculationThreadCount:     To calculate raw reports in chunks on multiple threads, 0 means all hardware threads
+    // - AggregateAndCalculateMetrics:  To aggregate data and calculate normalized metrics/information from aggregated reports
+    //                                  without a caller aggregated raw data buffer. Calculated reports (and max values) are
+    //                                  the same as from AggregateData followed by CalculateMetrics. They are stored in the
+    //                                  context and valid until the next AggregateAndCalculateMetrics.
+    //
+    ///////////////////////////////////////////////////////////////////////////////
+    class ICalculationContext_1_17 : public ICalculationContext_1_16
+    {
+    public:
+        virtual ~ICalculationContext_1_17();
+
+        // New.
+        virtual TCompletionCode CalculateMetricColumns( const uint8_t* rawData, uint32_t rawDataSize, TCalculationOutputDescriptor_1_17* outDescriptor, uint32_t* outReportCount );
+        virtual TCompletionCode SetCalculationThreadCount( uint32_t threadCount );
+        virtual TCompletionCode AggregateAndCalculateMetrics( const uint8_t** rawData, const uint32_t* rawDataSizes, const TTypedValue_1_0** out, uint32_t* outReportCount, const TTypedValue_1_0** outMaxValues, bool lastDataPortion );
+    };
+
     ///////////////////////////////////////////////////////////////////////////////
     //
     // Class:
@@ -2358,16 +2530,18 @@ namespace MetricsDiscovery
     //////////////////////////////////////////////////////////////////////////////////
     using IAdapterGroupLatest                         = IAdapterGroup_1_16;
     using IAdapterLatest                              = IAdapter_1_16;
-    using ICalculationContextLatest                   = ICalculationContext_1_16;
+    using ICalculationContextLatest                   = ICalculationContext_1_17;
     using IConcurrentGroupLatest                      = IConcurrentGroup_1_16;
     using IEquationLatest                             = IEquation_1_0;
     using IInformationLatest                          = IInformation_1_0;
     using IMetricEnumeratorLatest                     = IMetricEnumerator_1_13;
     using IMetricLatest                               = IMetric_1_13;
     using IMetricPrototypeLatest                      = IMetricPrototype_1_13;
-    using IMetricSetLatest                            = IMetricSet_1_16;
+    using IMetricSetLatest                            = IMetricSet_1_17;
     using IMetricsDeviceLatest                        = IMetricsDevice_1_16;
     using IOverrideLatest                             = IOverride_1_2;
+    using IRangeIndexLatest                           = IRangeIndex_1_17;
+    using IStreamCalculationLatest                    = IStreamCalculation_1_17;
     using TAdapterGroupParamsLatest                   = TAdapterGroupParams_1_6;
     using TAdapterIdLatest                            = TAdapterId_1_6;
     using TAdapterIdLuidLatest                        = TAdapterIdLuid_1_6;
@@ -2380,6 +2554,7 @@ namespace MetricsDiscovery
     using TCalculationContextIoStreamDescriptorLatest = TCalculationContextIoStreamDescriptor_1_16;
     using TCalculationContextParamsLatest             = TCalculationContextParams_1_16;
     using TCalculationContextQueryDescriptorLatest    = TCalculationContextQueryDescriptor_1_16;
+    using TCalculationOutputDescriptorLatest          = TCalculationOutputDescriptor_1_17;
     using TConcurrentGroupParamsLatest                = TConcurrentGroupParams_1_13;
     using TDeltaFunctionLatest                        = TDeltaFunction_1_0;
     using TEngineIdClassInstanceLatest                = TEngineIdClassInstance_1_9;
@@ -2388,6 +2563,7 @@ namespace MetricsDiscovery
     using TEquationElementLatest                      = TEquationElement_1_0;
     using TGlobalSymbolLatest                         = TGlobalSymbol_1_0;
     using TInformationParamsLatest                    = TInformationParams_1_0;
+    using TMetricColumnLatest                         = TMetricColumn_1_17;
     using TMetricParamsLatest                         = TMetricParams_1_13;
     using TMetricPrototypeOptionDescriptorLatest      = TMetricPrototypeOptionDescriptor_1_13;
     using TMetricPrototypeParamsLatest                = TMetricPrototypeParams_1_13;
@@ -14,8 +14,13 @@ SPDX-License-Identifier: MIT
 
 #include "metrics_discovery_internal_api.h"
 #include "md_calculation.h"
+#include "md_worker_pool.h"
 
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <string_view>
+#include <vector>
 
 using namespace MetricsDiscovery;
 
@@ -26,6 +31,124 @@ namespace MetricsDiscoveryInternal
     ///////////////////////////////////////////////////////////////////////////////
     class CCalculationManager;
 
+    ///////////////////////////////////////////////////////////////////////////////
+    // Report headers of a single aggregated data set:
+    //////////////////////////////////////////////////////////////////////////////
+    typedef struct SReportHeaders
+    {
+        const uint8_t*        RawData;             // First raw report of the read buffer
+        uint32_t              RawReportCount;      // Raw reports read from the buffer
+        uint32_t              FirstReport;         // First raw report of the current data portion
+        std::vector<uint64_t> RawReportReasons;    // Per read raw report
+        std::vector<uint64_t> RawTimestamps;       // Per read raw report
+        std::vector<uint64_t> TimestampIndex;      // Timestamp of every MD_REPORT_TIMESTAMP_INDEX_STRIDE-th read raw report
+        std::vector<uint32_t> GoReports;           // Read raw reports with the GO report reason, ascending
+        bool                  AreTimestampsSorted; // Timestamps of all the read raw reports
+
+    } TReportHeaders;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Raw reports cached by a single aggregation call:
+    //////////////////////////////////////////////////////////////////////////////
+    typedef struct SCachedReportSegment
+    {
+        std::vector<uint8_t>  RawData;       // Cached raw reports
+        std::vector<uint64_t> ReportReasons; // Per cached report
+        std::vector<uint64_t> Timestamps;    // Per cached report
+        uint32_t              ReportCount;
+
+    } TCachedReportSegment;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Cached raw reports of a single aggregated data set:
+    //////////////////////////////////////////////////////////////////////////////
+    typedef struct SCachedReports
+    {
+        std::deque<TCachedReportSegment> Segments;             // Oldest first, appended in O(1)
+        uint32_t                         ConsumedSegmentCount; // Leading consumed segments, released by the next aggregation call
+        uint32_t                         CurrentReport;        // Current report in the first unconsumed segment
+        TCachedReportSegment             Spare;                // Released segment reused by the next caching
+
+    } TCachedReports;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Data set entry of the current timestamp heap:
+    //////////////////////////////////////////////////////////////////////////////
+    typedef struct SDataSetTimestamp
+    {
+        uint64_t Timestamp;    // Current timestamp of the data set
+        uint32_t DataSetIndex; // Index of the data set
+        uint32_t Generation;   // Entry is stale if it differs from the data set generation
+
+    } TDataSetTimestamp;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Data sets of the stream aggregation ordered by their current timestamps:
+    //////////////////////////////////////////////////////////////////////////////
+    typedef struct SDataSetQueue
+    {
+        std::vector<TDataSetTimestamp> Heap;        // Min heap of data sets with a current report
+        std::vector<uint32_t>          Generations; // Per data set, incremented by each report request
+        std::vector<uint32_t>          Requested;   // Data sets that need a report
+
+    } TDataSetQueue;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Single pass sweep over overlapping or unsorted time windows:
+    // Aggregated reports are taken once at each window boundary, windows are
+    // made of the reports at their boundaries.
+    //////////////////////////////////////////////////////////////////////////////
+    typedef struct SWindowSweep
+    {
+        std::vector<uint64_t> Boundaries;         // Aggregation window boundaries of windows in the caller order, window after window
+        std::vector<uint32_t> FirstBoundaries;    // Per window index of its first boundary, followed by the boundary count
+        std::vector<uint64_t> RemainingStarts;    // Per window, the earliest start of the window and the windows after it
+        std::vector<uint64_t> Events;             // Unique boundaries of all the windows, ascending
+        std::vector<uint8_t>  Snapshots;          // Aggregated reports taken by the sweep, ascending timestamps
+        std::vector<uint64_t> SnapshotTimestamps; // Per aggregated report
+        std::vector<uint8_t>  PendingReports;     // Output windows not returned yet by a single window aggregation
+        uint32_t              FirstSnapshot;      // Aggregated reports before it are released
+        uint32_t              NextWindow;         // First window not output yet
+        uint32_t              FirstPending;       // First pending report not returned yet
+        uint32_t              PendingCount;       // Pending reports output by the sweep
+
+    } TWindowSweep;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Aggregated reports queued by the stream aggregation:
+    // Reports are interpolated and aggregated for up to MD_AGGREGATION_BATCH_REPORT_COUNT
+    // reports at once, so a single worker pool run covers many aggregation windows.
+    //////////////////////////////////////////////////////////////////////////////
+    typedef struct SAggregationBatch
+    {
+        std::vector<uint64_t>       Timestamps;             // Per queued report, the interpolation timestamp
+        std::vector<uint32_t>       OutOffsets;             // Per queued report, offset of the aggregated report in the output
+        std::vector<uint8_t>        IsNewCalculationWindow; // Per queued report, the first one of a calculation window
+        std::vector<const uint8_t*> PrevRawDataPtrs;        // Per queued report and data set
+        std::vector<const uint8_t*> LastRawDataPtrs;        // Per queued report and data set
+        std::vector<uint8_t>        InterpolatedReports;    // Per task and data set
+        std::vector<uint8_t*>       InterpolatedReportPtrs; // Per task and data set
+        uint32_t                    ReportCount;            // Queued reports not aggregated yet
+
+    } TAggregationBatch;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Calculation fused with the stream aggregation:
+    // Aggregated reports are calculated every MD_FUSED_CALCULATION_REPORT_COUNT
+    // reports, so they are never all kept.
+    //////////////////////////////////////////////////////////////////////////////
+    typedef struct SFusedCalculation
+    {
+        std::vector<uint8_t>         RawData;        // Aggregated reports not calculated yet
+        std::vector<TTypedValue_1_0> Out;            // Calculated reports of the current call
+        std::vector<TTypedValue_1_0> OutMaxValues;   // Per calculated report, if requested
+        uint32_t                     OutReportCount; // Calculated reports of the current call
+        bool                         IsEnabled;      // Only within AggregateAndCalculateMetrics
+        bool                         IsMaxValues;    // Max values requested by the current call
+        TCompletionCode              Result;         // First calculation error of the current call
+
+    } TFusedCalculation;
+
     //////////////////////////////////////////////////////////////////////////////
     //
     // Class:
@@ -47,6 +170,11 @@ namespace MetricsDiscoveryInternal
         virtual TCompletionCode CalculateMetrics( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize ) final;
         virtual TCompletionCode CalculateSingleWindowMetrics( const uint8_t** rawData, const uint32_t* rawDataSizes, uint32_t* outProcessedRawDataCount, TTypedValue_1_0* out, uint32_t outSize, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize, bool lastDataPortion ) final;
 
+        // API 1.17:
+        virtual TCompletionCode CalculateMetricColumns( const uint8_t* rawData, uint32_t rawDataSize, TCalculationOutputDescriptorLatest* outDescriptor, uint32_t* outReportCount ) final;
+        virtual TCompletionCode SetCalculationThreadCount( uint32_t threadCount ) final;
+        virtual TCompletionCode AggregateAndCalculateMetrics( const uint8_t** rawData, const uint32_t* rawDataSizes, const TTypedValue_1_0** out, uint32_t* outReportCount, const TTypedValue_1_0** outMaxValues, bool lastDataPortion ) final;
+
         //  Constructor & Destructor:
         CCalculationContext();
         virtual ~CCalculationContext();
@@ -66,6 +194,7 @@ namespace MetricsDiscoveryInternal
         TCompletionCode        InitializeAggregationContext( const bool init );
         void                   DestroyContexts();
         TCompletionCode        CreateInternalMetricSet( CMetricSet* baseMetricSet );
+        TCompletionCode        CalculateReports( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize, TCalculationOutputDescriptorLatest* outDescriptor );
         TCompletionCode        ValidateCalculateMetricsParams( TMetricSetParamsLatest* params, uint32_t rawDataSize, uint32_t rawReportSize, uint32_t outSize, uint32_t rawReportCount, uint32_t outMaxValuesSize );
         static TCompletionCode AreMetricsEqual( TMetricParamsLatest* baseParams, TMetricParamsLatest* metricParams, TCalculationContextType calculationContextType );
         static TCompletionCode ValidateApiMask( TCalculationContextType calculationContextType, uint32_t apiMask );
@@ -76,13 +205,40 @@ namespace MetricsDiscoveryInternal
         static TCompletionCode ValidateMetricParams( const T& baseValue, const T& metricValue, const char* fieldName );
         template <bool timerMode>
         bool            EnsureDataAtTimestamp( uint64_t timestamp );
+        void            RequestReport( uint32_t dataSetIndex );
+        bool            TakeRequestedReports( uint32_t timerDataSetIndex );
+        void            PushCurrentTimestamp( uint32_t dataSetIndex );
+        bool            PeekMinTimestamp( TDataSetTimestamp& outMinimum );
+        void            PopMinTimestamp();
+        void            SeekReport( uint32_t dataSetIndex, uint64_t timestamp );
         TCompletionCode FilterReport( uint32_t dataSetIndex, bool isTimerMode );
+        uint32_t        GetCalculationThreadCount() const;
+        void            RunPerDataSet( uint32_t reportCount, const std::function<void( uint32_t )>& task );
+        void            ReadReportHeaders();
+        bool            AreReportHeadersReusable( uint32_t dataSetIndex, uint32_t& outFirstReport ) const;
+        size_t          GetRawReportIndex( uint32_t dataSetIndex ) const;
+        uint64_t        GetReportReason( uint32_t dataSetIndex ) const;
+        uint64_t        GetReportTimestamp( uint32_t dataSetIndex ) const;
+        bool            NextCachedReport( uint32_t dataSetIndex );
+        void            ReleaseConsumedReports();
         uint64_t        GetMaxCurrentTimestamp() const;
-        uint64_t        GetMinCurrentTimestamp() const;
+        uint64_t        GetMinCurrentTimestamp();
         bool            IsEnoughData() const;
         void            UpdateAggregationWindowStop();
         void            Interpolate( uint64_t timestamp );
+        void            InterpolateReports( uint64_t timestamp, bool newCalculationWindow, const uint8_t* const* prevRawDataPtrs, const uint8_t* const* lastRawDataPtrs, uint8_t* const* outReportPtrs ) const;
+        void            AggregateInterpolatedReports( uint64_t timestamp );
+        void            QueueAggregatedReport( uint64_t timestamp, uint32_t outOffset );
+        void            AggregateQueuedReports();
+        TCompletionCode InitializeWindowSweep();
+        bool            IsWindowSweep() const;
+        void            OutputSweptWindows( bool isFinished );
+        TCompletionCode AggregateSweptSingleWindow( const uint8_t** rawData, const uint32_t* rawDataSizes, uint8_t* outAggregatedRawData, uint32_t* outProcessedRawDataCount, bool lastDataPortion );
         TCompletionCode CacheRemainingReports();
+        TCompletionCode CalculateFusedReports( const uint8_t* rawData, uint32_t rawDataSize );
+        void            CalculateAggregatedReports();
+        void            ReserveAggregatedReports( uint32_t reportCount );
+        static bool     IsLaterTimestamp( const TDataSetTimestamp& left, const TDataSetTimestamp& right );
 
     private:
         // Members:
@@ -98,5 +254,13 @@ namespace MetricsDiscoveryInternal
         bool                              m_aggregationEnabled;
         TCalculationContextState          m_state;
         TCalculationContextStateTimerMode m_timerModeState;
+        std::atomic<uint32_t>             m_calculationThreadCount; // 0 means hardware concurrency
+        std::vector<TReportHeaders>       m_reportHeaders;          // Per data set, kept while the same raw buffer is passed
+        std::vector<TCachedReports>       m_cachedReports;          // Per data set, reports kept for next data portions
+        CWorkerPool                       m_workerPool;             // Report headers per data set, queued reports per batch
+        TAggregationBatch                 m_aggregationBatch;       // Aggregated reports not interpolated yet
+        TDataSetQueue                     m_dataSetQueue;           // Data sets ordered by current timestamps
+        TWindowSweep                      m_windowSweep;            // Used only if time windows overlap or aren't sorted
+        TFusedCalculation                 m_fusedCalculation;       // Used only by AggregateAndCalculateMetrics
     };
 } // namespace MetricsDiscoveryInternal
@@ -25,6 +25,84 @@ namespace MetricsDiscoveryInternal
     // Forward declarations:                                                     //
     ///////////////////////////////////////////////////////////////////////////////
     class CMetricsDevice;
+    class CCalculatorSymbols;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Equation instruction codes:                                               //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef enum EEquationInstructionCode : uint32_t
+    {
+        EQUATION_INSTR_READ_UINT8,
+        EQUATION_INSTR_READ_UINT16,
+        EQUATION_INSTR_READ_UINT32,
+        EQUATION_INSTR_READ_UINT64,
+        EQUATION_INSTR_READ_FLOAT,
+        EQUATION_INSTR_READ_40BIT_CNTR,
+        EQUATION_INSTR_READ_BITFIELD,
+        EQUATION_INSTR_IMMEDIATE,
+        EQUATION_INSTR_GLOBAL_SYMBOL,         // Value bound to SymbolValue
+        EQUATION_INSTR_GLOBAL_SYMBOL_DYNAMIC, // Value redetected by name on every use
+        EQUATION_INSTR_PREVIOUS_CONTEXT_ID,
+        EQUATION_INSTR_INFORMATION_SYMBOL, // Not supported information symbol
+        EQUATION_INSTR_LOCAL_COUNTER,
+        EQUATION_INSTR_SELF_COUNTER,
+        EQUATION_INSTR_LOCAL_METRIC,
+        EQUATION_INSTR_PREV_METRIC,
+        EQUATION_INSTR_OPERATION,
+        EQUATION_INSTR_STD_NORM_GPU_DURATION,
+        EQUATION_INSTR_STD_NORM_EU_AGGR_DURATION,
+        EQUATION_INSTR_NOT_SUPPORTED,
+        // ...
+        EQUATION_INSTR_LAST
+    } TEquationInstructionCode;
+
+    static_assert( EQUATION_INSTR_LAST <= 32, "Instruction codes must fit in a 32 bit instruction mask" );
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Equation program types:                                                   //
+    // Type of all operations in a program, inferred during compilation.         //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef enum EEquationProgramType : uint32_t
+    {
+        EQUATION_PROGRAM_TYPE_MIXED,  // Operations with different or boolean result types
+        EQUATION_PROGRAM_TYPE_UINT64, // Only unsigned integer 64b operations
+        EQUATION_PROGRAM_TYPE_FLOAT,  // Only floating point operations
+        // ...
+        EQUATION_PROGRAM_TYPE_LAST
+    } TEquationProgramType;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Equation instruction:                                                     //
+    // Equation element lowered at parse time, with read offsets and global      //
+    // symbols resolved, so evaluation does not require any string operations.   //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef struct SEquationInstruction
+    {
+        TEquationInstructionCode Code;
+        TEquationOperation       Operation;
+        uint32_t                 ByteOffset;
+        uint32_t                 ByteOffsetExt;          // High byte offset of 40 bit counters
+        uint32_t                 BitOffset;              // Bitfield shift
+        uint32_t                 BitMask;                // Bitfield mask, zero if bitfield is invalid
+        int32_t                  MetricIndex;            // Local counter / metric index, -1 if not found
+        bool                     IsGpuCoreClocks;        // Local counter refers to GpuCoreClocks
+        bool                     IsMissingSymbolAllowed; // Missing local counter in read equation is expected
+        TTypedValue_1_0          Value;                  // Immediate value
+        TTypedValue_1_0*         SymbolValue;            // Global symbol value
+        const char*              SymbolName;             // Points to the name owned by the equation element
+    } TEquationInstruction;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Equation operand:                                                         //
+    // Subexpression tracked on the stack during constant folding.               //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef struct SEquationOperand
+    {
+        uint32_t        Start;      // Index of the first instruction of the subexpression
+        TValueType      Type;       // Statically known result type, VALUE_TYPE_LAST if unknown
+        bool            IsConstant; // Subexpression has been folded into Value
+        TTypedValue_1_0 Value;      // Folded value
+    } TEquationOperand;
 
     //////////////////////////////////////////////////////////////////////////////
     //
@@ -81,6 +159,8 @@ namespace MetricsDiscoveryInternal
         bool SolveBooleanEquation( void ); // Used only for availability equations
         bool ParseEquationString( const char* equationString );
         bool ParseEquationElement( const char* equationString );
+        void Compile();
+        void BindGlobalSymbols( CCalculatorSymbols& symbols );
 
         TCompletionCode WriteCEquationToBuffer( uint8_t* buffer, uint32_t& bufferSize, uint32_t& bufferOffset );
 
@@ -90,13 +170,67 @@ namespace MetricsDiscoveryInternal
             return m_elementsVector;
         }
 
+        inline const std::vector<TEquationInstruction>& GetProgram() const
+        {
+            return m_program;
+        }
+
+        inline TEquationProgramType GetProgramType() const
+        {
+            return m_programType;
+        }
+
+        inline TEquationProgramType GetOptimizedProgramType() const
+        {
+            return m_optimizedProgramType;
+        }
+
+        inline uint32_t GetMaxStackDepth() const
+        {
+            return m_maxStackDepth;
+        }
+
+        // Returns the program with constant subexpressions folded. It is built once by
+        // Compile and only read afterwards, so calculators may share it between threads.
+        inline const std::vector<TEquationInstruction>& GetOptimizedProgram() const
+        {
+            return m_optimizedProgram;
+        }
+
+        // Returns true if the program is a valid RPN and contains only allowed instructions,
+        // so it can be evaluated without stack validation.
+        inline bool IsValidatedProgram( const uint32_t allowedInstructionMask ) const
+        {
+            return m_isProgramValid && ( m_instructionMask & ~allowedInstructionMask ) == 0;
+        }
+
+    public:
+        // Constants:
+        static constexpr uint32_t MAX_STACK_DEPTH = 32;
+
     private:
         // Non-API:
         bool IsLegacyMaskGlobalSymbol( const char* symbolName );
+        void CompileElement( const CEquationElementInternal& element, TEquationInstruction& instruction );
+        void Optimize();
+        void EmitOperand( const TEquationInstruction& instruction, TEquationOperand& operand );
+        bool SimplifyIdentity( const TEquationInstruction& instruction, TEquationOperand& operandPrev, const TEquationOperand& operandLast );
+
+        TEquationProgramType SpecializeProgram( std::vector<TEquationInstruction>& program );
+
+        static TValueType GetInstructionType( const TEquationInstruction& instruction );
+        static TValueType GetOperationType( const TEquationOperation operation );
 
     private:
         // Variables:
         std::vector<CEquationElementInternal> m_elementsVector;
+        std::vector<TEquationInstruction>     m_program;
+        std::vector<TEquationInstruction>     m_optimizedProgram;
+        TEquationProgramType                  m_programType;
+        TEquationProgramType                  m_optimizedProgramType;
+        uint32_t                              m_instructionMask;
+        uint32_t                              m_maxStackDepth;
+        bool                                  m_isProgramValid;
         const char*                           m_equationString;
         CMetricsDevice&                       m_device;
     };
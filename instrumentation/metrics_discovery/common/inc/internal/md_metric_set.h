@@ -19,6 +19,9 @@ SPDX-License-Identifier: MIT
 #include <vector>
 #include <list>
 #include <functional>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
 
 #define MD_METRIC_GROUP_NAME_LEVEL_MAX 3
 
@@ -30,17 +33,23 @@ namespace MetricsDiscoveryInternal
     // Forward declarations:                                                     //
     ///////////////////////////////////////////////////////////////////////////////
     class CCalculationManager;
+    class CCalculatorSymbols;
     class CConcurrentGroup;
     class CEquation;
     class CInformation;
     class CMetric;
     class CMetricsCalculator;
     class CMetricsDevice;
+    class CRangeIndex;
     class CRegisterSet;
+    class CStreamCalculation;
 
     union SCalculationContext;
     using TCalculationContext = SCalculationContext;
 
+    struct SCalculationSession;
+    using TCalculationSession = SCalculationSession;
+
     class CPrototypeManager;
 
     ///////////////////////////////////////////////////////////////////////////////
@@ -138,6 +147,89 @@ namespace MetricsDiscoveryInternal
         uint32_t RrConfigHandle;
     } TPmRegsConfigInfo;
 
+    ///////////////////////////////////////////////////////////////////////////////
+    // Metric normalization kinds:                                               //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef enum ENormalizationKind
+    {
+        NORMALIZATION_KIND_DELTA,    // Delta value is used as normalized value
+        NORMALIZATION_KIND_EQUATION, // Normalization equation is calculated
+        // ...
+        NORMALIZATION_KIND_LAST
+    } TNormalizationKind;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Metric kernel types:                                                      //
+    // Equation shapes common in generated metric sets, calculated natively      //
+    // for a batch of reports instead of interpreting their programs.            //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef enum EMetricKernelType
+    {
+        METRIC_KERNEL_TYPE_NONE,                     // Program is interpreted
+        METRIC_KERNEL_TYPE_COLUMN_DELTA,             // dw@ / qw@ report column read with DELTA N
+        METRIC_KERNEL_TYPE_GPU_DURATION,             // GpuDuration
+        METRIC_KERNEL_TYPE_EU_AGGR_DURATION,         // EuAggrDuration
+        METRIC_KERNEL_TYPE_SELF_UMUL,                // $Self N UMUL
+        METRIC_KERNEL_TYPE_COUNTER_UMUL_METRIC_UDIV, // $Counter N UMUL $$Metric UDIV
+        METRIC_KERNEL_TYPE_SELF_METRIC_FDIV,         // $Self $$Metric FDIV
+        // ...
+        METRIC_KERNEL_TYPE_LAST
+    } TMetricKernelType;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Metric kernel:                                                            //
+    // Kernel type with operands taken from the folded equation program.         //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef struct SMetricKernel
+    {
+        TMetricKernelType Type;
+        int32_t           Column;       // Report column, see TReportColumn
+        uint32_t          BitsCount;    // Column delta bits count
+        int32_t           CounterIndex; // Local counter index
+        int32_t           MetricIndex;  // Local metric index
+        uint64_t          Immediate;    // Immediate multiplier
+    } TMetricKernel;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Information read descriptor:                                              //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef struct SInformationReadDescriptor
+    {
+        CEquation* ReadEquation; // Io or query read equation, depending on the metric set API mask
+        bool       IsFlag;       // Read value is returned as bool
+    } TInformationReadDescriptor;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Calculation plan:                                                         //
+    // Flat per metric / information arrays built once for the current metrics,  //
+    // so per report calculations don't look up metrics and their params.        //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef struct SCalculationPlan
+    {
+        bool                                    IsValid;
+        uint32_t                                MetricsCount;
+        uint32_t                                InformationCount;
+        int32_t                                 GpuCoreClocksIndex; // -1 if the metric set has no GpuCoreClocks metric
+        std::vector<CEquation*>                 QueryReadEquations;
+        std::vector<CEquation*>                 IoReadEquations;
+        std::vector<CEquation*>                 NormEquations;
+        std::vector<CEquation*>                 MaxValueEquations;
+        std::vector<TDeltaFunction_1_0>         DeltaFunctions;
+        std::vector<TMetricResultType>          ResultTypes;
+        std::vector<TNormalizationKind>         NormalizationKinds;
+        std::vector<TInformationReadDescriptor> Informations;
+        TReportLayout                           ReportLayout;      // Counter regions of the metric set report type
+        bool                                    IsProjected;       // Only selected metrics are written to calculated reports
+        std::vector<uint32_t>                   CalculatedMetrics; // Indices of metrics to calculate, in ascending order
+        std::vector<uint32_t>                   OutMetrics;        // Indices of metrics written to calculated reports
+        bool                                    HasPrevMetrics;    // Calculated equations use previous calculated report
+        uint32_t                                Generation;        // Incremented whenever the plan is built, 0 if never built
+        bool                                    HasKernels;        // Kernels are matched, only for unmodified metric sets
+        std::vector<TMetricKernel>              ReadKernels;       // Io read equation kernels, METRIC_KERNEL_TYPE_NONE if interpreted
+        std::vector<TMetricKernel>              NormKernels;       // Normalization equation kernels, METRIC_KERNEL_TYPE_NONE if interpreted
+        std::vector<CEquation*>                 BoundEquations;    // Owned equation copies bound to symbols aggregated across devices
+    } TCalculationPlan;
+
     //////////////////////////////////////////////////////////////////////////////
     //
     // Class:
@@ -152,6 +244,16 @@ namespace MetricsDiscoveryInternal
     class CMetricSet : public IInternalMetricSet
     {
     public:
+        // API 1.17:
+        virtual TCompletionCode SetCalculationProjection( const uint32_t* metricIndices, uint32_t metricIndicesCount ) final;
+        virtual TCompletionCode SetCalculationProjectionByNames( const char** symbolNames, uint32_t symbolNamesCount ) final;
+        virtual TCompletionCode CalculateMetricColumns( const uint8_t* rawData, uint32_t rawDataSize, TCalculationOutputDescriptorLatest* outDescriptor, uint32_t* outReportCount ) final;
+        virtual TCompletionCode SetCalculationThreadCount( uint32_t threadCount ) final;
+        virtual TCompletionCode CreateStreamCalculation( bool calculateMaxValues, IStreamCalculationLatest** streamCalculation ) final;
+        virtual TCompletionCode DestroyStreamCalculation( IStreamCalculationLatest* streamCalculation ) final;
+        virtual TCompletionCode CreateRangeIndex( const uint8_t* rawData, uint32_t rawDataSize, bool calculateMaxValues, IRangeIndexLatest** rangeIndex ) final;
+        virtual TCompletionCode DestroyRangeIndex( IRangeIndexLatest* rangeIndex ) final;
+
         // API 1.16:
         virtual TCompletionCode CalculateAsyncMetrics( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize ) final;
 
@@ -279,8 +381,17 @@ namespace MetricsDiscoveryInternal
         CMetricsCalculator* GetMetricsCalculator();
         CMetricsDevice&     GetMetricsDevice();
         TByteArrayLatest*   GetPlatformMask();
+        TCalculationPlan*   GetCalculationPlan();
+        TCompletionCode     PrepareCalculationPlan();
+        TCompletionCode     LockCalculationPlan( std::shared_lock<std::shared_mutex>& lock );
+        TCompletionCode     CreateCalculationSession( TMeasurementType measurementType, TCalculationSession** session );
+        void                DestroyCalculationSession( TCalculationSession*& session );
+        TCompletionCode     InitializeCalculationContext( TCalculationSession& session, TTypedValue_1_0* out, TTypedValue_1_0* outMaxValues, TCalculationOutputDescriptorLatest* outDescriptor, const uint8_t* rawData, uint32_t rawReportCount, bool contextFiltering );
+        uint32_t            GetCalculationThreadCount();
+        TCompletionCode     ValidateOutputDescriptor( const TCalculationOutputDescriptorLatest* outDescriptor, uint32_t rawDataSize, uint32_t rawReportSize, uint32_t outReportCount );
 
         TCompletionCode InitializeMetricsCalculator( std::vector<std::reference_wrapper<CMetricsDevice>>& devices );
+        void            DiscardSavedReports();
 
         TCompletionCode SetAvailabilityEquation( const char* equationString );
         bool            IsAvailabilityEquationTrue();
@@ -317,9 +428,16 @@ namespace MetricsDiscoveryInternal
         void            UseApiFilteredVariables( bool enable );
         void            RefreshCachedMetricsAndInformation();
         void            ClearCachedMetricsAndInformation();
+        TCompletionCode BuildCalculationPlan();
+        TCompletionCode BuildCalculationProjection( TCalculationPlan& plan );
+        void            InvalidateCalculationPlan();
         TCompletionCode ValidateCalculateMetricsParams( uint32_t rawDataSize, uint32_t rawReportSize, uint32_t outSize, uint32_t rawReportCount, uint32_t outMaxValuesSize );
         void            InitializeCalculationManager( TMeasurementType measurementType, CCalculationManager** calculationManager, bool init );
-        TCompletionCode InitializeCalculationContext( TCalculationContext& context, CCalculationManager* calculationManager, TMeasurementType measurementType, TTypedValue_1_0* out, TTypedValue_1_0* outMaxValues, const uint8_t* rawData, uint32_t rawReportCount, bool init );
+        TCompletionCode PrepareCalculationPlanInternal();
+        TCompletionCode BindCalculationPlan( TCalculationPlan& plan );
+        void            DeleteBoundEquations( TCalculationPlan& plan );
+        TCompletionCode AcquireCalculationSession( TMeasurementType measurementType, TCalculationSession** session );
+        void            ReleaseCalculationSession( TCalculationSession* session );
 
         bool AreMetricParamsValid( const char* symbolName, const char* shortName, const char* description, const char* groupName, TMetricType metricType, TMetricResultType resultType, const char* units, THwUnitType hwType, const char* alias );
         bool IsCustomApiMaskValid( const uint32_t apiMask );
@@ -330,12 +448,13 @@ namespace MetricsDiscoveryInternal
 
         uint32_t GetRawCounterSize();
         uint32_t GetRawCounterCount();
+        void     GetReportLayout( TReportLayout& layout );
 
         // Flexible metric set methods:
         virtual TCompletionCode AddDefaultMetrics();
 
         template <bool async>
-        TCompletionCode CalculateMetrics( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize );
+        TCompletionCode CalculateMetrics( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize, TCalculationOutputDescriptorLatest* outDescriptor, bool contextFiltering );
 
     private:
         // Variables:
@@ -372,7 +491,27 @@ namespace MetricsDiscoveryInternal
         bool                m_aggregationEnabled; // if true then non-aggregatable informations are filtered out from the set
         bool                m_isReadRegsCfgSet;   // if true then read regs config will be cleared on Deactivate; determined during Activate
         TPmRegsConfigInfo   m_pmRegsConfigInfo;
+        CCalculatorSymbols* m_calculatorSymbols;
         CMetricsCalculator* m_metricsCalculator;
+        TCalculationPlan    m_calculationPlan;
+
+        // Calculation state shared by the calls through the metric set, guarded by the mutex.
+        // Setters changing the plan lock it exclusively, CalculateMetrics, stream calculations,
+        // range indexes and calculation contexts share it while they calculate:
+        std::shared_mutex                 m_calculationMutex;
+        std::atomic<uint32_t>             m_calculationThreadCount; // 0 means hardware concurrency
+        uint32_t                          m_preparedPlanGeneration; // Plan generation with matched metric kernels
+        std::vector<CStreamCalculation*>  m_streamCalculations;     // Stream calculations created by the user
+        std::vector<CRangeIndex*>         m_rangeIndexes;           // Range indexes created by the user
+
+        // Sessions of CalculateMetrics calls, guarded by the session mutex. Kept until the metric set is destroyed:
+        std::mutex                        m_calculationSessionMutex;
+        TCalculationSession*              m_calculationSession;      // Continues one IoStream through sequential calls
+        bool                              m_isCalculationSessionUsed; // if true then a call is calculating with the session above
+        std::vector<TCalculationSession*> m_idleCalculationSessions;  // Sessions of overlapping calls, reused by the next ones
+
+        // Calculation projection, empty if all the metrics are calculated:
+        std::vector<uint32_t> m_projectedMetrics;
 
         // Flexible metric set members:
         TMetricPrototypeManagerType m_prototypeManagerType;
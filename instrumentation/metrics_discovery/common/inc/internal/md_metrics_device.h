@@ -117,6 +117,8 @@ namespace MetricsDiscoveryInternal
         std::vector<uint8_t>& GetStreamBuffer();
 
     private:
+        friend class CMetricsDeviceTest; // Sets the platform of an offline device, see tests/md_calculation_test.cpp and tests/md_equation_test.cpp
+
         // Methods to read from buffer must be used in correct order
         TCompletionCode ReadGlobalSymbolsFromBuffer( uint8_t*& bufferPtr, const uint8_t* bufferBeginOffset, const uint32_t bufferSize, const uint32_t bufferVersion );
         TCompletionCode ReadConcurrentGroupsFromBuffer( uint8_t*& bufferPtr, const uint8_t* bufferBeginOffset, const uint32_t bufferSize, TApiVersion_1_0* apiVersion, const uint32_t bufferVersion );
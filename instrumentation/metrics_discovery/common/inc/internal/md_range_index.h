@@ -0,0 +1,85 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2026 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+//     File Name:  md_range_index.h
+
+//     Abstract:   C++ Metrics Discovery internal range index header
+
+#pragma once
+
+#include "metrics_discovery_internal_api.h"
+#include "md_calculation.h"
+#include "md_types.h"
+
+#include <vector>
+
+using namespace MetricsDiscovery;
+
+namespace MetricsDiscoveryInternal
+{
+    ///////////////////////////////////////////////////////////////////////////////
+    // Forward declarations:                                                     //
+    ///////////////////////////////////////////////////////////////////////////////
+    class CMetricSet;
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CRangeIndex
+    //
+    // Description:
+    //     Range queries over IoStream raw data created by a metric set. Keeps a prefix
+    //     sum table of counters (GpuTicks, PEC and NOA) at each raw report: the first
+    //     row holds counters of the first report, each next one adds wrapped counter
+    //     deltas to the previous row. Counter deltas of a range are 64 bit differences
+    //     of rows interpolated at its ends, so a range is calculated in O(1) after
+    //     the search for the ends, however many times its counters wrap.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    class CRangeIndex : public IRangeIndexLatest
+    {
+    public:
+        // API 1.17:
+        virtual TCompletionCode GetTimeRange( uint64_t* outStartTimestamp, uint64_t* outEndTimestamp ) final;
+        virtual TCompletionCode CalculateRange( uint64_t startTimestamp, uint64_t endTimestamp, const TTypedValue_1_0** out, const TTypedValue_1_0** outMaxValues ) final;
+
+        // Constructor & Destructor:
+        CRangeIndex( CMetricSet& metricSet, bool calculateMaxValues );
+        virtual ~CRangeIndex();
+
+        TCompletionCode Initialize( const uint8_t* rawData, uint32_t rawDataSize );
+
+    private:
+        CRangeIndex( const CRangeIndex& )            = delete; // Delete copy-constructor
+        CRangeIndex& operator=( const CRangeIndex& ) = delete; // Delete assignment operator
+
+        TCompletionCode PreparePlan();
+        void            InterpolateReport( uint64_t timestamp, uint64_t* outCounters, uint8_t* outReport );
+
+    private:
+        // Members:
+        CMetricSet&                       m_metricSet;
+        TCalculationSession*              m_session;
+        bool                              m_calculateMaxValues;
+        uint32_t                          m_planGeneration;        // Plan generation the sizes below are computed for
+        uint32_t                          m_outReportValues;       // Values count in one calculated report
+        uint32_t                          m_maxValuesReportValues; // Values count in one max values report
+        uint32_t                          m_rawReportSize;         // Raw report size in bytes
+        uint32_t                          m_timestampOffset;       // 64 bit timestamp header field offset
+        uint32_t                          m_counterCount;          // Counters in a prefix sum row
+        uint64_t                          m_gpuTimestampFrequency;
+        std::vector<TReportCounterRegion> m_regions;               // Counter regions of a prefix sum row, GpuTicks first
+        std::vector<uint64_t>             m_timestamps;            // Per indexed raw report, GPU timestamp ticks
+        std::vector<uint64_t>             m_prefixSums;            // Per indexed raw report, m_counterCount cumulative counters
+        std::vector<uint64_t>             m_rangeCounters;         // Cumulative counters interpolated at range start and end
+        std::vector<uint64_t>             m_rangeDeltas;           // Per report column, deltas between range ends
+        std::vector<uint8_t>              m_rangeReports;          // Two raw reports at range ends, other fields from the first indexed report
+        std::vector<TTypedValue_1_0>      m_out;
+        std::vector<TTypedValue_1_0>      m_outMaxValues;
+    };
+} // namespace MetricsDiscoveryInternal
@@ -0,0 +1,72 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2026 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+//     File Name:  md_stream_calculation.h
+
+//     Abstract:   C++ Metrics Discovery internal stream calculation header
+
+#pragma once
+
+#include "metrics_discovery_internal_api.h"
+#include "md_calculation.h"
+
+#include <vector>
+
+using namespace MetricsDiscovery;
+
+namespace MetricsDiscoveryInternal
+{
+    ///////////////////////////////////////////////////////////////////////////////
+    // Forward declarations:                                                     //
+    ///////////////////////////////////////////////////////////////////////////////
+    class CMetricSet;
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CStreamCalculation
+    //
+    // Description:
+    //     Incremental IoStream calculation created by a metric set. Owns its
+    //     calculation session (calculator with the carried over report, manager
+    //     and context) and output buffers, so consecutive pushes only check
+    //     the raw data size and reuse everything prepared for the calculation plan.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    class CStreamCalculation : public IStreamCalculationLatest
+    {
+    public:
+        // API 1.17:
+        virtual TCompletionCode Push( const uint8_t* rawData, uint32_t rawDataSize, const TTypedValue_1_0** out, const TTypedValue_1_0** outMaxValues, uint32_t* outReportCount ) final;
+        virtual void            Reset( void ) final;
+
+        // Constructor & Destructor:
+        CStreamCalculation( CMetricSet& metricSet, bool calculateMaxValues );
+        virtual ~CStreamCalculation();
+
+        TCompletionCode Initialize();
+
+    private:
+        CStreamCalculation( const CStreamCalculation& )            = delete; // Delete copy-constructor
+        CStreamCalculation& operator=( const CStreamCalculation& ) = delete; // Delete assignment operator
+
+        TCompletionCode PreparePlan();
+
+    private:
+        // Members:
+        CMetricSet&                  m_metricSet;
+        TCalculationSession*         m_session;
+        bool                         m_calculateMaxValues;
+        uint32_t                     m_planGeneration;        // Plan generation the sizes below are computed for
+        uint32_t                     m_rawReportSize;         // Raw report size in bytes
+        uint32_t                     m_outReportValues;       // Values count in one calculated report
+        uint32_t                     m_maxValuesReportValues; // Values count in one max values report
+        std::vector<TTypedValue_1_0> m_out;
+        std::vector<TTypedValue_1_0> m_outMaxValues;
+    };
+} // namespace MetricsDiscoveryInternal
@@ -13,17 +13,27 @@ SPDX-License-Identifier: MIT
 #pragma once
 
 #include "metrics_discovery_api.h"
+#include "md_worker_pool.h"
 
 #include <stack>
-
-#define MD_SAVED_REPORT_NUMBER        0xFFFFFFFF
-#define MD_REPORT_ID_SKIP_CALCULATION 2048
+#include <vector>
+
+#define MD_SAVED_REPORT_NUMBER                0xFFFFFFFF
+#define MD_REPORT_ID_SKIP_CALCULATION         2048
+#define MD_CALCULATION_BATCH_SIZE             64
+#define MD_CALCULATION_MAX_THREAD_COUNT       64
+#define MD_CALCULATION_MIN_CHUNK_REPORT_COUNT 256
+#define MD_REPORT_TIMESTAMP_OFFSET            8
+#define MD_REPORT_TIMESTAMP_INDEX_STRIDE      64
+#define MD_FUSED_CALCULATION_REPORT_COUNT     1024
+#define MD_AGGREGATION_BATCH_REPORT_COUNT     256
 
 using namespace MetricsDiscovery;
 
 namespace MetricsDiscoveryInternal
 {
     // Forward declarations //
+    class CCalculationManager;
     class CMetricsDevice;
     class CMetricSet;
     class CEquation;
@@ -48,9 +58,11 @@ namespace MetricsDiscoveryInternal
         uint32_t       RawReportSize;
 
         // Output
-        TTypedValue_1_0* Out; // Required
-        uint32_t         OutReportCount;
-        TTypedValue_1_0* OutMaxValues;
+        TTypedValue_1_0*                    Out; // Required, unless output descriptor is used
+        uint32_t                            OutReportCount;
+        TTypedValue_1_0*                    OutMaxValues;
+        TCalculationOutputDescriptorLatest* OutDescriptor;   // Columnar output, used instead of Out and OutMaxValues
+        uint32_t                            OutReportOffset; // Index of the first calculated report in output columns
 
         // Calculation
         TTypedValue_1_0* DeltaValues; // Required
@@ -70,7 +82,13 @@ namespace MetricsDiscoveryInternal
         int32_t ReportReasonIdx;
 
         // ContextFiltering
-        bool DoContextFiltering; // Required - not supported
+        bool           DoContextFiltering;  // Only reports starting in the filtered context are calculated
+        uint64_t       FilteredContextId;   // Context id of the first report of the stream
+        const uint8_t* ContextSelection;    // Per raw report, 1 if the report is from the filtered context
+        bool           SavedReportSelected; // Saved report is from the filtered context
+
+        // Async calculation
+        const uint64_t* ReportReasons; // Per raw report, read once before the first async report
 
         // Calculation
         const uint8_t* PrevRawDataPtr;
@@ -78,6 +96,11 @@ namespace MetricsDiscoveryInternal
         const uint8_t* LastRawDataPtr;
         uint32_t       LastRawReportNumber;
 
+        // Batch calculation
+        const uint8_t* BatchPrevRawDataPtrs[MD_CALCULATION_BATCH_SIZE];
+        const uint8_t* BatchLastRawDataPtrs[MD_CALCULATION_BATCH_SIZE];
+        uint32_t       BatchReportCount;
+
     } TStreamCalculationContext;
 
     ///////////////////////////////////////////////////////////////////////////////
@@ -97,6 +120,34 @@ namespace MetricsDiscoveryInternal
         TQueryCalculationContext  QueryCalculationContext;
     } TCalculationContext;
 
+    ///////////////////////////////////////////////////////////////////////////////
+    // Calculation session:
+    // Calculator, manager and context calculating metrics with a metric set. The metric
+    // set owns one continuing the stream of sequential CalculateMetrics calls and idle
+    // ones for overlapping calls, each stream calculation and range index owns its own.
+    // Reused by the next calculations of the owner, so they don't allocate.
+    //////////////////////////////////////////////////////////////////////////////
+    typedef struct SCalculationSession
+    {
+        CMetricsCalculator*  Calculator;
+        CCalculationManager* CalculationManager;
+        TMeasurementType     MeasurementType; // Measurement type of the calculation manager
+        uint32_t             PlanGeneration;  // Calculation plan generation the context is prepared for, 0 if not prepared
+        TCalculationContext  Context;
+    } TCalculationSession;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // Calculation chunk:
+    // Consecutive raw reports calculated on a separate thread.
+    //////////////////////////////////////////////////////////////////////////////
+    typedef struct SCalculationChunk
+    {
+        uint32_t FirstRawReport;    // Index of the first raw report of the chunk
+        uint32_t RawReportCount;    // Raw report count, including the first one
+        uint32_t OutReportOffset;   // Index of the first calculated report of the chunk in the output
+        uint64_t PreviousContextId; // Context id of the report calculated before the chunk, stream only
+    } TCalculationChunk;
+
     ///////////////////////////////////////////////////////////////////////////////
     // Common aggregation context:
     //////////////////////////////////////////////////////////////////////////////
@@ -160,8 +211,7 @@ namespace MetricsDiscoveryInternal
         uint8_t** PrevSavedReportPtrs;
         uint8_t** LastSavedReportPtrs;
 
-        // Cached report pointers
-        uint8_t** CachedReportPtrsBase;
+        // Current cached report pointers, cached reports are kept by the calculation context
         uint8_t** CachedReportPtrs;
 
         // Interpolated report pointers
@@ -174,7 +224,6 @@ namespace MetricsDiscoveryInternal
         uint64_t* CurrentTs;
         bool*     NeedReport;
         bool*     IsCachedReport;
-        uint32_t* CachedReportPtrsSize;
         bool      IsNewCalculationWindow;
         bool*     SkipReportAfterRc6;
         bool*     IsPrevRawDataPresent;
@@ -240,10 +289,11 @@ namespace MetricsDiscoveryInternal
         virtual ~CCalculationManager() {};
 
         // Calculation.
-        virtual void            ResetContext( TCalculationContext& context )             = 0;
-        virtual TCompletionCode PrepareContext( TCalculationContext& context )           = 0;
-        virtual bool            CalculateNextReport( TCalculationContext& context )      = 0;
-        virtual bool            CalculateNextAsyncReport( TCalculationContext& context ) = 0;
+        virtual void            ResetContext( TCalculationContext& context )                         = 0;
+        virtual TCompletionCode PrepareContext( TCalculationContext& context )                       = 0;
+        virtual bool            CalculateNextReport( TCalculationContext& context )                  = 0;
+        virtual bool            CalculateNextAsyncReport( TCalculationContext& context )             = 0;
+        virtual TCompletionCode CalculateReports( TCalculationContext& context, uint32_t threadCount ) = 0;
 
         // Aggregation.
         virtual void            ResetContext( TAggregationContext& context )        = 0;
@@ -266,11 +316,14 @@ namespace MetricsDiscoveryInternal
     class CMetricsCalculationManager : public CCalculationManager
     {
     public:
+        virtual ~CMetricsCalculationManager();
+
         // Calculation.
         virtual void            ResetContext( TCalculationContext& context ) final;
         virtual TCompletionCode PrepareContext( TCalculationContext& context ) final;
         virtual bool            CalculateNextReport( TCalculationContext& context ) final;
         virtual bool            CalculateNextAsyncReport( TCalculationContext& context ) final;
+        virtual TCompletionCode CalculateReports( TCalculationContext& context, uint32_t threadCount ) final;
 
         // Aggregation.
         virtual void            ResetContext( TAggregationContext& context ) final;
@@ -282,5 +335,18 @@ namespace MetricsDiscoveryInternal
     private:
         int32_t GetInformationIndex( const char* symbolName, CMetricSet* set );
         void    ProcessCalculation( TStreamCalculationContext* sc, bool async, uint32_t adapterId );
+        void    QueueCalculation( TStreamCalculationContext* sc, uint32_t adapterId );
+        void    FlushCalculation( TStreamCalculationContext* sc, uint32_t adapterId );
+
+        uint32_t        GetChunkCount( TCommonCalculationContext& context, uint32_t threadCount );
+        TCompletionCode CalculateChunks( TCalculationContext& context, const std::vector<TCalculationChunk>& chunks, uint32_t threadCount );
+
+        static uint32_t GetThreadCount( uint32_t threadCount );
+
+    private:
+        CWorkerPool                      m_workerPool;       // Threads calculating chunks of raw reports
+        std::vector<TCalculationChunk>   m_chunks;           // Chunks of raw reports of the last calculation
+        std::vector<TCalculationContext> m_chunkContexts;    // Calculation contexts of the chunks
+        std::vector<CMetricsCalculator*> m_chunkCalculators; // Calculators of the chunks but the last one, kept for the next calls
     };
 } // namespace MetricsDiscoveryInternal
@@ -14,6 +14,8 @@ SPDX-License-Identifier: MIT
 #pragma once
 
 #include "md_adapter.h"
+#include "md_calculation.h"
+#include "md_report_kernels.h"
 #include "md_metrics_device.h"
 #include "md_metric_set.h"
 #include "md_metric.h"
@@ -22,56 +24,115 @@ SPDX-License-Identifier: MIT
 #include "md_types.h"
 #include "md_utils.h"
 
+#include <algorithm>
 #include <cstring>
 #include <limits>
-#include <stack>
 #include <array>
 #include <functional>
+#include <type_traits>
 
 namespace MetricsDiscoveryInternal
 {
     //////////////////////////////////////////////////////////////////////////////
     //
     // Class:
-    //     CMetricsCalculator
+    //     CEquationStack
     //
     // Description:
-    //     Class wrapping operations like raw values read or normalization on a single report.
+    //     Equation evaluation stack with inline storage for MAX_STACK_DEPTH values.
+    //     Capacity is sufficient for every validated program (see CEquation::Compile),
+    //     so Push and Pop are not checked. Deeper equations aren't validated, they are
+    //     evaluated with IsFull checks after Reserve, which moves the stack to the heap.
     //
     //////////////////////////////////////////////////////////////////////////////
-    class CMetricsCalculator
+    class CEquationStack
+    {
+    public:
+        inline void Clear()
+        {
+            m_size = 0;
+        }
+
+        inline void Reserve( const uint32_t depth )
+        {
+            if( depth > GetCapacity() )
+            {
+                m_heapValues.resize( depth );
+            }
+        }
+
+        inline void Push( const TTypedValue_1_0& value )
+        {
+            GetValues()[m_size++] = value;
+        }
+
+        inline TTypedValue_1_0 Pop()
+        {
+            return GetValues()[--m_size];
+        }
+
+        inline uint32_t GetSize() const
+        {
+            return m_size;
+        }
+
+        inline bool IsFull() const
+        {
+            return m_size == GetCapacity();
+        }
+
+    private:
+        inline TTypedValue_1_0* GetValues()
+        {
+            return m_heapValues.empty() ? m_values.data() : m_heapValues.data();
+        }
+
+        inline uint32_t GetCapacity() const
+        {
+            return m_heapValues.empty() ? CEquation::MAX_STACK_DEPTH : static_cast<uint32_t>( m_heapValues.size() );
+        }
+
+    private:
+        std::array<TTypedValue_1_0, CEquation::MAX_STACK_DEPTH> m_values     = {};
+        std::vector<TTypedValue_1_0>                            m_heapValues = {}; // Used only after deeper equations are reserved
+        uint32_t                                                m_size       = 0;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculatorSymbols
+    //
+    // Description:
+    //     Global symbols used in metrics calculation, aggregated across devices if needed.
+    //     Not modified after construction, so it's shared by all the calculators of
+    //     a metric set, including the ones used concurrently by different threads.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    class CCalculatorSymbols
     {
     public:
         //////////////////////////////////////////////////////////////////////////////
         //
         // Class:
-        //     CMetricsCalculator
+        //     CCalculatorSymbols
         //
         // Method:
-        //     CMetricsCalculator
+        //     CCalculatorSymbols
         //
         // Description:
-        //     CMetricsCalculator constructor.
+        //     CCalculatorSymbols constructor.
         //
         // Input:
         //     CMetricsDevice& metricsDevice - metrics device is used for obtaining global symbols
         //                                     during calculations
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline CMetricsCalculator( CMetricsDevice& metricsDevice )
-            : m_readEquationStack{}
-            , m_readEquationAndDeltaStack{}
-            , m_normalizationEquationStack{}
-            , m_symbolMap{}
+        inline CCalculatorSymbols( CMetricsDevice& metricsDevice )
+            : m_symbolMap{}
             , m_device( metricsDevice )
-            , m_gpuCoreClocks( 0 )
+            , m_symbolSet( metricsDevice.GetSymbolSet() )
             , m_euCoresCount( 0 )
-            , m_savedReport( nullptr )
-            , m_savedReportSize( 0 )
-            , m_contextIdPrev( 0 )
-            , m_prevValues( nullptr )
-            , m_prevValuesCount( 0 )
-            , m_savedReportPresent( false )
             , m_multipleSymbols( false )
         {
             TTypedValue_1_0* euCoresTotalCount = GetGlobalSymbolValue( "VectorEngineTotalCount" );
@@ -86,33 +147,24 @@ namespace MetricsDiscoveryInternal
         //////////////////////////////////////////////////////////////////////////////
         //
         // Class:
-        //     CMetricsCalculator
+        //     CCalculatorSymbols
         //
         // Method:
-        //     CMetricsCalculator
+        //     CCalculatorSymbols
         //
         // Description:
-        //     CMetricsCalculator constructor.
+        //     CCalculatorSymbols constructor.
         //
         // Input:
         //     std::vector<std::reference_wrapper<CMetricsDevice>> metricsDevice -
         //          metrics devices are used for obtaining global symbols during calculations
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline CMetricsCalculator( std::vector<std::reference_wrapper<CMetricsDevice>> metricsDevice )
-            : m_readEquationStack{}
-            , m_readEquationAndDeltaStack{}
-            , m_normalizationEquationStack{}
-            , m_symbolMap{}
+        inline CCalculatorSymbols( std::vector<std::reference_wrapper<CMetricsDevice>> metricsDevice )
+            : m_symbolMap{}
             , m_device( metricsDevice[0] )
-            , m_gpuCoreClocks( 0 )
+            , m_symbolSet( m_device.GetSymbolSet() )
             , m_euCoresCount( 0 )
-            , m_savedReport( nullptr )
-            , m_savedReportSize( 0 )
-            , m_contextIdPrev( 0 )
-            , m_prevValues( nullptr )
-            , m_prevValuesCount( 0 )
-            , m_savedReportPresent( false )
             , m_multipleSymbols( false )
         {
             constexpr size_t acceptableSymbolsSize = 19;
@@ -151,7 +203,7 @@ namespace MetricsDiscoveryInternal
                     {
                         auto isSymbolNameEqual = [&]( const std::pair<const char*, bool>& element )
                         {
-                            return element.first == symbol->SymbolName;
+                            return std::string_view( element.first ) == symbol->SymbolName;
                         };
 
                         auto acceptableSymbolIterator = std::find_if( acceptableSymbols.begin(), acceptableSymbols.end(), isSymbolNameEqual );
@@ -206,6 +258,293 @@ namespace MetricsDiscoveryInternal
             m_euCoresCount = euCoresTotalCount ? euCoresTotalCount->ValueUInt32 : 0;
         }
 
+        CCalculatorSymbols( const CCalculatorSymbols& )            = delete; // Delete copy-constructor
+        CCalculatorSymbols& operator=( const CCalculatorSymbols& ) = delete; // Delete assignment operator
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CCalculatorSymbols
+        //
+        // Method:
+        //     GetBoundSymbolValue
+        //
+        // Description:
+        //     Returns value of a global symbol bound to the given compiled instruction.
+        //     Dynamic symbols are redetected by name. Equations calculated with symbols
+        //     aggregated across devices are bound to the aggregated values when
+        //     the calculation plan is prepared, see CEquation::BindGlobalSymbols,
+        //     symbols that aren't aggregated are the symbols of the first device.
+        //
+        // Input:
+        //     const TEquationInstruction& instruction - global symbol instruction
+        //
+        // Output:
+        //     TTypedValue_1_0 - global symbol typed value, 0 if not available
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline TTypedValue_1_0 GetBoundSymbolValue( const TEquationInstruction& instruction ) const
+        {
+            TTypedValue_1_0  dynamicValue = {};
+            TTypedValue_1_0* value        = nullptr;
+
+            if( instruction.Code == EQUATION_INSTR_GLOBAL_SYMBOL_DYNAMIC )
+            {
+                value = DetectDynamicSymbolValue( instruction.SymbolName, dynamicValue )
+                    ? &dynamicValue
+                    : nullptr;
+            }
+            else
+            {
+                value = instruction.SymbolValue;
+            }
+
+            if( value )
+            {
+                return *value;
+            }
+
+            TTypedValue_1_0 typedValue = {};
+            typedValue.ValueUInt64     = 0;
+            typedValue.ValueType       = VALUE_TYPE_UINT64;
+            return typedValue;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CCalculatorSymbols
+        //
+        // Method:
+        //     GetEquationProgram
+        //
+        // Description:
+        //     Returns program used to calculate the given equation. Constant folded
+        //     program is built when the equation is compiled, or when it's bound to
+        //     symbols aggregated across devices, and is only read here.
+        //
+        // Input:
+        //     const CEquation&      equation    - equation to calculate
+        //     TEquationProgramType& programType - (OUT) inferred type of the returned program
+        //
+        // Output:
+        //     const std::vector<TEquationInstruction>& - equation program
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline const std::vector<TEquationInstruction>& GetEquationProgram(
+            const CEquation&      equation,
+            TEquationProgramType& programType ) const
+        {
+            programType = equation.GetOptimizedProgramType();
+            return equation.GetOptimizedProgram();
+        }
+
+        inline uint32_t GetEuCoresCount() const
+        {
+            return m_euCoresCount;
+        }
+
+        // Returns true if global symbols are aggregated across devices, so equations
+        // bound to the symbols of a single device have to be bound to them.
+        inline bool HasAggregatedSymbols() const
+        {
+            return m_multipleSymbols;
+        }
+
+        inline CMetricsDevice& GetMetricsDevice() const
+        {
+            return m_device;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CCalculatorSymbols
+        //
+        // Method:
+        //     GetAggregatedSymbolValue
+        //
+        // Description:
+        //     Returns value of a global symbol aggregated across devices. Values aren't
+        //     changed after construction, so equations may be bound to them.
+        //
+        // Input:
+        //     const char* symbolName - global symbol name
+        //
+        // Output:
+        //     TTypedValue_1_0* - aggregated symbol typed value, null if not aggregated
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline TTypedValue_1_0* GetAggregatedSymbolValue( const char* symbolName )
+        {
+            if( symbolName == nullptr )
+            {
+                return nullptr;
+            }
+
+            if( auto symbol = m_symbolMap.find( symbolName );
+                symbol != m_symbolMap.end() )
+            {
+                return &symbol->second;
+            }
+
+            return nullptr;
+        }
+
+    private:
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CCalculatorSymbols
+        //
+        // Method:
+        //     GetGlobalSymbolValue
+        //
+        // Description:
+        //     Returns global symbol of a given name. Uses MetricsDevice.
+        //
+        // Input:
+        //     const char* symbolName - global symbol name
+        //
+        // Output:
+        //     TTypedValue_1_0* - global symbol typed value, null if error
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline TTypedValue_1_0* GetGlobalSymbolValue( const char* symbolName )
+        {
+            const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+            MD_CHECK_PTR_RET_A( adapterId, symbolName, nullptr );
+
+            if( m_multipleSymbols )
+            {
+                if( auto symbol = m_symbolMap.find( symbolName );
+                    symbol != m_symbolMap.end() )
+                {
+                    return &symbol->second;
+                }
+                else
+                {
+                    return nullptr;
+                }
+            }
+
+            return m_device.GetGlobalSymbolValueByName( symbolName );
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CCalculatorSymbols
+        //
+        // Method:
+        //     DetectDynamicSymbolValue
+        //
+        // Description:
+        //     Detects the current value of a dynamic global symbol. The value is detected
+        //     to the given copy, the device symbol isn't updated, so concurrent calculations
+        //     don't write the shared symbol set.
+        //
+        // Input:
+        //     const char*      symbolName - global symbol name
+        //     TTypedValue_1_0& value      - (OUT) detected symbol value
+        //
+        // Output:
+        //     bool - true if the symbol value is available
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline bool DetectDynamicSymbolValue( const char* symbolName, TTypedValue_1_0& value ) const
+        {
+            if( symbolName == nullptr )
+            {
+                return false;
+            }
+
+            TGlobalSymbol* symbol = m_symbolSet.GetSymbolByName( symbolName );
+
+            if( symbol == nullptr )
+            {
+                return false;
+            }
+
+            value = symbol->symbol.SymbolTypedValue;
+
+            return m_symbolSet.DetectSymbolValue( symbolName, value ) == CC_OK;
+        }
+
+    private:
+        std::unordered_map<std::string_view, TTypedValueLatest> m_symbolMap;
+        CMetricsDevice&                                         m_device;
+        CSymbolSet&                                             m_symbolSet;
+        uint32_t                                                m_euCoresCount;
+        bool                                                    m_multipleSymbols;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricsCalculator
+    //
+    // Description:
+    //     Class wrapping operations like raw values read or normalization on a single report.
+    //     Holds the calculation state of a single report stream (saved report, previous
+    //     values, equation stacks and batch buffers), so it's a workspace that can't be
+    //     used by more than one thread at a time. Global symbols are shared, see
+    //     CCalculatorSymbols.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    class CMetricsCalculator
+    {
+    public:
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CMetricsCalculator
+        //
+        // Description:
+        //     CMetricsCalculator constructor.
+        //
+        // Input:
+        //     CCalculatorSymbols& symbols - global symbols used during calculations, shared
+        //                                   with other calculators of the metric set
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline CMetricsCalculator( CCalculatorSymbols& symbols )
+            : m_readEquationStack{}
+            , m_readEquationAndDeltaStack{}
+            , m_normalizationEquationStack{}
+            , m_symbols( symbols )
+            , m_device( symbols.GetMetricsDevice() )
+            , m_gpuCoreClocks( 0 )
+            , m_savedReport( nullptr )
+            , m_savedReportSize( 0 )
+            , m_contextIdPrev( 0 )
+            , m_filteredContextId( 0 )
+            , m_prevValues( nullptr )
+            , m_prevValuesCount( 0 )
+            , m_savedReportPresent( false )
+            , m_batchDeltaValues{}
+            , m_batchGpuCoreClocks{}
+            , m_batchRegistersUInt64( CEquation::MAX_STACK_DEPTH * MD_CALCULATION_BATCH_SIZE )
+            , m_batchRegistersFloat( CEquation::MAX_STACK_DEPTH * MD_CALCULATION_BATCH_SIZE )
+            , m_batchRegisters( CEquation::MAX_STACK_DEPTH * MD_CALCULATION_BATCH_SIZE )
+            , m_reportDeltas{}
+            , m_reportDeltasBitsCount{}
+            , m_batchColumnsLast{}
+            , m_batchColumnsPrev{}
+            , m_batchColumnDeltas{}
+            , m_batchColumnDeltasBitsCount{}
+            , m_batchColumnsTransposed( false )
+            , m_calculatedValues{}
+            , m_calculatedMaxValues{}
+            , m_deltaValues{}
+            , m_contextSelection{}
+            , m_reportReasons{}
+        {
+        }
+
         //////////////////////////////////////////////////////////////////////////////
         //
         // Class:
@@ -334,23 +673,25 @@ namespace MetricsDiscoveryInternal
 
             m_gpuCoreClocks = 0;
 
-            const uint32_t metricsCount = metricSet.GetParams()->MetricsCount;
-            for( uint32_t i = 0; i < metricsCount; ++i )
-            {
-                outValues[i].ValueType   = VALUE_TYPE_UINT64;
-                outValues[i].ValueUInt64 = 0ULL;
+            auto plan = metricSet.GetCalculationPlan();
+            MD_CHECK_PTR_RET_A( adapterId, plan, CC_ERROR_GENERAL );
 
-                auto metric = metricSet.GetMetricExplicit( i );
-                MD_CHECK_PTR_RET_A( adapterId, metric, CC_ERROR_GENERAL );
+            const int32_t gpuCoreClocksIndex = plan->GpuCoreClocksIndex;
+            CEquation**   readEquations      = plan->QueryReadEquations.data();
 
-                auto& metricParams = *metric->GetParams();
-
-                if( metricParams.QueryReadEquation )
+            for( const uint32_t i : plan->CalculatedMetrics )
+            {
+                if( readEquations[i] )
+                {
+                    outValues[i] = CalculateReadEquation( *readEquations[i], rawReport );
+                }
+                else
                 {
-                    outValues[i] = CalculateReadEquation( static_cast<CEquation&>( *( metricParams.QueryReadEquation ) ), rawReport );
+                    outValues[i].ValueType   = VALUE_TYPE_UINT64;
+                    outValues[i].ValueUInt64 = 0ULL;
                 }
 
-                if( m_gpuCoreClocks == 0 && std::string_view( metricParams.SymbolName ) == "GpuCoreClocks" )
+                if( static_cast<int32_t>( i ) == gpuCoreClocksIndex )
                 {
                     m_gpuCoreClocks = outValues[i].ValueUInt64;
                 }
@@ -369,18 +710,21 @@ namespace MetricsDiscoveryInternal
         //
         // Description:
         //     Reads metrics from a given metric set using raw report data for prev and last report.
+        //     If column deltas are given, they are used instead of the deltas of report columns
+        //     read with DELTA_N_BITS, see CalculateReadEquationAndDelta.
         //
         // Input:
         //     const uint8_t*   rawRaportLast - (IN) last (next) single raw report
         //     const uint8_t*   rawRaportPrev - (IN) previous single raw report
         //     TTypedValue_1_0* outValues     - (OUT) read metric values
         //     CMetricSet&      metricSet     - MetricSet for calculations
+        //     const uint64_t*  columnDeltas  - (IN - optional) per report column, see TReportColumn
         //
         // Output:
         //     TCompletionCode - *CC_OK* means success
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline TCompletionCode ReadMetricsFromIoReport( const uint8_t* rawRaportLast, const uint8_t* rawRaportPrev, TTypedValue_1_0* outValues, CMetricSet& metricSet )
+        inline TCompletionCode ReadMetricsFromIoReport( const uint8_t* rawRaportLast, const uint8_t* rawRaportPrev, TTypedValue_1_0* outValues, CMetricSet& metricSet, const uint64_t* columnDeltas = nullptr )
         {
             const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
 
@@ -390,23 +734,28 @@ namespace MetricsDiscoveryInternal
 
             m_gpuCoreClocks = 0;
 
-            const uint32_t metricsCount = metricSet.GetParams()->MetricsCount;
-            for( uint32_t i = 0; i < metricsCount; ++i )
-            {
-                outValues[i].ValueType   = VALUE_TYPE_UINT64;
-                outValues[i].ValueUInt64 = 0ULL;
+            auto plan = metricSet.GetCalculationPlan();
+            MD_CHECK_PTR_RET_A( adapterId, plan, CC_ERROR_GENERAL );
 
-                auto metric = metricSet.GetMetricExplicit( i );
-                MD_CHECK_PTR_RET_A( adapterId, metric, CC_ERROR_GENERAL );
+            const int32_t             gpuCoreClocksIndex = plan->GpuCoreClocksIndex;
+            CEquation**               readEquations      = plan->IoReadEquations.data();
+            const TDeltaFunction_1_0* deltaFunctions     = plan->DeltaFunctions.data();
 
-                auto& metricParams = *metric->GetParams();
+            InvalidateReportDeltas( plan->ReportLayout );
 
-                if( metricParams.IoReadEquation )
+            for( const uint32_t i : plan->CalculatedMetrics )
+            {
+                if( readEquations[i] )
                 {
-                    outValues[i] = CalculateReadEquationAndDelta( static_cast<CEquation&>( *( metricParams.IoReadEquation ) ), metricParams.DeltaFunction, rawRaportLast, rawRaportPrev );
+                    outValues[i] = CalculateReadEquationAndDelta( *readEquations[i], deltaFunctions[i], plan->ReportLayout, rawRaportLast, rawRaportPrev, columnDeltas );
+                }
+                else
+                {
+                    outValues[i].ValueType   = VALUE_TYPE_UINT64;
+                    outValues[i].ValueUInt64 = 0ULL;
                 }
 
-                if( m_gpuCoreClocks == 0 && std::string_view( metricParams.SymbolName ) == "GpuCoreClocks" )
+                if( static_cast<int32_t>( i ) == gpuCoreClocksIndex )
                 {
                     m_gpuCoreClocks = outValues[i].ValueUInt64;
                 }
@@ -444,55 +793,20 @@ namespace MetricsDiscoveryInternal
                 return;
             }
 
-            const uint32_t metricsCount = metricSet.GetParams()->MetricsCount;
-            for( uint32_t i = 0; i < metricsCount; ++i )
-            {
-                auto metric = metricSet.GetMetricExplicit( i );
-                MD_CHECK_PTR_RET_A( adapterId, metric, MD_EMPTY );
+            auto plan = metricSet.GetCalculationPlan();
+            MD_CHECK_PTR_RET_A( adapterId, plan, MD_EMPTY );
 
-                auto& metricParams = *metric->GetParams();
+            CEquation**               normEquations      = plan->NormEquations.data();
+            const TNormalizationKind* normalizationKinds = plan->NormalizationKinds.data();
+            const TMetricResultType*  resultTypes        = plan->ResultTypes.data();
 
-                outValues[i] = metricParams.NormEquation
-                    ? CalculateLocalNormalizationEquation( static_cast<CEquation&>( *( metricParams.NormEquation ) ), deltaValues, outValues, i )
+            for( const uint32_t i : plan->CalculatedMetrics )
+            {
+                outValues[i] = ( normalizationKinds[i] == NORMALIZATION_KIND_EQUATION )
+                    ? CalculateLocalNormalizationEquation( *normEquations[i], deltaValues, outValues, i )
                     : deltaValues[i];
 
-                switch( metricParams.ResultType )
-                {
-                    case RESULT_UINT32:
-                        if( outValues[i].ValueType != VALUE_TYPE_UINT32 )
-                        {
-                            outValues[i].ValueUInt32 = CastToUInt32( outValues[i] );
-                            outValues[i].ValueType   = VALUE_TYPE_UINT32;
-                        }
-                        break;
-
-                    case RESULT_UINT64:
-                        if( outValues[i].ValueType != VALUE_TYPE_UINT64 )
-                        {
-                            outValues[i].ValueUInt64 = CastToUInt64( outValues[i] );
-                            outValues[i].ValueType   = VALUE_TYPE_UINT64;
-                        }
-                        break;
-
-                    case RESULT_FLOAT:
-                        if( outValues[i].ValueType != VALUE_TYPE_FLOAT )
-                        {
-                            outValues[i].ValueFloat = CastToFloat( outValues[i] );
-                            outValues[i].ValueType  = VALUE_TYPE_FLOAT;
-                        }
-                        break;
-
-                    case RESULT_BOOL:
-                        if( outValues[i].ValueType != VALUE_TYPE_BOOL )
-                        {
-                            outValues[i].ValueBool = CastToBoolean( outValues[i] );
-                            outValues[i].ValueType = VALUE_TYPE_BOOL;
-                        }
-                        break;
-
-                    default:
-                        MD_ASSERT_A( adapterId, false );
-                }
+                ConvertToResultType( outValues[i], resultTypes[i] );
             }
         }
 
@@ -526,15 +840,15 @@ namespace MetricsDiscoveryInternal
                 return;
             }
 
-            auto&          metricSetParams  = *metricSet.GetParams();
-            const uint32_t apiMask          = metricSetParams.ApiMask;
-            const uint32_t informationCount = metricSetParams.InformationCount;
+            auto plan = metricSet.GetCalculationPlan();
+            MD_CHECK_PTR_RET_A( m_device.GetAdapter().GetAdapterId(), plan, MD_EMPTY );
+
+            const uint32_t                    informationCount = plan->InformationCount;
+            const TInformationReadDescriptor* informations     = plan->Informations.data();
 
             for( uint32_t i = 0; i < informationCount; ++i )
             {
-                auto information = metricSet.GetInformation( i );
-
-                ReadSingleInformation( rawData, information, apiMask, &outValues[i] );
+                ReadSingleInformation( rawData, informations[i], &outValues[i] );
             }
 
             if( contextIdIdx != -1 )
@@ -570,13 +884,7 @@ namespace MetricsDiscoveryInternal
                 return;
             }
 
-            TTypedValue_1_0   outValue    = {};
-            IInformation_1_0* information = metricSet.GetInformation( static_cast<uint32_t>( contextIdIdx ) );
-            const uint32_t    apiMask     = metricSet.GetParams()->ApiMask;
-
-            ReadSingleInformation( rawData, information, apiMask, &outValue );
-
-            m_contextIdPrev = outValue.ValueUInt64;
+            m_contextIdPrev = ReadInformationByIndex( rawData, metricSet, contextIdIdx );
         }
 
         //////////////////////////////////////////////////////////////////////////////
@@ -606,11 +914,17 @@ namespace MetricsDiscoveryInternal
                 return 0;
             }
 
-            TTypedValue_1_0   outValue    = {};
-            IInformation_1_0* information = metricSet.GetInformation( static_cast<uint32_t>( informationIndex ) );
-            const uint32_t    apiMask     = metricSet.GetParams()->ApiMask;
+            auto plan = metricSet.GetCalculationPlan();
+
+            if( plan == nullptr || static_cast<uint32_t>( informationIndex ) >= plan->InformationCount )
+            {
+                MD_ASSERT_A( m_device.GetAdapter().GetAdapterId(), false );
+                return 0;
+            }
+
+            TTypedValue_1_0 outValue = {};
 
-            ReadSingleInformation( rawData, information, apiMask, &outValue );
+            ReadSingleInformation( rawData, plan->Informations[informationIndex], &outValue );
 
             return outValue.ValueUInt64;
         }
@@ -627,50 +941,34 @@ namespace MetricsDiscoveryInternal
         //     Reads single information.
         //
         // Input:
-        //     const uint8_t*    rawReport   - single raw report
-        //     IInformation_1_0* information - information to calculate
-        //     uint32_t          apiMask     - API mask (needed for choosing proper equation)
-        //     TTypedValue_1_0*  outValue    - (OUT) read information value
+        //     const uint8_t*                    rawReport   - single raw report
+        //     const TInformationReadDescriptor& information - information to calculate, with a read
+        //                                                     equation chosen by the API mask
+        //     TTypedValue_1_0*                  outValue    - (OUT) read information value
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline void ReadSingleInformation( const uint8_t* rawReport, IInformation_1_0* information, uint32_t apiMask, TTypedValue_1_0* outValue )
+        inline void ReadSingleInformation( const uint8_t* rawReport, const TInformationReadDescriptor& information, TTypedValue_1_0* outValue )
         {
-            if( !rawReport || !information || !outValue )
+            if( !rawReport || !outValue )
             {
                 const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
 
                 MD_ASSERT_A( adapterId, rawReport != nullptr );
-                MD_ASSERT_A( adapterId, information != nullptr );
                 MD_ASSERT_A( adapterId, outValue != nullptr );
                 MD_LOG_A( adapterId, LOG_ERROR, "error: nullptr params" );
                 return;
             }
 
-            constexpr uint32_t streamMask = API_TYPE_IOSTREAM;
-
-            auto& informationParams = *information->GetParams();
-            auto  equation          = ( apiMask & streamMask )
-                          ? informationParams.IoReadEquation
-                          : informationParams.QueryReadEquation;
-
-            if( equation != nullptr )
+            if( information.ReadEquation != nullptr )
             {
-                *outValue = CalculateReadEquation( static_cast<CEquation&>( *equation ), rawReport );
+                *outValue = CalculateReadEquation( *information.ReadEquation, rawReport );
             }
             else
             {
                 outValue->ValueUInt64 = 0ULL;
             }
 
-            if( informationParams.InfoType == INFORMATION_TYPE_FLAG )
-            {
-                outValue->ValueType = VALUE_TYPE_BOOL;
-                outValue->ValueBool = ( outValue->ValueUInt64 != 0ULL );
-            }
-            else
-            {
-                outValue->ValueType = VALUE_TYPE_UINT64;
-            }
+            ConvertToInformationType( *outValue, information );
         }
 
         //////////////////////////////////////////////////////////////////////////////
@@ -709,7 +1007,15 @@ namespace MetricsDiscoveryInternal
                 auto& measurementInfoParams = *measurementInfo->GetParams();
 
                 if( auto equation = measurementInfoParams.IoReadEquation;
-                    equation )
+                    equation && m_symbols.HasAggregatedSymbols() )
+                {
+                    // Not a part of the calculation plan, so bound once per read
+                    CEquation boundEquation( static_cast<CEquation&>( *equation ) );
+                    boundEquation.BindGlobalSymbols( m_symbols );
+
+                    outValues[i] = CalculateReadEquation( boundEquation, nullptr );
+                }
+                else if( equation )
                 {
                     outValues[i] = CalculateReadEquation( static_cast<CEquation&>( *equation ), nullptr );
                 }
@@ -756,20 +1062,321 @@ namespace MetricsDiscoveryInternal
                 return;
             }
 
-            const uint32_t metricsCount = metricSet.GetParams()->MetricsCount;
-            for( uint32_t i = 0; i < metricsCount; ++i )
-            {
-                auto metric = metricSet.GetMetricExplicit( i );
-                MD_CHECK_PTR_RET_A( adapterId, metric, MD_EMPTY );
+            auto plan = metricSet.GetCalculationPlan();
+            MD_CHECK_PTR_RET_A( adapterId, plan, MD_EMPTY );
 
-                auto& metricParams = *metric->GetParams();
+            CEquation** maxValueEquations = plan->MaxValueEquations.data();
 
-                outMaxValues[i] = metricParams.MaxValueEquation
-                    ? CalculateLocalNormalizationEquation( static_cast<CEquation&>( *( metricParams.MaxValueEquation ) ), deltaMetricValues, outMetricValues, i )
+            for( const uint32_t i : plan->CalculatedMetrics )
+            {
+                outMaxValues[i] = maxValueEquations[i]
+                    ? CalculateLocalNormalizationEquation( *maxValueEquations[i], deltaMetricValues, outMetricValues, i )
                     : outMetricValues[i];
             }
         }
 
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CalculateIoReports
+        //
+        // Description:
+        //     Calculates metrics, information and optionally max values for a batch of
+        //     consecutive IoStream report pairs. Every equation is calculated for all
+        //     the reports at once, so instructions are dispatched once per batch.
+        //     Results are the same as calculating the reports one by one, metric sets
+        //     with equations that can't be calculated in columns are calculated report
+        //     by report. The last calculated report is stored for reuse.
+        //
+        // Input:
+        //     const uint8_t* const* rawReportsLast - (IN) last (next) raw reports
+        //     const uint8_t* const* rawReportsPrev - (IN) previous raw reports
+        //     uint32_t              reportCount    - report pairs count, up to MD_CALCULATION_BATCH_SIZE
+        //     TTypedValue_1_0*      outValues      - (OUT) calculated reports, metrics and information for each report
+        //     TTypedValue_1_0*      outMaxValues   - (OUT) max values for each report, can be nullptr
+        //     CMetricSet&           metricSet      - MetricSet for calculations
+        //     int32_t               contextIdIdx   - index of contextId information to cache the value
+        //
+        // Output:
+        //     TCompletionCode - *CC_OK* means success
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline TCompletionCode CalculateIoReports(
+            const uint8_t* const* rawReportsLast,
+            const uint8_t* const* rawReportsPrev,
+            uint32_t              reportCount,
+            TTypedValue_1_0*      outValues,
+            TTypedValue_1_0*      outMaxValues,
+            CMetricSet&           metricSet,
+            int32_t               contextIdIdx )
+        {
+            const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+            MD_CHECK_PTR_RET_A( adapterId, rawReportsLast, CC_ERROR_INVALID_PARAMETER );
+            MD_CHECK_PTR_RET_A( adapterId, rawReportsPrev, CC_ERROR_INVALID_PARAMETER );
+            MD_CHECK_PTR_RET_A( adapterId, outValues, CC_ERROR_INVALID_PARAMETER );
+
+            if( reportCount == 0 || reportCount > MD_CALCULATION_BATCH_SIZE )
+            {
+                MD_LOG_A( adapterId, LOG_ERROR, "error: invalid report count: %u", reportCount );
+                return CC_ERROR_INVALID_PARAMETER;
+            }
+
+            auto plan = metricSet.GetCalculationPlan();
+            MD_CHECK_PTR_RET_A( adapterId, plan, CC_ERROR_GENERAL );
+
+            const uint32_t metricsCount     = plan->MetricsCount;
+            const uint32_t informationCount = plan->InformationCount;
+            const uint32_t reportSize       = metricsCount + informationCount;
+
+            m_batchDeltaValues.resize( static_cast<size_t>( ( std::max )( metricsCount, 1U ) ) * MD_CALCULATION_BATCH_SIZE );
+
+            if( !IsBatchCalculationSupported( *plan, contextIdIdx ) )
+            {
+                TTypedValue_1_0* deltaValues = m_batchDeltaValues.data();
+
+                for( uint32_t j = 0; j < reportCount; ++j )
+                {
+                    TTypedValue_1_0* out = outValues + j * reportSize;
+
+                    ReadMetricsFromIoReport( rawReportsLast[j], rawReportsPrev[j], deltaValues, metricSet );
+                    NormalizeMetrics( deltaValues, out, metricSet );
+                    ReadInformation( rawReportsLast[j], out + metricsCount, metricSet, contextIdIdx );
+
+                    if( outMaxValues )
+                    {
+                        CalculateMaxValues( deltaValues, out, outMaxValues + j * metricsCount, metricSet );
+                    }
+
+                    SaveCalculatedReport( out );
+                }
+
+                return CC_OK;
+            }
+
+            const int32_t                     gpuCoreClocksIndex = plan->GpuCoreClocksIndex;
+            CEquation**                       readEquations      = plan->IoReadEquations.data();
+            CEquation**                       normEquations      = plan->NormEquations.data();
+            CEquation**                       maxValueEquations  = plan->MaxValueEquations.data();
+            const TDeltaFunction_1_0*         deltaFunctions     = plan->DeltaFunctions.data();
+            const TNormalizationKind*         normalizationKinds = plan->NormalizationKinds.data();
+            const TMetricResultType*          resultTypes        = plan->ResultTypes.data();
+            const TInformationReadDescriptor* informations       = plan->Informations.data();
+            TTypedValue_1_0*                  deltaValues        = m_batchDeltaValues.data();
+            const TTypedValue_1_0*            prevValues         = m_prevValues;
+            const uint64_t                    contextIdPrev      = m_contextIdPrev;
+
+            const TMetricKernel* readKernels = plan->HasKernels ? plan->ReadKernels.data() : nullptr;
+            const TMetricKernel* normKernels = plan->HasKernels ? plan->NormKernels.data() : nullptr;
+
+            m_batchGpuCoreClocks.fill( 0 );
+            InvalidateBatchColumns( plan->ReportLayout );
+
+            // Previous calculated report of the first report is the one saved after the previous batch
+            auto getPrevMetric = [&]( const TEquationInstruction& instruction, uint32_t j )
+            {
+                TTypedValue_1_0 typedValue = {};
+                typedValue.ValueUInt64     = 0;
+                typedValue.ValueType       = VALUE_TYPE_UINT64;
+
+                if( instruction.MetricIndex < 0 )
+                {
+                    return typedValue;
+                }
+
+                if( j > 0 )
+                {
+                    return outValues[( j - 1 ) * reportSize + instruction.MetricIndex];
+                }
+
+                return prevValues
+                    ? prevValues[instruction.MetricIndex]
+                    : typedValue;
+            };
+
+            // Normalization and max value equations operand
+            auto getNormalizationOperand = [&]( const TEquationInstruction& instruction, uint32_t j, uint32_t metricIndex )
+            {
+                if( instruction.Code == EQUATION_INSTR_PREV_METRIC )
+                {
+                    return getPrevMetric( instruction, j );
+                }
+
+                m_gpuCoreClocks = m_batchGpuCoreClocks[j];
+                return GetNormalizationEquationOperand( instruction, deltaValues + j * metricsCount, outValues + j * reportSize, metricIndex );
+            };
+
+            // Information read equation operand
+            auto getInformationOperand = [&]( const TEquationInstruction& instruction, uint32_t j )
+            {
+                if( instruction.Code == EQUATION_INSTR_PREVIOUS_CONTEXT_ID )
+                {
+                    m_contextIdPrev = ( j > 0 && contextIdIdx != -1 )
+                        ? outValues[( j - 1 ) * reportSize + metricsCount + contextIdIdx].ValueUInt64
+                        : contextIdPrev;
+                }
+
+                m_gpuCoreClocks = m_batchGpuCoreClocks[j];
+                return GetReadEquationOperand( instruction, rawReportsLast[j] );
+            };
+
+            // Information are read in columns
+            auto readInformation = [&]( uint32_t i )
+            {
+                TTypedValue_1_0* out = outValues + metricsCount + i;
+
+                if( informations[i].ReadEquation != nullptr )
+                {
+                    CalculateProgramBatch( *informations[i].ReadEquation, reportCount, out, reportSize, getInformationOperand );
+                }
+                else
+                {
+                    for( uint32_t j = 0; j < reportCount; ++j )
+                    {
+                        out[j * reportSize].ValueUInt64 = 0ULL;
+                    }
+                }
+
+                for( uint32_t j = 0; j < reportCount; ++j )
+                {
+                    ConvertToInformationType( out[j * reportSize], informations[i] );
+                }
+            };
+
+            // METRICS
+            for( const uint32_t i : plan->CalculatedMetrics )
+            {
+                if( readKernels && readKernels[i].Type == METRIC_KERNEL_TYPE_COLUMN_DELTA )
+                {
+                    const uint64_t* columnDeltas = GetBatchColumnDeltas( readKernels[i].Column, readKernels[i].BitsCount, plan->ReportLayout, rawReportsLast, rawReportsPrev, reportCount );
+
+                    for( uint32_t j = 0; j < reportCount; ++j )
+                    {
+                        deltaValues[j * metricsCount + i]             = {};
+                        deltaValues[j * metricsCount + i].ValueType   = VALUE_TYPE_UINT64;
+                        deltaValues[j * metricsCount + i].ValueUInt64 = columnDeltas[j];
+                    }
+                }
+                else if( readEquations[i] )
+                {
+                    const TDeltaFunction_1_0 readDeltaFunction = GetReadDeltaFunction( deltaFunctions[i] );
+
+                    auto getReadOperand = [&]( const TEquationInstruction& instruction, uint32_t j )
+                    {
+                        if( READ_INSTRUCTIONS & ( 1U << instruction.Code ) )
+                        {
+                            TTypedValue_1_0 columnDelta = {};
+
+                            if( GetBatchColumnDelta( instruction, readDeltaFunction, plan->ReportLayout, rawReportsLast, rawReportsPrev, reportCount, j, columnDelta ) )
+                            {
+                                return columnDelta;
+                            }
+
+                            const TTypedValue_1_0 typedValuePrev = ReadInstructionValue( instruction, rawReportsPrev[j] );
+                            const TTypedValue_1_0 typedValueLast = ReadInstructionValue( instruction, rawReportsLast[j] );
+
+                            return CalculateDeltaFunction( readDeltaFunction, typedValueLast, typedValuePrev );
+                        }
+
+                        m_gpuCoreClocks = m_batchGpuCoreClocks[j];
+                        return GetReadEquationOperand( instruction, nullptr );
+                    };
+
+                    CalculateProgramBatch( *readEquations[i], reportCount, deltaValues + i, metricsCount, getReadOperand );
+                }
+                else
+                {
+                    for( uint32_t j = 0; j < reportCount; ++j )
+                    {
+                        deltaValues[j * metricsCount + i].ValueType   = VALUE_TYPE_UINT64;
+                        deltaValues[j * metricsCount + i].ValueUInt64 = 0ULL;
+                    }
+                }
+
+                if( static_cast<int32_t>( i ) == gpuCoreClocksIndex )
+                {
+                    for( uint32_t j = 0; j < reportCount; ++j )
+                    {
+                        m_batchGpuCoreClocks[j] = deltaValues[j * metricsCount + i].ValueUInt64;
+                    }
+                }
+            }
+
+            // NORMALIZATION
+            for( const uint32_t i : plan->CalculatedMetrics )
+            {
+                if( normKernels && normKernels[i].Type != METRIC_KERNEL_TYPE_NONE )
+                {
+                    CalculateNormalizationKernelBatch( normKernels[i], i, reportCount, deltaValues, metricsCount, outValues, reportSize );
+                }
+                else if( normalizationKinds[i] == NORMALIZATION_KIND_EQUATION )
+                {
+                    CalculateProgramBatch( *normEquations[i], reportCount, outValues + i, reportSize, [&]( const TEquationInstruction& instruction, uint32_t j )
+                        { return getNormalizationOperand( instruction, j, i ); } );
+                }
+                else
+                {
+                    for( uint32_t j = 0; j < reportCount; ++j )
+                    {
+                        outValues[j * reportSize + i] = deltaValues[j * metricsCount + i];
+                    }
+                }
+
+                for( uint32_t j = 0; j < reportCount; ++j )
+                {
+                    ConvertToResultType( outValues[j * reportSize + i], resultTypes[i] );
+                }
+            }
+
+            // INFORMATION
+            // ContextId is read first, because it's previous context id of the next reports
+            if( contextIdIdx != -1 )
+            {
+                readInformation( static_cast<uint32_t>( contextIdIdx ) );
+            }
+
+            for( uint32_t i = 0; i < informationCount; ++i )
+            {
+                if( static_cast<int32_t>( i ) != contextIdIdx )
+                {
+                    readInformation( i );
+                }
+            }
+
+            // MAX VALUES
+            if( outMaxValues )
+            {
+                for( const uint32_t i : plan->CalculatedMetrics )
+                {
+                    if( maxValueEquations[i] )
+                    {
+                        CalculateProgramBatch( *maxValueEquations[i], reportCount, outMaxValues + i, metricsCount, [&]( const TEquationInstruction& instruction, uint32_t j )
+                            { return getNormalizationOperand( instruction, j, i ); } );
+                    }
+                    else
+                    {
+                        for( uint32_t j = 0; j < reportCount; ++j )
+                        {
+                            outMaxValues[j * metricsCount + i] = outValues[j * reportSize + i];
+                        }
+                    }
+                }
+            }
+
+            // State left by the last report of the batch
+            TTypedValue_1_0* lastOut = outValues + ( reportCount - 1 ) * reportSize;
+
+            m_gpuCoreClocks = m_batchGpuCoreClocks[reportCount - 1];
+            m_contextIdPrev = ( contextIdIdx != -1 )
+                ? lastOut[metricsCount + contextIdIdx].ValueUInt64
+                : contextIdPrev;
+
+            return SaveCalculatedReport( lastOut );
+        }
+
         //////////////////////////////////////////////////////////////////////////////
         //
         // Class:
@@ -840,18 +1447,32 @@ namespace MetricsDiscoveryInternal
         //    CMetricsCalculator
         //
         // Method:
-        //     SavedReportPresent
+        //     GetCalculatedValues
         //
         // Description:
-        //     Check if Calculator has saved report.
+        //     Returns buffer for calculated reports. If metrics are projected or written
+        //     to columns, reports with all the metrics are calculated into an internal
+        //     buffer, because equations refer to metrics by their indices in the metric
+        //     set. Then they are written to the output by WriteCalculatedReports.
+        //
+        // Input:
+        //     const TCalculationPlan&          plan        - calculation plan
+        //     const TCommonCalculationContext& context     - calculation context with the output
+        //     uint32_t                         reportCount - count of reports to calculate
         //
         // Output:
-        //     bool - true if report saved
+        //     TTypedValue_1_0* - buffer for calculated reports
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline bool SavedReportPresent()
+        inline TTypedValue_1_0* GetCalculatedValues( const TCalculationPlan& plan, const TCommonCalculationContext& context, uint32_t reportCount )
         {
-            return m_savedReportPresent;
+            if( !plan.IsProjected && context.OutDescriptor == nullptr )
+            {
+                return context.Out;
+            }
+
+            m_calculatedValues.resize( static_cast<size_t>( plan.MetricsCount + plan.InformationCount ) * reportCount );
+            return m_calculatedValues.data();
         }
 
         //////////////////////////////////////////////////////////////////////////////
@@ -860,18 +1481,37 @@ namespace MetricsDiscoveryInternal
         //    CMetricsCalculator
         //
         // Method:
-        //     GetSavedReport
+        //     GetCalculatedMaxValues
         //
         // Description:
-        //     Getter for saved report pointer.
+        //     Returns buffer for calculated max values, see GetCalculatedValues.
+        //
+        // Input:
+        //     const TCalculationPlan&          plan        - calculation plan
+        //     const TCommonCalculationContext& context     - calculation context with the output
+        //     uint32_t                         reportCount - count of reports to calculate
         //
         // Output:
-        //     uint8_t* - saved report
+        //     TTypedValue_1_0* - buffer for calculated max values, nullptr if max values
+        //                        aren't calculated
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline uint8_t* GetSavedReport()
+        inline TTypedValue_1_0* GetCalculatedMaxValues( const TCalculationPlan& plan, const TCommonCalculationContext& context, uint32_t reportCount )
         {
-            return m_savedReport;
+            const bool isColumnar = context.OutDescriptor != nullptr;
+
+            if( isColumnar ? context.OutDescriptor->MaxValueColumns == nullptr : context.OutMaxValues == nullptr )
+            {
+                return nullptr;
+            }
+
+            if( !plan.IsProjected && !isColumnar )
+            {
+                return context.OutMaxValues;
+            }
+
+            m_calculatedMaxValues.resize( static_cast<size_t>( plan.MetricsCount ) * reportCount );
+            return m_calculatedMaxValues.data();
         }
 
         //////////////////////////////////////////////////////////////////////////////
@@ -880,380 +1520,2878 @@ namespace MetricsDiscoveryInternal
         //    CMetricsCalculator
         //
         // Method:
-        //     DiscardSavedReport
+        //     WriteCalculatedReports
         //
         // Description:
-        //     Sets to false flag indicating report save.
+        //     Writes reports calculated into buffers returned by GetCalculatedValues and
+        //     GetCalculatedMaxValues to the output of the calculation context and moves
+        //     the output pointers past them. Reports are written to columns starting
+        //     at the context's out report offset plus out report count, so the count
+        //     has to be updated afterwards.
+        //
+        // Input:
+        //     const TCalculationPlan&    plan        - calculation plan
+        //     TCommonCalculationContext& context     - (IN/OUT) calculation context with the output
+        //     uint32_t                   reportCount - count of calculated reports
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline void DiscardSavedReport()
+        inline void WriteCalculatedReports( const TCalculationPlan& plan, TCommonCalculationContext& context, uint32_t reportCount )
         {
-            m_savedReportPresent = false;
+            if( context.OutDescriptor != nullptr )
+            {
+                WriteReportColumns( plan, *context.OutDescriptor, context.OutReportOffset + context.OutReportCount, reportCount );
+                return;
+            }
+
+            const uint32_t outMetricsCount = static_cast<uint32_t>( plan.OutMetrics.size() );
+
+            if( plan.IsProjected )
+            {
+                ProjectReports( plan, reportCount, context.Out, context.OutMaxValues );
+            }
+
+            context.Out += reportCount * ( outMetricsCount + plan.InformationCount );
+
+            if( context.OutMaxValues )
+            {
+                context.OutMaxValues += reportCount * outMetricsCount;
+            }
         }
 
         //////////////////////////////////////////////////////////////////////////////
         //
         // Class:
-        //     CMetricsCalculator
+        //    CMetricsCalculator
         //
         // Method:
-        //     CastToUInt32
+        //     SavedReportPresent
         //
         // Description:
-        //     Returns typed value casted to uint32.
-        //
-        // Input:
-        //     const TTypedValue_1_0& value - typed value to be casted
+        //     Check if Calculator has saved report.
         //
         // Output:
-        //     uint32_t                     - casted typed value to uint32
+        //     bool - true if report saved
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline uint32_t CastToUInt32( const TTypedValue_1_0& value )
+        inline bool SavedReportPresent()
         {
-            switch( value.ValueType )
-            {
-                case VALUE_TYPE_BOOL:
-                    return ( value.ValueBool ) ? 1U : 0U;
-
-                case VALUE_TYPE_UINT32:
-                    return value.ValueUInt32;
-
-                case VALUE_TYPE_UINT64:
-                    return static_cast<uint32_t>( value.ValueUInt64 );
-
-                case VALUE_TYPE_FLOAT:
-                    return static_cast<uint32_t>( value.ValueFloat );
-
-                default:
-                    return 0U;
-            }
+            return m_savedReportPresent;
         }
 
         //////////////////////////////////////////////////////////////////////////////
         //
         // Class:
-        //     CMetricsCalculator
+        //    CMetricsCalculator
         //
         // Method:
-        //     CastToUInt64
+        //     GetSavedReport
         //
         // Description:
-        //     Returns typed value casted to uint64.
-        //
-        // Input:
-        //     const TTypedValue_1_0& value - typed value to be casted
+        //     Getter for saved report pointer.
         //
         // Output:
-        //     uint64_t                     - casted typed value to uint64
+        //     uint8_t* - saved report
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline uint64_t CastToUInt64( const TTypedValue_1_0& value )
+        inline uint8_t* GetSavedReport()
         {
-            switch( value.ValueType )
-            {
-                case VALUE_TYPE_BOOL:
-                    return ( value.ValueBool ) ? 1ULL : 0ULL;
-
-                case VALUE_TYPE_UINT32:
-                    return static_cast<uint64_t>( value.ValueUInt32 );
-
-                case VALUE_TYPE_UINT64:
-                    return value.ValueUInt64;
-
-                case VALUE_TYPE_FLOAT:
-                    return static_cast<uint64_t>( value.ValueFloat );
+            return m_savedReport;
+        }
 
-                default:
-                    return 0ULL;
-            }
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //    CMetricsCalculator
+        //
+        // Method:
+        //     DiscardSavedReport
+        //
+        // Description:
+        //     Sets to false flag indicating report save.
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline void DiscardSavedReport()
+        {
+            m_savedReportPresent = false;
         }
 
         //////////////////////////////////////////////////////////////////////////////
         //
         // Class:
-        //     CMetricsCalculator
+        //    CMetricsCalculator
         //
         // Method:
-        //     CastToFloat
+        //     GetDeltaValues
         //
         // Description:
-        //     Returns typed value casted to float.
+        //     Returns buffer for delta values of a single report, used by calculations
+        //     report by report. The buffer is reused, it grows only with metrics count.
         //
         // Input:
-        //     const TTypedValue_1_0& value - typed value to be casted
+        //     uint32_t metricsCount - metrics count of the metric set
         //
         // Output:
-        //     float                        - casted typed value to float
+        //     TTypedValue_1_0* - buffer for delta values
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline float CastToFloat( const TTypedValue_1_0& value )
+        inline TTypedValue_1_0* GetDeltaValues( uint32_t metricsCount )
         {
-            switch( value.ValueType )
+            if( m_deltaValues.size() < metricsCount )
             {
-                case VALUE_TYPE_BOOL:
-                    return ( value.ValueBool ) ? 1.0f : 0.0f;
-
-                case VALUE_TYPE_UINT32:
-                    return static_cast<float>( value.ValueUInt32 );
-
-                case VALUE_TYPE_UINT64:
-                    return static_cast<float>( value.ValueUInt64 );
-
-                case VALUE_TYPE_FLOAT:
-                    return value.ValueFloat;
-
-                default:
-                    return 0.0f;
+                m_deltaValues.resize( metricsCount );
             }
+
+            return m_deltaValues.data();
         }
 
         //////////////////////////////////////////////////////////////////////////////
         //
         // Class:
-        //     CMetricsCalculator
+        //    CMetricsCalculator
         //
         // Method:
-        //     CastToBoolean
+        //     GetPreviousContextId
         //
         // Description:
-        //     Returns typed value casted to boolean.
-        //
-        // Input:
-        //     const TTypedValue_1_0& value - typed value to be casted
+        //     Returns context id of the last calculated report, used as PreviousContextId
+        //     information of the next one.
         //
         // Output:
-        //     bool                         - casted typed value to boolean
+        //     uint64_t - previous context id
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline bool CastToBoolean( const TTypedValue_1_0& value )
+        inline uint64_t GetPreviousContextId() const
         {
-            switch( value.ValueType )
-            {
-                case VALUE_TYPE_BOOL:
-                    return value.ValueBool;
-
-                case VALUE_TYPE_UINT32:
-                    return value.ValueUInt32 != 0U;
-
-                case VALUE_TYPE_UINT64:
-                    return value.ValueUInt64 != 0ULL;
-
-                case VALUE_TYPE_FLOAT:
-                    return value.ValueFloat != 0.0f;
-
-                default:
-                    return false;
-            }
+            return m_contextIdPrev;
         }
 
         //////////////////////////////////////////////////////////////////////////////
         //
         // Class:
-        //     CMetricsCalculator
+        //    CMetricsCalculator
         //
         // Method:
-        //     ReadBitfield
+        //     SetPreviousContextId
         //
         // Description:
-        //     Returns bitfield from the report.
+        //     Sets context id used as PreviousContextId information of the next calculated
+        //     report, e.g. when calculation starts in the middle of the raw data.
         //
         // Input:
-        //     const uint8_t* rawReport - raw report
-        //     uint32_t       bitOffset - bit offset
-        //     uint32_t       bitCount  - bit count
+        //     uint64_t contextId - previous context id
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline void SetPreviousContextId( uint64_t contextId )
+        {
+            m_contextIdPrev = contextId;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //    CMetricsCalculator
+        //
+        // Method:
+        //     GetFilteredContextId
+        //
+        // Description:
+        //     Returns context id of reports calculated with context filtering. It's the
+        //     context of the first report of the stream, so it's kept with the saved report.
         //
         // Output:
-        //     uint64_t                 - bitfield from the report
+        //     uint64_t - filtered context id
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline uint64_t ReadBitfield(
-            const uint8_t* rawReport,
-            uint32_t       bitOffset,
-            uint32_t       bitCount )
+        inline uint64_t GetFilteredContextId() const
         {
-            if( !rawReport || ( bitCount > 32 ) || ( bitCount == 0 ) || ( bitCount + bitOffset > 32 ) )
-            {
-                const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
-
-                MD_ASSERT_A( adapterId, false );
-                MD_LOG_A( adapterId, LOG_ERROR, "error: invalid params" );
-                return 0;
-            }
-
-            // Build mask
-            const uint32_t mask = MD_BITMASK_RANGE( bitOffset, bitOffset + bitCount - 1 );
-
-            // Get integer in the way in is alignment safe
-            const uint32_t data = *reinterpret_cast<const uint32_t*>( rawReport );
-
-            return static_cast<uint64_t>( ( data & mask ) >> bitOffset );
+            return m_filteredContextId;
         }
 
         //////////////////////////////////////////////////////////////////////////////
         //
         // Class:
-        //     CMetricsCalculator
+        //    CMetricsCalculator
         //
         // Method:
-        //     GetMetricsDevice
+        //     SetFilteredContextId
         //
         // Description:
-        //     Returns metrics device
+        //     Sets context id of reports calculated with context filtering, when a new
+        //     stream starts.
         //
-        // Output:
-        //     CMetricsDevice& - metrics device
+        // Input:
+        //     uint64_t contextId - filtered context id
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline CMetricsDevice& GetMetricsDevice()
+        inline void SetFilteredContextId( uint64_t contextId )
         {
-            return m_device;
+            m_filteredContextId = contextId;
         }
 
-    private:
         //////////////////////////////////////////////////////////////////////////////
         //
         // Class:
-        //     CMetricsCalculator
+        //    CMetricsCalculator
         //
         // Method:
-        //     CalculateDeltaFunction
+        //     SelectContextReports
         //
         // Description:
-        //     Calculates the given delta function.
+        //     Scans ContextId information of all the given raw reports and returns
+        //     a selection, 1 for reports of the given context, 0 for other ones.
+        //     If ContextId is read directly from a report field, optionally masked,
+        //     fields are compared with SIMD kernels, otherwise the information is
+        //     calculated report by report. The selection is valid until the next scan.
         //
         // Input:
-        //     TDeltaFunction_1_0     deltaFunction  - delta function to be calculated
-        //     const TTypedValue_1_0& lastValue     - (IN) last (next) value
-        //     const TTypedValue_1_0& previousValue - (IN) previous value
+        //     const uint8_t* rawData        - (IN) raw reports
+        //     uint32_t       rawReportCount - raw report count
+        //     uint32_t       rawReportSize  - single raw report size in bytes
+        //     CMetricSet&    metricSet      - MetricSet for calculations
+        //     int32_t        contextIdIdx   - index of contextId information
+        //     uint64_t       contextId      - context id of selected reports
         //
         // Output:
-        //     TTypedValue_1_0 - output calculated delta value
+        //     const uint8_t* - selection, raw report count values
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline TTypedValue_1_0 CalculateDeltaFunction(
-            TDeltaFunction_1_0     deltaFunction,
-            const TTypedValue_1_0& lastValue,
-            const TTypedValue_1_0& previousValue )
+        inline const uint8_t* SelectContextReports( const uint8_t* rawData, uint32_t rawReportCount, uint32_t rawReportSize, CMetricSet& metricSet, int32_t contextIdIdx, uint64_t contextId )
         {
-            TTypedValue_1_0 typedValue = {};
+            const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
 
-            switch( deltaFunction.FunctionType )
+            if( m_contextSelection.size() < rawReportCount )
             {
-                case DELTA_BOOL_OR:
-                    typedValue.ValueUInt64 = ( ( lastValue.ValueUInt64 | previousValue.ValueUInt64 ) != 0 ) ? 1ULL : 0ULL;
-                    typedValue.ValueType   = VALUE_TYPE_UINT64;
-                    return typedValue;
-
-                case DELTA_BOOL_XOR:
-                    typedValue.ValueUInt64 = ( ( lastValue.ValueUInt64 ^ previousValue.ValueUInt64 ) != 0 ) ? 1ULL : 0ULL;
-                    typedValue.ValueType   = VALUE_TYPE_UINT64;
-                    return typedValue;
-
-                case DELTA_GET_LAST:
-                    return lastValue;
-
-                case DELTA_GET_PREVIOUS:
-                    return previousValue;
+                m_contextSelection.resize( rawReportCount );
+            }
 
-                case DELTA_NS_TIME:
-                    // No 'break' intentional - NS_TIME should be used only for overflow functions, here use as DELTA 32 or DELTA 56
-                    switch( m_device.GetPlatformIndex() )
-                    {
-                        case GENERATION_BMG:
-                        case GENERATION_LNL:
-                        case GENERATION_PTL:
-                        case GENERATION_NVL:
-                        case GENERATION_NVLP:
-                        case GENERATION_CRI:
-                            deltaFunction.BitsCount = 56;
-                            break;
-                        default:
-                            deltaFunction.BitsCount = 32;
-                            break;
-                    }
-                    [[fallthrough]];
+            uint8_t* selection = m_contextSelection.data();
+            auto     plan      = metricSet.GetCalculationPlan();
 
-                case DELTA_N_BITS:
-                    if( deltaFunction.BitsCount <= 64 )
-                    {
-                        if( previousValue.ValueUInt64 > lastValue.ValueUInt64 )
-                        {
-                            if( deltaFunction.BitsCount < 64 )
-                            {
-                                const uint64_t value   = lastValue.ValueUInt64 | ( 1ULL << deltaFunction.BitsCount );
-                                typedValue.ValueUInt64 = value - previousValue.ValueUInt64;
-                            }
-                            else
-                            {
-                                typedValue.ValueUInt64 = ( std::numeric_limits<uint64_t>::max )() - previousValue.ValueUInt64 + lastValue.ValueUInt64;
-                            }
+            MD_ASSERT_A( adapterId, plan != nullptr && contextIdIdx >= 0 && static_cast<uint32_t>( contextIdIdx ) < plan->InformationCount );
 
-                            typedValue.ValueType = VALUE_TYPE_UINT64;
-                            return typedValue;
-                        }
-                        else
-                        {
-                            typedValue.ValueUInt64 = lastValue.ValueUInt64 - previousValue.ValueUInt64;
-                            typedValue.ValueType   = VALUE_TYPE_UINT64;
-                            return typedValue;
-                        }
-                    }
-                    break;
+            const TInformationReadDescriptor& information = plan->Informations[contextIdIdx];
 
-                case DELTA_FUNCTION_NULL:
-                    typedValue.ValueUInt64 = 0;
-                    typedValue.ValueType   = VALUE_TYPE_UINT64;
-                    return typedValue;
+            uint32_t fieldOffset = 0;
+            uint32_t fieldSize   = 0;
+            uint32_t fieldShift  = 0;
+            uint64_t fieldMask   = 0;
 
-                default:
-                    MD_ASSERT_A( m_device.GetAdapter().GetAdapterId(), false );
-                    break;
+            if( !information.IsFlag && information.ReadEquation != nullptr &&
+                MatchInformationField( *information.ReadEquation, rawReportSize, fieldOffset, fieldSize, fieldShift, fieldMask ) &&
+                fieldShift == 0 )
+            {
+                CReportKernels::SelectReports( rawData, rawReportCount, rawReportSize, fieldOffset, fieldSize, fieldMask, contextId, selection );
+                return selection;
             }
 
-            typedValue.ValueUInt64 = 0;
-            typedValue.ValueType   = VALUE_TYPE_UINT64;
+            for( uint32_t j = 0; j < rawReportCount; ++j )
+            {
+                selection[j] = ( ReadInformationByIndex( rawData + static_cast<size_t>( j ) * rawReportSize, metricSet, contextIdIdx ) == contextId ) ? 1 : 0;
+            }
 
-            return typedValue;
+            return selection;
         }
 
         //////////////////////////////////////////////////////////////////////////////
         //
         // Class:
-        //     CMetricsCalculator
+        //    CMetricsCalculator
         //
         // Method:
-        //     GetGlobalSymbolValue
+        //     GetInformationField
         //
         // Description:
-        //     Returns global symbol of a given name. Uses MetricsDevice.
+        //     Checks if an information is read directly from a report field, optionally
+        //     shifted and masked. The field may be then extracted with CReportKernels
+        //     without the calculator, e.g. on other threads.
         //
         // Input:
-        //     const char* symbolName - global symbol name
+        //     CMetricSet&   metricSet      - MetricSet for calculations
+        //     int32_t       informationIdx - index of information
+        //     uint32_t      rawReportSize  - single raw report size in bytes
+        //     TReportField& outField       - (OUT) report field of the information
         //
         // Output:
-        //     TTypedValue_1_0* - global symbol typed value, null if error
+        //     bool - true if the information is a report field
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline TTypedValue_1_0* GetGlobalSymbolValue( const char* symbolName )
+        inline bool GetInformationField( CMetricSet& metricSet, int32_t informationIdx, uint32_t rawReportSize, TReportField& outField )
         {
-            const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
-            MD_CHECK_PTR_RET_A( adapterId, symbolName, nullptr );
+            auto plan = metricSet.GetCalculationPlan();
+
+            if( informationIdx < 0 || plan == nullptr || static_cast<uint32_t>( informationIdx ) >= plan->InformationCount )
+            {
+                return false;
+            }
+
+            const TInformationReadDescriptor& information = plan->Informations[informationIdx];
+
+            return !information.IsFlag && information.ReadEquation != nullptr &&
+                MatchInformationField( *information.ReadEquation, rawReportSize, outField.Offset, outField.Size, outField.Shift, outField.Mask );
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //    CMetricsCalculator
+        //
+        // Method:
+        //     ReadInformationValues
+        //
+        // Description:
+        //     Reads a single information of all the given raw reports at once, e.g. report
+        //     reason before async calculation or aggregation. If the information is read
+        //     directly from a report field, optionally shifted and masked, fields are
+        //     extracted with SIMD kernels, otherwise the information is calculated report
+        //     by report. Values are the same as returned by ReadInformationByIndex.
+        //
+        // Input:
+        //     const uint8_t* rawData        - (IN) raw reports
+        //     uint32_t       rawReportCount - raw report count
+        //     uint32_t       rawReportSize  - single raw report size in bytes
+        //     CMetricSet&    metricSet      - MetricSet for calculations
+        //     int32_t        informationIdx - index of information, -1 reads zeros
+        //     uint64_t*      outValues      - (OUT) values, raw report count values
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline void ReadInformationValues( const uint8_t* rawData, uint32_t rawReportCount, uint32_t rawReportSize, CMetricSet& metricSet, int32_t informationIdx, uint64_t* outValues )
+        {
+            TReportField field = {};
+
+            if( GetInformationField( metricSet, informationIdx, rawReportSize, field ) )
+            {
+                CReportKernels::ExtractFields( rawData, rawReportCount, rawReportSize, field.Offset, field.Size, field.Shift, field.Mask, outValues );
+                return;
+            }
+
+            for( uint32_t j = 0; j < rawReportCount; ++j )
+            {
+                outValues[j] = ReadInformationByIndex( rawData + static_cast<size_t>( j ) * rawReportSize, metricSet, informationIdx );
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //    CMetricsCalculator
+        //
+        // Method:
+        //     ReadTimestamps
+        //
+        // Description:
+        //     Reads timestamps of all the given raw reports at once with SIMD kernels.
+        //
+        // Input:
+        //     const uint8_t* rawData        - (IN) raw reports
+        //     uint32_t       rawReportCount - raw report count
+        //     uint32_t       rawReportSize  - single raw report size in bytes
+        //     uint64_t*      outTimestamps  - (OUT) timestamps, raw report count values
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        static inline void ReadTimestamps( const uint8_t* rawData, uint32_t rawReportCount, uint32_t rawReportSize, uint64_t* outTimestamps )
+        {
+            CReportKernels::ExtractFields( rawData, rawReportCount, rawReportSize, MD_REPORT_TIMESTAMP_OFFSET, sizeof( uint64_t ), 0, ~0ULL, outTimestamps );
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //    CMetricsCalculator
+        //
+        // Method:
+        //     ReadReportReasons
+        //
+        // Description:
+        //     Reads report reasons of all the given raw reports once, so async calculation
+        //     doesn't calculate the information report by report. The values are valid
+        //     until the next read.
+        //
+        // Input:
+        //     const uint8_t* rawData         - (IN) raw reports
+        //     uint32_t       rawReportCount  - raw report count
+        //     uint32_t       rawReportSize   - single raw report size in bytes
+        //     CMetricSet&    metricSet       - MetricSet for calculations
+        //     int32_t        reportReasonIdx - index of ReportReason information
+        //
+        // Output:
+        //     const uint64_t* - report reasons, raw report count values
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline const uint64_t* ReadReportReasons( const uint8_t* rawData, uint32_t rawReportCount, uint32_t rawReportSize, CMetricSet& metricSet, int32_t reportReasonIdx )
+        {
+            if( m_reportReasons.size() < rawReportCount )
+            {
+                m_reportReasons.resize( rawReportCount );
+            }
+
+            ReadInformationValues( rawData, rawReportCount, rawReportSize, metricSet, reportReasonIdx, m_reportReasons.data() );
+
+            return m_reportReasons.data();
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //    CMetricsCalculator
+        //
+        // Method:
+        //     GetSymbols
+        //
+        // Description:
+        //     Returns global symbols of the calculator, so other calculators of the same
+        //     metric set can be created.
+        //
+        // Output:
+        //     CCalculatorSymbols& - global symbols
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline CCalculatorSymbols& GetSymbols()
+        {
+            return m_symbols;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CastToUInt32
+        //
+        // Description:
+        //     Returns typed value casted to uint32.
+        //
+        // Input:
+        //     const TTypedValue_1_0& value - typed value to be casted
+        //
+        // Output:
+        //     uint32_t                     - casted typed value to uint32
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline uint32_t CastToUInt32( const TTypedValue_1_0& value )
+        {
+            switch( value.ValueType )
+            {
+                case VALUE_TYPE_BOOL:
+                    return ( value.ValueBool ) ? 1U : 0U;
+
+                case VALUE_TYPE_UINT32:
+                    return value.ValueUInt32;
+
+                case VALUE_TYPE_UINT64:
+                    return static_cast<uint32_t>( value.ValueUInt64 );
+
+                case VALUE_TYPE_FLOAT:
+                    return static_cast<uint32_t>( value.ValueFloat );
+
+                default:
+                    return 0U;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CastToUInt64
+        //
+        // Description:
+        //     Returns typed value casted to uint64.
+        //
+        // Input:
+        //     const TTypedValue_1_0& value - typed value to be casted
+        //
+        // Output:
+        //     uint64_t                     - casted typed value to uint64
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        static inline uint64_t CastToUInt64( const TTypedValue_1_0& value )
+        {
+            switch( value.ValueType )
+            {
+                case VALUE_TYPE_BOOL:
+                    return ( value.ValueBool ) ? 1ULL : 0ULL;
+
+                case VALUE_TYPE_UINT32:
+                    return static_cast<uint64_t>( value.ValueUInt32 );
+
+                case VALUE_TYPE_UINT64:
+                    return value.ValueUInt64;
+
+                case VALUE_TYPE_FLOAT:
+                    return static_cast<uint64_t>( value.ValueFloat );
+
+                default:
+                    return 0ULL;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CastToFloat
+        //
+        // Description:
+        //     Returns typed value casted to float.
+        //
+        // Input:
+        //     const TTypedValue_1_0& value - typed value to be casted
+        //
+        // Output:
+        //     float                        - casted typed value to float
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        static inline float CastToFloat( const TTypedValue_1_0& value )
+        {
+            switch( value.ValueType )
+            {
+                case VALUE_TYPE_BOOL:
+                    return ( value.ValueBool ) ? 1.0f : 0.0f;
+
+                case VALUE_TYPE_UINT32:
+                    return static_cast<float>( value.ValueUInt32 );
+
+                case VALUE_TYPE_UINT64:
+                    return static_cast<float>( value.ValueUInt64 );
+
+                case VALUE_TYPE_FLOAT:
+                    return value.ValueFloat;
+
+                default:
+                    return 0.0f;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CalculateEquationElemOperation
+        //
+        // Description:
+        //     Calculates the given equation operation.
+        //
+        // Input:
+        //     TEquationOperation     operation - operation to be calculated
+        //     const TTypedValue_1_0& valuePrev - (IN) previous value
+        //     const TTypedValue_1_0& valueLast - (IN) last (next) value
+        //
+        // Output:
+        //     TTypedValue_1_0 - output calculated value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        static inline TTypedValue_1_0 CalculateEquationElemOperation(
+            TEquationOperation     operation,
+            const TTypedValue_1_0& valuePrev,
+            const TTypedValue_1_0& valueLast )
+        {
+            TTypedValue_1_0 value = {};
+            value.ValueType       = VALUE_TYPE_UINT64;
+            value.ValueUInt64     = 0ULL;
+
+            switch( operation )
+            {
+                case EQUATION_OPER_AND:
+                    value.ValueUInt64 = CastToUInt64( valuePrev ) & CastToUInt64( valueLast );
+                    break;
+
+                case EQUATION_OPER_OR:
+                    value.ValueUInt64 = CastToUInt64( valuePrev ) | CastToUInt64( valueLast );
+                    break;
+
+                case EQUATION_OPER_RSHIFT:
+                    value.ValueUInt64 = CastToUInt64( valuePrev ) >> CastToUInt64( valueLast );
+                    break;
+
+                case EQUATION_OPER_LSHIFT:
+                    value.ValueUInt64 = CastToUInt64( valuePrev ) << CastToUInt64( valueLast );
+                    break;
+
+                case EQUATION_OPER_XOR:
+                    value.ValueUInt64 = CastToUInt64( valuePrev ) ^ CastToUInt64( valueLast );
+                    break;
+
+                case EQUATION_OPER_XNOR:
+                    value.ValueUInt64 = ~( CastToUInt64( valuePrev ) ^ CastToUInt64( valueLast ) );
+                    break;
+
+                case EQUATION_OPER_AND_L:
+                    value.ValueBool = CastToUInt64( valuePrev ) && CastToUInt64( valueLast );
+                    value.ValueType = VALUE_TYPE_BOOL;
+                    break;
+
+                case EQUATION_OPER_EQUALS:
+                    value.ValueBool = CastToUInt64( valuePrev ) == CastToUInt64( valueLast );
+                    value.ValueType = VALUE_TYPE_BOOL;
+                    break;
+
+                case EQUATION_OPER_UADD:
+                    value.ValueUInt64 = CastToUInt64( valuePrev ) + CastToUInt64( valueLast );
+                    break;
+
+                case EQUATION_OPER_USUB:
+                    value.ValueUInt64 = CastToUInt64( valuePrev ) - CastToUInt64( valueLast );
+                    break;
+
+                case EQUATION_OPER_UDIV:
+                {
+                    const uint64_t valueLastUint64 = CastToUInt64( valueLast );
+                    value.ValueUInt64              = valueLastUint64 != 0ULL
+                                     ? CastToUInt64( valuePrev ) / valueLastUint64
+                                     : 0ULL;
+                    break;
+                }
+
+                case EQUATION_OPER_UMUL:
+                    value.ValueUInt64 = CastToUInt64( valuePrev ) * CastToUInt64( valueLast );
+
+                    break;
+
+                case EQUATION_OPER_FADD:
+                    value.ValueFloat = CastToFloat( valuePrev ) + CastToFloat( valueLast );
+                    value.ValueType  = VALUE_TYPE_FLOAT;
+                    break;
+
+                case EQUATION_OPER_FSUB:
+                    value.ValueFloat = CastToFloat( valuePrev ) - CastToFloat( valueLast );
+                    value.ValueType  = VALUE_TYPE_FLOAT;
+                    break;
+
+                case EQUATION_OPER_FMUL:
+                    value.ValueFloat = CastToFloat( valuePrev ) * CastToFloat( valueLast );
+                    value.ValueType  = VALUE_TYPE_FLOAT;
+                    break;
+
+                case EQUATION_OPER_FDIV:
+                {
+                    const float valueLastFloat = CastToFloat( valueLast );
+                    value.ValueFloat           = valueLastFloat != 0.0f
+                                  ? CastToFloat( valuePrev ) / valueLastFloat
+                                  : 0.0f;
+                    value.ValueType            = VALUE_TYPE_FLOAT;
+                    break;
+                }
+
+                case EQUATION_OPER_UGT:
+                    value.ValueBool = CastToUInt64( valuePrev ) > CastToUInt64( valueLast );
+                    value.ValueType = VALUE_TYPE_BOOL;
+                    break;
+
+                case EQUATION_OPER_ULT:
+                    value.ValueBool = CastToUInt64( valuePrev ) < CastToUInt64( valueLast );
+                    value.ValueType = VALUE_TYPE_BOOL;
+                    break;
+
+                case EQUATION_OPER_UGTE:
+                    value.ValueBool = CastToUInt64( valuePrev ) >= CastToUInt64( valueLast );
+                    value.ValueType = VALUE_TYPE_BOOL;
+                    break;
+
+                case EQUATION_OPER_ULTE:
+                    value.ValueBool = CastToUInt64( valuePrev ) <= CastToUInt64( valueLast );
+                    value.ValueType = VALUE_TYPE_BOOL;
+                    break;
+
+                case EQUATION_OPER_FGT:
+                    value.ValueBool = CastToFloat( valuePrev ) > CastToFloat( valueLast );
+                    value.ValueType = VALUE_TYPE_BOOL;
+                    break;
+
+                case EQUATION_OPER_FLT:
+                    value.ValueBool = CastToFloat( valuePrev ) < CastToFloat( valueLast );
+                    value.ValueType = VALUE_TYPE_BOOL;
+                    break;
+
+                case EQUATION_OPER_FGTE:
+                    value.ValueBool = CastToFloat( valuePrev ) >= CastToFloat( valueLast );
+                    value.ValueType = VALUE_TYPE_BOOL;
+                    break;
+
+                case EQUATION_OPER_FLTE:
+                    value.ValueBool = CastToFloat( valuePrev ) <= CastToFloat( valueLast );
+                    value.ValueType = VALUE_TYPE_BOOL;
+                    break;
+
+                case EQUATION_OPER_UMIN:
+                    // (std::min) - braces to bypass windows.h min/max errors
+                    value.ValueUInt64 = ( std::min )( CastToUInt64( valuePrev ), CastToUInt64( valueLast ) );
+                    break;
+
+                case EQUATION_OPER_UMAX:
+                    // (std::min) - braces to bypass windows.h min/max errors
+                    value.ValueUInt64 = ( std::max )( CastToUInt64( valuePrev ), CastToUInt64( valueLast ) );
+                    break;
+
+                case EQUATION_OPER_FMIN:
+                    // (std::min) - braces to bypass windows.h min/max errors
+                    value.ValueFloat = ( std::min )( CastToFloat( valuePrev ), CastToFloat( valueLast ) );
+                    value.ValueType  = VALUE_TYPE_FLOAT;
+                    break;
+
+                case EQUATION_OPER_FMAX:
+                    // (std::min) - braces to bypass windows.h min/max errors
+                    value.ValueFloat = ( std::max )( CastToFloat( valuePrev ), CastToFloat( valueLast ) );
+                    value.ValueType  = VALUE_TYPE_FLOAT;
+                    break;
+
+                default:
+                    MD_ASSERT( false );
+                    break;
+            }
+
+            return value;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CastToBoolean
+        //
+        // Description:
+        //     Returns typed value casted to boolean.
+        //
+        // Input:
+        //     const TTypedValue_1_0& value - typed value to be casted
+        //
+        // Output:
+        //     bool                         - casted typed value to boolean
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline bool CastToBoolean( const TTypedValue_1_0& value )
+        {
+            switch( value.ValueType )
+            {
+                case VALUE_TYPE_BOOL:
+                    return value.ValueBool;
+
+                case VALUE_TYPE_UINT32:
+                    return value.ValueUInt32 != 0U;
+
+                case VALUE_TYPE_UINT64:
+                    return value.ValueUInt64 != 0ULL;
+
+                case VALUE_TYPE_FLOAT:
+                    return value.ValueFloat != 0.0f;
+
+                default:
+                    return false;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     ReadBitfield
+        //
+        // Description:
+        //     Returns bitfield from the report.
+        //
+        // Input:
+        //     const uint8_t* rawReport - raw report
+        //     uint32_t       bitOffset - bit offset
+        //     uint32_t       bitCount  - bit count
+        //
+        // Output:
+        //     uint64_t                 - bitfield from the report
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline uint64_t ReadBitfield(
+            const uint8_t* rawReport,
+            uint32_t       bitOffset,
+            uint32_t       bitCount )
+        {
+            if( !rawReport || ( bitCount > 32 ) || ( bitCount == 0 ) || ( bitCount + bitOffset > 32 ) )
+            {
+                const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+                MD_ASSERT_A( adapterId, false );
+                MD_LOG_A( adapterId, LOG_ERROR, "error: invalid params" );
+                return 0;
+            }
+
+            // Build mask
+            const uint32_t mask = MD_BITMASK_RANGE( bitOffset, bitOffset + bitCount - 1 );
+
+            // Get integer in the way in is alignment safe
+            const uint32_t data = *reinterpret_cast<const uint32_t*>( rawReport );
+
+            return static_cast<uint64_t>( ( data & mask ) >> bitOffset );
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     GetMetricsDevice
+        //
+        // Description:
+        //     Returns metrics device
+        //
+        // Output:
+        //     CMetricsDevice& - metrics device
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline CMetricsDevice& GetMetricsDevice()
+        {
+            return m_device;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     MatchMetricKernels
+        //
+        // Description:
+        //     Matches folded io read and normalization programs of the calculated metrics
+        //     against equation shapes with native batch kernels. Equations not matched
+        //     are interpreted. Kernels have to be matched again if the plan is built
+        //     again.
+        //
+        // Input:
+        //     TCalculationPlan& plan - (IN/OUT) calculation plan
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline void MatchMetricKernels( TCalculationPlan& plan )
+        {
+            const TMetricKernel noKernel = { METRIC_KERNEL_TYPE_NONE, -1, 0, -1, -1, 0 };
+
+            plan.ReadKernels.assign( plan.MetricsCount, noKernel );
+            plan.NormKernels.assign( plan.MetricsCount, noKernel );
+
+            uint32_t kernelsCount = 0;
+
+            for( const uint32_t i : plan.CalculatedMetrics )
+            {
+                if( plan.IoReadEquations[i] != nullptr )
+                {
+                    plan.ReadKernels[i] = MatchReadKernel( *plan.IoReadEquations[i], GetReadDeltaFunction( plan.DeltaFunctions[i] ), plan.ReportLayout );
+                    kernelsCount += ( plan.ReadKernels[i].Type != METRIC_KERNEL_TYPE_NONE ) ? 1 : 0;
+                }
+
+                if( plan.NormalizationKinds[i] == NORMALIZATION_KIND_EQUATION )
+                {
+                    plan.NormKernels[i] = MatchNormalizationKernel( *plan.NormEquations[i] );
+                    kernelsCount += ( plan.NormKernels[i].Type != METRIC_KERNEL_TYPE_NONE ) ? 1 : 0;
+                }
+            }
+
+            MD_LOG_A( m_device.GetAdapter().GetAdapterId(), LOG_DEBUG, "metric kernels matched: %u, calculated metrics: %u", kernelsCount, static_cast<uint32_t>( plan.CalculatedMetrics.size() ) );
+        }
+
+    private:
+        friend class CMetricsCalculatorTest; // Compares evaluation paths, see tests/md_equation_test.cpp
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //    CMetricsCalculator
+        //
+        // Method:
+        //     ProjectReports
+        //
+        // Description:
+        //     Writes projected metrics and all information of calculated reports to
+        //     the output buffers.
+        //
+        // Input:
+        //     const TCalculationPlan& plan         - calculation plan
+        //     uint32_t                reportCount  - count of calculated reports
+        //     TTypedValue_1_0*        outValues    - (OUT) projected reports
+        //     TTypedValue_1_0*        outMaxValues - (OUT) projected max values, can be nullptr
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline void ProjectReports( const TCalculationPlan& plan, uint32_t reportCount, TTypedValue_1_0* outValues, TTypedValue_1_0* outMaxValues )
+        {
+            const uint32_t  metricsCount    = plan.MetricsCount;
+            const uint32_t  reportSize      = metricsCount + plan.InformationCount;
+            const uint32_t  outMetricsCount = static_cast<uint32_t>( plan.OutMetrics.size() );
+            const uint32_t  outReportSize   = outMetricsCount + plan.InformationCount;
+            const uint32_t* outMetrics      = plan.OutMetrics.data();
+
+            for( uint32_t j = 0; j < reportCount; ++j )
+            {
+                const TTypedValue_1_0* calculated = m_calculatedValues.data() + j * reportSize;
+                TTypedValue_1_0*       out        = outValues + j * outReportSize;
+
+                for( uint32_t i = 0; i < outMetricsCount; ++i )
+                {
+                    out[i] = calculated[outMetrics[i]];
+                }
+
+                std::copy( calculated + metricsCount, calculated + reportSize, out + outMetricsCount );
+
+                if( outMaxValues )
+                {
+                    const TTypedValue_1_0* calculatedMaxValues = m_calculatedMaxValues.data() + j * metricsCount;
+                    TTypedValue_1_0*       outMax              = outMaxValues + j * outMetricsCount;
+
+                    for( uint32_t i = 0; i < outMetricsCount; ++i )
+                    {
+                        outMax[i] = calculatedMaxValues[outMetrics[i]];
+                    }
+                }
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //    CMetricsCalculator
+        //
+        // Method:
+        //     WriteReportColumns
+        //
+        // Description:
+        //     Writes output metrics, their max values and information of calculated
+        //     reports to the columns of the output descriptor.
+        //
+        // Input:
+        //     const TCalculationPlan&                   plan          - calculation plan
+        //     const TCalculationOutputDescriptorLatest& outDescriptor - (OUT) output columns
+        //     uint32_t                                  firstReport   - index of the first calculated report in columns
+        //     uint32_t                                  reportCount   - count of calculated reports
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline void WriteReportColumns( const TCalculationPlan& plan, const TCalculationOutputDescriptorLatest& outDescriptor, uint32_t firstReport, uint32_t reportCount )
+        {
+            const uint32_t         metricsCount     = plan.MetricsCount;
+            const uint32_t         informationCount = plan.InformationCount;
+            const uint32_t         reportSize       = metricsCount + informationCount;
+            const uint32_t         outMetricsCount  = static_cast<uint32_t>( plan.OutMetrics.size() );
+            const TTypedValue_1_0* calculated       = m_calculatedValues.data();
+
+            for( uint32_t i = 0; i < outMetricsCount; ++i )
+            {
+                const uint32_t          metricIndex = plan.OutMetrics[i];
+                const TMetricResultType resultType  = plan.ResultTypes[metricIndex];
+
+                WriteColumn( outDescriptor.MetricColumns[i], resultType, calculated + metricIndex, reportSize, firstReport, reportCount );
+
+                if( outDescriptor.MaxValueColumns )
+                {
+                    WriteColumn( outDescriptor.MaxValueColumns[i], resultType, m_calculatedMaxValues.data() + metricIndex, metricsCount, firstReport, reportCount );
+                }
+            }
+
+            if( outDescriptor.OutInformation && informationCount > 0 )
+            {
+                TTypedValue_1_0* outInformation = outDescriptor.OutInformation + static_cast<size_t>( firstReport ) * informationCount;
+
+                for( uint32_t j = 0; j < reportCount; ++j )
+                {
+                    const TTypedValue_1_0* information = calculated + j * reportSize + metricsCount;
+
+                    std::copy( information, information + informationCount, outInformation + j * informationCount );
+                }
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //    CMetricsCalculator
+        //
+        // Method:
+        //     WriteColumn
+        //
+        // Description:
+        //     Writes values of a single metric to the column typed by the metric result
+        //     type. Bool values are written as bits.
+        //
+        // Input:
+        //     const TMetricColumnLatest& column      - (OUT) metric column
+        //     TMetricResultType          resultType  - metric result type
+        //     const TTypedValue_1_0*     values      - (IN) first value of the metric
+        //     uint32_t                   stride      - distance between values of consecutive reports
+        //     uint32_t                   firstReport - index of the first report in the column
+        //     uint32_t                   reportCount - count of values to write
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline void WriteColumn( const TMetricColumnLatest& column, TMetricResultType resultType, const TTypedValue_1_0* values, uint32_t stride, uint32_t firstReport, uint32_t reportCount )
+        {
+            auto getValue = [&]( uint32_t j )
+            {
+                // Max values are typed the same way as metric values
+                TTypedValue_1_0 value = values[j * stride];
+                ConvertToResultType( value, resultType );
+                return value;
+            };
+
+            switch( resultType )
+            {
+                case RESULT_UINT32:
+                {
+                    uint32_t* data = static_cast<uint32_t*>( column.Data ) + firstReport;
+
+                    for( uint32_t j = 0; j < reportCount; ++j )
+                    {
+                        data[j] = getValue( j ).ValueUInt32;
+                    }
+                    break;
+                }
+
+                case RESULT_UINT64:
+                {
+                    uint64_t* data = static_cast<uint64_t*>( column.Data ) + firstReport;
+
+                    for( uint32_t j = 0; j < reportCount; ++j )
+                    {
+                        data[j] = getValue( j ).ValueUInt64;
+                    }
+                    break;
+                }
+
+                case RESULT_FLOAT:
+                {
+                    float* data = static_cast<float*>( column.Data ) + firstReport;
+
+                    for( uint32_t j = 0; j < reportCount; ++j )
+                    {
+                        data[j] = getValue( j ).ValueFloat;
+                    }
+                    break;
+                }
+
+                case RESULT_BOOL:
+                {
+                    uint8_t* data = static_cast<uint8_t*>( column.Data );
+
+                    for( uint32_t j = 0; j < reportCount; ++j )
+                    {
+                        const uint32_t report = firstReport + j;
+                        const uint8_t  bit    = static_cast<uint8_t>( 1U << ( report % MD_BYTE ) );
+
+                        data[report / MD_BYTE] = getValue( j ).ValueBool
+                            ? static_cast<uint8_t>( data[report / MD_BYTE] | bit )
+                            : static_cast<uint8_t>( data[report / MD_BYTE] & ~bit );
+                    }
+                    break;
+                }
+
+                default:
+                    MD_ASSERT_A( m_device.GetAdapter().GetAdapterId(), false );
+                    break;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CalculateDeltaFunction
+        //
+        // Description:
+        //     Calculates the given delta function.
+        //
+        // Input:
+        //     TDeltaFunction_1_0     deltaFunction  - delta function to be calculated
+        //     const TTypedValue_1_0& lastValue     - (IN) last (next) value
+        //     const TTypedValue_1_0& previousValue - (IN) previous value
+        //
+        // Output:
+        //     TTypedValue_1_0 - output calculated delta value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline TTypedValue_1_0 CalculateDeltaFunction(
+            TDeltaFunction_1_0     deltaFunction,
+            const TTypedValue_1_0& lastValue,
+            const TTypedValue_1_0& previousValue )
+        {
+            TTypedValue_1_0 typedValue = {};
+
+            switch( deltaFunction.FunctionType )
+            {
+                case DELTA_BOOL_OR:
+                    typedValue.ValueUInt64 = ( ( lastValue.ValueUInt64 | previousValue.ValueUInt64 ) != 0 ) ? 1ULL : 0ULL;
+                    typedValue.ValueType   = VALUE_TYPE_UINT64;
+                    return typedValue;
+
+                case DELTA_BOOL_XOR:
+                    typedValue.ValueUInt64 = ( ( lastValue.ValueUInt64 ^ previousValue.ValueUInt64 ) != 0 ) ? 1ULL : 0ULL;
+                    typedValue.ValueType   = VALUE_TYPE_UINT64;
+                    return typedValue;
+
+                case DELTA_GET_LAST:
+                    return lastValue;
+
+                case DELTA_GET_PREVIOUS:
+                    return previousValue;
+
+                case DELTA_NS_TIME:
+                    // No 'break' intentional - NS_TIME should be used only for overflow functions, here use as DELTA 32 or DELTA 56
+                    switch( m_device.GetPlatformIndex() )
+                    {
+                        case GENERATION_BMG:
+                        case GENERATION_LNL:
+                        case GENERATION_PTL:
+                        case GENERATION_NVL:
+                        case GENERATION_NVLP:
+                        case GENERATION_CRI:
+                            deltaFunction.BitsCount = 56;
+                            break;
+                        default:
+                            deltaFunction.BitsCount = 32;
+                            break;
+                    }
+                    [[fallthrough]];
+
+                case DELTA_N_BITS:
+                    if( deltaFunction.BitsCount <= 64 )
+                    {
+                        if( previousValue.ValueUInt64 > lastValue.ValueUInt64 )
+                        {
+                            if( deltaFunction.BitsCount < 64 )
+                            {
+                                const uint64_t value   = lastValue.ValueUInt64 | ( 1ULL << deltaFunction.BitsCount );
+                                typedValue.ValueUInt64 = value - previousValue.ValueUInt64;
+                            }
+                            else
+                            {
+                                typedValue.ValueUInt64 = ( std::numeric_limits<uint64_t>::max )() - previousValue.ValueUInt64 + lastValue.ValueUInt64;
+                            }
+
+                            typedValue.ValueType = VALUE_TYPE_UINT64;
+                            return typedValue;
+                        }
+                        else
+                        {
+                            typedValue.ValueUInt64 = lastValue.ValueUInt64 - previousValue.ValueUInt64;
+                            typedValue.ValueType   = VALUE_TYPE_UINT64;
+                            return typedValue;
+                        }
+                    }
+                    break;
+
+                case DELTA_FUNCTION_NULL:
+                    typedValue.ValueUInt64 = 0;
+                    typedValue.ValueType   = VALUE_TYPE_UINT64;
+                    return typedValue;
+
+                default:
+                    MD_ASSERT_A( m_device.GetAdapter().GetAdapterId(), false );
+                    break;
+            }
+
+            typedValue.ValueUInt64 = 0;
+            typedValue.ValueType   = VALUE_TYPE_UINT64;
+
+            return typedValue;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     GetReadDeltaFunction
+        //
+        // Description:
+        //     Returns delta function used when delta is calculated directly after reading
+        //     raw offsets. DELTA_NS_TIME works then as a normal DELTA_32 or DELTA_56.
+        //
+        // Input:
+        //     TDeltaFunction_1_0 deltaFunction - metric delta function
+        //
+        // Output:
+        //     TDeltaFunction_1_0 - delta function to use for raw offsets
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline TDeltaFunction_1_0 GetReadDeltaFunction( TDeltaFunction_1_0 deltaFunction )
+        {
+            if( deltaFunction.FunctionType != DELTA_NS_TIME )
+            {
+                return deltaFunction;
+            }
+
+            TDeltaFunction_1_0 readDeltaFunction;
+            readDeltaFunction.FunctionType = DELTA_N_BITS;
+
+            switch( m_device.GetPlatformIndex() )
+            {
+                case GENERATION_BMG:
+                case GENERATION_LNL:
+                case GENERATION_PTL:
+                case GENERATION_NVL:
+                case GENERATION_NVLP:
+                case GENERATION_CRI:
+                    readDeltaFunction.BitsCount = 56;
+                    break;
+                default:
+                    readDeltaFunction.BitsCount = 32;
+                    break;
+            }
+
+            return readDeltaFunction;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     GetReportColumn
+        //
+        // Description:
+        //     Returns report column read by the given instruction, see TReportColumn.
+        //     Timestamp, gpu ticks and PEC / NOA counters read with their own size
+        //     have columns.
+        //
+        // Input:
+        //     const TEquationInstruction& instruction  - read instruction
+        //     const TReportLayout&        reportLayout - report layout
+        //
+        // Output:
+        //     int32_t - report column index, -1 if the instruction doesn't read a column
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline int32_t GetReportColumn( const TEquationInstruction& instruction, const TReportLayout& reportLayout )
+        {
+            uint32_t elemSize = 0;
+
+            switch( instruction.Code )
+            {
+                case EQUATION_INSTR_READ_UINT32:
+                    elemSize = sizeof( uint32_t );
+                    break;
+
+                case EQUATION_INSTR_READ_UINT64:
+                    elemSize = sizeof( uint64_t );
+                    break;
+
+                default:
+                    return -1;
+            }
+
+            if( reportLayout.HeaderSize == 0 )
+            {
+                return -1;
+            }
+
+            if( elemSize == sizeof( uint64_t ) && instruction.ByteOffset == reportLayout.TimestampOffset )
+            {
+                return REPORT_COLUMN_TIMESTAMP;
+            }
+
+            if( elemSize == sizeof( uint64_t ) && instruction.ByteOffset == reportLayout.GpuTicksOffset )
+            {
+                return REPORT_COLUMN_GPU_TICKS;
+            }
+
+            uint32_t column = REPORT_COLUMN_COUNTERS;
+
+            for( const auto& region : reportLayout.Regions )
+            {
+                if( region.Count != 0 && region.ElemSize == elemSize &&
+                    instruction.ByteOffset >= region.Offset &&
+                    instruction.ByteOffset < region.Offset + region.Count * region.ElemSize &&
+                    ( instruction.ByteOffset - region.Offset ) % region.ElemSize == 0 )
+                {
+                    return static_cast<int32_t>( column + ( instruction.ByteOffset - region.Offset ) / region.ElemSize );
+                }
+
+                column += region.Count;
+            }
+
+            return -1;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     InvalidateReportDeltas
+        //
+        // Description:
+        //     Marks counter region deltas of a single report pair as not calculated and
+        //     allocates memory for them. Deltas are calculated on the first use.
+        //
+        // Input:
+        //     const TReportLayout& reportLayout - report layout
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline void InvalidateReportDeltas( const TReportLayout& reportLayout )
+        {
+            m_reportDeltas.resize( reportLayout.CountersCount );
+            m_reportDeltasBitsCount.fill( REPORT_DELTAS_INVALID );
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     GetReportDelta
+        //
+        // Description:
+        //     Returns delta of a PEC or NOA counter read by the given instruction.
+        //     Deltas of all the counters of the region are calculated at once with
+        //     a SIMD kernel and reused by the next instructions reading the same
+        //     region with the same bits count. Other reads aren't handled.
+        //
+        // Input:
+        //     const TEquationInstruction& instruction       - read instruction
+        //     TDeltaFunction_1_0          readDeltaFunction - delta function used for raw offsets
+        //     const TReportLayout&        reportLayout      - report layout
+        //     const uint8_t*              rawReportLast     - (IN) last (next) single raw report
+        //     const uint8_t*              rawReportPrev     - (IN) previous single raw report
+        //     TTypedValue_1_0&            outValue          - (OUT) counter delta
+        //
+        // Output:
+        //     bool - true if the delta is returned
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline bool GetReportDelta(
+            const TEquationInstruction& instruction,
+            TDeltaFunction_1_0          readDeltaFunction,
+            const TReportLayout&        reportLayout,
+            const uint8_t*              rawReportLast,
+            const uint8_t*              rawReportPrev,
+            TTypedValue_1_0&            outValue )
+        {
+            const int32_t column = GetReportColumn( instruction, reportLayout );
+
+            if( readDeltaFunction.FunctionType != DELTA_N_BITS || column < REPORT_COLUMN_COUNTERS )
+            {
+                return false;
+            }
+
+            const uint32_t counterIndex = static_cast<uint32_t>( column - REPORT_COLUMN_COUNTERS );
+            uint32_t       regionFirst  = 0;
+
+            for( uint32_t r = 0; r < REPORT_REGION_LAST; ++r )
+            {
+                const TReportCounterRegion& region = reportLayout.Regions[r];
+
+                if( counterIndex >= regionFirst + region.Count )
+                {
+                    regionFirst += region.Count;
+                    continue;
+                }
+
+                if( m_reportDeltasBitsCount[r] != readDeltaFunction.BitsCount )
+                {
+                    CReportKernels::CalculateRegionDeltas( region, rawReportLast, rawReportPrev, readDeltaFunction.BitsCount, m_reportDeltas.data() + regionFirst );
+                    m_reportDeltasBitsCount[r] = readDeltaFunction.BitsCount;
+                }
+
+                break;
+            }
+
+            outValue.ValueType   = VALUE_TYPE_UINT64;
+            outValue.ValueUInt64 = m_reportDeltas[counterIndex];
+            return true;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     InvalidateBatchColumns
+        //
+        // Description:
+        //     Marks report columns of a batch as not transposed yet. Reports are
+        //     transposed to columns on the first column read.
+        //
+        // Input:
+        //     const TReportLayout& reportLayout - report layout
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline void InvalidateBatchColumns( const TReportLayout& reportLayout )
+        {
+            const size_t columnsCount = REPORT_COLUMN_COUNTERS + reportLayout.CountersCount;
+
+            m_batchColumnsLast.resize( columnsCount * MD_CALCULATION_BATCH_SIZE );
+            m_batchColumnsPrev.resize( columnsCount * MD_CALCULATION_BATCH_SIZE );
+            m_batchColumnDeltas.resize( columnsCount * MD_CALCULATION_BATCH_SIZE );
+            m_batchColumnDeltasBitsCount.assign( columnsCount, REPORT_DELTAS_INVALID );
+            m_batchColumnsTransposed = false;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     GetBatchColumnDelta
+        //
+        // Description:
+        //     Returns delta of a report column read by the given instruction for
+        //     a report in a batch. Last and previous reports of the batch are
+        //     transposed to columns once and deltas of a column are calculated for
+        //     all the reports at once, so equations calculated in columns read
+        //     memory linearly. Other reads aren't handled.
+        //
+        // Input:
+        //     const TEquationInstruction& instruction       - read instruction
+        //     TDeltaFunction_1_0          readDeltaFunction - delta function used for raw offsets
+        //     const TReportLayout&        reportLayout      - report layout
+        //     const uint8_t* const*       rawReportsLast    - (IN) last (next) raw reports
+        //     const uint8_t* const*       rawReportsPrev    - (IN) previous raw reports
+        //     uint32_t                    reportCount       - report pairs count
+        //     uint32_t                    reportIndex       - report index in the batch
+        //     TTypedValue_1_0&            outValue          - (OUT) column delta
+        //
+        // Output:
+        //     bool - true if the delta is returned
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline bool GetBatchColumnDelta(
+            const TEquationInstruction& instruction,
+            TDeltaFunction_1_0          readDeltaFunction,
+            const TReportLayout&        reportLayout,
+            const uint8_t* const*       rawReportsLast,
+            const uint8_t* const*       rawReportsPrev,
+            uint32_t                    reportCount,
+            uint32_t                    reportIndex,
+            TTypedValue_1_0&            outValue )
+        {
+            const int32_t column = GetReportColumn( instruction, reportLayout );
+
+            if( readDeltaFunction.FunctionType != DELTA_N_BITS || column < 0 )
+            {
+                return false;
+            }
+
+            const uint64_t* columnDeltas = GetBatchColumnDeltas( column, readDeltaFunction.BitsCount, reportLayout, rawReportsLast, rawReportsPrev, reportCount );
+
+            outValue.ValueType   = VALUE_TYPE_UINT64;
+            outValue.ValueUInt64 = columnDeltas[reportIndex];
+            return true;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     GetBatchColumnDeltas
+        //
+        // Description:
+        //     Returns deltas of a report column for all the reports in a batch.
+        //     Reports are transposed on the first call for the batch and deltas of
+        //     a column are calculated once for the given bits count.
+        //
+        // Input:
+        //     int32_t               column         - report column, see TReportColumn
+        //     uint32_t              bitsCount      - delta bits count
+        //     const TReportLayout&  reportLayout   - report layout
+        //     const uint8_t* const* rawReportsLast - (IN) last (next) raw reports
+        //     const uint8_t* const* rawReportsPrev - (IN) previous raw reports
+        //     uint32_t              reportCount    - report pairs count
+        //
+        // Output:
+        //     const uint64_t* - column deltas, one for each report
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline const uint64_t* GetBatchColumnDeltas(
+            int32_t               column,
+            uint32_t              bitsCount,
+            const TReportLayout&  reportLayout,
+            const uint8_t* const* rawReportsLast,
+            const uint8_t* const* rawReportsPrev,
+            uint32_t              reportCount )
+        {
+            if( !m_batchColumnsTransposed )
+            {
+                CReportKernels::TransposeReports( reportLayout, rawReportsLast, reportCount, MD_CALCULATION_BATCH_SIZE, m_batchColumnsLast.data() );
+                CReportKernels::TransposeReports( reportLayout, rawReportsPrev, reportCount, MD_CALCULATION_BATCH_SIZE, m_batchColumnsPrev.data() );
+                m_batchColumnsTransposed = true;
+            }
+
+            const size_t columnOffset = static_cast<size_t>( column ) * MD_CALCULATION_BATCH_SIZE;
+
+            if( m_batchColumnDeltasBitsCount[column] != bitsCount )
+            {
+                CReportKernels::CalculateColumnDeltas( m_batchColumnsLast.data() + columnOffset, m_batchColumnsPrev.data() + columnOffset, reportCount, bitsCount, m_batchColumnDeltas.data() + columnOffset );
+                m_batchColumnDeltasBitsCount[column] = bitsCount;
+            }
+
+            return m_batchColumnDeltas.data() + columnOffset;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     ConvertToResultType
+        //
+        // Description:
+        //     Casts normalized metric value to the metric result type.
+        //
+        // Input:
+        //     TTypedValue_1_0&  value      - (IN/OUT) normalized metric value
+        //     TMetricResultType resultType - metric result type
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline void ConvertToResultType( TTypedValue_1_0& value, TMetricResultType resultType )
+        {
+            switch( resultType )
+            {
+                case RESULT_UINT32:
+                    if( value.ValueType != VALUE_TYPE_UINT32 )
+                    {
+                        value.ValueUInt32 = CastToUInt32( value );
+                        value.ValueType   = VALUE_TYPE_UINT32;
+                    }
+                    break;
+
+                case RESULT_UINT64:
+                    if( value.ValueType != VALUE_TYPE_UINT64 )
+                    {
+                        value.ValueUInt64 = CastToUInt64( value );
+                        value.ValueType   = VALUE_TYPE_UINT64;
+                    }
+                    break;
+
+                case RESULT_FLOAT:
+                    if( value.ValueType != VALUE_TYPE_FLOAT )
+                    {
+                        value.ValueFloat = CastToFloat( value );
+                        value.ValueType  = VALUE_TYPE_FLOAT;
+                    }
+                    break;
+
+                case RESULT_BOOL:
+                    if( value.ValueType != VALUE_TYPE_BOOL )
+                    {
+                        value.ValueBool = CastToBoolean( value );
+                        value.ValueType = VALUE_TYPE_BOOL;
+                    }
+                    break;
+
+                default:
+                    MD_ASSERT_A( m_device.GetAdapter().GetAdapterId(), false );
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     ConvertToInformationType
+        //
+        // Description:
+        //     Sets type of the read information value. Flags are returned as bool,
+        //     other information as uint64.
+        //
+        // Input:
+        //     TTypedValue_1_0&                  value       - (IN/OUT) read information value
+        //     const TInformationReadDescriptor& information - read information
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline void ConvertToInformationType( TTypedValue_1_0& value, const TInformationReadDescriptor& information )
+        {
+            if( information.IsFlag )
+            {
+                value.ValueType = VALUE_TYPE_BOOL;
+                value.ValueBool = ( value.ValueUInt64 != 0ULL );
+            }
+            else
+            {
+                value.ValueType = VALUE_TYPE_UINT64;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     ReadInstructionValue
+        //
+        // Description:
+        //     Reads a raw value described by the given compiled read instruction.
+        //
+        // Input:
+        //     const TEquationInstruction& instruction - read instruction
+        //     const uint8_t*              rawReport   - (IN) single raw report
+        //
+        // Output:
+        //     TTypedValue_1_0 - read value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline TTypedValue_1_0 ReadInstructionValue(
+            const TEquationInstruction& instruction,
+            const uint8_t*              rawReport )
+        {
+            TTypedValue_1_0 typedValue = {};
+            typedValue.ValueType       = VALUE_TYPE_UINT64;
+
+            const uint8_t* data = rawReport + instruction.ByteOffset;
+
+            switch( instruction.Code )
+            {
+                case EQUATION_INSTR_READ_UINT8:
+                    typedValue.ValueUInt64 = static_cast<uint64_t>( *data );
+                    break;
+
+                case EQUATION_INSTR_READ_UINT16:
+                    typedValue.ValueUInt64 = static_cast<uint64_t>( *reinterpret_cast<const uint16_t*>( data ) );
+                    break;
+
+                case EQUATION_INSTR_READ_UINT32:
+                    typedValue.ValueUInt64 = static_cast<uint64_t>( *reinterpret_cast<const uint32_t*>( data ) );
+                    break;
+
+                case EQUATION_INSTR_READ_UINT64:
+                    typedValue.ValueUInt64 = *reinterpret_cast<const uint64_t*>( data );
+                    break;
+
+                case EQUATION_INSTR_READ_FLOAT:
+                    typedValue.ValueFloat = *reinterpret_cast<const float*>( data );
+                    typedValue.ValueType  = VALUE_TYPE_FLOAT;
+                    break;
+
+                case EQUATION_INSTR_READ_40BIT_CNTR:
+                    typedValue.ValueUInt64 = static_cast<uint64_t>( *reinterpret_cast<const uint32_t*>( data ) ) |
+                        ( static_cast<uint64_t>( *( rawReport + instruction.ByteOffsetExt ) ) << 32 );
+                    break;
+
+                case EQUATION_INSTR_READ_BITFIELD:
+                    if( !rawReport || !instruction.BitMask )
+                    {
+                        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+                        MD_ASSERT_A( adapterId, false );
+                        MD_LOG_A( adapterId, LOG_ERROR, "error: invalid params" );
+                        break;
+                    }
+                    typedValue.ValueUInt64 = static_cast<uint64_t>( ( *reinterpret_cast<const uint32_t*>( data ) & instruction.BitMask ) >> instruction.BitOffset );
+                    break;
+
+                default:
+                    MD_ASSERT_A( m_device.GetAdapter().GetAdapterId(), false );
+                    break;
+            }
+
+            return typedValue;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     GetReadEquationOperand
+        //
+        // Description:
+        //     Returns value of the given read equation operand.
+        //
+        // Input:
+        //     const TEquationInstruction& instruction - operand instruction
+        //     const uint8_t*              rawReport   - (IN) single raw report
+        //
+        // Output:
+        //     TTypedValue_1_0 - operand value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline TTypedValue_1_0 GetReadEquationOperand(
+            const TEquationInstruction& instruction,
+            const uint8_t*              rawReport )
+        {
+            TTypedValue_1_0 typedValue = {};
+            typedValue.ValueUInt64     = 0;
+            typedValue.ValueType       = VALUE_TYPE_UINT64;
+
+            switch( instruction.Code )
+            {
+                case EQUATION_INSTR_READ_UINT8:
+                case EQUATION_INSTR_READ_UINT16:
+                case EQUATION_INSTR_READ_UINT32:
+                case EQUATION_INSTR_READ_UINT64:
+                case EQUATION_INSTR_READ_FLOAT:
+                case EQUATION_INSTR_READ_40BIT_CNTR:
+                case EQUATION_INSTR_READ_BITFIELD:
+                    return ReadInstructionValue( instruction, rawReport );
+
+                case EQUATION_INSTR_IMMEDIATE:
+                    return instruction.Value;
+
+                case EQUATION_INSTR_GLOBAL_SYMBOL:
+                case EQUATION_INSTR_GLOBAL_SYMBOL_DYNAMIC:
+                    return m_symbols.GetBoundSymbolValue( instruction );
+
+                case EQUATION_INSTR_PREVIOUS_CONTEXT_ID:
+                    // Return cached context ID from the previous report
+                    typedValue.ValueUInt64 = m_contextIdPrev;
+                    return typedValue;
+
+                case EQUATION_INSTR_LOCAL_COUNTER:
+                    if( m_gpuCoreClocks != 0 && instruction.IsGpuCoreClocks )
+                    {
+                        typedValue.ValueUInt64 = m_gpuCoreClocks;
+                        return typedValue;
+                    }
+
+                    // Exception for missing global symbols (GtSlice[X]XeCore[Y]) in read equations.
+                    // Asserts otherwise, because this is not a valid condition
+                    MD_ASSERT_A( m_device.GetAdapter().GetAdapterId(), instruction.IsMissingSymbolAllowed );
+                    return typedValue;
+
+                case EQUATION_INSTR_INFORMATION_SYMBOL:
+                    // TODO: not supported yet
+                    [[fallthrough]];
+
+                default:
+                    MD_ASSERT_A( m_device.GetAdapter().GetAdapterId(), false );
+                    return typedValue;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     GetNormalizationEquationOperand
+        //
+        // Description:
+        //     Returns value of the given normalization equation operand.
+        //
+        // Input:
+        //     const TEquationInstruction& instruction - operand instruction
+        //     TTypedValue_1_0*            deltaValues - (IN) previously calculated / read delta values
+        //     TTypedValue_1_0*            outValues   - (IN) so far normalized values (metrics with lower indices)
+        //     uint32_t                    metricIndex - index of the currently calculated metric
+        //
+        // Output:
+        //     TTypedValue_1_0 - operand value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline TTypedValue_1_0 GetNormalizationEquationOperand(
+            const TEquationInstruction& instruction,
+            TTypedValue_1_0*            deltaValues,
+            TTypedValue_1_0*            outValues,
+            uint32_t                    metricIndex )
+        {
+            TTypedValue_1_0 typedValue = {};
+            typedValue.ValueUInt64     = 0;
+            typedValue.ValueType       = VALUE_TYPE_UINT64;
+
+            // For local symbols the index is higher than or equals 0 if the symbol name was found, otherwise it equals -1
+            switch( instruction.Code )
+            {
+                case EQUATION_INSTR_IMMEDIATE:
+                    return instruction.Value;
+
+                case EQUATION_INSTR_SELF_COUNTER:
+                    // Get result of delta equation
+                    return deltaValues[metricIndex];
+
+                case EQUATION_INSTR_LOCAL_COUNTER:
+                    return ( instruction.MetricIndex >= 0 )
+                        ? deltaValues[instruction.MetricIndex]
+                        : typedValue;
+
+                case EQUATION_INSTR_LOCAL_METRIC:
+                    return ( instruction.MetricIndex >= 0 )
+                        ? outValues[instruction.MetricIndex]
+                        : typedValue;
+
+                case EQUATION_INSTR_PREV_METRIC:
+                    return ( m_prevValues && instruction.MetricIndex >= 0 )
+                        ? m_prevValues[instruction.MetricIndex]
+                        : typedValue;
+
+                case EQUATION_INSTR_GLOBAL_SYMBOL:
+                case EQUATION_INSTR_GLOBAL_SYMBOL_DYNAMIC:
+                    return m_symbols.GetBoundSymbolValue( instruction );
+
+                case EQUATION_INSTR_STD_NORM_GPU_DURATION:
+                    typedValue.ValueType  = VALUE_TYPE_FLOAT;
+                    typedValue.ValueFloat = 0.0f;
+
+                    // compute $Self $gpuCoreClocks FDIV 100 FMUL
+                    if( m_gpuCoreClocks != 0 )
+                    {
+                        const float self          = CastToFloat( deltaValues[metricIndex] );
+                        const float gpuCoreClocks = static_cast<float>( m_gpuCoreClocks );
+
+                        typedValue.ValueFloat = 100.0f * self / gpuCoreClocks;
+                    }
+                    // Warning: GpuCoreClocks is 0 otherwise
+                    return typedValue;
+
+                case EQUATION_INSTR_STD_NORM_EU_AGGR_DURATION:
+                    // EU cores count is needed here
+                    MD_ASSERT_A( m_device.GetAdapter().GetAdapterId(), m_symbols.GetEuCoresCount() != 0 );
+
+                    typedValue.ValueType  = VALUE_TYPE_FLOAT;
+                    typedValue.ValueFloat = 0.0f;
+
+                    // compute $Self $gpuCoreClocks $EUsCount UMUL FDIV 100 FMUL
+                    if( m_gpuCoreClocks != 0 && m_symbols.GetEuCoresCount() != 0 )
+                    {
+                        const float self          = CastToFloat( deltaValues[metricIndex] );
+                        const float gpuCoreClocks = static_cast<float>( m_gpuCoreClocks * m_symbols.GetEuCoresCount() );
+
+                        typedValue.ValueFloat = 100.0f * self / gpuCoreClocks;
+                    }
+                    // Warning: GpuCoreClocks or euCoresCount is 0 otherwise
+                    return typedValue;
+
+                default:
+                    MD_ASSERT_A( m_device.GetAdapter().GetAdapterId(), false );
+                    return typedValue;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CalculateUInt64Operation
+        //
+        // Description:
+        //     Calculates the given unsigned integer 64b equation operation.
+        //
+        // Input:
+        //     TEquationOperation operation - operation to be calculated
+        //     uint64_t           valuePrev - previous value
+        //     uint64_t           valueLast - last (next) value
+        //
+        // Output:
+        //     uint64_t - output calculated value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        static inline uint64_t CalculateUInt64Operation(
+            TEquationOperation operation,
+            uint64_t           valuePrev,
+            uint64_t           valueLast )
+        {
+            switch( operation )
+            {
+                case EQUATION_OPER_AND:
+                    return valuePrev & valueLast;
+
+                case EQUATION_OPER_OR:
+                    return valuePrev | valueLast;
+
+                case EQUATION_OPER_RSHIFT:
+                    return valuePrev >> valueLast;
+
+                case EQUATION_OPER_LSHIFT:
+                    return valuePrev << valueLast;
+
+                case EQUATION_OPER_XOR:
+                    return valuePrev ^ valueLast;
+
+                case EQUATION_OPER_XNOR:
+                    return ~( valuePrev ^ valueLast );
+
+                case EQUATION_OPER_UADD:
+                    return valuePrev + valueLast;
+
+                case EQUATION_OPER_USUB:
+                    return valuePrev - valueLast;
+
+                case EQUATION_OPER_UDIV:
+                    return valueLast != 0ULL
+                        ? valuePrev / valueLast
+                        : 0ULL;
+
+                case EQUATION_OPER_UMUL:
+                    return valuePrev * valueLast;
+
+                case EQUATION_OPER_UMIN:
+                    // (std::min) - braces to bypass windows.h min/max errors
+                    return ( std::min )( valuePrev, valueLast );
+
+                case EQUATION_OPER_UMAX:
+                    // (std::max) - braces to bypass windows.h min/max errors
+                    return ( std::max )( valuePrev, valueLast );
+
+                default:
+                    MD_ASSERT( false );
+                    return 0ULL;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CalculateFloatOperation
+        //
+        // Description:
+        //     Calculates the given floating point equation operation.
+        //
+        // Input:
+        //     TEquationOperation operation - operation to be calculated
+        //     float              valuePrev - previous value
+        //     float              valueLast - last (next) value
+        //
+        // Output:
+        //     float - output calculated value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        static inline float CalculateFloatOperation(
+            TEquationOperation operation,
+            float              valuePrev,
+            float              valueLast )
+        {
+            switch( operation )
+            {
+                case EQUATION_OPER_FADD:
+                    return valuePrev + valueLast;
+
+                case EQUATION_OPER_FSUB:
+                    return valuePrev - valueLast;
+
+                case EQUATION_OPER_FMUL:
+                    return valuePrev * valueLast;
+
+                case EQUATION_OPER_FDIV:
+                    return valueLast != 0.0f
+                        ? valuePrev / valueLast
+                        : 0.0f;
+
+                case EQUATION_OPER_FMIN:
+                    // (std::min) - braces to bypass windows.h min/max errors
+                    return ( std::min )( valuePrev, valueLast );
+
+                case EQUATION_OPER_FMAX:
+                    // (std::max) - braces to bypass windows.h min/max errors
+                    return ( std::max )( valuePrev, valueLast );
+
+                default:
+                    MD_ASSERT( false );
+                    return 0.0f;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CalculateTypedProgram
+        //
+        // Description:
+        //     Calculates a validated program whose operations are all of the same type.
+        //     Operands are casted once when pushed and operations are calculated on raw
+        //     values, the typed value is created only for the output.
+        //
+        // Input:
+        //     const std::vector<TEquationInstruction>& program    - validated uint64 or float program
+        //     TGetOperand&&                            getOperand - returns operand value for an instruction
+        //
+        // Output:
+        //     TTypedValue_1_0 - output value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        template <typename TValue, typename TGetOperand>
+        inline TTypedValue_1_0 CalculateTypedProgram(
+            const std::vector<TEquationInstruction>& program,
+            TGetOperand&&                            getOperand )
+        {
+            std::array<TValue, CEquation::MAX_STACK_DEPTH> registers;
+            uint32_t                                       size = 0;
+
+            for( const auto& instruction : program )
+            {
+                if( instruction.Code == EQUATION_INSTR_OPERATION )
+                {
+                    const TValue valueLast = registers[--size];
+                    const TValue valuePrev = registers[size - 1];
+
+                    if constexpr( std::is_same_v<TValue, uint64_t> )
+                    {
+                        registers[size - 1] = CalculateUInt64Operation( instruction.Operation, valuePrev, valueLast );
+                    }
+                    else
+                    {
+                        registers[size - 1] = CalculateFloatOperation( instruction.Operation, valuePrev, valueLast );
+                    }
+                }
+                else if constexpr( std::is_same_v<TValue, uint64_t> )
+                {
+                    registers[size++] = CastToUInt64( getOperand( instruction ) );
+                }
+                else
+                {
+                    registers[size++] = CastToFloat( getOperand( instruction ) );
+                }
+            }
+
+            TTypedValue_1_0 typedValue = {};
+
+            if constexpr( std::is_same_v<TValue, uint64_t> )
+            {
+                typedValue.ValueUInt64 = registers[0];
+                typedValue.ValueType   = VALUE_TYPE_UINT64;
+            }
+            else
+            {
+                typedValue.ValueFloat = registers[0];
+                typedValue.ValueType  = VALUE_TYPE_FLOAT;
+            }
+
+            return typedValue;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CalculateValidatedProgram
+        //
+        // Description:
+        //     Calculates a program validated during equation compilation. Stack depth
+        //     and operand count have been already checked, so no bookkeeping is needed.
+        //     Programs with a single operations type are calculated on raw values.
+        //
+        // Input:
+        //     const std::vector<TEquationInstruction>& program     - validated program
+        //     TEquationProgramType                     programType - inferred program type
+        //     CEquationStack&                          stack       - evaluation stack
+        //     TGetOperand&&                            getOperand  - returns operand value for an instruction
+        //
+        // Output:
+        //     TTypedValue_1_0 - output value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        template <typename TGetOperand>
+        inline TTypedValue_1_0 CalculateValidatedProgram(
+            const std::vector<TEquationInstruction>& program,
+            TEquationProgramType                     programType,
+            CEquationStack&                          stack,
+            TGetOperand&&                            getOperand )
+        {
+            switch( programType )
+            {
+                case EQUATION_PROGRAM_TYPE_UINT64:
+                    return CalculateTypedProgram<uint64_t>( program, getOperand );
+
+                case EQUATION_PROGRAM_TYPE_FLOAT:
+                    return CalculateTypedProgram<float>( program, getOperand );
+
+                default:
+                    break;
+            }
+
+            stack.Clear();
+
+            for( const auto& instruction : program )
+            {
+                if( instruction.Code == EQUATION_INSTR_OPERATION )
+                {
+                    const TTypedValue_1_0 valueLast = stack.Pop();
+                    const TTypedValue_1_0 valuePrev = stack.Pop();
+
+                    stack.Push( CalculateEquationElemOperation( instruction.Operation, valuePrev, valueLast ) );
+                }
+                else
+                {
+                    stack.Push( getOperand( instruction ) );
+                }
+            }
+
+            return stack.Pop();
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     MatchReadKernel
+        //
+        // Description:
+        //     Returns column delta kernel for an io read equation that only reads
+        //     a report column, with DELTA N delta function.
+        //
+        // Input:
+        //     CEquation&           equation          - io read equation
+        //     TDeltaFunction_1_0   readDeltaFunction - delta function used for raw offsets
+        //     const TReportLayout& reportLayout      - report layout
+        //
+        // Output:
+        //     TMetricKernel - matched kernel, METRIC_KERNEL_TYPE_NONE if not matched
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline TMetricKernel MatchReadKernel( CEquation& equation, TDeltaFunction_1_0 readDeltaFunction, const TReportLayout& reportLayout )
+        {
+            TMetricKernel        kernel      = { METRIC_KERNEL_TYPE_NONE, -1, 0, -1, -1, 0 };
+            TEquationProgramType programType = EQUATION_PROGRAM_TYPE_MIXED;
+            const auto&          program     = m_symbols.GetEquationProgram( equation, programType );
+
+            if( program.size() != 1 || readDeltaFunction.FunctionType != DELTA_N_BITS )
+            {
+                return kernel;
+            }
+
+            const int32_t column = GetReportColumn( program[0], reportLayout );
+
+            if( column >= 0 )
+            {
+                kernel.Type      = METRIC_KERNEL_TYPE_COLUMN_DELTA;
+                kernel.Column    = column;
+                kernel.BitsCount = readDeltaFunction.BitsCount;
+            }
+
+            return kernel;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     MatchInformationField
+        //
+        // Description:
+        //     Checks if an information read equation only reads a 32 or 64 bit report
+        //     field, optionally shifted right and masked with immediates: "dw@0x08",
+        //     "dw@0x08 0xFFFF AND", "dw@0x00 19 >>" or "dw@0x00 19 >> 0x3F AND".
+        //
+        // Input:
+        //     CEquation& equation      - information read equation
+        //     uint32_t   rawReportSize - single raw report size in bytes
+        //     uint32_t&  fieldOffset   - (OUT) field offset in a report
+        //     uint32_t&  fieldSize     - (OUT) field size in bytes
+        //     uint32_t&  fieldShift    - (OUT) right shift applied to the field
+        //     uint64_t&  fieldMask     - (OUT) mask applied to the shifted field
+        //
+        // Output:
+        //     bool - true if matched
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline bool MatchInformationField( CEquation& equation, uint32_t rawReportSize, uint32_t& fieldOffset, uint32_t& fieldSize, uint32_t& fieldShift, uint64_t& fieldMask )
+        {
+            TEquationProgramType programType = EQUATION_PROGRAM_TYPE_MIXED;
+            const auto&          program     = m_symbols.GetEquationProgram( equation, programType );
+
+            auto matchRead = [&]( size_t index )
+            {
+                const auto& instruction = program[index];
+
+                switch( instruction.Code )
+                {
+                    case EQUATION_INSTR_READ_UINT32:
+                        fieldSize = sizeof( uint32_t );
+                        break;
+
+                    case EQUATION_INSTR_READ_UINT64:
+                        fieldSize = sizeof( uint64_t );
+                        break;
+
+                    default:
+                        return false;
+                }
+
+                fieldOffset = instruction.ByteOffset;
+                return fieldOffset + fieldSize <= rawReportSize;
+            };
+
+            auto isImmediate = [&]( size_t index )
+            {
+                return program[index].Code == EQUATION_INSTR_IMMEDIATE;
+            };
+
+            auto isOperation = [&]( size_t index, TEquationOperation operation )
+            {
+                return program[index].Code == EQUATION_INSTR_OPERATION && program[index].Operation == operation;
+            };
+
+            // Shifts by 64 bits or more aren't defined, such equations are calculated generically
+            auto matchShift = [&]( size_t index )
+            {
+                const uint64_t shift = CastToUInt64( program[index].Value );
+
+                fieldShift = static_cast<uint32_t>( shift );
+                return shift < 64;
+            };
+
+            fieldShift = 0;
+            fieldMask  = ~0ULL;
+
+            switch( program.size() )
+            {
+                case 1:
+                    return matchRead( 0 );
+
+                case 3:
+                    if( isOperation( 2, EQUATION_OPER_RSHIFT ) )
+                    {
+                        return isImmediate( 1 ) && matchRead( 0 ) && matchShift( 1 );
+                    }
+                    if( !isOperation( 2, EQUATION_OPER_AND ) )
+                    {
+                        return false;
+                    }
+                    if( isImmediate( 1 ) && matchRead( 0 ) )
+                    {
+                        fieldMask = CastToUInt64( program[1].Value );
+                        return true;
+                    }
+                    if( isImmediate( 0 ) && matchRead( 1 ) )
+                    {
+                        fieldMask = CastToUInt64( program[0].Value );
+                        return true;
+                    }
+                    return false;
+
+                case 5:
+                    if( !isOperation( 2, EQUATION_OPER_RSHIFT ) || !isOperation( 4, EQUATION_OPER_AND ) ||
+                        !isImmediate( 1 ) || !isImmediate( 3 ) || !matchRead( 0 ) || !matchShift( 1 ) )
+                    {
+                        return false;
+                    }
+                    fieldMask = CastToUInt64( program[3].Value );
+                    return true;
+
+                default:
+                    return false;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     MatchNormalizationKernel
+        //
+        // Description:
+        //     Returns kernel for a normalization equation of one of the shapes most
+        //     often used by generated metric sets. Immediates are taken from the folded
+        //     program, so global symbols folded into them are supported as well.
+        //     Kernels calculate the same operations as the interpreter, so the results
+        //     don't depend on the inferred program type.
+        //
+        // Input:
+        //     CEquation& equation - normalization equation
+        //
+        // Output:
+        //     TMetricKernel - matched kernel, METRIC_KERNEL_TYPE_NONE if not matched
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline TMetricKernel MatchNormalizationKernel( CEquation& equation )
+        {
+            TMetricKernel        kernel      = { METRIC_KERNEL_TYPE_NONE, -1, 0, -1, -1, 0 };
+            TEquationProgramType programType = EQUATION_PROGRAM_TYPE_MIXED;
+            const auto&          program     = m_symbols.GetEquationProgram( equation, programType );
+
+            auto isCode = [&]( size_t index, TEquationInstructionCode code )
+            {
+                // Local symbols have to be found
+                return program[index].Code == code && ( ( code != EQUATION_INSTR_LOCAL_COUNTER && code != EQUATION_INSTR_LOCAL_METRIC ) || program[index].MetricIndex >= 0 );
+            };
+
+            auto isOperation = [&]( size_t index, TEquationOperation operation )
+            {
+                return program[index].Code == EQUATION_INSTR_OPERATION && program[index].Operation == operation;
+            };
+
+            switch( program.size() )
+            {
+                case 1:
+                    // GpuDuration, EuAggrDuration
+                    if( isCode( 0, EQUATION_INSTR_STD_NORM_GPU_DURATION ) )
+                    {
+                        kernel.Type = METRIC_KERNEL_TYPE_GPU_DURATION;
+                    }
+                    else if( isCode( 0, EQUATION_INSTR_STD_NORM_EU_AGGR_DURATION ) )
+                    {
+                        kernel.Type = METRIC_KERNEL_TYPE_EU_AGGR_DURATION;
+                    }
+                    break;
+
+                case 3:
+                    // $Self N UMUL, N $Self UMUL
+                    if( isOperation( 2, EQUATION_OPER_UMUL ) && isCode( 0, EQUATION_INSTR_SELF_COUNTER ) && isCode( 1, EQUATION_INSTR_IMMEDIATE ) )
+                    {
+                        kernel.Type      = METRIC_KERNEL_TYPE_SELF_UMUL;
+                        kernel.Immediate = CastToUInt64( program[1].Value );
+                    }
+                    else if( isOperation( 2, EQUATION_OPER_UMUL ) && isCode( 0, EQUATION_INSTR_IMMEDIATE ) && isCode( 1, EQUATION_INSTR_SELF_COUNTER ) )
+                    {
+                        kernel.Type      = METRIC_KERNEL_TYPE_SELF_UMUL;
+                        kernel.Immediate = CastToUInt64( program[0].Value );
+                    }
+                    // $Self $$Metric FDIV
+                    else if( isOperation( 2, EQUATION_OPER_FDIV ) && isCode( 0, EQUATION_INSTR_SELF_COUNTER ) && isCode( 1, EQUATION_INSTR_LOCAL_METRIC ) )
+                    {
+                        kernel.Type        = METRIC_KERNEL_TYPE_SELF_METRIC_FDIV;
+                        kernel.MetricIndex = program[1].MetricIndex;
+                    }
+                    break;
+
+                case 5:
+                    // $Counter N UMUL $$Metric UDIV
+                    if( isCode( 0, EQUATION_INSTR_LOCAL_COUNTER ) && isCode( 1, EQUATION_INSTR_IMMEDIATE ) && isOperation( 2, EQUATION_OPER_UMUL ) &&
+                        isCode( 3, EQUATION_INSTR_LOCAL_METRIC ) && isOperation( 4, EQUATION_OPER_UDIV ) )
+                    {
+                        kernel.Type         = METRIC_KERNEL_TYPE_COUNTER_UMUL_METRIC_UDIV;
+                        kernel.CounterIndex = program[0].MetricIndex;
+                        kernel.Immediate    = CastToUInt64( program[1].Value );
+                        kernel.MetricIndex  = program[3].MetricIndex;
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+
+            return kernel;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CalculateNormalizationKernelBatch
+        //
+        // Description:
+        //     Calculates normalized values of a metric for a batch of reports with
+        //     a matched normalization kernel, without interpreting the program.
+        //
+        // Input:
+        //     const TMetricKernel&   kernel       - normalization kernel
+        //     uint32_t               metricIndex  - index of the normalized metric
+        //     uint32_t               reportCount  - reports count
+        //     const TTypedValue_1_0* deltaValues  - delta values of the batch, metricsCount per report
+        //     uint32_t               metricsCount - metrics count
+        //     TTypedValue_1_0*       outValues    - (IN/OUT) calculated reports of the batch, reportSize per report
+        //     uint32_t               reportSize   - calculated report size
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline void CalculateNormalizationKernelBatch(
+            const TMetricKernel&   kernel,
+            uint32_t               metricIndex,
+            uint32_t               reportCount,
+            const TTypedValue_1_0* deltaValues,
+            uint32_t               metricsCount,
+            TTypedValue_1_0*       outValues,
+            uint32_t               reportSize )
+        {
+            const uint64_t euCoresCount  = m_symbols.GetEuCoresCount();
+            const uint64_t* gpuCoreClocks = m_batchGpuCoreClocks.data();
 
-            if( m_multipleSymbols )
+            // Kernel type is resolved once for the batch, so every loop is straight-line code
+            auto calculateBatch = [&]( auto&& calculate )
             {
-                if( auto symbol = m_symbolMap.find( symbolName );
-                    symbol != m_symbolMap.end() )
+                for( uint32_t j = 0; j < reportCount; ++j )
                 {
-                    return &symbol->second;
+                    TTypedValue_1_0* out = outValues + j * reportSize;
+
+                    out[metricIndex] = calculate( deltaValues + j * metricsCount, out, j );
+                }
+            };
+
+            auto floatValue = []( float valueFloat )
+            {
+                TTypedValue_1_0 value = {};
+                value.ValueType       = VALUE_TYPE_FLOAT;
+                value.ValueFloat      = valueFloat;
+                return value;
+            };
+
+            auto uint64Value = []( uint64_t valueUInt64 )
+            {
+                TTypedValue_1_0 value = {};
+                value.ValueType       = VALUE_TYPE_UINT64;
+                value.ValueUInt64     = valueUInt64;
+                return value;
+            };
+
+            switch( kernel.Type )
+            {
+                case METRIC_KERNEL_TYPE_GPU_DURATION:
+                    // $Self $GpuCoreClocks FDIV 100 FMUL
+                    calculateBatch( [&]( const TTypedValue_1_0* delta, const TTypedValue_1_0*, uint32_t j )
+                        { return floatValue( ( gpuCoreClocks[j] != 0 )
+                                  ? 100.0f * CastToFloat( delta[metricIndex] ) / static_cast<float>( gpuCoreClocks[j] )
+                                  : 0.0f ); } );
+                    break;
+
+                case METRIC_KERNEL_TYPE_EU_AGGR_DURATION:
+                    // $Self $GpuCoreClocks $EuCoresCount UMUL FDIV 100 FMUL
+                    calculateBatch( [&]( const TTypedValue_1_0* delta, const TTypedValue_1_0*, uint32_t j )
+                        { return floatValue( ( gpuCoreClocks[j] != 0 && euCoresCount != 0 )
+                                  ? 100.0f * CastToFloat( delta[metricIndex] ) / static_cast<float>( gpuCoreClocks[j] * euCoresCount )
+                                  : 0.0f ); } );
+                    break;
+
+                case METRIC_KERNEL_TYPE_SELF_UMUL:
+                    calculateBatch( [&]( const TTypedValue_1_0* delta, const TTypedValue_1_0*, uint32_t )
+                        { return uint64Value( CastToUInt64( delta[metricIndex] ) * kernel.Immediate ); } );
+                    break;
+
+                case METRIC_KERNEL_TYPE_COUNTER_UMUL_METRIC_UDIV:
+                    calculateBatch( [&]( const TTypedValue_1_0* delta, const TTypedValue_1_0* out, uint32_t )
+                        { return uint64Value( CalculateUInt64Operation( EQUATION_OPER_UDIV, CastToUInt64( delta[kernel.CounterIndex] ) * kernel.Immediate, CastToUInt64( out[kernel.MetricIndex] ) ) ); } );
+                    break;
+
+                case METRIC_KERNEL_TYPE_SELF_METRIC_FDIV:
+                    calculateBatch( [&]( const TTypedValue_1_0* delta, const TTypedValue_1_0* out, uint32_t )
+                        { return floatValue( CalculateFloatOperation( EQUATION_OPER_FDIV, CastToFloat( delta[metricIndex] ), CastToFloat( out[kernel.MetricIndex] ) ) ); } );
+                    break;
+
+                default:
+                    MD_ASSERT_A( m_device.GetAdapter().GetAdapterId(), false );
+                    calculateBatch( [&]( const TTypedValue_1_0*, const TTypedValue_1_0*, uint32_t )
+                        { return uint64Value( 0ULL ); } );
+                    break;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     IsBatchCalculationSupported
+        //
+        // Description:
+        //     Checks if equations of the given plan can be calculated in columns for
+        //     a batch of reports. All programs have to be validated. Normalization
+        //     equations can't use previous values of metrics that are calculated later,
+        //     and ContextId information can't use the previous context id.
+        //
+        // Input:
+        //     const TCalculationPlan& plan         - calculation plan
+        //     int32_t                 contextIdIdx - index of contextId information
+        //
+        // Output:
+        //     bool - true if batch calculation is supported
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        inline bool IsBatchCalculationSupported( const TCalculationPlan& plan, int32_t contextIdIdx )
+        {
+            auto usesInstruction = []( CEquation& equation, TEquationInstructionCode code, int32_t minMetricIndex )
+            {
+                for( const auto& instruction : equation.GetProgram() )
+                {
+                    if( instruction.Code == code && instruction.MetricIndex >= minMetricIndex )
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            };
+
+            for( const uint32_t i : plan.CalculatedMetrics )
+            {
+                if( plan.IoReadEquations[i] && !plan.IoReadEquations[i]->IsValidatedProgram( READ_AND_DELTA_EQUATION_INSTRUCTIONS ) )
+                {
+                    return false;
+                }
+
+                if( plan.NormalizationKinds[i] == NORMALIZATION_KIND_EQUATION )
+                {
+                    if( !plan.NormEquations[i]->IsValidatedProgram( NORMALIZATION_EQUATION_INSTRUCTIONS ) ||
+                        usesInstruction( *plan.NormEquations[i], EQUATION_INSTR_PREV_METRIC, static_cast<int32_t>( i ) ) )
+                    {
+                        return false;
+                    }
+                }
+
+                if( plan.MaxValueEquations[i] && !plan.MaxValueEquations[i]->IsValidatedProgram( NORMALIZATION_EQUATION_INSTRUCTIONS ) )
+                {
+                    return false;
+                }
+            }
+
+            for( uint32_t i = 0; i < plan.InformationCount; ++i )
+            {
+                CEquation* readEquation = plan.Informations[i].ReadEquation;
+
+                if( readEquation && !readEquation->IsValidatedProgram( READ_EQUATION_INSTRUCTIONS ) )
+                {
+                    return false;
+                }
+
+                if( readEquation && static_cast<int32_t>( i ) == contextIdIdx &&
+                    usesInstruction( *readEquation, EQUATION_INSTR_PREVIOUS_CONTEXT_ID, -1 ) )
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CastOperand
+        //
+        // Description:
+        //     Casts operand value to the register type of a batch program.
+        //
+        // Input:
+        //     const TTypedValue_1_0& value - operand value
+        //
+        // Output:
+        //     TValue - casted operand value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        template <typename TValue>
+        static inline TValue CastOperand( const TTypedValue_1_0& value )
+        {
+            if constexpr( std::is_same_v<TValue, uint64_t> )
+            {
+                return CastToUInt64( value );
+            }
+            else if constexpr( std::is_same_v<TValue, float> )
+            {
+                return CastToFloat( value );
+            }
+            else
+            {
+                return value;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CalculateOperationBatch
+        //
+        // Description:
+        //     Calculates the given operation for a batch of values. The operation is
+        //     a template parameter, so the loop has no branches and can be vectorized.
+        //
+        // Input:
+        //     TValue*       valuesPrev - (IN/OUT) previous values, replaced with results
+        //     const TValue* valuesLast - last (next) values
+        //     uint32_t      count      - values count
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        template <TEquationOperation operation, typename TValue>
+        static inline void CalculateOperationBatch(
+            TValue*       valuesPrev,
+            const TValue* valuesLast,
+            uint32_t      count )
+        {
+            for( uint32_t j = 0; j < count; ++j )
+            {
+                if constexpr( std::is_same_v<TValue, uint64_t> )
+                {
+                    valuesPrev[j] = CalculateUInt64Operation( operation, valuesPrev[j], valuesLast[j] );
                 }
                 else
                 {
-                    return nullptr;
+                    valuesPrev[j] = CalculateFloatOperation( operation, valuesPrev[j], valuesLast[j] );
+                }
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CalculateOperationBatch
+        //
+        // Description:
+        //     Calculates the given unsigned integer 64b operation for a batch of values.
+        //
+        // Input:
+        //     TEquationOperation operation  - operation to be calculated
+        //     uint64_t*          valuesPrev - (IN/OUT) previous values, replaced with results
+        //     const uint64_t*    valuesLast - last (next) values
+        //     uint32_t           count      - values count
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        static inline void CalculateOperationBatch(
+            TEquationOperation operation,
+            uint64_t*          valuesPrev,
+            const uint64_t*    valuesLast,
+            uint32_t           count )
+        {
+            switch( operation )
+            {
+                case EQUATION_OPER_AND:
+                    return CalculateOperationBatch<EQUATION_OPER_AND>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_OR:
+                    return CalculateOperationBatch<EQUATION_OPER_OR>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_RSHIFT:
+                    return CalculateOperationBatch<EQUATION_OPER_RSHIFT>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_LSHIFT:
+                    return CalculateOperationBatch<EQUATION_OPER_LSHIFT>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_XOR:
+                    return CalculateOperationBatch<EQUATION_OPER_XOR>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_XNOR:
+                    return CalculateOperationBatch<EQUATION_OPER_XNOR>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_UADD:
+                    return CalculateOperationBatch<EQUATION_OPER_UADD>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_USUB:
+                    return CalculateOperationBatch<EQUATION_OPER_USUB>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_UDIV:
+                    return CalculateOperationBatch<EQUATION_OPER_UDIV>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_UMUL:
+                    return CalculateOperationBatch<EQUATION_OPER_UMUL>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_UMIN:
+                    return CalculateOperationBatch<EQUATION_OPER_UMIN>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_UMAX:
+                    return CalculateOperationBatch<EQUATION_OPER_UMAX>( valuesPrev, valuesLast, count );
+                default:
+                    MD_ASSERT( false );
+                    std::fill_n( valuesPrev, count, 0ULL );
+                    return;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CalculateOperationBatch
+        //
+        // Description:
+        //     Calculates the given floating point operation for a batch of values.
+        //
+        // Input:
+        //     TEquationOperation operation  - operation to be calculated
+        //     float*             valuesPrev - (IN/OUT) previous values, replaced with results
+        //     const float*       valuesLast - last (next) values
+        //     uint32_t           count      - values count
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        static inline void CalculateOperationBatch(
+            TEquationOperation operation,
+            float*             valuesPrev,
+            const float*       valuesLast,
+            uint32_t           count )
+        {
+            switch( operation )
+            {
+                case EQUATION_OPER_FADD:
+                    return CalculateOperationBatch<EQUATION_OPER_FADD>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_FSUB:
+                    return CalculateOperationBatch<EQUATION_OPER_FSUB>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_FMUL:
+                    return CalculateOperationBatch<EQUATION_OPER_FMUL>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_FDIV:
+                    return CalculateOperationBatch<EQUATION_OPER_FDIV>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_FMIN:
+                    return CalculateOperationBatch<EQUATION_OPER_FMIN>( valuesPrev, valuesLast, count );
+                case EQUATION_OPER_FMAX:
+                    return CalculateOperationBatch<EQUATION_OPER_FMAX>( valuesPrev, valuesLast, count );
+                default:
+                    MD_ASSERT( false );
+                    std::fill_n( valuesPrev, count, 0.0f );
+                    return;
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CalculateOperationBatch
+        //
+        // Description:
+        //     Calculates the given operation for a batch of typed values.
+        //
+        // Input:
+        //     TEquationOperation     operation  - operation to be calculated
+        //     TTypedValue_1_0*       valuesPrev - (IN/OUT) previous values, replaced with results
+        //     const TTypedValue_1_0* valuesLast - last (next) values
+        //     uint32_t               count      - values count
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        static inline void CalculateOperationBatch(
+            TEquationOperation     operation,
+            TTypedValue_1_0*       valuesPrev,
+            const TTypedValue_1_0* valuesLast,
+            uint32_t               count )
+        {
+            for( uint32_t j = 0; j < count; ++j )
+            {
+                valuesPrev[j] = CalculateEquationElemOperation( operation, valuesPrev[j], valuesLast[j] );
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CalculateTypedProgramBatch
+        //
+        // Description:
+        //     Calculates a validated program for a batch of reports. Every stack entry
+        //     is a column of registers, one for each report, so every instruction is
+        //     dispatched once for the whole batch.
+        //
+        // Input:
+        //     const std::vector<TEquationInstruction>& program     - validated program
+        //     TValue*                                  registers   - MAX_STACK_DEPTH columns of registers
+        //     uint32_t                                 reportCount - reports count
+        //     TTypedValue_1_0*                         outValues   - (OUT) output value of the first report
+        //     uint32_t                                 outStride   - distance between output values of the reports
+        //     TGetOperand&                             getOperand  - returns operand value for an instruction and a report
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        template <typename TValue, typename TGetOperand>
+        inline void CalculateTypedProgramBatch(
+            const std::vector<TEquationInstruction>& program,
+            TValue*                                  registers,
+            uint32_t                                 reportCount,
+            TTypedValue_1_0*                         outValues,
+            uint32_t                                 outStride,
+            TGetOperand&                             getOperand )
+        {
+            uint32_t size = 0;
+
+            for( const auto& instruction : program )
+            {
+                TValue* column = registers + size * MD_CALCULATION_BATCH_SIZE;
+
+                if( instruction.Code == EQUATION_INSTR_OPERATION )
+                {
+                    CalculateOperationBatch( instruction.Operation, column - 2 * MD_CALCULATION_BATCH_SIZE, column - MD_CALCULATION_BATCH_SIZE, reportCount );
+                    --size;
+                }
+                else if( REPORT_INVARIANT_INSTRUCTIONS & ( 1U << instruction.Code ) )
+                {
+                    // The same value for all the reports
+                    std::fill_n( column, reportCount, CastOperand<TValue>( getOperand( instruction, 0 ) ) );
+                    ++size;
+                }
+                else
+                {
+                    for( uint32_t j = 0; j < reportCount; ++j )
+                    {
+                        column[j] = CastOperand<TValue>( getOperand( instruction, j ) );
+                    }
+                    ++size;
+                }
+            }
+
+            for( uint32_t j = 0; j < reportCount; ++j )
+            {
+                TTypedValue_1_0& typedValue = outValues[j * outStride];
+
+                if constexpr( std::is_same_v<TValue, uint64_t> )
+                {
+                    typedValue             = {};
+                    typedValue.ValueUInt64 = registers[j];
+                    typedValue.ValueType   = VALUE_TYPE_UINT64;
+                }
+                else if constexpr( std::is_same_v<TValue, float> )
+                {
+                    typedValue            = {};
+                    typedValue.ValueFloat = registers[j];
+                    typedValue.ValueType  = VALUE_TYPE_FLOAT;
+                }
+                else
+                {
+                    typedValue = registers[j];
                 }
             }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculator
+        //
+        // Method:
+        //     CalculateProgramBatch
+        //
+        // Description:
+        //     Calculates the given validated equation for a batch of reports, using
+        //     raw value registers for programs with a single operations type.
+        //
+        // Input:
+        //     CEquation&       equation    - equation to calculate
+        //     uint32_t         reportCount - reports count
+        //     TTypedValue_1_0* outValues   - (OUT) output value of the first report
+        //     uint32_t         outStride   - distance between output values of the reports
+        //     TGetOperand&&    getOperand  - returns operand value for an instruction and a report
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        template <typename TGetOperand>
+        inline void CalculateProgramBatch(
+            CEquation&       equation,
+            uint32_t         reportCount,
+            TTypedValue_1_0* outValues,
+            uint32_t         outStride,
+            TGetOperand&&    getOperand )
+        {
+            TEquationProgramType programType = EQUATION_PROGRAM_TYPE_MIXED;
+            const auto&          program     = m_symbols.GetEquationProgram( equation, programType );
 
-            return m_device.GetGlobalSymbolValueByName( symbolName );
+            switch( programType )
+            {
+                case EQUATION_PROGRAM_TYPE_UINT64:
+                    CalculateTypedProgramBatch( program, m_batchRegistersUInt64.data(), reportCount, outValues, outStride, getOperand );
+                    break;
+
+                case EQUATION_PROGRAM_TYPE_FLOAT:
+                    CalculateTypedProgramBatch( program, m_batchRegistersFloat.data(), reportCount, outValues, outStride, getOperand );
+                    break;
+
+                default:
+                    CalculateTypedProgramBatch( program, m_batchRegisters.data(), reportCount, outValues, outStride, getOperand );
+                    break;
+            }
         }
 
         //////////////////////////////////////////////////////////////////////////////
@@ -1279,125 +4417,32 @@ namespace MetricsDiscoveryInternal
             CEquation&     equation,
             const uint8_t* rawReport )
         {
+            TEquationProgramType programType = EQUATION_PROGRAM_TYPE_MIXED;
+            const auto&          program     = m_symbols.GetEquationProgram( equation, programType );
+
+            if( equation.IsValidatedProgram( READ_EQUATION_INSTRUCTIONS ) )
+            {
+                return CalculateValidatedProgram( program, programType, m_readEquationStack, [&]( const TEquationInstruction& instruction )
+                    { return GetReadEquationOperand( instruction, rawReport ); } );
+            }
+
             const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
 
             TTypedValue_1_0 typedValue     = {};
             bool            isValid        = true;
             uint32_t        algorithmCheck = 0;
 
-            ClearStack( m_readEquationStack );
-            const auto&    equationElements      = equation.GetElementsVector();
-            const uint32_t equationElementsCount = static_cast<uint32_t>( equationElements.size() );
-            for( uint32_t i = 0; i < equationElementsCount && isValid; ++i )
+            m_readEquationStack.Reserve( equation.GetMaxStackDepth() );
+            m_readEquationStack.Clear();
+            const size_t instructionsCount = program.size();
+            for( size_t i = 0; i < instructionsCount && isValid; ++i )
             {
-                const auto& element = equationElements[i];
-                switch( element.Type )
+                const auto& instruction = program[i];
+                switch( instruction.Code )
                 {
-                    case EQUATION_ELEM_RD_BITFIELD:
-                        typedValue.ValueUInt64 = ReadBitfield( (const uint8_t*) ( rawReport + element.ReadParams.ByteOffset ), element.ReadParams.BitOffset, element.ReadParams.BitsCount );
-                        typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        isValid                = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_RD_UINT8:
-                    {
-                        uint8_t byteValue      = *( (const uint8_t*) ( rawReport + element.ReadParams.ByteOffset ) );
-                        typedValue.ValueUInt64 = (uint64_t) byteValue;
-                        typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        isValid                = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
-                        break;
-                    }
-
-                    case EQUATION_ELEM_RD_UINT16:
-                    {
-                        uint16_t shortValue    = *( (const uint16_t*) ( rawReport + element.ReadParams.ByteOffset ) );
-                        typedValue.ValueUInt64 = (uint64_t) shortValue;
-                        typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        isValid                = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
-                        break;
-                    }
-
-                    case EQUATION_ELEM_RD_UINT32:
-                    {
-                        uint32_t dwordValue    = *( (const uint32_t*) ( rawReport + element.ReadParams.ByteOffset ) );
-                        typedValue.ValueUInt64 = (uint64_t) dwordValue;
-                        typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        isValid                = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
-                        break;
-                    }
-
-                    case EQUATION_ELEM_RD_UINT64:
-                        typedValue.ValueUInt64 = *( (const uint64_t*) ( rawReport + element.ReadParams.ByteOffset ) );
-                        typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        isValid                = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_RD_FLOAT:
-                        typedValue.ValueFloat = *( (const float*) ( rawReport + element.ReadParams.ByteOffset ) );
-                        typedValue.ValueType  = VALUE_TYPE_FLOAT;
-                        isValid               = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_RD_40BIT_CNTR:
-                    {
-                        TLargeInteger largeValue;
-                        largeValue.u.LowPart   = *( (const uint32_t*) ( rawReport + element.ReadParams.ByteOffset ) );
-                        largeValue.u.HighPart  = (int32_t) *( (const uint8_t*) ( rawReport + element.ReadParams.ByteOffsetExt ) );
-                        typedValue.ValueUInt64 = static_cast<uint64_t>( largeValue.QuadPart );
-                        typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        isValid                = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
-                        break;
-                    }
-
-                    case EQUATION_ELEM_IMM_UINT64:
-                        typedValue.ValueUInt64 = element.ImmediateUInt64;
-                        typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        isValid                = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_IMM_FLOAT:
-                        typedValue.ValueFloat = element.ImmediateFloat;
-                        typedValue.ValueType  = VALUE_TYPE_FLOAT;
-                        isValid               = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_GLOBAL_SYMBOL:
-                    {
-                        TTypedValue_1_0* pValue = GetGlobalSymbolValue( element.SymbolName );
-                        if( pValue )
-                        {
-                            typedValue = *pValue;
-                        }
-                        else
-                        {
-                            typedValue.ValueUInt64 = 0;
-                            typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        }
-                        isValid = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
-                        break;
-                    }
-
-                    case EQUATION_ELEM_INFORMATION_SYMBOL:
-                    {
-                        if( std::string_view( element.SymbolName ) == "PreviousContextId" )
-                        {
-                            // Return cached context ID from the previous report
-                            typedValue.ValueUInt64 = m_contextIdPrev;
-                        }
-                        else
-                        {
-                            // TODO: not supported yet
-                            typedValue.ValueUInt64 = 0;
-                            MD_ASSERT_A( adapterId, false );
-                        }
-                        typedValue.ValueType = VALUE_TYPE_UINT64;
-                        isValid              = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
-                        break;
-                    }
-
-                    case EQUATION_ELEM_OPERATION:
+                    case EQUATION_INSTR_OPERATION:
                     {
-                        if( m_readEquationStack.size() < 2 )
+                        if( m_readEquationStack.GetSize() < 2 )
                         {
                             MD_LOG_A( adapterId, LOG_DEBUG, "Not enough elements in equationStack, size is less than 2." );
                             typedValue = {};
@@ -1405,42 +4450,26 @@ namespace MetricsDiscoveryInternal
                         }
 
                         // Pop two values from stack
-                        TTypedValue_1_0 valueLast = m_readEquationStack.top();
-                        m_readEquationStack.pop();
+                        TTypedValue_1_0 valueLast = m_readEquationStack.Pop();
                         algorithmCheck--;
-                        TTypedValue_1_0 valuePrev = m_readEquationStack.top();
-                        m_readEquationStack.pop();
+                        TTypedValue_1_0 valuePrev = m_readEquationStack.Pop();
                         algorithmCheck--;
 
-                        typedValue = CalculateEquationElemOperation( element.Operation, valuePrev, valueLast );
+                        typedValue = CalculateEquationElemOperation( instruction.Operation, valuePrev, valueLast );
                         isValid    = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
                         break;
                     }
 
-                    case EQUATION_ELEM_LOCAL_COUNTER_SYMBOL:
-                        if( m_gpuCoreClocks != 0 && std::string_view( element.SymbolName ) == "GpuCoreClocks" )
+                    default:
+                        if( READ_EQUATION_INSTRUCTIONS & ( 1U << instruction.Code ) )
                         {
-                            typedValue.ValueUInt64 = m_gpuCoreClocks;
-                            typedValue.ValueType   = VALUE_TYPE_UINT64;
-                            isValid                = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
-                            break;
+                            typedValue = GetReadEquationOperand( instruction, rawReport );
+                            isValid    = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
                         }
-
-                        typedValue.ValueUInt64 = 0LL;
-                        typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        isValid                = EquationStackPush( m_readEquationStack, typedValue, algorithmCheck );
-
-                        if( IsPlatformMatch( m_device.GetPlatformIndex(), GENERATION_ACM, GENERATION_PVC, GENERATION_MTL, GENERATION_ARL ) &&
-                            strstr( element.SymbolName, "GtSlice" ) != nullptr )
+                        else
                         {
-                            // Exception for missing global symbols (GtSlice[X]XeCore[Y]) in read equations.
-                            break;
+                            MD_ASSERT_A( adapterId, false );
                         }
-                        // Asserts, because this is not a valid condition
-                        [[fallthrough]];
-
-                    default:
-                        MD_ASSERT_A( adapterId, false );
                         break;
                 }
             }
@@ -1449,8 +4478,7 @@ namespace MetricsDiscoveryInternal
 
             if( isValid && algorithmCheck == 1 )
             {
-                typedValue = m_readEquationStack.top();
-                m_readEquationStack.pop();
+                typedValue = m_readEquationStack.Pop();
             }
             else
             {
@@ -1471,388 +4499,87 @@ namespace MetricsDiscoveryInternal
         //
         // Description:
         //     Calculates the given read equation using delta function directly after reading
-        //     raw offsets.
+        //     raw offsets. Given column deltas are taken as they are, they aren't wrapped
+        //     to the delta function bits count, so they may be longer than one wrap period.
         //
         // Input:
-        //     IEquation_1_0*     equation       - read equation to calculate
-        //     TDeltaFunction_1_0 deltaFunction  - delta function to use during calculations
-        //     const uint8_t*     pRawReportLast - (IN) last (next) single raw report
-        //     const uint8_t*     pRawReportPrev - (IN) previous single raw report
+        //     IEquation_1_0*       equation       - read equation to calculate
+        //     TDeltaFunction_1_0   deltaFunction  - delta function to use during calculations
+        //     const TReportLayout& reportLayout   - report counter regions with deltas calculated at once
+        //     const uint8_t*       pRawReportLast - (IN) last (next) single raw report
+        //     const uint8_t*       pRawReportPrev - (IN) previous single raw report
+        //     const uint64_t*      columnDeltas   - (IN - optional) per report column, see TReportColumn
         //
         // Output:
         //     TTypedValue_1_0 - output read value
         //
         //////////////////////////////////////////////////////////////////////////////
         inline TTypedValue_1_0 CalculateReadEquationAndDelta(
-            CEquation&         equation,
-            TDeltaFunction_1_0 deltaFunction,
-            const uint8_t*     pRawReportLast,
-            const uint8_t*     pRawReportPrev )
+            CEquation&           equation,
+            TDeltaFunction_1_0   deltaFunction,
+            const TReportLayout& reportLayout,
+            const uint8_t*       pRawReportLast,
+            const uint8_t*       pRawReportPrev,
+            const uint64_t*      columnDeltas = nullptr )
         {
-            TTypedValue_1_0    typedValue, typedValuePrev, typedValueLast;
-            TDeltaFunction_1_0 readDeltaFunction;
-            // As we calculate delta when reading operands DELTA_NS_TIME works as a normal DELTA_32 or DELTA_56
-            if( deltaFunction.FunctionType == DELTA_NS_TIME )
-            {
-                readDeltaFunction.FunctionType = DELTA_N_BITS;
-
-                switch( m_device.GetPlatformIndex() )
-                {
-                    case GENERATION_BMG:
-                    case GENERATION_LNL:
-                    case GENERATION_PTL:
-                    case GENERATION_NVL:
-                    case GENERATION_NVLP:
-                    case GENERATION_CRI:
-                        readDeltaFunction.BitsCount = 56;
-                        break;
-                    default:
-                        readDeltaFunction.BitsCount = 32;
-                        break;
-                }
-            }
-            else
-            {
-                readDeltaFunction = deltaFunction;
-            }
-
-            const uint32_t adapterId      = m_device.GetAdapter().GetAdapterId();
-            bool           isValid        = true;
-            uint32_t       algorithmCheck = 0;
+            TTypedValue_1_0          typedValue        = {};
+            const TDeltaFunction_1_0 readDeltaFunction = GetReadDeltaFunction( deltaFunction );
 
-            ClearStack( m_readEquationAndDeltaStack );
-            const auto&    equationElements      = equation.GetElementsVector();
-            const uint32_t equationElementsCount = static_cast<uint32_t>( equationElements.size() );
-            for( uint32_t i = 0; i < equationElementsCount && isValid; ++i )
+            auto getOperand = [&]( const TEquationInstruction& instruction )
             {
-                const auto& element = equationElements[i];
-                switch( element.Type )
+                if( READ_INSTRUCTIONS & ( 1U << instruction.Code ) )
                 {
-                    case EQUATION_ELEM_RD_BITFIELD:
-
-                        typedValuePrev.ValueUInt64 = ReadBitfield( pRawReportPrev + element.ReadParams.ByteOffset, element.ReadParams.BitOffset, element.ReadParams.BitsCount );
-                        typedValuePrev.ValueType   = VALUE_TYPE_UINT64;
-
-                        typedValueLast.ValueUInt64 = ReadBitfield( pRawReportLast + element.ReadParams.ByteOffset, element.ReadParams.BitOffset, element.ReadParams.BitsCount );
-                        typedValueLast.ValueType   = VALUE_TYPE_UINT64;
-
-                        typedValue = CalculateDeltaFunction( readDeltaFunction, typedValueLast, typedValuePrev );
-                        isValid    = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_RD_UINT8:
-                        typedValuePrev.ValueUInt64 =
-                            (uint64_t) *( (const uint8_t*) ( pRawReportPrev + element.ReadParams.ByteOffset ) );
-                        typedValuePrev.ValueType = VALUE_TYPE_UINT64;
+                    TTypedValue_1_0 reportDelta = {};
 
-                        typedValueLast.ValueUInt64 =
-                            (uint64_t) *( (const uint8_t*) ( pRawReportLast + element.ReadParams.ByteOffset ) );
-                        typedValueLast.ValueType = VALUE_TYPE_UINT64;
-
-                        typedValue = CalculateDeltaFunction( readDeltaFunction, typedValueLast, typedValuePrev );
-                        isValid    = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_RD_UINT16:
-                        typedValuePrev.ValueUInt64 =
-                            (uint64_t) *( (const uint16_t*) ( pRawReportPrev + element.ReadParams.ByteOffset ) );
-                        typedValuePrev.ValueType = VALUE_TYPE_UINT64;
-
-                        typedValueLast.ValueUInt64 =
-                            (uint64_t) *( (const uint16_t*) ( pRawReportLast + element.ReadParams.ByteOffset ) );
-                        typedValueLast.ValueType = VALUE_TYPE_UINT64;
-
-                        typedValue = CalculateDeltaFunction( readDeltaFunction, typedValueLast, typedValuePrev );
-                        isValid    = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_RD_UINT32:
-                        typedValuePrev.ValueUInt64 =
-                            (uint64_t) *( (const uint32_t*) ( pRawReportPrev + element.ReadParams.ByteOffset ) );
-                        typedValuePrev.ValueType = VALUE_TYPE_UINT64;
-
-                        typedValueLast.ValueUInt64 =
-                            (uint64_t) *( (const uint32_t*) ( pRawReportLast + element.ReadParams.ByteOffset ) );
-                        typedValueLast.ValueType = VALUE_TYPE_UINT64;
-
-                        typedValue = CalculateDeltaFunction( readDeltaFunction, typedValueLast, typedValuePrev );
-                        isValid    = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_RD_UINT64:
-                        typedValuePrev.ValueUInt64 = *( (const uint64_t*) ( pRawReportPrev + element.ReadParams.ByteOffset ) );
-                        typedValuePrev.ValueType   = VALUE_TYPE_UINT64;
-
-                        typedValueLast.ValueUInt64 = *( (const uint64_t*) ( pRawReportLast + element.ReadParams.ByteOffset ) );
-                        typedValueLast.ValueType   = VALUE_TYPE_UINT64;
-
-                        typedValue = CalculateDeltaFunction( readDeltaFunction, typedValueLast, typedValuePrev );
-                        isValid    = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_RD_FLOAT:
-                        typedValuePrev.ValueFloat = *( (const float*) ( pRawReportPrev + element.ReadParams.ByteOffset ) );
-                        typedValuePrev.ValueType  = VALUE_TYPE_FLOAT;
-
-                        typedValueLast.ValueFloat = *( (const float*) ( pRawReportLast + element.ReadParams.ByteOffset ) );
-                        typedValueLast.ValueType  = VALUE_TYPE_FLOAT;
-
-                        typedValue = CalculateDeltaFunction( readDeltaFunction, typedValueLast, typedValuePrev );
-                        isValid    = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_RD_40BIT_CNTR:
+                    if( columnDeltas != nullptr && readDeltaFunction.FunctionType == DELTA_N_BITS )
                     {
-                        TLargeInteger largeValue;
-                        largeValue.u.LowPart       = *( (const uint32_t*) ( pRawReportPrev + element.ReadParams.ByteOffset ) );
-                        largeValue.u.HighPart      = (int32_t) *( (const uint8_t*) ( pRawReportPrev + element.ReadParams.ByteOffsetExt ) );
-                        typedValuePrev.ValueUInt64 = static_cast<uint64_t>( largeValue.QuadPart );
-                        typedValuePrev.ValueType   = VALUE_TYPE_UINT64;
-
-                        largeValue.u.LowPart       = *( (const uint32_t*) ( pRawReportLast + element.ReadParams.ByteOffset ) );
-                        largeValue.u.HighPart      = (int32_t) *( (const uint8_t*) ( pRawReportLast + element.ReadParams.ByteOffsetExt ) );
-                        typedValueLast.ValueUInt64 = static_cast<uint64_t>( largeValue.QuadPart );
-                        typedValueLast.ValueType   = VALUE_TYPE_UINT64;
-
-                        typedValue = CalculateDeltaFunction( readDeltaFunction, typedValueLast, typedValuePrev );
-                        isValid    = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
-                        break;
-                    }
-
-                    case EQUATION_ELEM_IMM_UINT64:
-                        typedValue.ValueUInt64 = element.ImmediateUInt64;
-                        typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        isValid                = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_IMM_FLOAT:
-                        typedValue.ValueFloat = element.ImmediateFloat;
-                        typedValue.ValueType  = VALUE_TYPE_FLOAT;
-                        isValid               = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
-                        break;
+                        const int32_t column = GetReportColumn( instruction, reportLayout );
 
-                    case EQUATION_ELEM_GLOBAL_SYMBOL:
-                    {
-                        TTypedValue_1_0* pValue = GetGlobalSymbolValue( element.SymbolName );
-                        if( pValue )
+                        if( column >= 0 )
                         {
-                            typedValue = *pValue;
+                            reportDelta.ValueType   = VALUE_TYPE_UINT64;
+                            reportDelta.ValueUInt64 = columnDeltas[column];
+                            return reportDelta;
                         }
-                        else
-                        {
-                            typedValue.ValueUInt64 = 0LL;
-                            typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        }
-                        isValid = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
-                        break;
                     }
 
-                    case EQUATION_ELEM_OPERATION:
+                    if( GetReportDelta( instruction, readDeltaFunction, reportLayout, pRawReportLast, pRawReportPrev, reportDelta ) )
                     {
-                        if( m_readEquationAndDeltaStack.size() < 2 )
-                        {
-                            MD_LOG_A( adapterId, LOG_DEBUG, "Not enough elements in equationStack, size is less than 2." );
-                            typedValue = {};
-                            return typedValue;
-                        }
-
-                        // Pop two values from stack
-                        TTypedValue_1_0 valueLast = m_readEquationAndDeltaStack.top();
-                        m_readEquationAndDeltaStack.pop();
-                        algorithmCheck--;
-                        TTypedValue_1_0 valuePrev = m_readEquationAndDeltaStack.top();
-                        m_readEquationAndDeltaStack.pop();
-                        algorithmCheck--;
-
-                        typedValue = CalculateEquationElemOperation( element.Operation, valuePrev, valueLast );
-                        isValid    = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
-                        break;
+                        return reportDelta;
                     }
 
-                    case EQUATION_ELEM_LOCAL_COUNTER_SYMBOL:
-                        if( m_gpuCoreClocks != 0 && std::string_view( element.SymbolName ) == "GpuCoreClocks" )
-                        {
-                            typedValue.ValueUInt64 = m_gpuCoreClocks;
-                            typedValue.ValueType   = VALUE_TYPE_UINT64;
-                            isValid                = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
-                            break;
-                        }
-
-                        typedValue.ValueUInt64 = 0LL;
-                        typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        isValid                = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
-
-                        if( IsPlatformMatch( m_device.GetPlatformIndex(), GENERATION_ACM, GENERATION_PVC, GENERATION_MTL, GENERATION_ARL ) &&
-                            strstr( element.SymbolName, "GtSlice" ) != nullptr )
-                        {
-                            // Exception for missing global symbols (GtSlice[X]XeCore[Y]) in read equations.
-                            break;
-                        }
-                        // Asserts, because this is not a valid condition
-                        [[fallthrough]];
+                    const TTypedValue_1_0 typedValuePrev = ReadInstructionValue( instruction, pRawReportPrev );
+                    const TTypedValue_1_0 typedValueLast = ReadInstructionValue( instruction, pRawReportLast );
 
-                    default:
-                        MD_ASSERT_A( adapterId, false );
-                        break;
+                    return CalculateDeltaFunction( readDeltaFunction, typedValueLast, typedValuePrev );
                 }
-            }
-            // here should be only 1 element on the list - the result (if the equation is fine)
-            MD_ASSERT_A( adapterId, algorithmCheck == 1 );
-
-            if( isValid && algorithmCheck == 1 )
-            {
-                typedValue = m_readEquationAndDeltaStack.top();
-                m_readEquationAndDeltaStack.pop();
-            }
-            else
-            {
-                typedValue.ValueUInt64 = 0LL;
-                typedValue.ValueType   = VALUE_TYPE_UINT64;
-            }
-
-            return typedValue;
-        }
-
-        //////////////////////////////////////////////////////////////////////////////
-        //
-        // Class:
-        //     CMetricsCalculator
-        //
-        // Method:
-        //     CalculateLocalNormalizationEquation
-        //
-        // Description:
-        //     Calculates the given normalization equation.
-        //
-        // Input:
-        //     IEquation_1_0*   equation         - (IN) normalization equation to be calculated
-        //     TTypedValue_1_0* deltaValues      - (IN) previously calculated / read delta values
-        //     TTypedValue_1_0* outValues        - (IN) so far normalized values (metrics with lower indices)
-        //     CMetricSet*      metricSet        - MetricSet for calculation
-        //     uint32_t         currentMetricIdx - index of the currently calculated metric
-        //
-        // Output:
-        //     TTypedValue_1_0 - output normalized value
-        //
-        //////////////////////////////////////////////////////////////////////////////
-        inline TTypedValue_1_0 CalculateLocalNormalizationEquation(
-            CEquation&       equation,
-            TTypedValue_1_0* deltaValues,
-            TTypedValue_1_0* outValues,
-            uint32_t         metricIndex )
-        {
-            const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
-
-            TTypedValue_1_0 typedValue     = {};
-            bool            isValid        = true;
-            uint32_t        algorithmCheck = 0;
-
-            ClearStack( m_normalizationEquationStack );
-            const auto&    equationElements      = equation.GetElementsVector();
-            const uint32_t equationElementsCount = static_cast<uint32_t>( equationElements.size() );
-            for( uint32_t i = 0; i < equationElementsCount && isValid; ++i )
-            {
-                const auto& element = equationElements[i];
-                switch( element.Type )
-                {
-                    case EQUATION_ELEM_RD_BITFIELD:
-                    case EQUATION_ELEM_RD_UINT8:
-                    case EQUATION_ELEM_RD_UINT16:
-                    case EQUATION_ELEM_RD_UINT32:
-                    case EQUATION_ELEM_RD_UINT64:
-                    case EQUATION_ELEM_RD_FLOAT:
-                    case EQUATION_ELEM_RD_40BIT_CNTR:
-                        // Not allowed in norm equation
-                        break;
-
-                    case EQUATION_ELEM_IMM_FLOAT:
-                        typedValue.ValueFloat = element.ImmediateFloat;
-                        typedValue.ValueType  = VALUE_TYPE_FLOAT;
-                        isValid               = EquationStackPush( m_normalizationEquationStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_IMM_UINT64:
-                        typedValue.ValueUInt64 = element.ImmediateUInt64;
-                        typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        isValid                = EquationStackPush( m_normalizationEquationStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_SELF_COUNTER_VALUE:
-                        // Get result of delta equation
-                        typedValue = deltaValues[metricIndex];
-                        isValid    = EquationStackPush( m_normalizationEquationStack, typedValue, algorithmCheck );
-                        break;
-
-                    case EQUATION_ELEM_LOCAL_COUNTER_SYMBOL:
-                    {
-                        // The index is higher than or equals 0 if the symbol name was found, otherwise it equals -1
-                        if( equationElements[i].MetricIndexInternal >= 0 )
-                        {
-                            typedValue = deltaValues[equationElements[i].MetricIndexInternal];
-                        }
-                        else
-                        {
-                            typedValue.ValueUInt64 = 0;
-                            typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        }
-
-                        isValid = EquationStackPush( m_normalizationEquationStack, typedValue, algorithmCheck );
-                        break;
-                    }
-
-                    case EQUATION_ELEM_LOCAL_METRIC_SYMBOL:
-                    {
-                        // The index is higher than or equals 0 if the symbol name was found, otherwise it equals -1
-                        if( equationElements[i].MetricIndexInternal >= 0 )
-                        {
-                            typedValue = outValues[equationElements[i].MetricIndexInternal];
-                        }
-                        else
-                        {
-                            typedValue.ValueUInt64 = 0;
-                            typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        }
-
-                        isValid = EquationStackPush( m_normalizationEquationStack, typedValue, algorithmCheck );
-                        break;
-                    }
 
-                    case EQUATION_ELEM_PREV_METRIC_SYMBOL:
-                    {
-                        // The index is higher than or equals 0 if the symbol name was found, otherwise it equals -1
-                        if( m_prevValues && equationElements[i].MetricIndexInternal >= 0 )
-                        {
-                            typedValue = m_prevValues[equationElements[i].MetricIndexInternal];
-                        }
-                        else
-                        {
-                            typedValue.ValueUInt64 = 0;
-                            typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        }
+                return GetReadEquationOperand( instruction, nullptr );
+            };
 
-                        isValid = EquationStackPush( m_normalizationEquationStack, typedValue, algorithmCheck );
-                        break;
-                    }
+            TEquationProgramType programType = EQUATION_PROGRAM_TYPE_MIXED;
+            const auto&          program     = m_symbols.GetEquationProgram( equation, programType );
 
-                    case EQUATION_ELEM_GLOBAL_SYMBOL:
-                    {
-                        TTypedValue_1_0* pValue = GetGlobalSymbolValue( element.SymbolName );
-                        if( pValue )
-                        {
-                            typedValue = *pValue;
-                        }
-                        else
-                        {
-                            typedValue.ValueUInt64 = 0;
-                            typedValue.ValueType   = VALUE_TYPE_UINT64;
-                        }
-                        isValid = EquationStackPush( m_normalizationEquationStack, typedValue, algorithmCheck );
-                        break;
-                    }
+            if( equation.IsValidatedProgram( READ_AND_DELTA_EQUATION_INSTRUCTIONS ) )
+            {
+                return CalculateValidatedProgram( program, programType, m_readEquationAndDeltaStack, getOperand );
+            }
+
+            const uint32_t adapterId      = m_device.GetAdapter().GetAdapterId();
+            bool           isValid        = true;
+            uint32_t       algorithmCheck = 0;
 
-                    case EQUATION_ELEM_OPERATION:
+            m_readEquationAndDeltaStack.Reserve( equation.GetMaxStackDepth() );
+            m_readEquationAndDeltaStack.Clear();
+            const size_t instructionsCount = program.size();
+            for( size_t i = 0; i < instructionsCount && isValid; ++i )
+            {
+                const auto& instruction = program[i];
+                switch( instruction.Code )
+                {
+                    case EQUATION_INSTR_OPERATION:
                     {
-                        if( m_normalizationEquationStack.size() < 2 )
+                        if( m_readEquationAndDeltaStack.GetSize() < 2 )
                         {
                             MD_LOG_A( adapterId, LOG_DEBUG, "Not enough elements in equationStack, size is less than 2." );
                             typedValue = {};
@@ -1860,65 +4587,26 @@ namespace MetricsDiscoveryInternal
                         }
 
                         // Pop two values from stack
-                        TTypedValue_1_0 valueLast = m_normalizationEquationStack.top();
-                        m_normalizationEquationStack.pop();
+                        TTypedValue_1_0 valueLast = m_readEquationAndDeltaStack.Pop();
                         algorithmCheck--;
-                        TTypedValue_1_0 valuePrev = m_normalizationEquationStack.top();
-                        m_normalizationEquationStack.pop();
+                        TTypedValue_1_0 valuePrev = m_readEquationAndDeltaStack.Pop();
                         algorithmCheck--;
 
-                        typedValue = CalculateEquationElemOperation( element.Operation, valuePrev, valueLast );
-                        isValid    = EquationStackPush( m_normalizationEquationStack, typedValue, algorithmCheck );
+                        typedValue = CalculateEquationElemOperation( instruction.Operation, valuePrev, valueLast );
+                        isValid    = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
                         break;
                     }
 
-                    case EQUATION_ELEM_STD_NORM_GPU_DURATION:
-                        // equation stack should be empty
-                        MD_ASSERT_A( adapterId, algorithmCheck == 0 );
-
-                        // compute $Self $gpuCoreClocks FDIV 100 FMUL
-                        if( m_gpuCoreClocks != 0 )
-                        {
-                            const float self          = CastToFloat( deltaValues[metricIndex] );
-                            const float gpuCoreClocks = static_cast<float>( m_gpuCoreClocks );
-
-                            typedValue.ValueFloat = 100.0f * self / gpuCoreClocks;
-                            typedValue.ValueType  = VALUE_TYPE_FLOAT;
-                            return typedValue;
-                        }
-                        else
-                        {
-                            // Warning: GpuCoreClocks is 0
-                            typedValue.ValueFloat = 0.0f;
-                            typedValue.ValueType  = VALUE_TYPE_FLOAT;
-                            return typedValue;
-                        }
-
-                    case EQUATION_ELEM_STD_NORM_EU_AGGR_DURATION:
-                        // equation stack should be empty
-                        MD_ASSERT_A( adapterId, algorithmCheck == 0 );
-                        // m_euCoresCount is needed here
-                        MD_ASSERT_A( adapterId, m_euCoresCount != 0 );
-
-                        // compute $Self $gpuCoreClocks $EUsCount UMUL FDIV 100 FMUL
-                        if( m_gpuCoreClocks != 0 && m_euCoresCount != 0 )
+                    default:
+                        if( READ_AND_DELTA_EQUATION_INSTRUCTIONS & ( 1U << instruction.Code ) )
                         {
-                            const float self          = CastToFloat( deltaValues[metricIndex] );
-                            const float gpuCoreClocks = static_cast<float>( m_gpuCoreClocks * m_euCoresCount );
-
-                            typedValue.ValueFloat = 100.0f * self / gpuCoreClocks;
-                            typedValue.ValueType  = VALUE_TYPE_FLOAT;
-                            return typedValue;
+                            typedValue = getOperand( instruction );
+                            isValid    = EquationStackPush( m_readEquationAndDeltaStack, typedValue, algorithmCheck );
                         }
                         else
                         {
-                            // Warning: GpuCoreClocks or euCoresCount is 0
-                            typedValue.ValueFloat = 0.0f;
-                            typedValue.ValueType  = VALUE_TYPE_FLOAT;
-                            return typedValue;
+                            MD_ASSERT_A( adapterId, false );
                         }
-
-                    default:
                         break;
                 }
             }
@@ -1927,12 +4615,11 @@ namespace MetricsDiscoveryInternal
 
             if( isValid && algorithmCheck == 1 )
             {
-                typedValue = m_normalizationEquationStack.top();
-                m_normalizationEquationStack.pop();
+                typedValue = m_readEquationAndDeltaStack.Pop();
             }
             else
             {
-                typedValue.ValueUInt64 = 0;
+                typedValue.ValueUInt64 = 0LL;
                 typedValue.ValueType   = VALUE_TYPE_UINT64;
             }
 
@@ -1945,180 +4632,101 @@ namespace MetricsDiscoveryInternal
         //     CMetricsCalculator
         //
         // Method:
-        //     CalculateEquationElemOperation
+        //     CalculateLocalNormalizationEquation
         //
         // Description:
-        //     Calculates the given equation operation.
+        //     Calculates the given normalization equation.
         //
         // Input:
-        //     TEquationOperation     operation - operation to be calculated
-        //     const TTypedValue_1_0& valuePrev - (IN) previous value
-        //     const TTypedValue_1_0& valueLast - (IN) last (next) value
+        //     IEquation_1_0*   equation         - (IN) normalization equation to be calculated
+        //     TTypedValue_1_0* deltaValues      - (IN) previously calculated / read delta values
+        //     TTypedValue_1_0* outValues        - (IN) so far normalized values (metrics with lower indices)
+        //     CMetricSet*      metricSet        - MetricSet for calculation
+        //     uint32_t         currentMetricIdx - index of the currently calculated metric
         //
         // Output:
-        //     TTypedValue_1_0 - output calculated value
+        //     TTypedValue_1_0 - output normalized value
         //
         //////////////////////////////////////////////////////////////////////////////
-        inline TTypedValue_1_0 CalculateEquationElemOperation(
-            TEquationOperation     operation,
-            const TTypedValue_1_0& valuePrev,
-            const TTypedValue_1_0& valueLast )
+        inline TTypedValue_1_0 CalculateLocalNormalizationEquation(
+            CEquation&       equation,
+            TTypedValue_1_0* deltaValues,
+            TTypedValue_1_0* outValues,
+            uint32_t         metricIndex )
         {
-            TTypedValue_1_0 value = {};
-            value.ValueType       = VALUE_TYPE_UINT64;
-            value.ValueUInt64     = 0ULL;
+            TEquationProgramType programType = EQUATION_PROGRAM_TYPE_MIXED;
+            const auto&          program     = m_symbols.GetEquationProgram( equation, programType );
 
-            switch( operation )
+            if( equation.IsValidatedProgram( NORMALIZATION_EQUATION_INSTRUCTIONS ) )
             {
-                case EQUATION_OPER_AND:
-                    value.ValueUInt64 = CastToUInt64( valuePrev ) & CastToUInt64( valueLast );
-                    break;
-
-                case EQUATION_OPER_OR:
-                    value.ValueUInt64 = CastToUInt64( valuePrev ) | CastToUInt64( valueLast );
-                    break;
-
-                case EQUATION_OPER_RSHIFT:
-                    value.ValueUInt64 = CastToUInt64( valuePrev ) >> CastToUInt64( valueLast );
-                    break;
-
-                case EQUATION_OPER_LSHIFT:
-                    value.ValueUInt64 = CastToUInt64( valuePrev ) << CastToUInt64( valueLast );
-                    break;
-
-                case EQUATION_OPER_XOR:
-                    value.ValueUInt64 = CastToUInt64( valuePrev ) ^ CastToUInt64( valueLast );
-                    break;
-
-                case EQUATION_OPER_XNOR:
-                    value.ValueUInt64 = ~( CastToUInt64( valuePrev ) ^ CastToUInt64( valueLast ) );
-                    break;
-
-                case EQUATION_OPER_AND_L:
-                    value.ValueBool = CastToUInt64( valuePrev ) && CastToUInt64( valueLast );
-                    value.ValueType = VALUE_TYPE_BOOL;
-                    break;
-
-                case EQUATION_OPER_EQUALS:
-                    value.ValueBool = CastToUInt64( valuePrev ) == CastToUInt64( valueLast );
-                    value.ValueType = VALUE_TYPE_BOOL;
-                    break;
+                return CalculateValidatedProgram( program, programType, m_normalizationEquationStack, [&]( const TEquationInstruction& instruction )
+                    { return GetNormalizationEquationOperand( instruction, deltaValues, outValues, metricIndex ); } );
+            }
 
-                case EQUATION_OPER_UADD:
-                    value.ValueUInt64 = CastToUInt64( valuePrev ) + CastToUInt64( valueLast );
-                    break;
+            const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
 
-                case EQUATION_OPER_USUB:
-                    value.ValueUInt64 = CastToUInt64( valuePrev ) - CastToUInt64( valueLast );
-                    break;
+            TTypedValue_1_0 typedValue     = {};
+            bool            isValid        = true;
+            uint32_t        algorithmCheck = 0;
 
-                case EQUATION_OPER_UDIV:
+            m_normalizationEquationStack.Reserve( equation.GetMaxStackDepth() );
+            m_normalizationEquationStack.Clear();
+            const size_t instructionsCount = program.size();
+            for( size_t i = 0; i < instructionsCount && isValid; ++i )
+            {
+                const auto& instruction = program[i];
+                switch( instruction.Code )
                 {
-                    const uint64_t valueLastUint64 = CastToUInt64( valueLast );
-                    value.ValueUInt64              = valueLastUint64 != 0ULL
-                                     ? CastToUInt64( valuePrev ) / valueLastUint64
-                                     : 0ULL;
-                    break;
-                }
-
-                case EQUATION_OPER_UMUL:
-                    value.ValueUInt64 = CastToUInt64( valuePrev ) * CastToUInt64( valueLast );
-
-                    break;
+                    case EQUATION_INSTR_OPERATION:
+                    {
+                        if( m_normalizationEquationStack.GetSize() < 2 )
+                        {
+                            MD_LOG_A( adapterId, LOG_DEBUG, "Not enough elements in equationStack, size is less than 2." );
+                            typedValue = {};
+                            return typedValue;
+                        }
 
-                case EQUATION_OPER_FADD:
-                    value.ValueFloat = CastToFloat( valuePrev ) + CastToFloat( valueLast );
-                    value.ValueType  = VALUE_TYPE_FLOAT;
-                    break;
+                        // Pop two values from stack
+                        TTypedValue_1_0 valueLast = m_normalizationEquationStack.Pop();
+                        algorithmCheck--;
+                        TTypedValue_1_0 valuePrev = m_normalizationEquationStack.Pop();
+                        algorithmCheck--;
 
-                case EQUATION_OPER_FSUB:
-                    value.ValueFloat = CastToFloat( valuePrev ) - CastToFloat( valueLast );
-                    value.ValueType  = VALUE_TYPE_FLOAT;
-                    break;
+                        typedValue = CalculateEquationElemOperation( instruction.Operation, valuePrev, valueLast );
+                        isValid    = EquationStackPush( m_normalizationEquationStack, typedValue, algorithmCheck );
+                        break;
+                    }
 
-                case EQUATION_OPER_FMUL:
-                    value.ValueFloat = CastToFloat( valuePrev ) * CastToFloat( valueLast );
-                    value.ValueType  = VALUE_TYPE_FLOAT;
-                    break;
+                    case EQUATION_INSTR_STD_NORM_GPU_DURATION:
+                    case EQUATION_INSTR_STD_NORM_EU_AGGR_DURATION:
+                        // equation stack should be empty
+                        MD_ASSERT_A( adapterId, algorithmCheck == 0 );
+                        return GetNormalizationEquationOperand( instruction, deltaValues, outValues, metricIndex );
 
-                case EQUATION_OPER_FDIV:
-                {
-                    const float valueLastFloat = CastToFloat( valueLast );
-                    value.ValueFloat           = valueLastFloat != 0.0f
-                                  ? CastToFloat( valuePrev ) / valueLastFloat
-                                  : 0.0f;
-                    value.ValueType            = VALUE_TYPE_FLOAT;
-                    break;
+                    default:
+                        // Raw reads are not allowed in norm equation
+                        if( NORMALIZATION_EQUATION_INSTRUCTIONS & ( 1U << instruction.Code ) )
+                        {
+                            typedValue = GetNormalizationEquationOperand( instruction, deltaValues, outValues, metricIndex );
+                            isValid    = EquationStackPush( m_normalizationEquationStack, typedValue, algorithmCheck );
+                        }
+                        break;
                 }
+            }
+            // here should be only 1 element on the list - the result (if the equation is fine)
+            MD_ASSERT_A( adapterId, algorithmCheck == 1 );
 
-                case EQUATION_OPER_UGT:
-                    value.ValueBool = CastToUInt64( valuePrev ) > CastToUInt64( valueLast );
-                    value.ValueType = VALUE_TYPE_BOOL;
-                    break;
-
-                case EQUATION_OPER_ULT:
-                    value.ValueBool = CastToUInt64( valuePrev ) < CastToUInt64( valueLast );
-                    value.ValueType = VALUE_TYPE_BOOL;
-                    break;
-
-                case EQUATION_OPER_UGTE:
-                    value.ValueBool = CastToUInt64( valuePrev ) >= CastToUInt64( valueLast );
-                    value.ValueType = VALUE_TYPE_BOOL;
-                    break;
-
-                case EQUATION_OPER_ULTE:
-                    value.ValueBool = CastToUInt64( valuePrev ) <= CastToUInt64( valueLast );
-                    value.ValueType = VALUE_TYPE_BOOL;
-                    break;
-
-                case EQUATION_OPER_FGT:
-                    value.ValueBool = CastToFloat( valuePrev ) > CastToFloat( valueLast );
-                    value.ValueType = VALUE_TYPE_BOOL;
-                    break;
-
-                case EQUATION_OPER_FLT:
-                    value.ValueBool = CastToFloat( valuePrev ) < CastToFloat( valueLast );
-                    value.ValueType = VALUE_TYPE_BOOL;
-                    break;
-
-                case EQUATION_OPER_FGTE:
-                    value.ValueBool = CastToFloat( valuePrev ) >= CastToFloat( valueLast );
-                    value.ValueType = VALUE_TYPE_BOOL;
-                    break;
-
-                case EQUATION_OPER_FLTE:
-                    value.ValueBool = CastToFloat( valuePrev ) <= CastToFloat( valueLast );
-                    value.ValueType = VALUE_TYPE_BOOL;
-                    break;
-
-                case EQUATION_OPER_UMIN:
-                    // (std::min) - braces to bypass windows.h min/max errors
-                    value.ValueUInt64 = ( std::min )( CastToUInt64( valuePrev ), CastToUInt64( valueLast ) );
-                    break;
-
-                case EQUATION_OPER_UMAX:
-                    // (std::min) - braces to bypass windows.h min/max errors
-                    value.ValueUInt64 = ( std::max )( CastToUInt64( valuePrev ), CastToUInt64( valueLast ) );
-                    break;
-
-                case EQUATION_OPER_FMIN:
-                    // (std::min) - braces to bypass windows.h min/max errors
-                    value.ValueFloat = ( std::min )( CastToFloat( valuePrev ), CastToFloat( valueLast ) );
-                    value.ValueType  = VALUE_TYPE_FLOAT;
-                    break;
-
-                case EQUATION_OPER_FMAX:
-                    // (std::min) - braces to bypass windows.h min/max errors
-                    value.ValueFloat = ( std::max )( CastToFloat( valuePrev ), CastToFloat( valueLast ) );
-                    value.ValueType  = VALUE_TYPE_FLOAT;
-                    break;
-
-                default:
-                    MD_ASSERT( false );
-                    break;
+            if( isValid && algorithmCheck == 1 )
+            {
+                typedValue = m_normalizationEquationStack.Pop();
+            }
+            else
+            {
+                typedValue.ValueUInt64 = 0;
+                typedValue.ValueType   = VALUE_TYPE_UINT64;
             }
 
-            return value;
+            return typedValue;
         }
 
         //////////////////////////////////////////////////////////////////////////////
@@ -2133,61 +4741,105 @@ namespace MetricsDiscoveryInternal
         //     Pushes an equation to the stack.
         //
         // Input:
-        //     std::stack<TTypedValue_1_0>& stack          - equation stack.
-        //     TTypedValue_1_0&             value          - value to be pushed.
-        //     uint32_t&                    algorithmCheck - algorithm check.
+        //     CEquationStack&  stack          - equation stack.
+        //     TTypedValue_1_0& value          - value to be pushed.
+        //     uint32_t&        algorithmCheck - algorithm check.
         //
         // Output:
         //     bool - true if an equation was pushed successfully.
         //
         //////////////////////////////////////////////////////////////////////////////
         inline bool EquationStackPush(
-            std::stack<TTypedValue_1_0>& stack,
-            TTypedValue_1_0&             value,
-            uint32_t&                    algorithmCheck )
-        {
-            stack.push( value );
-            algorithmCheck++;
-            return ( stack.size() == algorithmCheck );
-        }
-
-        //////////////////////////////////////////////////////////////////////////////
-        //
-        // Class:
-        //     CMetricsCalculator
-        //
-        // Method:
-        //     ClearStack
-        //
-        // Description:
-        //     Clears the stack until it is empty.
-        //
-        // Input:
-        //     std::stack<TTypedValue_1_0>& stack - equation stack.
-        //
-        //////////////////////////////////////////////////////////////////////////////
-        inline void ClearStack( std::stack<TTypedValue_1_0>& stack )
+            CEquationStack&  stack,
+            TTypedValue_1_0& value,
+            uint32_t&        algorithmCheck )
         {
-            while( !stack.empty() )
+            if( stack.IsFull() )
             {
-                stack.pop();
+                MD_LOG_A( m_device.GetAdapter().GetAdapterId(), LOG_DEBUG, "Equation stack overflow" );
+                return false;
             }
+
+            stack.Push( value );
+            algorithmCheck++;
+            return ( stack.GetSize() == algorithmCheck );
         }
 
     private:
-        std::stack<TTypedValue_1_0>                             m_readEquationStack;
-        std::stack<TTypedValue_1_0>                             m_readEquationAndDeltaStack;
-        std::stack<TTypedValue_1_0>                             m_normalizationEquationStack;
-        std::unordered_map<std::string_view, TTypedValueLatest> m_symbolMap;
-        CMetricsDevice&                                         m_device;
-        uint64_t                                                m_gpuCoreClocks;
-        uint32_t                                                m_euCoresCount;
-        uint8_t*                                                m_savedReport;
-        uint32_t                                                m_savedReportSize;
-        uint64_t                                                m_contextIdPrev;
-        TTypedValue_1_0*                                        m_prevValues;
-        uint32_t                                                m_prevValuesCount;
-        bool                                                    m_savedReportPresent;
-        bool                                                    m_multipleSymbols;
+        CEquationStack                                               m_readEquationStack;
+        CEquationStack                                               m_readEquationAndDeltaStack;
+        CEquationStack                                               m_normalizationEquationStack;
+        CCalculatorSymbols&                                          m_symbols;
+        CMetricsDevice&                                              m_device;
+        uint64_t                                                     m_gpuCoreClocks;
+        uint8_t*                                                     m_savedReport;
+        uint32_t                                                     m_savedReportSize;
+        uint64_t                                                     m_contextIdPrev;
+        uint64_t                                                     m_filteredContextId; // Context of the first report of the stream
+        TTypedValue_1_0*                                             m_prevValues;
+        uint32_t                                                     m_prevValuesCount;
+        bool                                                         m_savedReportPresent;
+        std::vector<TTypedValue_1_0>                                 m_batchDeltaValues;
+        std::array<uint64_t, MD_CALCULATION_BATCH_SIZE>              m_batchGpuCoreClocks;
+        std::vector<uint64_t>                                        m_batchRegistersUInt64;
+        std::vector<float>                                           m_batchRegistersFloat;
+        std::vector<TTypedValue_1_0>                                 m_batchRegisters;
+        std::vector<uint64_t>                                        m_reportDeltas;               // Counter region deltas of a single report pair
+        std::array<uint32_t, REPORT_REGION_LAST>                     m_reportDeltasBitsCount;      // Bits count of calculated region deltas
+        std::vector<uint64_t>                                        m_batchColumnsLast;           // Last reports of a batch transposed to columns
+        std::vector<uint64_t>                                        m_batchColumnsPrev;           // Previous reports of a batch transposed to columns
+        std::vector<uint64_t>                                        m_batchColumnDeltas;          // Column deltas of a batch
+        std::vector<uint32_t>                                        m_batchColumnDeltasBitsCount; // Bits count of calculated column deltas
+        bool                                                         m_batchColumnsTransposed;
+        std::vector<TTypedValue_1_0>                                 m_calculatedValues;           // Reports with all the metrics, if metrics are projected
+        std::vector<TTypedValue_1_0>                                 m_calculatedMaxValues;        // Max values of all the metrics, if metrics are projected
+        std::vector<TTypedValue_1_0>                                 m_deltaValues;                // Delta values of a single report
+        std::vector<uint8_t>                                         m_contextSelection;           // Selection of reports of the filtered context
+        std::vector<uint64_t>                                        m_reportReasons;              // Report reasons of raw reports calculated asynchronously
+
+    private:
+        // Static variables:
+        static constexpr uint32_t READ_INSTRUCTIONS =
+            ( 1U << EQUATION_INSTR_READ_UINT8 ) |
+            ( 1U << EQUATION_INSTR_READ_UINT16 ) |
+            ( 1U << EQUATION_INSTR_READ_UINT32 ) |
+            ( 1U << EQUATION_INSTR_READ_UINT64 ) |
+            ( 1U << EQUATION_INSTR_READ_FLOAT ) |
+            ( 1U << EQUATION_INSTR_READ_40BIT_CNTR ) |
+            ( 1U << EQUATION_INSTR_READ_BITFIELD );
+
+        static constexpr uint32_t READ_AND_DELTA_EQUATION_INSTRUCTIONS =
+            READ_INSTRUCTIONS |
+            ( 1U << EQUATION_INSTR_IMMEDIATE ) |
+            ( 1U << EQUATION_INSTR_GLOBAL_SYMBOL ) |
+            ( 1U << EQUATION_INSTR_GLOBAL_SYMBOL_DYNAMIC ) |
+            ( 1U << EQUATION_INSTR_LOCAL_COUNTER ) |
+            ( 1U << EQUATION_INSTR_OPERATION );
+
+        static constexpr uint32_t READ_EQUATION_INSTRUCTIONS =
+            READ_AND_DELTA_EQUATION_INSTRUCTIONS |
+            ( 1U << EQUATION_INSTR_PREVIOUS_CONTEXT_ID ) |
+            ( 1U << EQUATION_INSTR_INFORMATION_SYMBOL );
+
+        static constexpr uint32_t NORMALIZATION_EQUATION_INSTRUCTIONS =
+            ( 1U << EQUATION_INSTR_IMMEDIATE ) |
+            ( 1U << EQUATION_INSTR_SELF_COUNTER ) |
+            ( 1U << EQUATION_INSTR_LOCAL_COUNTER ) |
+            ( 1U << EQUATION_INSTR_LOCAL_METRIC ) |
+            ( 1U << EQUATION_INSTR_PREV_METRIC ) |
+            ( 1U << EQUATION_INSTR_GLOBAL_SYMBOL ) |
+            ( 1U << EQUATION_INSTR_GLOBAL_SYMBOL_DYNAMIC ) |
+            ( 1U << EQUATION_INSTR_OPERATION ) |
+            ( 1U << EQUATION_INSTR_STD_NORM_GPU_DURATION ) |
+            ( 1U << EQUATION_INSTR_STD_NORM_EU_AGGR_DURATION );
+
+        // Bits count of region deltas that aren't calculated yet.
+        static constexpr uint32_t REPORT_DELTAS_INVALID = ( std::numeric_limits<uint32_t>::max )();
+
+        // Operands with the same value for all the reports in a batch.
+        static constexpr uint32_t REPORT_INVARIANT_INSTRUCTIONS =
+            ( 1U << EQUATION_INSTR_IMMEDIATE ) |
+            ( 1U << EQUATION_INSTR_GLOBAL_SYMBOL ) |
+            ( 1U << EQUATION_INSTR_GLOBAL_SYMBOL_DYNAMIC );
     };
 } // namespace MetricsDiscoveryInternal
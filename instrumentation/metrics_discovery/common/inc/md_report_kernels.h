@@ -0,0 +1,111 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2026 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+//     File Name:  md_report_kernels.h
+
+//     Abstract:   C++ metrics discovery header for raw report SIMD kernels
+
+#pragma once
+
+#include "md_types.h"
+
+#include <cstdint>
+
+namespace MetricsDiscoveryInternal
+{
+    ///////////////////////////////////////////////////////////////////////////////
+    // Report kernel instruction set levels:                                     //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef enum EReportKernelLevel
+    {
+        REPORT_KERNEL_LEVEL_SCALAR = 0,
+        REPORT_KERNEL_LEVEL_SSE42,
+        REPORT_KERNEL_LEVEL_AVX2,
+        // ...
+        REPORT_KERNEL_LEVEL_LAST
+    } TReportKernelLevel;
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Description:
+    //     SIMD kernels working on raw OA reports with a known layout:
+    //      - DELTA_N_BITS deltas of all the counters of a contiguous report region
+    //        (PEC or NOA) or of report columns, bit exact with
+    //        CMetricsCalculator::CalculateDeltaFunction,
+    //      - transposition of a block of reports to per counter columns,
+    //      - selection of reports with a header field equal to a value,
+    //      - extraction of a header field of consecutive reports to an array,
+    //      - linear interpolation of counters between two reports with Q32 alpha.
+    //     AVX2 or SSE4.2 kernels are selected once using CPUID, scalar kernels are
+    //     used on other CPUs.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    class CReportKernels
+    {
+    public:
+        static void               CalculateRegionDeltas( const TReportCounterRegion& region, const uint8_t* rawReportLast, const uint8_t* rawReportPrev, uint32_t bitsCount, uint64_t* outDeltas );
+        static void               CalculateColumnDeltas( const uint64_t* columnLast, const uint64_t* columnPrev, uint32_t count, uint32_t bitsCount, uint64_t* outDeltas );
+        static void               TransposeReports( const TReportLayout& layout, const uint8_t* const* rawReports, uint32_t reportCount, uint32_t columnStride, uint64_t* outColumns );
+        static void               SelectReports( const uint8_t* rawData, uint32_t reportCount, uint32_t reportSize, uint32_t fieldOffset, uint32_t fieldSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection );
+        static void               ExtractFields( const uint8_t* rawData, uint32_t reportCount, uint32_t reportSize, uint32_t fieldOffset, uint32_t fieldSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues );
+        static void               InterpolateCounters( const uint8_t* prev, const uint8_t* last, uint32_t count, uint32_t elemSize, uint64_t alphaQ32, uint8_t* out );
+        static uint64_t           GetInterpolationAlpha( uint64_t timestamp, uint64_t timestampPrev, uint64_t timestampLast );
+        static TReportKernelLevel GetKernelLevel();
+        static bool               SelfTest( TReportKernelLevel level );
+
+    private:
+        friend class CReportKernelsTest; // Compares deltas of each level with the calculator, see tests/md_equation_test.cpp
+
+        static TReportKernelLevel DetectKernelLevel();
+
+        static void CalculateDeltas( TReportKernelLevel level, const uint8_t* last, const uint8_t* prev, uint32_t count, uint32_t elemSize, uint32_t bitsCount, uint64_t* outDeltas );
+
+        template <typename TCounter>
+        static void CalculateDeltasScalar( const uint8_t* last, const uint8_t* prev, uint32_t count, uint64_t wrapBit, uint64_t wrapBorrow, uint64_t* outDeltas );
+
+        static void CalculateDeltas32Sse42( const uint8_t* last, const uint8_t* prev, uint32_t count, uint64_t wrapBit, uint64_t wrapBorrow, uint64_t* outDeltas );
+        static void CalculateDeltas64Sse42( const uint8_t* last, const uint8_t* prev, uint32_t count, uint64_t wrapBit, uint64_t wrapBorrow, uint64_t* outDeltas );
+        static void CalculateDeltas32Avx2( const uint8_t* last, const uint8_t* prev, uint32_t count, uint64_t wrapBit, uint64_t wrapBorrow, uint64_t* outDeltas );
+        static void CalculateDeltas64Avx2( const uint8_t* last, const uint8_t* prev, uint32_t count, uint64_t wrapBit, uint64_t wrapBorrow, uint64_t* outDeltas );
+
+        template <typename TCounter>
+        static void TransposeRegionScalar( const uint8_t* const* rawReports, uint32_t reportCount, uint32_t regionOffset, uint32_t counterCount, uint32_t columnStride, uint64_t* outColumns );
+
+        static void TransposeRegion32Sse42( const uint8_t* const* rawReports, uint32_t reportCount, uint32_t regionOffset, uint32_t counterCount, uint32_t columnStride, uint64_t* outColumns );
+        static void TransposeRegion64Sse42( const uint8_t* const* rawReports, uint32_t reportCount, uint32_t regionOffset, uint32_t counterCount, uint32_t columnStride, uint64_t* outColumns );
+        static void TransposeRegion32Avx2( const uint8_t* const* rawReports, uint32_t reportCount, uint32_t regionOffset, uint32_t counterCount, uint32_t columnStride, uint64_t* outColumns );
+        static void TransposeRegion64Avx2( const uint8_t* const* rawReports, uint32_t reportCount, uint32_t regionOffset, uint32_t counterCount, uint32_t columnStride, uint64_t* outColumns );
+
+        template <typename TField>
+        static void SelectReportsScalar( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection );
+
+        static void SelectReports32Sse42( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection );
+        static void SelectReports64Sse42( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection );
+        static void SelectReports32Avx2( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection );
+        static void SelectReports64Avx2( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection );
+
+        template <typename TField>
+        static void ExtractFieldsScalar( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues );
+
+        static void ExtractFields32Sse42( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues );
+        static void ExtractFields64Sse42( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues );
+        static void ExtractFields32Avx2( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues );
+        static void ExtractFields64Avx2( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues );
+
+        template <typename TCounter>
+        static void InterpolateCountersScalar( const uint8_t* prev, const uint8_t* last, uint32_t count, uint64_t alphaQ32, uint8_t* out );
+
+        static void InterpolateCounters32Sse42( const uint8_t* prev, const uint8_t* last, uint32_t count, uint64_t alphaQ32, uint8_t* out );
+        static void InterpolateCounters64Sse42( const uint8_t* prev, const uint8_t* last, uint32_t count, uint64_t alphaQ32, uint8_t* out );
+        static void InterpolateCounters32Avx2( const uint8_t* prev, const uint8_t* last, uint32_t count, uint64_t alphaQ32, uint8_t* out );
+        static void InterpolateCounters64Avx2( const uint8_t* prev, const uint8_t* last, uint32_t count, uint64_t alphaQ32, uint8_t* out );
+    };
+} // namespace MetricsDiscoveryInternal
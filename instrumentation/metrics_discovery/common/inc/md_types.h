@@ -56,6 +56,67 @@ namespace MetricsDiscoveryInternal
         OA_REPORT_TYPE_LAST,
     } TReportType;
 
+    ///////////////////////////////////////////////////////////////////////////////
+    // OA report counter regions:                                                //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef enum EReportRegion
+    {
+        REPORT_REGION_PEC = 0,
+        REPORT_REGION_NOA,
+        // ...
+        REPORT_REGION_LAST
+    } TReportRegion;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // OA report counter region:                                                 //
+    // Contiguous array of counters of the same size.                           //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef struct SReportCounterRegion
+    {
+        uint32_t Offset;   // Region offset from the report beginning in bytes
+        uint32_t Count;    // Counters count, 0 if the report has no such region
+        uint32_t ElemSize; // Single counter size in bytes
+    } TReportCounterRegion;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // OA report layout:                                                         //
+    // Header (ReportId, Timestamp, ContextId, GpuTicks) followed by PEC and     //
+    // NOA counter regions.                                                      //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef struct SReportLayout
+    {
+        uint32_t             HeaderSize;      // 0 if the report type layout isn't known
+        uint32_t             TimestampOffset; // 64 bit timestamp header field offset
+        uint32_t             GpuTicksOffset;  // 64 bit gpu ticks header field offset
+        uint32_t             CountersCount;   // Counters count in all the regions
+        TReportCounterRegion Regions[REPORT_REGION_LAST];
+    } TReportLayout;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // OA report columns:                                                        //
+    // Reports transposed to columns, one 64 bit value per report in a column.  //
+    // Counter columns follow, PEC counters first, then NOA counters.           //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef enum EReportColumn
+    {
+        REPORT_COLUMN_TIMESTAMP = 0,
+        REPORT_COLUMN_GPU_TICKS,
+        // ...
+        REPORT_COLUMN_COUNTERS // First counter column
+    } TReportColumn;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // OA report field:                                                          //
+    // Value read directly from a report: ( field >> Shift ) & Mask.             //
+    ///////////////////////////////////////////////////////////////////////////////
+    typedef struct SReportField
+    {
+        uint32_t Offset; // Field offset from the report beginning in bytes
+        uint32_t Size;   // Field size in bytes, 4 or 8
+        uint32_t Shift;  // Right shift of the field value
+        uint64_t Mask;   // Mask of the shifted field value
+    } TReportField;
+
     ///////////////////////////////////////////////////////////////////////////////
     // Stream types:                                                             //
     ///////////////////////////////////////////////////////////////////////////////
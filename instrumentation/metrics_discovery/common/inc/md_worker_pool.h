@@ -0,0 +1,68 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2026 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+//     File Name:  md_worker_pool.h
+
+//     Abstract:   C++ metrics discovery header for a pool of worker threads
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MetricsDiscoveryInternal
+{
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CWorkerPool
+    //
+    // Description:
+    //     Pool of persistent worker threads running independent tasks. The calling
+    //     thread runs tasks too and Run returns when all the tasks are finished, so
+    //     each Run is a barrier. Tasks are picked in order of their indices, which
+    //     tasks a given thread runs isn't defined.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    class CWorkerPool
+    {
+    public:
+        CWorkerPool();
+        ~CWorkerPool();
+
+        uint32_t Start( uint32_t threadCount );
+        void     Stop();
+        uint32_t GetThreadCount() const;
+        void     Run( uint32_t taskCount, const std::function<void( uint32_t )>& task );
+
+    private:
+        CWorkerPool( const CWorkerPool& )            = delete; // Delete copy-constructor
+        CWorkerPool& operator=( const CWorkerPool& ) = delete; // Delete assignment operator
+
+        void WorkerMain( uint64_t generation );
+        void RunTasks();
+
+    private:
+        // Members:
+        std::vector<std::thread>               m_workers;
+        std::mutex                             m_mutex;
+        std::condition_variable                m_startCondition;
+        std::condition_variable                m_finishCondition;
+        const std::function<void( uint32_t )>* m_task;
+        uint32_t                               m_taskCount;
+        std::atomic<uint32_t>                  m_nextTask;
+        uint32_t                               m_busyWorkerCount;
+        uint64_t                               m_generation; // Incremented by each Run with workers
+        bool                                   m_stop;
+    };
+} // namespace MetricsDiscoveryInternal
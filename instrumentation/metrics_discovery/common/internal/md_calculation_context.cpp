@@ -17,6 +17,7 @@ SPDX-License-Identifier: MIT
 #include "md_metrics_calculator.h"
 #include "md_utils.h"
 
+#include <algorithm>
 #include <functional>
 
 namespace MetricsDiscoveryInternal
@@ -46,6 +47,14 @@ namespace MetricsDiscoveryInternal
         , m_aggregationEnabled( false )
         , m_state( CALCULATION_CONTEXT_STATE_INITIAL )
         , m_timerModeState( CALCULATION_CONTEXT_STATE_TIMER_MODE_INITIAL )
+        , m_calculationThreadCount( 1 )
+        , m_reportHeaders()
+        , m_cachedReports()
+        , m_workerPool()
+        , m_aggregationBatch{}
+        , m_dataSetQueue()
+        , m_windowSweep()
+        , m_fusedCalculation{}
     {
     }
 
@@ -172,14 +181,6 @@ namespace MetricsDiscoveryInternal
                 }
             }
 
-            if( m_aggregationContext.StreamAggregationContext.CachedReportPtrsBase )
-            {
-                for( uint32_t i = 0; i < m_aggregationContext.CommonAggregationContext.DataSetCount; ++i )
-                {
-                    MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.CachedReportPtrsBase[i] );
-                }
-            }
-
             if( m_aggregationContext.StreamAggregationContext.PrevSavedReportPtrs )
             {
                 for( uint32_t i = 0; i < m_aggregationContext.CommonAggregationContext.DataSetCount; ++i )
@@ -201,17 +202,21 @@ namespace MetricsDiscoveryInternal
             MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.PrevRawDataPtrs );
             MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.PrevSavedReportPtrs );
             MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.LastSavedReportPtrs );
-            MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.CachedReportPtrsBase );
             MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.CachedReportPtrs );
             MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.InterpolatedReportPtrs );
             MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.OutAggregatedRawDataPtr );
             MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.CurrentTs );
             MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.NeedReport );
             MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.IsCachedReport );
-            MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.CachedReportPtrsSize );
             MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.IsPrevRawDataPresent );
             MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.IsLastRawDataPresent );
             MD_SAFE_DELETE_ARRAY( m_aggregationContext.StreamAggregationContext.SkipReportAfterRc6 );
+
+            m_reportHeaders.clear();
+            m_cachedReports.clear();
+            m_dataSetQueue     = TDataSetQueue();
+            m_windowSweep      = TWindowSweep();
+            m_fusedCalculation = TFusedCalculation();
         }
     }
 
@@ -325,6 +330,9 @@ namespace MetricsDiscoveryInternal
             // Convert aggregation window from ns to GPU timestamp ticks
             sa.NsTimeAggregationWindow     = device.ConvertNsToGpuTimestamp( calculationContextDescriptor.IoStreamDescriptor.NsTimeAggregationWindow, gpuTimestampFrequency );
             sa.MaxAggregationWindowInTicks = device.ConvertNsToGpuTimestamp( std::numeric_limits<uint64_t>::max(), gpuTimestampFrequency );
+
+            ret = InitializeWindowSweep();
+            MD_CHECK_CC_RET( ret );
         }
 
         if( calculationContextDescriptor.TimeOffsets )
@@ -665,7 +673,12 @@ namespace MetricsDiscoveryInternal
 
             if( *outAggregatedRawDataSize == 0 )
             {
-                *outAggregatedRawDataSize = m_calculationManager->GetRequiredSize( m_aggregationContext );
+                // Each swept window is output once, with at most a report per its boundary
+                const uint64_t sweepSize = static_cast<uint64_t>( m_windowSweep.Boundaries.size() ) * sa.RawReportSize;
+
+                *outAggregatedRawDataSize = IsWindowSweep()
+                    ? static_cast<uint32_t>( ( std::min )( sweepSize, static_cast<uint64_t>( std::numeric_limits<uint32_t>::max() ) ) )
+                    : m_calculationManager->GetRequiredSize( m_aggregationContext );
                 MD_LOG_EXIT();
                 return CC_OK;
             }
@@ -757,6 +770,15 @@ namespace MetricsDiscoveryInternal
             return CC_ERROR_NOT_SUPPORTED;
         }
 
+        if( IsWindowSweep() )
+        {
+            // Swept windows are returned an aggregation window at a time, as without the sweep
+            TCompletionCode ret = AggregateSweptSingleWindow( rawData, rawDataSizes, outAggregatedRawData, outProcessedRawDataCount, lastDataPortion );
+
+            MD_LOG_EXIT();
+            return ret;
+        }
+
         if( m_state == CALCULATION_CONTEXT_STATE_FINISHED )
         {
             sa.OutAggregatedRawDataSize = 0;
@@ -813,76 +835,15 @@ namespace MetricsDiscoveryInternal
             sa.LastRawDataPtrs[i] = sa.IsLastRawDataPresent[i] ? sa.LastSavedReportPtrs[i] : nullptr;
         }
 
+        ReleaseConsumedReports();
+        ReadReportHeaders();
+
         TCompletionCode ret        = CC_OK;
         bool            needReport = false;
 
         do
         {
-            for( uint32_t i = 0; i < m_dataSetCount; ++i )
-            {
-                if( sa.NeedReport[i] )
-                {
-                    if( sa.LastRawDataPtrs[i] != nullptr )
-                    {
-                        sa.PrevRawDataPtrs[i]      = sa.LastRawDataPtrs[i];
-                        sa.IsPrevRawDataPresent[i] = false;
-                    }
-
-                    TCompletionCode getReport = FilterReport( i, false );
-
-                    if( getReport == CC_OK )
-                    {
-                        if( sa.IsCachedReport[i] )
-                        {
-                            sa.LastRawDataPtrs[i] = sa.CachedReportPtrs[i];
-                            sa.CurrentTs[i]       = *reinterpret_cast<const uint64_t*>( sa.CachedReportPtrs[i] + 8 );
-                        }
-                        else
-                        {
-                            sa.LastRawDataPtrs[i] = sa.RawData[i];
-                            sa.CurrentTs[i]       = *reinterpret_cast<const uint64_t*>( sa.RawData[i] + 8 );
-                        }
-
-                        sa.IsLastRawDataPresent[i] = false;
-                        sa.NeedReport[i]           = false;
-
-                        if( ( sa.OutReportCount[i] < sa.RawReportCount[i] ) || ( sa.RawReportCount[i] == 0 && sa.IsCachedReport[i] ) )
-                        {
-                            if( sa.IsCachedReport[i] )
-                            {
-                                sa.CachedReportPtrsSize[i] -= sa.RawReportSize;
-
-                                if( sa.CachedReportPtrsSize[i] == 0 )
-                                {
-                                    MD_LOG( LOG_DEBUG, "No more cached reports available for dataSetCount: %u", i );
-                                    sa.IsCachedReport[i] = false;
-                                }
-                                else
-                                {
-                                    sa.CachedReportPtrs[i] += sa.RawReportSize;
-                                }
-                            }
-                            else
-                            {
-                                sa.RawData[i] += sa.RawReportSize;
-                            }
-                        }
-                    }
-                    else
-                    {
-                        continue;
-                    }
-                }
-            }
-
-            for( uint32_t i = 0; i < m_dataSetCount; ++i )
-            {
-                if( sa.NeedReport[i] )
-                {
-                    needReport = true;
-                    break;
-                }
-            }
+            needReport = !TakeRequestedReports( m_dataSetCount );
 
             if( needReport )
             {
@@ -915,7 +876,7 @@ namespace MetricsDiscoveryInternal
             {
                 for( uint32_t i = 0; i < m_dataSetCount; ++i )
                 {
-                    sa.NeedReport[i] = true;
+                    RequestReport( i );
                 }
 
                 m_state = CALCULATION_CONTEXT_STATE_LOAD_CALCULATION_WINDOW;
@@ -1126,6 +1087,7 @@ namespace MetricsDiscoveryInternal
         if( m_state == CALCULATION_CONTEXT_STATE_FINISHED || m_timerModeState == CALCULATION_CONTEXT_STATE_TIMER_MODE_FINISHED )
         {
             sa.OutAggregatedRawDataSize = 0;
+            *outAggregatedRawDataSize   = 0;
             MD_LOG_EXIT();
             return CC_OK;
         }
@@ -1179,6 +1141,12 @@ namespace MetricsDiscoveryInternal
             sa.LastRawDataPtrs[i] = sa.IsLastRawDataPresent[i] ? sa.LastSavedReportPtrs[i] : nullptr;
         }
 
+        // Reports queued by a failed call are dropped
+        m_aggregationBatch.ReportCount = 0;
+
+        ReleaseConsumedReports();
+        ReadReportHeaders();
+
         TCompletionCode ret = CC_OK;
 
         // For timer mode
@@ -1190,66 +1158,13 @@ namespace MetricsDiscoveryInternal
             bool notEnoughData = false;
             do
             {
-                for( uint32_t i = 0; i < m_dataSetCount; ++i )
-                {
-                    if( sa.NeedReport[i] )
-                    {
-                        if( sa.LastRawDataPtrs[i] != nullptr )
-                        {
-                            sa.PrevRawDataPtrs[i]      = sa.LastRawDataPtrs[i];
-                            sa.IsPrevRawDataPresent[i] = false;
-                        }
-
-                        ret = ( i == baseStream ) ? FilterReport( i, true ) : FilterReport( i, false );
-
-                        if( ret == CC_OK )
-                        {
-                            if( sa.IsCachedReport[i] )
-                            {
-                                sa.LastRawDataPtrs[i] = sa.CachedReportPtrs[i];
-                                sa.CurrentTs[i]       = *reinterpret_cast<const uint64_t*>( sa.CachedReportPtrs[i] + 8 );
-                            }
-                            else
-                            {
-                                sa.LastRawDataPtrs[i] = sa.RawData[i];
-                                sa.CurrentTs[i]       = *reinterpret_cast<const uint64_t*>( sa.RawData[i] + 8 );
-                            }
-
-                            sa.IsLastRawDataPresent[i] = false;
-                            sa.NeedReport[i]           = false;
-
-                            if( ( sa.OutReportCount[i] < sa.RawReportCount[i] ) || ( sa.RawReportCount[i] == 0 && sa.IsCachedReport[i] ) )
-                            {
-                                if( sa.IsCachedReport[i] )
-                                {
-                                    sa.CachedReportPtrsSize[i] -= sa.RawReportSize;
-
-                                    if( sa.CachedReportPtrsSize[i] == 0 )
-                                    {
-                                        MD_LOG( LOG_DEBUG, "No more cached reports available for dataSetCount: %u", i );
-                                        sa.IsCachedReport[i] = false;
-                                    }
-                                    else
-                                    {
-                                        sa.CachedReportPtrs[i] += sa.RawReportSize;
-                                    }
-                                }
-                                else
-                                {
-                                    sa.RawData[i] += sa.RawReportSize;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            notEnoughData = true;
-                            continue;
-                        }
-                    }
-                }
+                notEnoughData = !TakeRequestedReports( baseStream );
 
                 if( notEnoughData )
                 {
+                    // Queued reports may be interpolated from the reports about to be cached
+                    AggregateQueuedReports();
+
                     ret = CacheRemainingReports();
                     MD_CHECK_CC_RET( ret );
 
@@ -1260,7 +1175,7 @@ namespace MetricsDiscoveryInternal
                 {
                     for( uint32_t i = 0; i < m_dataSetCount; ++i )
                     {
-                        sa.NeedReport[i] = true;
+                        RequestReport( i );
                     }
 
                     m_timerModeState = CALCULATION_CONTEXT_STATE_TIMER_MODE_SEEK_DATA_START;
@@ -1280,7 +1195,7 @@ namespace MetricsDiscoveryInternal
 
                         if( sa.CurrentTs[i] > baseSampleTimestamp )
                         {
-                            sa.NeedReport[baseStream] = true;
+                            RequestReport( baseStream );
                             break;
                         }
                     }
@@ -1331,7 +1246,7 @@ namespace MetricsDiscoveryInternal
                     }
                     else if( baseSampleTimestamp < sa.TimeWindows[sa.CalculationWindowIndex].Start )
                     {
-                        sa.NeedReport[baseStream] = true;
+                        RequestReport( baseStream );
                         continue;
                     }
 
@@ -1347,15 +1262,17 @@ namespace MetricsDiscoveryInternal
                         continue;
                     }
 
-                    Interpolate( baseSampleTimestamp );
-                    m_calculationManager->AggregateCounters( m_aggregationContext );
+                    ReserveAggregatedReports( 1 );
+                    QueueAggregatedReport( baseSampleTimestamp, sa.OutAggregatedRawDataSize );
 
                     sa.OutAggregatedRawDataSize += sa.RawReportSize;
-                    sa.NeedReport[baseStream] = true;
-                    m_timerModeState          = CALCULATION_CONTEXT_STATE_TIMER_MODE_SEEK_NEXT_SAMPLE;
+                    RequestReport( baseStream );
+                    m_timerModeState = CALCULATION_CONTEXT_STATE_TIMER_MODE_SEEK_NEXT_SAMPLE;
                 }
             }
             while( m_timerModeState != CALCULATION_CONTEXT_STATE_TIMER_MODE_FINISHED );
+
+            AggregateQueuedReports();
         }
         else
         {
@@ -1363,71 +1280,7 @@ namespace MetricsDiscoveryInternal
 
             do
             {
-                for( uint32_t i = 0; i < m_dataSetCount; ++i )
-                {
-                    if( sa.NeedReport[i] )
-                    {
-                        if( sa.LastRawDataPtrs[i] != nullptr )
-                        {
-                            sa.PrevRawDataPtrs[i]      = sa.LastRawDataPtrs[i];
-                            sa.IsPrevRawDataPresent[i] = false;
-                        }
-
-                        TCompletionCode getReport = FilterReport( i, false );
-
-                        if( getReport == CC_OK )
-                        {
-                            if( sa.IsCachedReport[i] )
-                            {
-                                sa.LastRawDataPtrs[i] = sa.CachedReportPtrs[i];
-                                sa.CurrentTs[i]       = *reinterpret_cast<const uint64_t*>( sa.CachedReportPtrs[i] + 8 );
-                            }
-                            else
-                            {
-                                sa.LastRawDataPtrs[i] = sa.RawData[i];
-                                sa.CurrentTs[i]       = *reinterpret_cast<const uint64_t*>( sa.RawData[i] + 8 );
-                            }
-
-                            sa.IsLastRawDataPresent[i] = false;
-                            sa.NeedReport[i]           = false;
-
-                            if( ( sa.OutReportCount[i] < sa.RawReportCount[i] ) || ( sa.RawReportCount[i] == 0 && sa.IsCachedReport[i] ) )
-                            {
-                                if( sa.IsCachedReport[i] )
-                                {
-                                    sa.CachedReportPtrsSize[i] -= sa.RawReportSize;
-
-                                    if( sa.CachedReportPtrsSize[i] == 0 )
-                                    {
-                                        MD_LOG( LOG_DEBUG, "No more cached reports available for dataSetCount: %u", i );
-                                        sa.IsCachedReport[i] = false;
-                                    }
-                                    else
-                                    {
-                                        sa.CachedReportPtrs[i] += sa.RawReportSize;
-                                    }
-                                }
-                                else
-                                {
-                                    sa.RawData[i] += sa.RawReportSize;
-                                }
-                            }
-                        }
-                        else
-                        {
-                            continue;
-                        }
-                    }
-                }
-
-                for( uint32_t i = 0; i < m_dataSetCount; ++i )
-                {
-                    if( sa.NeedReport[i] )
-                    {
-                        needReport = true;
-                        break;
-                    }
-                }
+                needReport = !TakeRequestedReports( m_dataSetCount );
 
                 if( needReport )
                 {
@@ -1438,9 +1291,7 @@ namespace MetricsDiscoveryInternal
                             uint64_t minTimestamp = GetMinCurrentTimestamp();
                             if( sa.LastAggregatedTimestamp != minTimestamp )
                             {
-                                Interpolate( minTimestamp );
-                                m_calculationManager->AggregateCounters( m_aggregationContext );
-                                sa.OutAggregatedRawDataSize += sa.RawReportSize;
+                                AggregateInterpolatedReports( minTimestamp );
                             }
                         }
 
@@ -1449,6 +1300,9 @@ namespace MetricsDiscoveryInternal
                         break;
                     }
 
+                    // Queued reports may be interpolated from the reports about to be cached
+                    AggregateQueuedReports();
+
                     ret = CacheRemainingReports();
                     MD_CHECK_CC_RET( ret );
 
@@ -1459,7 +1313,7 @@ namespace MetricsDiscoveryInternal
                 {
                     for( uint32_t i = 0; i < m_dataSetCount; ++i )
                     {
-                        sa.NeedReport[i] = true;
+                        RequestReport( i );
                     }
 
                     m_state = CALCULATION_CONTEXT_STATE_LOAD_CALCULATION_WINDOW;
@@ -1518,10 +1372,7 @@ namespace MetricsDiscoveryInternal
                     if( IsEnoughData() )
                     {
                         // all streams started before the first calculation window
-                        Interpolate( sa.TimeWindows[sa.CalculationWindowIndex].Start );
-                        m_calculationManager->AggregateCounters( m_aggregationContext );
-
-                        sa.OutAggregatedRawDataSize += sa.RawReportSize;
+                        AggregateInterpolatedReports( sa.TimeWindows[sa.CalculationWindowIndex].Start );
                         m_state = CALCULATION_CONTEXT_STATE_SEEK_AGGREGATION_WINDOW;
                     }
                     else
@@ -1555,12 +1406,17 @@ namespace MetricsDiscoveryInternal
                             continue;
                         }
 
-                        Interpolate( sa.NsTimeFirstReport );
-                        m_calculationManager->AggregateCounters( m_aggregationContext );
-
-                        sa.OutAggregatedRawDataSize += sa.RawReportSize;
+                        AggregateInterpolatedReports( sa.NsTimeFirstReport );
                         m_state = CALCULATION_CONTEXT_STATE_SEEK_AGGREGATION_WINDOW;
                     }
+                    else if( sa.NsTimeAggregationWindowStop >= sa.TimeWindows[sa.CalculationWindowIndex].End )
+                    {
+                        // No data within the calculation window
+                        sa.CalculationWindowIndex++;
+                        sa.IsNewCalculationWindow = true;
+
+                        m_state = CALCULATION_CONTEXT_STATE_LOAD_CALCULATION_WINDOW;
+                    }
                     else
                     {
                         UpdateAggregationWindowStop();
@@ -1574,10 +1430,7 @@ namespace MetricsDiscoveryInternal
                         continue;
                     }
 
-                    Interpolate( sa.NsTimeAggregationWindowStop );
-                    m_calculationManager->AggregateCounters( m_aggregationContext );
-
-                    sa.OutAggregatedRawDataSize += sa.RawReportSize;
+                    AggregateInterpolatedReports( sa.NsTimeAggregationWindowStop );
 
                     if( sa.NsTimeAggregationWindowStop >= sa.TimeWindows[sa.CalculationWindowIndex].End )
                     {
@@ -1593,6 +1446,13 @@ namespace MetricsDiscoveryInternal
                 }
             }
             while( m_state != CALCULATION_CONTEXT_STATE_FINISHED );
+
+            AggregateQueuedReports();
+
+            if( IsWindowSweep() )
+            {
+                OutputSweptWindows( m_state == CALCULATION_CONTEXT_STATE_FINISHED );
+            }
         }
 
         if( m_type == CALCULATION_CONTEXT_TYPE_IO_STREAM )
@@ -1649,147 +1509,39 @@ namespace MetricsDiscoveryInternal
     //////////////////////////////////////////////////////////////////////////////
     TCompletionCode CCalculationContext::CalculateMetrics( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize )
     {
-        MD_LOG_ENTER();
-        MD_CHECK_PTR_RET( m_calculationContext.CommonCalculationContext.Calculator, CC_ERROR_INVALID_PARAMETER );
-        MD_CHECK_PTR_RET( m_calculationContext.CommonCalculationContext.MetricSet, CC_ERROR_INVALID_PARAMETER );
-        MD_CHECK_PTR_RET( rawData, CC_ERROR_INVALID_PARAMETER );
         MD_CHECK_PTR_RET( out, CC_ERROR_INVALID_PARAMETER );
 
-        if( !rawDataSize )
-        {
-            MD_LOG( LOG_DEBUG, "nothing to calculate, rawDataSize: 0" );
-            MD_LOG_EXIT();
-            return CC_OK;
-        }
-        if( !outMaxValues || !outMaxValuesSize )
-        {
-            MD_LOG( LOG_DEBUG, "max values won't be calculated, outMaxValues: %p, outMaxValuesSize: %u", outMaxValues, outMaxValuesSize );
-            outMaxValues     = nullptr;
-            outMaxValuesSize = 0;
-        }
-
-        MD_CHECK_PTR_RET( m_metricSet, CC_ERROR_INVALID_PARAMETER );
-
-        if( !m_metricSet->IsFiltered() )
-        {
-            MD_LOG( LOG_ERROR, "error: API filtering must be enabled first" );
-            MD_LOG_EXIT();
-            return CC_ERROR_GENERAL;
-        }
-
-        TMetricSetParamsLatest* params = m_metricSet->GetParams();
-        MD_CHECK_PTR_RET( params, CC_ERROR_INVALID_PARAMETER );
-
-        if( ( params->MetricsCount + params->InformationCount ) == 0 )
-        {
-            // May happen when unsupported API is used in MetricSet filtering
-            MD_LOG( LOG_WARNING, "nothing to calculate, empty MetricSet" );
-            MD_LOG_EXIT();
-            return CC_OK;
-        }
-
-        const uint32_t rawReportSize  = m_calculationContext.CommonCalculationContext.RawReportSize;
-        const uint32_t rawReportCount = rawDataSize / rawReportSize;
-
-        // Validation
-        auto ret = ValidateCalculateMetricsParams( params, rawDataSize, rawReportSize, outSize, rawReportCount, outMaxValuesSize );
-        MD_CHECK_CC_RET( ret );
-
-        m_calculationContext.CommonCalculationContext.Out            = out;
-        m_calculationContext.CommonCalculationContext.OutMaxValues   = outMaxValues;
-        m_calculationContext.CommonCalculationContext.RawData        = rawData;
-        m_calculationContext.CommonCalculationContext.RawReportCount = rawReportCount;
-        m_calculationContext.CommonCalculationContext.OutReportCount = 0;
-
-        if( m_type == CALCULATION_CONTEXT_TYPE_IO_STREAM )
-        {
-            TStreamCalculationContext& sc = m_calculationContext.StreamCalculationContext;
-
-            sc.PrevRawDataPtr      = sc.RawData;
-            sc.PrevRawReportNumber = 0;
-            sc.LastRawDataPtr      = sc.RawData;
-            sc.LastRawReportNumber = 0;
-        }
-
-        MD_LOG( LOG_DEBUG, "about to calculate %u raw reports", rawReportCount );
-
-        // CALCULATE METRICS
-        while( m_calculationManager->CalculateNextReport( m_calculationContext ) )
-        { // void
-        }
-
-        MD_LOG( LOG_DEBUG, "calculated %u out reports", m_calculationContext.CommonCalculationContext.OutReportCount );
-        MD_LOG( LOG_DEBUG, "max values%s calculated", outMaxValues ? "" : " not" );
-
-        if( outReportCount )
-        {
-            *outReportCount = m_calculationContext.CommonCalculationContext.OutReportCount;
-        }
-
-        MD_LOG_EXIT();
-        return CC_OK;
+        return CalculateReports( rawData, rawDataSize, out, outSize, outReportCount, outMaxValues, outMaxValuesSize, nullptr );
     }
 
-    ///////////////////////////////////////////////////////////////////////////////
+    //////////////////////////////////////////////////////////////////////////////
     //
     // Class:
     //     CCalculationContext
     //
     // Method:
-    //     CalculateSingleWindowMetrics
+    //     CalculateMetricColumns
     //
     // Description:
-    //     Calculates metrics for a single aggregation window using the provided raw data sets.
-    //     This method aggregates raw reports from multiple data sets into a single output buffer
-    //     for one aggregation window, then calculates metric values and optional maximum values
-    //     for the aggregated data.
+    //     Calculates metric values from the provided raw data buffer like CalculateMetrics,
+    //     but writes output metrics to separate columns typed by the metric result type.
+    //     Information is written as TTypedValue_1_0 rows to the optional OutInformation buffer.
     //
     // Input:
-    //     const uint8_t**  rawData                  - Array of pointers to raw data buffers for each data set.
-    //     const uint32_t*  rawDataSizes             - Array of sizes (in bytes) for each raw data buffer.
-    //     uint32_t*        outProcessedRawDataCount - Array to receive the count of processed raw data for each data set.
-    //     TTypedValue_1_0* out                      - Buffer to store calculated metric values.
-    //     uint32_t         outSize                  - Size (in bytes) of the output buffer for metric values.
-    //     TTypedValue_1_0* outMaxValues             - Buffer to store calculated maximum metric values (optional).
-    //     uint32_t         outMaxValuesSize         - Size (in bytes) of the output buffer for max values.
-    //     bool             lastDataPortion          - Indicates if this is the last portion of data.
+    //     const uint8_t*                      rawData        - Pointer to the buffer containing raw report data.
+    //     uint32_t                            rawDataSize    - Size (in bytes) of the raw report data buffer.
+    //     TCalculationOutputDescriptorLatest* outDescriptor  - Output columns for calculated metrics, max values and information.
+    //     uint32_t*                           outReportCount - Pointer to a variable that will receive the number of calculated reports (can be nullptr).
     //
     // Output:
-    //     TCompletionCode - CC_OK on success, or an appropriate error code on failure.
+    //     TCompletionCode - *CC_OK* on success, or an appropriate error code on failure.
     //
-    ///////////////////////////////////////////////////////////////////////////////
-    TCompletionCode CCalculationContext::CalculateSingleWindowMetrics( const uint8_t** rawData, const uint32_t* rawDataSizes, uint32_t* outProcessedRawDataCount, TTypedValue_1_0* out, uint32_t outSize, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize, bool lastDataPortion )
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CCalculationContext::CalculateMetricColumns( const uint8_t* rawData, uint32_t rawDataSize, TCalculationOutputDescriptorLatest* outDescriptor, uint32_t* outReportCount )
     {
-        MD_LOG_ENTER();
-
-        TCompletionCode            ret = CC_OK;
-        TStreamAggregationContext& sa  = m_aggregationContext.StreamAggregationContext;
-
-        uint32_t size = sa.OutAggregatedRawDataSize;
-
-        ret = AggregateSingleWindow( rawData, rawDataSizes, sa.OutAggregatedRawDataPtr + sa.OutAggregatedRawDataSize, outProcessedRawDataCount, lastDataPortion );
-
-        if( !sa.OutAggregatedRawDataSize && ret == CC_OK )
-        {
-            // Could not aggregate any data
-            ret = CC_NO_RESULT;
-        }
-
-        sa.OutAggregatedRawDataSize += size;
-
-        MD_CHECK_CC_RET( ret );
-
-        ret = CalculateMetrics( sa.OutAggregatedRawDataPtr, sa.OutAggregatedRawDataSize, out, outSize, nullptr, outMaxValues, outMaxValuesSize );
-        MD_CHECK_CC_RET( ret );
-
-        if( sa.OutAggregatedRawDataSize != 0 )
-        {
-            iu_memset( sa.OutAggregatedRawDataPtr, 0x00, sa.RawReportSize * 2 );
-            sa.OutAggregatedRawDataSize = 0;
-        }
+        MD_CHECK_PTR_RET( outDescriptor, CC_ERROR_INVALID_PARAMETER );
 
-        MD_LOG_EXIT();
-        return ret;
+        return CalculateReports( rawData, rawDataSize, nullptr, 0, outReportCount, nullptr, 0, outDescriptor );
     }
 
     //////////////////////////////////////////////////////////////////////////////
@@ -1798,16 +1550,351 @@ namespace MetricsDiscoveryInternal
     //     CCalculationContext
     //
     // Method:
-    //     ValidateCalculateMetricsParams
+    //     SetCalculationThreadCount
     //
     // Description:
-    //     Validates the parameters required for metric calculation to ensure buffer sizes and counts are correct.
-    //     Checks that the raw data buffer, output buffer, and max values buffer (if provided) are properly sized
-    //     and aligned with the metric set's configuration. Returns an error code if any validation fails.
+    //     Sets count of threads used by CalculateMetrics and CalculateMetricColumns
+    //     to calculate raw reports in chunks and by aggregation to read and cache
+    //     reports of data sets. Results are the same as from a single thread.
     //
     // Input:
-    //     TMetricSetParamsLatest* params           - Pointer to the metric set parameters structure.
-    //     uint32_t                rawDataSize      - Size (in bytes) of the raw report data buffer.
+    //     uint32_t threadCount - thread count, 0 means hardware concurrency,
+    //                            1 (default) means the calling thread only
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* on success, or an appropriate error code on failure.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CCalculationContext::SetCalculationThreadCount( uint32_t threadCount )
+    {
+        m_calculationThreadCount.store( threadCount );
+
+        MD_LOG( LOG_DEBUG, "calculation thread count: %u", threadCount );
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     AggregateAndCalculateMetrics
+    //
+    // Description:
+    //     Aggregates raw data like AggregateData and calculates metric values from the
+    //     aggregated reports like CalculateMetrics, without a caller aggregated raw data
+    //     buffer. For IO stream contexts aggregated reports are calculated during the
+    //     aggregation every MD_FUSED_CALCULATION_REPORT_COUNT reports, so only a small
+    //     chunk of them is kept at any time. Calculated reports are the same as from
+    //     AggregateData followed by CalculateMetrics, they are stored in the context
+    //     and valid until the next call.
+    //
+    // Input:
+    //     const uint8_t**         rawData         - Array of pointers to raw data buffers to be aggregated.
+    //     const uint32_t*         rawDataSizes    - Array of sizes (in bytes) for each raw data buffer.
+    //     const TTypedValue_1_0** out             - (OUT) calculated reports.
+    //     uint32_t*               outReportCount  - (OUT) calculated report count.
+    //     const TTypedValue_1_0** outMaxValues    - (OUT - optional) calculated max values, not calculated if null.
+    //     bool                    lastDataPortion - Indicates if this is the last portion of data.
+    //
+    // Output:
+    //     TCompletionCode - CC_OK on success, or an appropriate error code on failure.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CCalculationContext::AggregateAndCalculateMetrics( const uint8_t** rawData, const uint32_t* rawDataSizes, const TTypedValue_1_0** out, uint32_t* outReportCount, const TTypedValue_1_0** outMaxValues, bool lastDataPortion )
+    {
+        MD_LOG_ENTER();
+
+        MD_CHECK_PTR_RET( out, CC_ERROR_INVALID_PARAMETER );
+        MD_CHECK_PTR_RET( outReportCount, CC_ERROR_INVALID_PARAMETER );
+
+        TFusedCalculation& fc = m_fusedCalculation;
+
+        *out            = nullptr;
+        *outReportCount = 0;
+        if( outMaxValues )
+        {
+            *outMaxValues = nullptr;
+        }
+
+        fc.OutReportCount = 0;
+        fc.IsMaxValues    = outMaxValues != nullptr;
+        fc.Result         = CC_OK;
+
+        TCompletionCode ret            = CC_OK;
+        uint32_t        aggregatedSize = 0;
+
+        if( m_type == CALCULATION_CONTEXT_TYPE_IO_STREAM )
+        {
+            TStreamAggregationContext& sa = m_aggregationContext.StreamAggregationContext;
+
+            const size_t chunkSize = static_cast<size_t>( MD_FUSED_CALCULATION_REPORT_COUNT ) * sa.RawReportSize;
+
+            if( fc.RawData.size() < chunkSize )
+            {
+                fc.RawData.resize( chunkSize );
+            }
+
+            aggregatedSize              = static_cast<uint32_t>( fc.RawData.size() );
+            sa.OutAggregatedRawDataSize = 0;
+
+            // Aggregation calculates full chunks, the remaining reports are calculated here
+            fc.IsEnabled = true;
+
+            ret = AggregateData( rawData, rawDataSizes, fc.RawData.data(), &aggregatedSize, lastDataPortion );
+            if( ret == CC_OK )
+            {
+                CalculateAggregatedReports();
+                ret = fc.Result;
+            }
+
+            fc.IsEnabled = false;
+        }
+        else
+        {
+            // Query aggregation fills the whole buffer, so it's calculated at once
+            ret = AggregateData( rawData, rawDataSizes, nullptr, &aggregatedSize, lastDataPortion );
+
+            if( ret == CC_OK && aggregatedSize != 0 )
+            {
+                if( fc.RawData.size() < aggregatedSize )
+                {
+                    fc.RawData.resize( aggregatedSize );
+                }
+
+                ret = AggregateData( rawData, rawDataSizes, fc.RawData.data(), &aggregatedSize, lastDataPortion );
+                if( ret == CC_OK )
+                {
+                    ret = CalculateFusedReports( fc.RawData.data(), aggregatedSize );
+                }
+            }
+        }
+
+        if( ret != CC_OK )
+        {
+            MD_LOG_EXIT();
+            return ret;
+        }
+
+        *out            = fc.Out.data();
+        *outReportCount = fc.OutReportCount;
+        if( outMaxValues )
+        {
+            *outMaxValues = fc.OutMaxValues.data();
+        }
+
+        MD_LOG( LOG_DEBUG, "calculated %u aggregated reports", fc.OutReportCount );
+        MD_LOG_EXIT();
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     CalculateReports
+    //
+    // Description:
+    //     Common part of CalculateMetrics and CalculateMetricColumns. Validates parameters
+    //     and calculates all reports from the raw data buffer either to the output buffer
+    //     or, if the output descriptor is provided, to the output columns.
+    //
+    // Input:
+    //     const uint8_t*                      rawData          - Pointer to the buffer containing raw report data.
+    //     uint32_t                            rawDataSize      - Size (in bytes) of the raw report data buffer.
+    //     TTypedValue_1_0*                    out              - Buffer for calculated metric values, unused with output descriptor.
+    //     uint32_t                            outSize          - Size (in bytes) of the output buffer.
+    //     uint32_t*                           outReportCount   - Pointer to a variable that will receive the number of calculated reports (can be nullptr).
+    //     TTypedValue_1_0*                    outMaxValues     - Buffer for maximum metric values (can be nullptr), unused with output descriptor.
+    //     uint32_t                            outMaxValuesSize - Size (in bytes) of the max values output buffer.
+    //     TCalculationOutputDescriptorLatest* outDescriptor    - Output columns (can be nullptr).
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* on success, or an appropriate error code on failure.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CCalculationContext::CalculateReports( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize, TCalculationOutputDescriptorLatest* outDescriptor )
+    {
+        MD_LOG_ENTER();
+        MD_CHECK_PTR_RET( m_calculationContext.CommonCalculationContext.Calculator, CC_ERROR_INVALID_PARAMETER );
+        MD_CHECK_PTR_RET( m_calculationContext.CommonCalculationContext.MetricSet, CC_ERROR_INVALID_PARAMETER );
+        MD_CHECK_PTR_RET( rawData, CC_ERROR_INVALID_PARAMETER );
+
+        if( !rawDataSize )
+        {
+            MD_LOG( LOG_DEBUG, "nothing to calculate, rawDataSize: 0" );
+            MD_LOG_EXIT();
+            return CC_OK;
+        }
+        if( !outMaxValues || !outMaxValuesSize )
+        {
+            MD_LOG( LOG_DEBUG, "max values won't be calculated, outMaxValues: %p, outMaxValuesSize: %u", outMaxValues, outMaxValuesSize );
+            outMaxValues     = nullptr;
+            outMaxValuesSize = 0;
+        }
+
+        MD_CHECK_PTR_RET( m_metricSet, CC_ERROR_INVALID_PARAMETER );
+
+        // Plan and metric kernels are prepared and kept unchanged by the metric set setters
+        // until the chunks calculated on other threads are done
+        std::shared_lock<std::shared_mutex> planLock;
+
+        TCompletionCode ret = m_metricSet->LockCalculationPlan( planLock );
+        MD_CHECK_CC_RET( ret );
+
+        if( !m_metricSet->IsFiltered() )
+        {
+            MD_LOG( LOG_ERROR, "error: API filtering must be enabled first" );
+            MD_LOG_EXIT();
+            return CC_ERROR_GENERAL;
+        }
+
+        TMetricSetParamsLatest* params = m_metricSet->GetParams();
+        MD_CHECK_PTR_RET( params, CC_ERROR_INVALID_PARAMETER );
+
+        if( ( params->MetricsCount + params->InformationCount ) == 0 )
+        {
+            // May happen when unsupported API is used in MetricSet filtering
+            MD_LOG( LOG_WARNING, "nothing to calculate, empty MetricSet" );
+            MD_LOG_EXIT();
+            return CC_OK;
+        }
+
+        const uint32_t rawReportSize  = m_calculationContext.CommonCalculationContext.RawReportSize;
+        const uint32_t rawReportCount = rawDataSize / rawReportSize;
+
+        // Validation
+        if( outDescriptor )
+        {
+            // Without a saved report the first stream report only starts the calculation
+            const bool     savedReportPresent = m_type != CALCULATION_CONTEXT_TYPE_IO_STREAM || m_calculationContext.CommonCalculationContext.Calculator->SavedReportPresent();
+            const uint32_t maxOutReportCount  = ( savedReportPresent || rawReportCount == 0 ) ? rawReportCount : rawReportCount - 1;
+
+            ret = m_metricSet->ValidateOutputDescriptor( outDescriptor, rawDataSize, rawReportSize, maxOutReportCount );
+        }
+        else
+        {
+            ret = ValidateCalculateMetricsParams( params, rawDataSize, rawReportSize, outSize, rawReportCount, outMaxValuesSize );
+        }
+        MD_CHECK_CC_RET( ret );
+
+        m_calculationContext.CommonCalculationContext.Out            = out;
+        m_calculationContext.CommonCalculationContext.OutMaxValues   = outMaxValues;
+        m_calculationContext.CommonCalculationContext.OutDescriptor  = outDescriptor;
+        m_calculationContext.CommonCalculationContext.RawData        = rawData;
+        m_calculationContext.CommonCalculationContext.RawReportCount = rawReportCount;
+        m_calculationContext.CommonCalculationContext.OutReportCount = 0;
+
+        if( m_type == CALCULATION_CONTEXT_TYPE_IO_STREAM )
+        {
+            TStreamCalculationContext& sc = m_calculationContext.StreamCalculationContext;
+
+            sc.PrevRawDataPtr      = sc.RawData;
+            sc.PrevRawReportNumber = 0;
+            sc.LastRawDataPtr      = sc.RawData;
+            sc.LastRawReportNumber = 0;
+        }
+
+        MD_LOG( LOG_DEBUG, "about to calculate %u raw reports", rawReportCount );
+
+        // CALCULATE METRICS
+        ret = m_calculationManager->CalculateReports( m_calculationContext, m_calculationThreadCount.load() );
+
+        MD_LOG( LOG_DEBUG, "calculated %u out reports", m_calculationContext.CommonCalculationContext.OutReportCount );
+        MD_LOG( LOG_DEBUG, "max values%s calculated", ( outDescriptor ? outDescriptor->MaxValueColumns != nullptr : outMaxValues != nullptr ) ? "" : " not" );
+
+        if( outReportCount )
+        {
+            *outReportCount = m_calculationContext.CommonCalculationContext.OutReportCount;
+        }
+
+        m_calculationContext.CommonCalculationContext.OutDescriptor = nullptr;
+
+        MD_LOG_EXIT();
+        return ret;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     CalculateSingleWindowMetrics
+    //
+    // Description:
+    //     Calculates metrics for a single aggregation window using the provided raw data sets.
+    //     This method aggregates raw reports from multiple data sets into a single output buffer
+    //     for one aggregation window, then calculates metric values and optional maximum values
+    //     for the aggregated data.
+    //
+    // Input:
+    //     const uint8_t**  rawData                  - Array of pointers to raw data buffers for each data set.
+    //     const uint32_t*  rawDataSizes             - Array of sizes (in bytes) for each raw data buffer.
+    //     uint32_t*        outProcessedRawDataCount - Array to receive the count of processed raw data for each data set.
+    //     TTypedValue_1_0* out                      - Buffer to store calculated metric values.
+    //     uint32_t         outSize                  - Size (in bytes) of the output buffer for metric values.
+    //     TTypedValue_1_0* outMaxValues             - Buffer to store calculated maximum metric values (optional).
+    //     uint32_t         outMaxValuesSize         - Size (in bytes) of the output buffer for max values.
+    //     bool             lastDataPortion          - Indicates if this is the last portion of data.
+    //
+    // Output:
+    //     TCompletionCode - CC_OK on success, or an appropriate error code on failure.
+    //
+    ///////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CCalculationContext::CalculateSingleWindowMetrics( const uint8_t** rawData, const uint32_t* rawDataSizes, uint32_t* outProcessedRawDataCount, TTypedValue_1_0* out, uint32_t outSize, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize, bool lastDataPortion )
+    {
+        MD_LOG_ENTER();
+
+        TCompletionCode            ret = CC_OK;
+        TStreamAggregationContext& sa  = m_aggregationContext.StreamAggregationContext;
+
+        uint32_t size = sa.OutAggregatedRawDataSize;
+
+        ret = AggregateSingleWindow( rawData, rawDataSizes, sa.OutAggregatedRawDataPtr + sa.OutAggregatedRawDataSize, outProcessedRawDataCount, lastDataPortion );
+
+        if( !sa.OutAggregatedRawDataSize && ret == CC_OK )
+        {
+            // Could not aggregate any data
+            ret = CC_NO_RESULT;
+        }
+
+        sa.OutAggregatedRawDataSize += size;
+
+        MD_CHECK_CC_RET( ret );
+
+        ret = CalculateMetrics( sa.OutAggregatedRawDataPtr, sa.OutAggregatedRawDataSize, out, outSize, nullptr, outMaxValues, outMaxValuesSize );
+        MD_CHECK_CC_RET( ret );
+
+        if( sa.OutAggregatedRawDataSize != 0 )
+        {
+            iu_memset( sa.OutAggregatedRawDataPtr, 0x00, sa.RawReportSize * 2 );
+            sa.OutAggregatedRawDataSize = 0;
+        }
+
+        MD_LOG_EXIT();
+        return ret;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     ValidateCalculateMetricsParams
+    //
+    // Description:
+    //     Validates the parameters required for metric calculation to ensure buffer sizes and counts are correct.
+    //     Checks that the raw data buffer, output buffer, and max values buffer (if provided) are properly sized
+    //     and aligned with the metric set's configuration. Returns an error code if any validation fails.
+    //
+    // Input:
+    //     TMetricSetParamsLatest* params           - Pointer to the metric set parameters structure.
+    //     uint32_t                rawDataSize      - Size (in bytes) of the raw report data buffer.
     //     uint32_t                rawReportSize    - Size (in bytes) of a single raw report.
     //     uint32_t                outSize          - Size (in bytes) of the output buffer.
     //     uint32_t                rawReportCount   - Number of raw reports in the input buffer.
@@ -2028,7 +2115,10 @@ namespace MetricsDiscoveryInternal
                 const auto& previous = timeWindows[i - 1];
                 const auto& current  = timeWindows[i];
 
-                if( !( previous.End <= current.Start && current.Start < current.End ) )
+                // Unsorted or overlapping windows are allowed with aggregation windows, see InitializeWindowSweep
+                const bool isSweep = calculationContextDescriptor.IoStreamDescriptor.NsTimeAggregationWindow != 0;
+
+                if( ( previous.End > current.Start && !isSweep ) || current.Start >= current.End )
                 {
                     MD_LOG( LOG_INFO, "Invalid time window: previous.End = %llu, current.Start = %llu, current.End = %llu", previous.End, current.Start, current.End );
                     return CC_ERROR_INVALID_PARAMETER;
@@ -2418,12 +2508,15 @@ namespace MetricsDiscoveryInternal
     // Description:
     //     Checks whether all data sets in the stream aggregation context have reached the specified
     //     target timestamp, with behavior determined by the timerMode template parameter.
-    //     - In timer mode (timerMode = true), marks each data set as needing a report if its current
+    //     - In timer mode (timerMode = true), requests a report for each data set whose current
     //       timestamp is less than the target timestamp. Returns false if any data set requires a report
     //       update, true otherwise.
-    //     - If aggregation windows are defined (timerMode = false), finds the minimum current timestamp among
-    //       all data sets and marks only those streams at the minimum timestamp as needing a report if they are
-    //       less than the target timestamp. Returns false if any such data set requires a report update, true otherwise.
+    //     - If aggregation windows are defined (timerMode = false), requests a report only for data sets
+    //       at the minimum current timestamp if it is less than the target timestamp. Returns false if any
+    //       such data set requires a report update, true otherwise.
+    //     Data sets are taken from the current timestamp heap, so only the data sets that need a report
+    //     are visited. A data set requesting a report seeks over reports it would take one by one anyway,
+    //     see SeekReport.
     //
     // Input:
     //     uint64_t timestamp - The target timestamp to check against.
@@ -2435,44 +2528,346 @@ namespace MetricsDiscoveryInternal
     template <bool timerMode>
     bool CCalculationContext::EnsureDataAtTimestamp( const uint64_t timestamp )
     {
-        TStreamAggregationContext& sa         = m_aggregationContext.StreamAggregationContext;
-        bool                       needReport = false;
+        TDataSetTimestamp minimum = {};
+
+        // Called only when all data sets have their current reports
+        MD_ASSERT( m_dataSetQueue.Requested.empty() );
 
         if constexpr( timerMode )
         {
             // Timer mode: every data set must reach (>=) target timestamp
-            for( uint32_t i = 0; i < m_dataSetCount; ++i )
+            while( PeekMinTimestamp( minimum ) && minimum.Timestamp < timestamp )
             {
-                sa.NeedReport[i] = ( sa.CurrentTs[i] < timestamp );
-                if( sa.NeedReport[i] )
-                {
-                    needReport = true;
-                }
+                PopMinTimestamp();
+                RequestReport( minimum.DataSetIndex );
+                SeekReport( minimum.DataSetIndex, timestamp );
             }
         }
         else
         {
             // Aggregation windows defined: advance only those streams that are at the current minimum timestamp
-            uint64_t minTimestamp = sa.CurrentTs[0];
-            for( uint32_t i = 1; i < m_dataSetCount; ++i )
+            if( !PeekMinTimestamp( minimum ) || minimum.Timestamp >= timestamp )
             {
-                if( sa.CurrentTs[i] < minTimestamp )
-                {
-                    minTimestamp = sa.CurrentTs[i];
-                }
+                return true;
             }
 
-            for( uint32_t i = 0; i < m_dataSetCount; ++i )
+            const uint64_t minTimestamp = minimum.Timestamp;
+
+            do
+            {
+                PopMinTimestamp();
+                RequestReport( minimum.DataSetIndex );
+            }
+            while( PeekMinTimestamp( minimum ) && minimum.Timestamp == minTimestamp );
+
+            if( m_dataSetQueue.Requested.size() == 1 )
+            {
+                // A single data set at the minimum takes all its reports before the next minimum
+                const uint64_t nextTimestamp = PeekMinTimestamp( minimum ) ? minimum.Timestamp : timestamp;
+
+                SeekReport( m_dataSetQueue.Requested[0], ( std::min )( timestamp, nextTimestamp ) );
+            }
+        }
+
+        return m_dataSetQueue.Requested.empty();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     RequestReport
+    //
+    // Description:
+    //     Marks a data set as needing its next report. The data set leaves the current
+    //     timestamp heap until TakeRequestedReports takes the report.
+    //
+    // Input:
+    //     uint32_t dataSetIdx - Index of the data set.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::RequestReport( uint32_t dataSetIdx )
+    {
+        TStreamAggregationContext& sa = m_aggregationContext.StreamAggregationContext;
+
+        if( sa.NeedReport[dataSetIdx] )
+        {
+            return;
+        }
+
+        if( m_dataSetQueue.Generations.size() < m_dataSetCount )
+        {
+            m_dataSetQueue.Generations.resize( m_dataSetCount, 0 );
+        }
+
+        // Heap entry of the data set becomes stale
+        ++m_dataSetQueue.Generations[dataSetIdx];
+
+        sa.NeedReport[dataSetIdx] = true;
+        m_dataSetQueue.Requested.push_back( dataSetIdx );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     TakeRequestedReports
+    //
+    // Description:
+    //     Takes the next filtered report of each data set that requested one, in data set
+    //     order. Previous last report becomes the previous report and the data set is
+    //     pushed to the current timestamp heap with the timestamp of its new report.
+    //     Data sets without more reports keep their request for the next data portion.
+    //
+    // Input:
+    //     uint32_t timerDataSetIdx - Index of the data set taking only timer reports,
+    //                                data set count if none.
+    //
+    // Output:
+    //     bool - true if all requested reports were taken.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    bool CCalculationContext::TakeRequestedReports( uint32_t timerDataSetIdx )
+    {
+        TStreamAggregationContext& sa          = m_aggregationContext.StreamAggregationContext;
+        std::vector<uint32_t>&     requested   = m_dataSetQueue.Requested;
+        size_t                     failedCount = 0;
+
+        if( requested.size() > 1 )
+        {
+            std::sort( requested.begin(), requested.end() );
+        }
+
+        for( const uint32_t i : requested )
+        {
+            if( sa.LastRawDataPtrs[i] != nullptr )
+            {
+                sa.PrevRawDataPtrs[i]      = sa.LastRawDataPtrs[i];
+                sa.IsPrevRawDataPresent[i] = false;
+            }
+
+            if( FilterReport( i, i == timerDataSetIdx ) != CC_OK )
+            {
+                requested[failedCount++] = i;
+                continue;
+            }
+
+            sa.LastRawDataPtrs[i] = sa.IsCachedReport[i] ? sa.CachedReportPtrs[i] : sa.RawData[i];
+            sa.CurrentTs[i]       = GetReportTimestamp( i );
+
+            sa.IsLastRawDataPresent[i] = false;
+            sa.NeedReport[i]           = false;
+
+            if( ( sa.OutReportCount[i] < sa.RawReportCount[i] ) || ( sa.RawReportCount[i] == 0 && sa.IsCachedReport[i] ) )
             {
-                if( sa.CurrentTs[i] == minTimestamp && sa.CurrentTs[i] < timestamp )
+                if( sa.IsCachedReport[i] )
+                {
+                    if( !NextCachedReport( i ) )
+                    {
+                        MD_LOG( LOG_DEBUG, "No more cached reports available for dataSetCount: %u", i );
+                    }
+                }
+                else
                 {
-                    sa.NeedReport[i] = true;
-                    needReport       = true;
+                    sa.RawData[i] += sa.RawReportSize;
                 }
             }
+
+            PushCurrentTimestamp( i );
+        }
+
+        requested.resize( failedCount );
+
+        return failedCount == 0;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     PushCurrentTimestamp
+    //
+    // Description:
+    //     Pushes a data set with its current timestamp to the current timestamp heap.
+    //     Stale entries are dropped once they outnumber the data sets.
+    //
+    // Input:
+    //     uint32_t dataSetIdx - Index of the data set.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::PushCurrentTimestamp( uint32_t dataSetIdx )
+    {
+        const TStreamAggregationContext& sa   = m_aggregationContext.StreamAggregationContext;
+        std::vector<TDataSetTimestamp>&  heap = m_dataSetQueue.Heap;
+
+        if( heap.size() >= 2 * static_cast<size_t>( m_dataSetCount ) )
+        {
+            auto isStale = [&]( const TDataSetTimestamp& entry )
+            {
+                return entry.Generation != m_dataSetQueue.Generations[entry.DataSetIndex];
+            };
+
+            heap.erase( std::remove_if( heap.begin(), heap.end(), isStale ), heap.end() );
+            std::make_heap( heap.begin(), heap.end(), IsLaterTimestamp );
+        }
+
+        heap.push_back( { sa.CurrentTs[dataSetIdx], dataSetIdx, m_dataSetQueue.Generations[dataSetIdx] } );
+        std::push_heap( heap.begin(), heap.end(), IsLaterTimestamp );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     PeekMinTimestamp
+    //
+    // Description:
+    //     Returns a data set with the minimum current timestamp, lower data set index
+    //     first. Skips stale entries of data sets that requested a report.
+    //
+    // Input:
+    //     TDataSetTimestamp& outMinimum - (OUT) Data set with the minimum timestamp.
+    //
+    // Output:
+    //     bool - false if no data set has a current report.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    bool CCalculationContext::PeekMinTimestamp( TDataSetTimestamp& outMinimum )
+    {
+        std::vector<TDataSetTimestamp>& heap = m_dataSetQueue.Heap;
+
+        while( !heap.empty() )
+        {
+            const TDataSetTimestamp& top = heap.front();
+
+            if( top.Generation == m_dataSetQueue.Generations[top.DataSetIndex] )
+            {
+                outMinimum = top;
+                return true;
+            }
+
+            PopMinTimestamp();
+        }
+
+        return false;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     PopMinTimestamp
+    //
+    // Description:
+    //     Removes the top entry of the current timestamp heap.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::PopMinTimestamp()
+    {
+        std::vector<TDataSetTimestamp>& heap = m_dataSetQueue.Heap;
+
+        std::pop_heap( heap.begin(), heap.end(), IsLaterTimestamp );
+        heap.pop_back();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     IsLaterTimestamp
+    //
+    // Description:
+    //     Heap order of data sets, the minimum timestamp and data set index on the top.
+    //
+    // Input:
+    //     const TDataSetTimestamp& left  - First data set.
+    //     const TDataSetTimestamp& right - Second data set.
+    //
+    // Output:
+    //     bool - true if the first data set comes after the second one.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    bool CCalculationContext::IsLaterTimestamp( const TDataSetTimestamp& left, const TDataSetTimestamp& right )
+    {
+        return left.Timestamp != right.Timestamp
+            ? left.Timestamp > right.Timestamp
+            : left.DataSetIndex > right.DataSetIndex;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     SeekReport
+    //
+    // Description:
+    //     Moves a data set that requested a report over raw reports it would take one by
+    //     one anyway before reaching the given timestamp, so they aren't filtered one by one.
+    //     The first raw report at or after the timestamp is found with a binary search
+    //     in the sparse timestamp index, then in the report timestamps of a single index
+    //     stride. The two reports preceding it are left to be taken as usual, so
+    //     the previous and last reports are the same as without seeking. Seeking stops
+    //     before an RC6 report, which changes filtering, and isn't done for cached
+    //     reports, after RC6 or if the timestamps aren't sorted.
+    //
+    // Input:
+    //     uint32_t dataSetIdx - Index of the data set.
+    //     uint64_t timestamp  - Timestamp the data set advances to; no other data set may
+    //                           need a report before the data set reaches it.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::SeekReport( uint32_t dataSetIdx, uint64_t timestamp )
+    {
+        TStreamAggregationContext& sa      = m_aggregationContext.StreamAggregationContext;
+        const TReportHeaders&      headers = m_reportHeaders[dataSetIdx];
+
+        if( sa.IsCachedReport[dataSetIdx] || sa.SkipReportAfterRc6[dataSetIdx] || !headers.AreTimestampsSorted || sa.OutReportCount[dataSetIdx] >= sa.RawReportCount[dataSetIdx] )
+        {
+            return;
+        }
+
+        const size_t    count      = static_cast<size_t>( headers.FirstReport ) + sa.RawReportCount[dataSetIdx];
+        const size_t    current    = static_cast<size_t>( sa.RawData[dataSetIdx] - headers.RawData ) / sa.RawReportSize;
+        const uint64_t* timestamps = headers.RawTimestamps.data();
+
+        // Nothing to skip if the timestamp is reached within the next three reports
+        if( current + 3 > count || timestamps[current + 2] >= timestamp )
+        {
+            return;
         }
 
-        return !needReport;
+        // Index entries after current + 2 up to the end of the data portion
+        const uint64_t* index      = headers.TimestampIndex.data();
+        const size_t    firstEntry = ( current + 2 ) / MD_REPORT_TIMESTAMP_INDEX_STRIDE + 1;
+        const size_t    endEntry   = ( count - 1 ) / MD_REPORT_TIMESTAMP_INDEX_STRIDE + 1;
+        const size_t    entry      = std::lower_bound( index + firstEntry, index + ( std::max )( firstEntry, endEntry ), timestamp ) - index;
+
+        // The first report at or after the timestamp is within the stride preceding the entry
+        const size_t low     = ( std::max )( current + 3, ( entry - 1 ) * MD_REPORT_TIMESTAMP_INDEX_STRIDE );
+        const size_t high    = ( std::min )( count, entry * MD_REPORT_TIMESTAMP_INDEX_STRIDE );
+        const size_t reached = std::lower_bound( timestamps + low, timestamps + high, timestamp ) - timestamps;
+
+        // Stop before the first GO report that would be skipped
+        const auto     goReport = std::lower_bound( headers.GoReports.begin(), headers.GoReports.end(), current );
+        const size_t   target   = ( goReport != headers.GoReports.end() && *goReport < reached - 2 ) ? *goReport : reached - 2;
+        const uint32_t skipped  = static_cast<uint32_t>( target - current );
+
+        sa.RawData[dataSetIdx] += static_cast<size_t>( skipped ) * sa.RawReportSize;
+        sa.OutReportCount[dataSetIdx] += skipped;
     }
 
     //////////////////////////////////////////////////////////////////////////////
@@ -2519,28 +2914,29 @@ namespace MetricsDiscoveryInternal
         {
             if( sa.IsCachedReport[dataSetIdx] )
             {
-                sa.CachedReportPtrs[dataSetIdx] += sa.RawReportSize;
-                sa.CachedReportPtrsSize[dataSetIdx] -= sa.RawReportSize;
-
-                if( sa.CachedReportPtrsSize[dataSetIdx] == 0 )
+                if( !NextCachedReport( dataSetIdx ) )
                 {
-                    sa.IsCachedReport[dataSetIdx] = false;
                     return false;
                 }
 
-                reportReason = sa.Calculator->ReadInformationByIndex( sa.CachedReportPtrs[dataSetIdx], *sa.BaseMetricSet, sa.ReportReasonIdx );
+                reportReason = GetReportReason( dataSetIdx );
             }
             else
             {
+                if( sa.OutReportCount[dataSetIdx] >= sa.RawReportCount[dataSetIdx] )
+                {
+                    return false; // The last taken report was the last one
+                }
+
                 sa.RawData[dataSetIdx] += sa.RawReportSize;
                 sa.OutReportCount[dataSetIdx]++;
 
-                if( sa.OutReportCount[dataSetIdx] > sa.RawReportCount[dataSetIdx] )
+                if( sa.OutReportCount[dataSetIdx] >= sa.RawReportCount[dataSetIdx] )
                 {
                     return false;
                 }
 
-                reportReason = sa.Calculator->ReadInformationByIndex( sa.RawData[dataSetIdx], *sa.BaseMetricSet, sa.ReportReasonIdx );
+                reportReason = GetReportReason( dataSetIdx );
             }
             return true;
         };
@@ -2563,6 +2959,11 @@ namespace MetricsDiscoveryInternal
 
                     if( !isTimerMode )
                     {
+                        if( !sa.IsCachedReport[dataSetIdx] )
+                        {
+                            sa.OutReportCount[dataSetIdx]++; // Take the report as the current one
+                        }
+
                         return CC_OK; // Return CC_OK if not timer mode
                     }
 
@@ -2586,11 +2987,11 @@ namespace MetricsDiscoveryInternal
         // Read current report
         if( sa.IsCachedReport[dataSetIdx] )
         {
-            reportReason = sa.Calculator->ReadInformationByIndex( sa.CachedReportPtrs[dataSetIdx], *sa.BaseMetricSet, sa.ReportReasonIdx );
+            reportReason = GetReportReason( dataSetIdx );
         }
         else
         {
-            reportReason = sa.Calculator->ReadInformationByIndex( sa.RawData[dataSetIdx], *sa.BaseMetricSet, sa.ReportReasonIdx );
+            reportReason = GetReportReason( dataSetIdx );
             sa.OutReportCount[dataSetIdx]++;
         }
 
@@ -2609,11 +3010,11 @@ namespace MetricsDiscoveryInternal
                 // Check if the new report is a timer report
                 if( sa.IsCachedReport[dataSetIdx] )
                 {
-                    reportReason = sa.Calculator->ReadInformationByIndex( sa.CachedReportPtrs[dataSetIdx], *sa.BaseMetricSet, sa.ReportReasonIdx );
+                    reportReason = GetReportReason( dataSetIdx );
                 }
                 else
                 {
-                    reportReason = sa.Calculator->ReadInformationByIndex( sa.RawData[dataSetIdx], *sa.BaseMetricSet, sa.ReportReasonIdx );
+                    reportReason = GetReportReason( dataSetIdx );
                     sa.OutReportCount[dataSetIdx]++;
                 }
             }
@@ -2636,30 +3037,117 @@ namespace MetricsDiscoveryInternal
     //     CCalculationContext
     //
     // Method:
-    //     GetMaxCurrentTimestamp
+    //     ReadReportHeaders
     //
     // Description:
-    //     Returns the maximum timestamp value among all data sets in the stream aggregation context.
-    //     Iterates over the CurrentTs array and finds the largest timestamp for the current aggregation window.
-    //
-    // Output:
-    //     uint64_t - Maximum timestamp value found across all data sets.
+    //     Reads report reason and timestamp of all raw reports of the current data portion
+    //     for each data set at once, so report filtering and timestamp seeking don't decode
+    //     report headers one by one. Must be called after raw data pointers are set.
+    //     Headers are kept while the data portions are parts of the same raw buffer, e.g.
+    //     when CalculateSingleWindowMetrics is called for consecutive windows, then only
+    //     reports past the already read ones are read, see AreReportHeadersReusable.
+    //     Along with the headers, a sparse timestamp index and GO reports are kept for
+    //     seeking. Data sets are read in parallel, see RunPerDataSet.
     //
     ///////////////////////////////////////////////////////////////////////////////
-    uint64_t CCalculationContext::GetMaxCurrentTimestamp() const
+    void CCalculationContext::ReadReportHeaders()
     {
-        const TStreamAggregationContext& sa    = m_aggregationContext.StreamAggregationContext;
-        uint64_t                         maxTs = 0;
+        TStreamAggregationContext& sa          = m_aggregationContext.StreamAggregationContext;
+        uint32_t                   reportCount = 0;
+
+        if( m_reportHeaders.size() < m_dataSetCount )
+        {
+            m_reportHeaders.resize( m_dataSetCount );
+        }
 
         for( uint32_t i = 0; i < m_dataSetCount; ++i )
         {
-            if( sa.CurrentTs[i] > maxTs )
+            reportCount += sa.RawReportCount[i];
+        }
+
+        // The calculator isn't thread safe, so data sets are read on other threads
+        // only if report reason is a report field read with kernels.
+        TReportField reportReasonField   = {};
+        const bool   isReportReasonField = sa.Calculator->GetInformationField( *sa.BaseMetricSet, sa.ReportReasonIdx, sa.RawReportSize, reportReasonField );
+
+        auto readHeaders = [&]( uint32_t i )
+        {
+            TReportHeaders& headers     = m_reportHeaders[i];
+            uint32_t        firstReport = 0;
+
+            if( !AreReportHeadersReusable( i, firstReport ) )
             {
-                maxTs = sa.CurrentTs[i];
+                headers.RawData             = sa.RawData[i];
+                headers.RawReportCount      = 0;
+                headers.AreTimestampsSorted = true;
+                headers.GoReports.clear();
             }
-        }
 
-        return maxTs;
+            headers.FirstReport = firstReport;
+
+            const uint32_t readFirst = headers.RawReportCount;
+            const uint32_t readEnd   = ( std::max )( readFirst, firstReport + sa.RawReportCount[i] );
+            const uint32_t readCount = readEnd - readFirst;
+
+            if( readCount == 0 )
+            {
+                return;
+            }
+
+            if( headers.RawReportReasons.size() < readEnd )
+            {
+                headers.RawReportReasons.resize( readEnd );
+                headers.RawTimestamps.resize( readEnd );
+            }
+
+            const uint8_t* rawData    = headers.RawData + static_cast<size_t>( readFirst ) * sa.RawReportSize;
+            uint64_t*      reasons    = headers.RawReportReasons.data();
+            uint64_t*      timestamps = headers.RawTimestamps.data();
+
+            if( isReportReasonField )
+            {
+                CReportKernels::ExtractFields( rawData, readCount, sa.RawReportSize, reportReasonField.Offset, reportReasonField.Size, reportReasonField.Shift, reportReasonField.Mask, reasons + readFirst );
+            }
+            else
+            {
+                sa.Calculator->ReadInformationValues( rawData, readCount, sa.RawReportSize, *sa.BaseMetricSet, sa.ReportReasonIdx, reasons + readFirst );
+            }
+
+            CMetricsCalculator::ReadTimestamps( rawData, readCount, sa.RawReportSize, timestamps + readFirst );
+
+            headers.AreTimestampsSorted = headers.AreTimestampsSorted &&
+                ( readFirst == 0 || timestamps[readFirst - 1] <= timestamps[readFirst] ) &&
+                std::is_sorted( timestamps + readFirst, timestamps + readEnd );
+
+            headers.TimestampIndex.resize( ( readEnd + MD_REPORT_TIMESTAMP_INDEX_STRIDE - 1 ) / MD_REPORT_TIMESTAMP_INDEX_STRIDE );
+
+            for( uint32_t k = ( readFirst + MD_REPORT_TIMESTAMP_INDEX_STRIDE - 1 ) / MD_REPORT_TIMESTAMP_INDEX_STRIDE; k < headers.TimestampIndex.size(); ++k )
+            {
+                headers.TimestampIndex[k] = timestamps[k * MD_REPORT_TIMESTAMP_INDEX_STRIDE];
+            }
+
+            for( uint32_t j = readFirst; j < readEnd; ++j )
+            {
+                if( reasons[j] & REPORT_REASON_INTERNAL_GO )
+                {
+                    headers.GoReports.push_back( j );
+                }
+            }
+
+            headers.RawReportCount = readEnd;
+        };
+
+        if( isReportReasonField )
+        {
+            RunPerDataSet( reportCount, readHeaders );
+        }
+        else
+        {
+            for( uint32_t i = 0; i < m_dataSetCount; ++i )
+            {
+                readHeaders( i );
+            }
+        }
     }
 
     ///////////////////////////////////////////////////////////////////////////////
@@ -2668,30 +3156,72 @@ namespace MetricsDiscoveryInternal
     //     CCalculationContext
     //
     // Method:
-    //     GetMinCurrentTimestamp
+    //     AreReportHeadersReusable
     //
     // Description:
-    //     Returns the minimum timestamp value among all data sets in the stream aggregation context.
-    //     Iterates over the CurrentTs array and finds the smallest timestamp for the current aggregation window.
+    //     Checks if the current data portion of a data set is a part of the raw buffer
+    //     its report headers were read from, so they don't need to be read again.
+    //     The portion must start within or right after the read reports, at a report
+    //     boundary. Since a buffer may be refilled in place, read reports within the
+    //     portion are validated against the sparse timestamp index and the first and
+    //     last ones against their timestamps, which costs one read per index stride.
+    //
+    // Input:
+    //     uint32_t  dataSetIdx     - Index of the data set.
     //
     // Output:
-    //     uint64_t - Minimum timestamp value found across all data sets.
+    //     uint32_t& outFirstReport - Index of the first report of the data portion
+    //                                in the read reports.
+    //     bool                     - true if the headers are reusable.
     //
     ///////////////////////////////////////////////////////////////////////////////
-    uint64_t CCalculationContext::GetMinCurrentTimestamp() const
+    bool CCalculationContext::AreReportHeadersReusable( uint32_t dataSetIdx, uint32_t& outFirstReport ) const
     {
-        const TStreamAggregationContext& sa    = m_aggregationContext.StreamAggregationContext;
-        uint64_t                         minTs = sa.MaxAggregationWindowInTicks;
+        const TStreamAggregationContext& sa      = m_aggregationContext.StreamAggregationContext;
+        const TReportHeaders&            headers = m_reportHeaders[dataSetIdx];
+        const uintptr_t                  rawData = reinterpret_cast<uintptr_t>( sa.RawData[dataSetIdx] );
+        const uintptr_t                  read    = reinterpret_cast<uintptr_t>( headers.RawData );
 
-        for( uint32_t i = 0; i < m_dataSetCount; ++i )
+        if( headers.RawReportCount == 0 || rawData < read || ( rawData - read ) % sa.RawReportSize != 0 )
         {
-            if( sa.CurrentTs[i] < minTs )
+            return false;
+        }
+
+        const size_t firstReport = ( rawData - read ) / sa.RawReportSize;
+
+        if( firstReport > headers.RawReportCount )
+        {
+            return false;
+        }
+
+        const size_t validatedEnd = ( std::min )( static_cast<size_t>( headers.RawReportCount ), firstReport + sa.RawReportCount[dataSetIdx] );
+        uint64_t     timestamp    = 0;
+
+        for( size_t k = ( firstReport + MD_REPORT_TIMESTAMP_INDEX_STRIDE - 1 ) / MD_REPORT_TIMESTAMP_INDEX_STRIDE; k * MD_REPORT_TIMESTAMP_INDEX_STRIDE < validatedEnd; ++k )
+        {
+            CMetricsCalculator::ReadTimestamps( headers.RawData + k * MD_REPORT_TIMESTAMP_INDEX_STRIDE * sa.RawReportSize, 1, sa.RawReportSize, &timestamp );
+
+            if( timestamp != headers.TimestampIndex[k] )
             {
-                minTs = sa.CurrentTs[i];
+                return false;
             }
         }
 
-        return minTs;
+        if( validatedEnd > firstReport )
+        {
+            for( const size_t j : { firstReport, validatedEnd - 1 } )
+            {
+                CMetricsCalculator::ReadTimestamps( headers.RawData + j * sa.RawReportSize, 1, sa.RawReportSize, &timestamp );
+
+                if( timestamp != headers.RawTimestamps[j] )
+                {
+                    return false;
+                }
+            }
+        }
+
+        outFirstReport = static_cast<uint32_t>( firstReport );
+        return true;
     }
 
     ///////////////////////////////////////////////////////////////////////////////
@@ -2700,309 +3230,1301 @@ namespace MetricsDiscoveryInternal
     //     CCalculationContext
     //
     // Method:
-    //     IsEnoughData
+    //     GetCalculationThreadCount
     //
     // Description:
-    //     Checks whether all data sets have both previous and last raw data pointers available.
-    //     Returns true if every PrevRawDataPtrs[i] and LastRawDataPtrs[i] in the stream aggregation
-    //     context are not nullptr. Returns false if any required pointer is missing.
+    //     Returns the count of threads aggregation phases may run on, including the
+    //     calling thread. The worker pool is started with it by all the phases, so
+    //     workers aren't restarted between them.
     //
     // Output:
-    //     bool - true if all required data pointers are available, false otherwise.
+    //     uint32_t - calculation thread count, at most MD_CALCULATION_MAX_THREAD_COUNT
     //
     ///////////////////////////////////////////////////////////////////////////////
-    bool CCalculationContext::IsEnoughData() const
+    uint32_t CCalculationContext::GetCalculationThreadCount() const
     {
-        const TStreamAggregationContext& sa = m_aggregationContext.StreamAggregationContext;
-        for( uint32_t i = 0; i < m_dataSetCount; ++i )
+        uint32_t threadCount = m_calculationThreadCount.load();
+
+        if( threadCount == 0 )
         {
-            if( sa.PrevRawDataPtrs[i] == nullptr || sa.LastRawDataPtrs[i] == nullptr )
-            {
-                return false;
-            }
+            threadCount = std::thread::hardware_concurrency();
         }
-        return true;
+
+        return ( std::min )( threadCount, static_cast<uint32_t>( MD_CALCULATION_MAX_THREAD_COUNT ) );
     }
 
-    //////////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////
     //
     // Class:
     //     CCalculationContext
     //
     // Method:
-    //     UpdateAggregationWindowStop
+    //     RunPerDataSet
     //
     // Description:
-    //     Updates the aggregation window stop timestamp in the stream aggregation context.
-    //     This method advances the NsTimeAggregationWindowStop value by the aggregation window size,
-    //     or sets it to the maximum value if the window size is unlimited. It also ensures that
-    //     the stop timestamp does not exceed the end of the current time window.
+    //     Runs a task for each data set. Tasks run on the worker pool if more than one
+    //     calculation thread is set and there are enough reports to amortize waking
+    //     the workers, otherwise on the calling thread in data set order. A task may
+    //     only touch state of its own data set, so results are the same either way.
+    //     Returns when all the tasks are finished.
     //
-    ////////////////////////////////////////////////////////////////////////////////
-    void CCalculationContext::UpdateAggregationWindowStop()
+    // Input:
+    //     uint32_t                               reportCount - raw report count of all the data sets
+    //     const std::function<void( uint32_t )>& task        - task called with a data set index
+    //
+    ///////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::RunPerDataSet( uint32_t reportCount, const std::function<void( uint32_t )>& task )
     {
-        TStreamAggregationContext& sa = m_aggregationContext.StreamAggregationContext;
+        const uint32_t threadCount = GetCalculationThreadCount();
 
-        if( sa.NsTimeAggregationWindow == sa.MaxAggregationWindowInTicks )
-        {
-            sa.NsTimeAggregationWindowStop = sa.NsTimeAggregationWindow;
-        }
-        else
+        if( threadCount > 1 && m_dataSetCount > 1 && reportCount >= MD_CALCULATION_MIN_CHUNK_REPORT_COUNT )
         {
-            sa.NsTimeAggregationWindowStop += sa.NsTimeAggregationWindow;
+            m_workerPool.Start( threadCount );
+            m_workerPool.Run( m_dataSetCount, task );
+            return;
         }
 
-        if( sa.NsTimeAggregationWindowStop > sa.TimeWindows[sa.CalculationWindowIndex].End )
+        for( uint32_t i = 0; i < m_dataSetCount; ++i )
         {
-            sa.NsTimeAggregationWindowStop = sa.TimeWindows[sa.CalculationWindowIndex].End;
+            task( i );
         }
     }
 
-    ////////////////////////////////////////////////////////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////////
     //
     // Class:
     //     CCalculationContext
     //
     // Method:
-    //     Interpolate
+    //     GetRawReportIndex
     //
     // Description:
-    //     Generates interpolated raw reports for each data set at the specified timestamp.
-    //     For each data set, this method linearly interpolates the GpuTicks field and all
-    //     PEC and NOA counters between the previous and last reports, according to the
-    //     report type and field sizes. The report header fields (ReportId, Timestamp, ContextId)
-    //     are set appropriately. If the timestamp matches the last report, the last report is
-    //     copied directly. Any remaining bytes in the report are copied from the previous report.
-    //     The resulting interpolated reports are written to sa.InterpolatedReportPtrs for each data set.
+    //     Returns index of the current raw report of a data set in its read report headers.
     //
     // Input:
-    //     uint64_t timestamp - The timestamp at which to interpolate the report data.
+    //     uint32_t dataSetIdx - Index of the data set.
     //
     // Output:
-    //     The interpolated reports are written directly to sa.InterpolatedReportPtrs for each data set.
+    //     size_t - Index of the current raw report.
     //
-    ////////////////////////////////////////////////////////////////////////////////
-    void CCalculationContext::Interpolate( uint64_t timestamp )
+    ///////////////////////////////////////////////////////////////////////////////
+    size_t CCalculationContext::GetRawReportIndex( uint32_t dataSetIdx ) const
     {
-        TStreamAggregationContext& sa            = m_aggregationContext.StreamAggregationContext;
-        const uint32_t             rawReportSize = sa.RawReportSize;
-        constexpr uint32_t         headerSize    = 4 * sizeof( uint64_t ); // 4 header fields, 8 bytes each
+        const TStreamAggregationContext& sa    = m_aggregationContext.StreamAggregationContext;
+        const TReportHeaders&            headers = m_reportHeaders[dataSetIdx];
+        const size_t                     index   = static_cast<size_t>( sa.RawData[dataSetIdx] - headers.RawData ) / sa.RawReportSize;
 
-        const bool newCalculationWindow = sa.IsNewCalculationWindow;
+        MD_ASSERT( index - headers.FirstReport < sa.RawReportCount[dataSetIdx] );
+        return index;
+    }
 
-        // Reset saved report if starting a new calculation window
-        if( sa.IsNewCalculationWindow )
+    ///////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     GetReportReason
+    //
+    // Description:
+    //     Returns report reason of the current report of a data set, cached or raw one.
+    //
+    // Input:
+    //     uint32_t dataSetIdx - Index of the data set.
+    //
+    // Output:
+    //     uint64_t - Report reason.
+    //
+    ///////////////////////////////////////////////////////////////////////////////
+    uint64_t CCalculationContext::GetReportReason( uint32_t dataSetIdx ) const
+    {
+        if( m_aggregationContext.StreamAggregationContext.IsCachedReport[dataSetIdx] )
         {
-            sa.Calculator->DiscardSavedReport();
-            sa.IsNewCalculationWindow = false;
-        }
+            const TCachedReports& cached = m_cachedReports[dataSetIdx];
 
-        sa.LastAggregatedTimestamp = timestamp;
+            return cached.Segments[cached.ConsumedSegmentCount].ReportReasons[cached.CurrentReport];
+        }
 
-        // Determine PEC/NOA sizes based on report type
-        uint32_t pecCount    = 0;
-        uint32_t pecElemSize = 0;
-        uint32_t noaCount    = 0;
-        uint32_t noaElemSize = 0;
+        return m_reportHeaders[dataSetIdx].RawReportReasons[GetRawReportIndex( dataSetIdx )];
+    }
 
-        switch( sa.MetricSet->GetReportType() )
+    ///////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     GetReportTimestamp
+    //
+    // Description:
+    //     Returns timestamp of the current report of a data set, cached or raw one.
+    //
+    // Input:
+    //     uint32_t dataSetIdx - Index of the data set.
+    //
+    // Output:
+    //     uint64_t - Report timestamp.
+    //
+    ///////////////////////////////////////////////////////////////////////////////
+    uint64_t CCalculationContext::GetReportTimestamp( uint32_t dataSetIdx ) const
+    {
+        if( m_aggregationContext.StreamAggregationContext.IsCachedReport[dataSetIdx] )
         {
-            case OA_REPORT_TYPE_576B_PEC64LL:
-                pecCount    = 64;
-                pecElemSize = sizeof( uint64_t );
-                break;
-
-            case OA_REPORT_TYPE_640B_PEC64LL_NOA16:
-                pecCount    = 64;
-                pecElemSize = sizeof( uint64_t );
-                noaCount    = 16;
-                noaElemSize = sizeof( uint32_t );
-                break;
-
-            case OA_REPORT_TYPE_192B_MPEC8LL_NOA16:
-                pecCount    = 8;
-                pecElemSize = sizeof( uint64_t );
-                noaCount    = 16;
-                noaElemSize = sizeof( uint32_t );
-                break;
-
-            case OA_REPORT_TYPE_128B_MPEC8_NOA16:
-                pecCount    = 8;
-                pecElemSize = sizeof( uint32_t );
-                noaCount    = 16;
-                noaElemSize = sizeof( uint32_t );
-                break;
+            const TCachedReports& cached = m_cachedReports[dataSetIdx];
 
-            case OA_REPORT_TYPE_128B_MERT_PEC8:
-                pecCount    = 8;
-                pecElemSize = sizeof( uint32_t );
-                break;
+            return cached.Segments[cached.ConsumedSegmentCount].Timestamps[cached.CurrentReport];
+        }
 
-            case OA_REPORT_TYPE_192B_MERT_PEC8LL:
-                pecCount    = 8;
-                pecElemSize = sizeof( uint64_t );
-                break;
+        return m_reportHeaders[dataSetIdx].RawTimestamps[GetRawReportIndex( dataSetIdx )];
+    }
 
-            default:
-                for( uint32_t i = 0; i < m_dataSetCount; ++i )
-                {
-                    iu_memcpy_s( sa.InterpolatedReportPtrs[i], rawReportSize, sa.LastRawDataPtrs[i], rawReportSize );
-                }
-                return;
-        }
+    ///////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     NextCachedReport
+    //
+    // Description:
+    //     Consumes the current cached report of a data set and moves to the next one,
+    //     possibly in the next segment. When the last cached report is consumed, the data
+    //     set goes back to raw reports and the cached report pointer is left on the consumed
+    //     report, as it may still be used as the last report. Consumed segments are released
+    //     by the next aggregation call.
+    //
+    // Input:
+    //     uint32_t dataSetIdx - Index of the data set.
+    //
+    // Output:
+    //     bool - true if there is a next cached report, false if all cached reports are consumed.
+    //
+    ///////////////////////////////////////////////////////////////////////////////
+    bool CCalculationContext::NextCachedReport( uint32_t dataSetIdx )
+    {
+        TStreamAggregationContext& sa     = m_aggregationContext.StreamAggregationContext;
+        TCachedReports&            cached = m_cachedReports[dataSetIdx];
 
-        const uint32_t pecSize = pecCount * pecElemSize;
+        MD_ASSERT( sa.IsCachedReport[dataSetIdx] && cached.ConsumedSegmentCount < cached.Segments.size() );
 
-        for( uint32_t i = 0; i < m_dataSetCount; ++i )
+        if( ++cached.CurrentReport == cached.Segments[cached.ConsumedSegmentCount].ReportCount )
         {
-            uint8_t*       interpolatedReport = sa.InterpolatedReportPtrs[i];
-            const uint8_t* prev               = sa.PrevRawDataPtrs[i];
-            const uint8_t* last               = sa.LastRawDataPtrs[i];
-            const uint64_t tsLast             = *reinterpret_cast<const uint64_t*>( last + 8 );
+            cached.ConsumedSegmentCount++;
+            cached.CurrentReport = 0;
 
-            if( timestamp == tsLast )
+            if( cached.ConsumedSegmentCount == cached.Segments.size() )
             {
-                iu_memcpy_s( interpolatedReport, rawReportSize, last, rawReportSize );
-                *reinterpret_cast<uint64_t*>( interpolatedReport + 0 )  = newCalculationWindow ? MD_REPORT_ID_SKIP_CALCULATION : 0; // ReportId
-                *reinterpret_cast<uint64_t*>( interpolatedReport + 16 ) = 0;                                                        // ContextId
-                continue;
+                sa.IsCachedReport[dataSetIdx] = false;
+                return false;
             }
+        }
 
-            // Header fields
-            *reinterpret_cast<uint64_t*>( interpolatedReport + 0 )  = newCalculationWindow ? MD_REPORT_ID_SKIP_CALCULATION : 0; // ReportId
-            *reinterpret_cast<uint64_t*>( interpolatedReport + 8 )  = timestamp;                                                // Timestamp
-            *reinterpret_cast<uint64_t*>( interpolatedReport + 16 ) = 0;                                                        // ContextId
-
-            const uint64_t tsPrev = *reinterpret_cast<const uint64_t*>( prev + 8 );
-
-            // Compute alpha once
-            double alpha = ( tsLast != tsPrev )
-                ? static_cast<double>( timestamp - tsPrev ) / static_cast<double>( tsLast - tsPrev )
-                : 1.0;
+        sa.CachedReportPtrs[dataSetIdx] = cached.Segments[cached.ConsumedSegmentCount].RawData.data() + static_cast<size_t>( cached.CurrentReport ) * sa.RawReportSize;
+        return true;
+    }
 
-            // GpuTicks interpolation
-            const uint64_t prevGpuTicks = *reinterpret_cast<const uint64_t*>( prev + 24 );
-            const uint64_t lastGpuTicks = *reinterpret_cast<const uint64_t*>( last + 24 );
-            const uint64_t gpuTicks     = ( lastGpuTicks >= prevGpuTicks )
-                    ? prevGpuTicks + static_cast<uint64_t>( ( lastGpuTicks - prevGpuTicks ) * alpha )
-                    : prevGpuTicks + static_cast<uint64_t>( ( lastGpuTicks + ( std::numeric_limits<uint64_t>::max() - prevGpuTicks + 1 ) ) * alpha ); // Handle overflow case
+    ///////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     ReleaseConsumedReports
+    //
+    // Description:
+    //     Releases segments of cached reports consumed by the previous aggregation call.
+    //     Reports used as previous or last ones are already copied to saved reports then,
+    //     so only unconsumed segments are kept. A single released segment is kept as a spare
+    //     one, so caching reports call by call doesn't allocate buffers again.
+    //
+    ///////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::ReleaseConsumedReports()
+    {
+        TStreamAggregationContext& sa = m_aggregationContext.StreamAggregationContext;
 
-            *reinterpret_cast<uint64_t*>( interpolatedReport + 24 ) = gpuTicks;
+        if( m_cachedReports.size() < m_dataSetCount )
+        {
+            m_cachedReports.resize( m_dataSetCount );
+        }
 
-            // PEC interpolation
-            const uint8_t* prevPec = prev + headerSize;
-            const uint8_t* lastPec = last + headerSize;
+        for( uint32_t i = 0; i < m_dataSetCount; ++i )
+        {
+            TCachedReports& cached = m_cachedReports[i];
 
-            for( uint32_t m = 0; m < pecCount; ++m )
+            for( ; cached.ConsumedSegmentCount > 0; --cached.ConsumedSegmentCount )
             {
-                uint32_t offset = headerSize + m * pecElemSize;
-
-                if( pecElemSize == sizeof( uint64_t ) )
+                if( cached.Spare.RawData.capacity() < cached.Segments.front().RawData.capacity() )
                 {
-                    const uint64_t valuePrev    = *reinterpret_cast<const uint64_t*>( prevPec + m * sizeof( uint64_t ) );
-                    const uint64_t valueLast    = *reinterpret_cast<const uint64_t*>( lastPec + m * sizeof( uint64_t ) );
-                    const uint64_t interpolated = ( valueLast >= valuePrev )
-                        ? valuePrev + static_cast<uint64_t>( ( valueLast - valuePrev ) * alpha )
-                        : valuePrev + static_cast<uint64_t>( ( valueLast + ( std::numeric_limits<uint64_t>::max() - valuePrev + 1 ) ) * alpha ); // Handle overflow case
-
-                    *reinterpret_cast<uint64_t*>( interpolatedReport + offset ) = interpolated;
+                    cached.Spare = std::move( cached.Segments.front() );
                 }
-                else
-                {
-                    const uint32_t valuePrev    = *reinterpret_cast<const uint32_t*>( prevPec + m * sizeof( uint32_t ) );
-                    const uint32_t valueLast    = *reinterpret_cast<const uint32_t*>( lastPec + m * sizeof( uint32_t ) );
-                    const uint32_t interpolated = ( valueLast >= valuePrev )
-                        ? valuePrev + static_cast<uint32_t>( ( valueLast - valuePrev ) * alpha )
-                        : valuePrev + static_cast<uint32_t>( ( valueLast + ( std::numeric_limits<uint32_t>::max() - valuePrev + 1 ) ) * alpha ); // Handle overflow case
 
-                    *reinterpret_cast<uint32_t*>( interpolatedReport + offset ) = interpolated;
-                }
+                cached.Segments.pop_front();
             }
 
-            // NOA interpolation (if present)
-            if( noaCount > 0 )
+            if( cached.Segments.empty() )
             {
-                const uint8_t* prevNoa = prevPec + pecSize;
-                const uint8_t* lastNoa = lastPec + pecSize;
-                for( uint32_t m = 0; m < noaCount; ++m )
-                {
-                    uint32_t       offset       = headerSize + pecSize + m * noaElemSize;
-                    const uint32_t valuePrev    = *reinterpret_cast<const uint32_t*>( prevNoa + m * noaElemSize );
-                    const uint32_t valueLast    = *reinterpret_cast<const uint32_t*>( lastNoa + m * noaElemSize );
-                    const uint32_t interpolated = ( valueLast >= valuePrev )
-                        ? valuePrev + static_cast<uint32_t>( ( valueLast - valuePrev ) * alpha )
-                        : valuePrev + static_cast<uint32_t>( ( valueLast + ( std::numeric_limits<uint32_t>::max() - valuePrev + 1 ) ) * alpha ); // Handle overflow case
-
-                    *reinterpret_cast<uint32_t*>( interpolatedReport + offset ) = interpolated;
-                }
+                sa.CachedReportPtrs[i] = nullptr;
             }
         }
     }
 
-    ////////////////////////////////////////////////////////////////////////////////
-    //
+    ///////////////////////////////////////////////////////////////////////////////
     //
     // Class:
     //     CCalculationContext
     //
     // Method:
-    //     CacheRemainingReports
+    //     GetMaxCurrentTimestamp
     //
     // Description:
-    //     Caches any remaining raw reports for each data set in the stream aggregation context
-    //     that have not yet been processed. For each data set, if additional reports are available
-    //     and not needed for immediate processing, this method allocates a new buffer to store both
-    //     previously cached reports and the remaining raw reports from the current call. It then
-    //     updates the cached pointers and sizes accordingly, marks the data set as having cached
-    //     reports, and increments the output report count. This ensures that all unprocessed reports
-    //     are preserved for future aggregation or interpolation steps, preventing data loss across
-    //     multiple aggregation windows.
+    //     Returns the maximum timestamp value among all data sets in the stream aggregation context.
+    //     Iterates over the CurrentTs array and finds the largest timestamp for the current aggregation window.
     //
     // Output:
-    //     TCompletionCode - CC_OK on success, or CC_ERROR_NO_MEMORY if allocation fails.
+    //     uint64_t - Maximum timestamp value found across all data sets.
     //
-    ////////////////////////////////////////////////////////////////////////////////
-    TCompletionCode CCalculationContext::CacheRemainingReports()
+    ///////////////////////////////////////////////////////////////////////////////
+    uint64_t CCalculationContext::GetMaxCurrentTimestamp() const
     {
-        TStreamAggregationContext& sa = m_aggregationContext.StreamAggregationContext;
+        const TStreamAggregationContext& sa    = m_aggregationContext.StreamAggregationContext;
+        uint64_t                         maxTs = 0;
 
         for( uint32_t i = 0; i < m_dataSetCount; ++i )
         {
-            uint32_t remainingReportCount = sa.RawReportCount[i] - sa.OutReportCount[i];
-
-            if( !sa.NeedReport[i] && remainingReportCount > 0 )
+            if( sa.CurrentTs[i] > maxTs )
             {
-                const uint32_t remainingRawDataSize = remainingReportCount * sa.RawReportSize;    // remaining raw data size from this call
-                const uint32_t cachedReportPtrSize  = sa.CachedReportPtrsSize[i];                 // cached report size from previous calls
-                const uint32_t sumCachedReportSize  = cachedReportPtrSize + remainingRawDataSize; // total cached report size
-
-                uint8_t* newCachedReportPtrs = new( std::nothrow ) uint8_t[sumCachedReportSize]();
-                MD_CHECK_PTR_RET( newCachedReportPtrs, CC_ERROR_NO_MEMORY );
-
-                if( sa.CachedReportPtrsBase[i] != nullptr && cachedReportPtrSize != 0 )
-                {
-                    iu_memcpy_s( newCachedReportPtrs, cachedReportPtrSize, sa.CachedReportPtrsBase[i], cachedReportPtrSize );
-                    MD_SAFE_DELETE_ARRAY( sa.CachedReportPtrsBase[i] );
-                }
-
-                iu_memcpy_s( newCachedReportPtrs + cachedReportPtrSize, remainingRawDataSize, sa.RawData[i], remainingRawDataSize );
-                sa.CachedReportPtrs[i]     = newCachedReportPtrs;
-                sa.CachedReportPtrsBase[i] = newCachedReportPtrs;
-
-                if( sa.CachedReportPtrsSize[i] > 0 )
-                {
-                    sa.CachedReportPtrsSize[i] += remainingRawDataSize;
-                }
-                else
-                {
-                    sa.CachedReportPtrsSize[i] = remainingRawDataSize;
-                }
-
-                sa.IsCachedReport[i] = true;
-                sa.OutReportCount[i] += remainingReportCount;
+                maxTs = sa.CurrentTs[i];
             }
         }
 
-        return CC_OK;
+        return maxTs;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     GetMinCurrentTimestamp
+    //
+    // Description:
+    //     Returns the minimum timestamp value among all data sets in the stream aggregation context.
+    //     Data sets with a current report are taken from the top of the current timestamp heap,
+    //     only data sets that requested a report are checked one by one.
+    //
+    // Output:
+    //     uint64_t - Minimum timestamp value found across all data sets.
+    //
+    ///////////////////////////////////////////////////////////////////////////////
+    uint64_t CCalculationContext::GetMinCurrentTimestamp()
+    {
+        const TStreamAggregationContext& sa      = m_aggregationContext.StreamAggregationContext;
+        uint64_t                         minTs   = sa.MaxAggregationWindowInTicks;
+        TDataSetTimestamp                minimum = {};
+
+        if( PeekMinTimestamp( minimum ) && minimum.Timestamp < minTs )
+        {
+            minTs = minimum.Timestamp;
+        }
+
+        for( const uint32_t i : m_dataSetQueue.Requested )
+        {
+            if( sa.CurrentTs[i] < minTs )
+            {
+                minTs = sa.CurrentTs[i];
+            }
+        }
+
+        return minTs;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     IsEnoughData
+    //
+    // Description:
+    //     Checks whether all data sets have both previous and last raw data pointers available.
+    //     Returns true if every PrevRawDataPtrs[i] and LastRawDataPtrs[i] in the stream aggregation
+    //     context are not nullptr. Returns false if any required pointer is missing.
+    //
+    // Output:
+    //     bool - true if all required data pointers are available, false otherwise.
+    //
+    ///////////////////////////////////////////////////////////////////////////////
+    bool CCalculationContext::IsEnoughData() const
+    {
+        const TStreamAggregationContext& sa = m_aggregationContext.StreamAggregationContext;
+        for( uint32_t i = 0; i < m_dataSetCount; ++i )
+        {
+            if( sa.PrevRawDataPtrs[i] == nullptr || sa.LastRawDataPtrs[i] == nullptr )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     UpdateAggregationWindowStop
+    //
+    // Description:
+    //     Updates the aggregation window stop timestamp in the stream aggregation context.
+    //     This method advances the NsTimeAggregationWindowStop value by the aggregation window size,
+    //     or sets it to the maximum value if the window size is unlimited. With the window sweep
+    //     it advances to the next boundary of any of the swept windows instead. It also ensures
+    //     that the stop timestamp does not exceed the end of the current time window.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::UpdateAggregationWindowStop()
+    {
+        TStreamAggregationContext& sa = m_aggregationContext.StreamAggregationContext;
+
+        if( IsWindowSweep() )
+        {
+            // Next boundary of any of the swept windows
+            const std::vector<uint64_t>& events = m_windowSweep.Events;
+            const auto                   next   = std::upper_bound( events.begin(), events.end(), sa.NsTimeAggregationWindowStop );
+
+            sa.NsTimeAggregationWindowStop = next != events.end() ? *next : sa.TimeWindows[sa.CalculationWindowIndex].End;
+        }
+        else if( sa.NsTimeAggregationWindow == sa.MaxAggregationWindowInTicks )
+        {
+            sa.NsTimeAggregationWindowStop = sa.NsTimeAggregationWindow;
+        }
+        else
+        {
+            sa.NsTimeAggregationWindowStop += sa.NsTimeAggregationWindow;
+        }
+
+        if( sa.NsTimeAggregationWindowStop > sa.TimeWindows[sa.CalculationWindowIndex].End )
+        {
+            sa.NsTimeAggregationWindowStop = sa.TimeWindows[sa.CalculationWindowIndex].End;
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     Interpolate
+    //
+    // Description:
+    //     Generates interpolated raw reports for each data set at the specified timestamp
+    //     from the current previous and last reports, see InterpolateReports.
+    //
+    // Input:
+    //     uint64_t timestamp - The timestamp at which to interpolate the report data.
+    //
+    // Output:
+    //     The interpolated reports are written directly to sa.InterpolatedReportPtrs for each data set.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::Interpolate( uint64_t timestamp )
+    {
+        TStreamAggregationContext& sa = m_aggregationContext.StreamAggregationContext;
+
+        // The first report of a new calculation window is marked to skip calculation.
+        // The saved report is kept, it ends the previous window in the calculation.
+        const bool newCalculationWindow = sa.IsNewCalculationWindow;
+
+        sa.IsNewCalculationWindow  = false;
+        sa.LastAggregatedTimestamp = timestamp;
+
+        InterpolateReports( timestamp, newCalculationWindow, sa.PrevRawDataPtrs, sa.LastRawDataPtrs, sa.InterpolatedReportPtrs );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     InterpolateReports
+    //
+    // Description:
+    //     For each data set, linearly interpolates the GpuTicks field and all PEC and NOA
+    //     counters between the given previous and last reports, according to the report
+    //     type and field sizes. Counters are interpolated with SIMD kernels using a Q32
+    //     fixed point alpha, see CReportKernels::InterpolateCounters for rounding. The report
+    //     header fields (ReportId, Timestamp, ContextId) are set appropriately. If the timestamp
+    //     matches the last report, the last report is copied directly. Any remaining bytes in
+    //     the report are copied from the previous report. Doesn't change the context, so
+    //     batches of reports may be interpolated concurrently.
+    //
+    // Input:
+    //     uint64_t              timestamp            - The timestamp at which to interpolate the report data.
+    //     bool                  newCalculationWindow - The first report of a calculation window, marked to skip calculation.
+    //     const uint8_t* const* prevRawDataPtrs      - Per data set, the previous report.
+    //     const uint8_t* const* lastRawDataPtrs      - Per data set, the last report.
+    //
+    // Output:
+    //     uint8_t* const* outReportPtrs - Per data set, the interpolated report.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::InterpolateReports( uint64_t timestamp, bool newCalculationWindow, const uint8_t* const* prevRawDataPtrs, const uint8_t* const* lastRawDataPtrs, uint8_t* const* outReportPtrs ) const
+    {
+        const TStreamAggregationContext& sa            = m_aggregationContext.StreamAggregationContext;
+        const uint32_t                   rawReportSize = sa.RawReportSize;
+        constexpr uint32_t               headerSize    = 4 * sizeof( uint64_t ); // 4 header fields, 8 bytes each
+
+        // Determine PEC/NOA sizes based on report type
+        uint32_t pecCount    = 0;
+        uint32_t pecElemSize = 0;
+        uint32_t noaCount    = 0;
+        uint32_t noaElemSize = 0;
+
+        switch( sa.MetricSet->GetReportType() )
+        {
+            case OA_REPORT_TYPE_576B_PEC64LL:
+                pecCount    = 64;
+                pecElemSize = sizeof( uint64_t );
+                break;
+
+            case OA_REPORT_TYPE_640B_PEC64LL_NOA16:
+                pecCount    = 64;
+                pecElemSize = sizeof( uint64_t );
+                noaCount    = 16;
+                noaElemSize = sizeof( uint32_t );
+                break;
+
+            case OA_REPORT_TYPE_192B_MPEC8LL_NOA16:
+                pecCount    = 8;
+                pecElemSize = sizeof( uint64_t );
+                noaCount    = 16;
+                noaElemSize = sizeof( uint32_t );
+                break;
+
+            case OA_REPORT_TYPE_128B_MPEC8_NOA16:
+                pecCount    = 8;
+                pecElemSize = sizeof( uint32_t );
+                noaCount    = 16;
+                noaElemSize = sizeof( uint32_t );
+                break;
+
+            case OA_REPORT_TYPE_128B_MERT_PEC8:
+                pecCount    = 8;
+                pecElemSize = sizeof( uint32_t );
+                break;
+
+            case OA_REPORT_TYPE_192B_MERT_PEC8LL:
+                pecCount    = 8;
+                pecElemSize = sizeof( uint64_t );
+                break;
+
+            default:
+                for( uint32_t i = 0; i < m_dataSetCount; ++i )
+                {
+                    iu_memcpy_s( outReportPtrs[i], rawReportSize, lastRawDataPtrs[i], rawReportSize );
+                }
+                return;
+        }
+
+        const uint32_t pecSize     = pecCount * pecElemSize;
+        const uint32_t countersEnd = ( std::min )( headerSize + pecSize + noaCount * noaElemSize, rawReportSize );
+
+        for( uint32_t i = 0; i < m_dataSetCount; ++i )
+        {
+            uint8_t*       interpolatedReport = outReportPtrs[i];
+            const uint8_t* prev               = prevRawDataPtrs[i];
+            const uint8_t* last               = lastRawDataPtrs[i];
+            const uint64_t tsLast             = *reinterpret_cast<const uint64_t*>( last + 8 );
+
+            if( timestamp == tsLast )
+            {
+                iu_memcpy_s( interpolatedReport, rawReportSize, last, rawReportSize );
+                *reinterpret_cast<uint64_t*>( interpolatedReport + 0 )  = newCalculationWindow ? MD_REPORT_ID_SKIP_CALCULATION : 0; // ReportId
+                *reinterpret_cast<uint64_t*>( interpolatedReport + 16 ) = 0;                                                        // ContextId
+                continue;
+            }
+
+            // Header fields
+            *reinterpret_cast<uint64_t*>( interpolatedReport + 0 )  = newCalculationWindow ? MD_REPORT_ID_SKIP_CALCULATION : 0; // ReportId
+            *reinterpret_cast<uint64_t*>( interpolatedReport + 8 )  = timestamp;                                                // Timestamp
+            *reinterpret_cast<uint64_t*>( interpolatedReport + 16 ) = 0;                                                        // ContextId
+
+            const uint64_t tsPrev = *reinterpret_cast<const uint64_t*>( prev + 8 );
+
+            // Compute alpha once, in Q32 fixed point
+            const uint64_t alphaQ32 = CReportKernels::GetInterpolationAlpha( timestamp, tsPrev, tsLast );
+
+            // GpuTicks interpolation
+            CReportKernels::InterpolateCounters( prev + 24, last + 24, 1, sizeof( uint64_t ), alphaQ32, interpolatedReport + 24 );
+
+            // PEC interpolation
+            CReportKernels::InterpolateCounters( prev + headerSize, last + headerSize, pecCount, pecElemSize, alphaQ32, interpolatedReport + headerSize );
+
+            // NOA interpolation (if present)
+            if( noaCount > 0 )
+            {
+                CReportKernels::InterpolateCounters( prev + headerSize + pecSize, last + headerSize + pecSize, noaCount, noaElemSize, alphaQ32, interpolatedReport + headerSize + pecSize );
+            }
+
+            // Remaining bytes, so the report doesn't depend on reports interpolated before
+            if( countersEnd < rawReportSize )
+            {
+                iu_memcpy_s( interpolatedReport + countersEnd, rawReportSize - countersEnd, prev + countersEnd, rawReportSize - countersEnd );
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     AggregateInterpolatedReports
+    //
+    // Description:
+    //     Queues an aggregated report of all data sets at the given timestamp, see
+    //     QueueAggregatedReport. With the window sweep, the aggregated report is kept
+    //     instead and windows are output from the kept reports by OutputSweptWindows.
+    //
+    // Input:
+    //     uint64_t timestamp - The timestamp at which to interpolate the report data.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::AggregateInterpolatedReports( uint64_t timestamp )
+    {
+        TStreamAggregationContext& sa    = m_aggregationContext.StreamAggregationContext;
+        TWindowSweep&              sweep = m_windowSweep;
+
+        if( !IsWindowSweep() )
+        {
+            ReserveAggregatedReports( 1 );
+            QueueAggregatedReport( timestamp, sa.OutAggregatedRawDataSize );
+
+            sa.OutAggregatedRawDataSize += sa.RawReportSize;
+            return;
+        }
+
+        if( !sweep.SnapshotTimestamps.empty() && timestamp <= sweep.SnapshotTimestamps.back() )
+        {
+            // Kept reports are looked up by their timestamps, so they must be ascending
+            return;
+        }
+
+        // Aggregation writes to the kept report instead of the output
+        const size_t offset = sweep.Snapshots.size();
+
+        sweep.Snapshots.resize( offset + sa.RawReportSize );
+        sweep.SnapshotTimestamps.push_back( timestamp );
+
+        QueueAggregatedReport( timestamp, static_cast<uint32_t>( offset ) );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     QueueAggregatedReport
+    //
+    // Description:
+    //     Queues an aggregated report of all data sets at the given timestamp, from the
+    //     current previous and last reports. Queued reports are aggregated when the batch
+    //     is full, or by AggregateQueuedReports before the output or the reports they
+    //     are interpolated from are used otherwise.
+    //
+    // Input:
+    //     uint64_t timestamp - The timestamp at which to interpolate the report data.
+    //     uint32_t outOffset - Offset of the aggregated report, in the output or the kept reports with the window sweep.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::QueueAggregatedReport( uint64_t timestamp, uint32_t outOffset )
+    {
+        TStreamAggregationContext& sa    = m_aggregationContext.StreamAggregationContext;
+        TAggregationBatch&         batch = m_aggregationBatch;
+
+        if( batch.Timestamps.size() < MD_AGGREGATION_BATCH_REPORT_COUNT )
+        {
+            batch.Timestamps.resize( MD_AGGREGATION_BATCH_REPORT_COUNT );
+            batch.OutOffsets.resize( MD_AGGREGATION_BATCH_REPORT_COUNT );
+            batch.IsNewCalculationWindow.resize( MD_AGGREGATION_BATCH_REPORT_COUNT );
+        }
+        if( batch.PrevRawDataPtrs.size() < static_cast<size_t>( MD_AGGREGATION_BATCH_REPORT_COUNT ) * m_dataSetCount )
+        {
+            batch.PrevRawDataPtrs.resize( static_cast<size_t>( MD_AGGREGATION_BATCH_REPORT_COUNT ) * m_dataSetCount );
+            batch.LastRawDataPtrs.resize( static_cast<size_t>( MD_AGGREGATION_BATCH_REPORT_COUNT ) * m_dataSetCount );
+        }
+
+        const uint32_t report = batch.ReportCount;
+        const size_t   first  = static_cast<size_t>( report ) * m_dataSetCount;
+
+        batch.Timestamps[report]             = timestamp;
+        batch.OutOffsets[report]             = outOffset;
+        batch.IsNewCalculationWindow[report] = sa.IsNewCalculationWindow;
+
+        std::copy( sa.PrevRawDataPtrs, sa.PrevRawDataPtrs + m_dataSetCount, batch.PrevRawDataPtrs.begin() + first );
+        std::copy( sa.LastRawDataPtrs, sa.LastRawDataPtrs + m_dataSetCount, batch.LastRawDataPtrs.begin() + first );
+
+        // See Interpolate
+        sa.IsNewCalculationWindow  = false;
+        sa.LastAggregatedTimestamp = timestamp;
+
+        if( ++batch.ReportCount == MD_AGGREGATION_BATCH_REPORT_COUNT )
+        {
+            AggregateQueuedReports();
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     AggregateQueuedReports
+    //
+    // Description:
+    //     Interpolates and aggregates the queued reports. Queued reports are split to
+    //     contiguous ranges run on the worker pool, each range with its own interpolated
+    //     reports, if more than one calculation thread is set and there are enough reports
+    //     to amortize waking the workers. Otherwise they are aggregated on the calling
+    //     thread. Each aggregated report is written to its own offset, so results are
+    //     the same either way.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::AggregateQueuedReports()
+    {
+        TAggregationBatch& batch       = m_aggregationBatch;
+        const uint32_t     reportCount = batch.ReportCount;
+
+        if( reportCount == 0 )
+        {
+            return;
+        }
+
+        batch.ReportCount = 0;
+
+        const uint32_t rawReportSize  = m_aggregationContext.StreamAggregationContext.RawReportSize;
+        const uint32_t threadCount    = GetCalculationThreadCount();
+        const bool     isParallel     = threadCount > 1 && reportCount * m_dataSetCount >= MD_CALCULATION_MIN_CHUNK_REPORT_COUNT;
+        const uint32_t taskCount      = isParallel ? ( std::min )( threadCount, reportCount ) : 1;
+        const size_t   reportPtrCount = static_cast<size_t>( taskCount ) * m_dataSetCount;
+
+        if( batch.InterpolatedReportPtrs.size() < reportPtrCount )
+        {
+            batch.InterpolatedReports.resize( reportPtrCount * rawReportSize );
+            batch.InterpolatedReportPtrs.resize( reportPtrCount );
+
+            for( size_t i = 0; i < reportPtrCount; ++i )
+            {
+                batch.InterpolatedReportPtrs[i] = batch.InterpolatedReports.data() + i * rawReportSize;
+            }
+        }
+
+        // With the window sweep, reports are kept instead of output
+        uint8_t* const out = IsWindowSweep()
+            ? m_windowSweep.Snapshots.data()
+            : m_aggregationContext.StreamAggregationContext.Out;
+
+        auto aggregateReports = [&]( uint32_t task )
+        {
+            const uint32_t firstReport = static_cast<uint32_t>( static_cast<uint64_t>( reportCount ) * task / taskCount );
+            const uint32_t endReport   = static_cast<uint32_t>( static_cast<uint64_t>( reportCount ) * ( task + 1 ) / taskCount );
+
+            // The context is copied, so tasks don't share their interpolated reports and output offsets
+            TAggregationContext        context = m_aggregationContext;
+            TStreamAggregationContext& sa      = context.StreamAggregationContext;
+
+            sa.InterpolatedReportPtrs = batch.InterpolatedReportPtrs.data() + static_cast<size_t>( task ) * m_dataSetCount;
+            sa.Out                    = out;
+
+            for( uint32_t i = firstReport; i < endReport; ++i )
+            {
+                const size_t first = static_cast<size_t>( i ) * m_dataSetCount;
+
+                InterpolateReports( batch.Timestamps[i], batch.IsNewCalculationWindow[i] != 0, batch.PrevRawDataPtrs.data() + first, batch.LastRawDataPtrs.data() + first, sa.InterpolatedReportPtrs );
+
+                sa.OutAggregatedRawDataSize = batch.OutOffsets[i];
+                m_calculationManager->AggregateCounters( context );
+            }
+        };
+
+        if( taskCount > 1 )
+        {
+            m_workerPool.Start( threadCount );
+            m_workerPool.Run( taskCount, aggregateReports );
+            return;
+        }
+
+        aggregateReports( 0 );
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     InitializeWindowSweep
+    //
+    // Description:
+    //     If time windows overlap or aren't sorted by their start, prepares a single pass sweep
+    //     over them instead of aggregating them one by one: the stream is aggregated as a single
+    //     window covering all of them, stopping at each unique boundary of any window once,
+    //     however many windows share it. Aggregated reports hold cumulative counters, so each
+    //     window is then made of the reports at its boundaries, and the deltas between them are
+    //     the window deltas. Windows are output in the caller order, see OutputSweptWindows.
+    //     Must be called after time windows are converted to GPU timestamp ticks.
+    //
+    // Output:
+    //     TCompletionCode - CC_OK on success, or an appropriate error code on failure.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CCalculationContext::InitializeWindowSweep()
+    {
+        TStreamAggregationContext& sa          = m_aggregationContext.StreamAggregationContext;
+        TWindowSweep&              sweep       = m_windowSweep;
+        TTimeWindowLatest* const   windows     = sa.TimeWindows;
+        const uint32_t             windowCount = sa.TimeWindowCount;
+
+        if( windowCount == 0 )
+        {
+            return CC_OK;
+        }
+
+        auto isEarlier = []( const TTimeWindowLatest& left, const TTimeWindowLatest& right )
+        {
+            return left.Start != right.Start
+                ? left.Start < right.Start
+                : left.End < right.End;
+        };
+
+        // Windows keep the caller order, a sorted copy only finds overlaps
+        std::vector<TTimeWindowLatest> sortedWindows( windows, windows + windowCount );
+        std::sort( sortedWindows.begin(), sortedWindows.end(), isEarlier );
+
+        const bool isSorted      = std::is_sorted( windows, windows + windowCount, isEarlier );
+        bool       isOverlapping = false;
+        uint64_t   end           = sortedWindows[0].End;
+
+        for( uint32_t i = 1; i < windowCount; ++i )
+        {
+            isOverlapping = isOverlapping || sortedWindows[i].Start < end;
+            end           = ( std::max )( end, sortedWindows[i].End );
+        }
+
+        if( ( isSorted && !isOverlapping ) || sa.NsTimeAggregationWindow == 0 )
+        {
+            return CC_OK;
+        }
+
+        sweep.FirstBoundaries.reserve( windowCount + 1 );
+        sweep.RemainingStarts.resize( windowCount );
+
+        for( uint32_t i = 0; i < windowCount; ++i )
+        {
+            const TTimeWindowLatest& window = windows[i];
+
+            sweep.FirstBoundaries.push_back( static_cast<uint32_t>( sweep.Boundaries.size() ) );
+            sweep.Boundaries.push_back( window.Start );
+
+            // Same stops as UpdateAggregationWindowStop gives for a single window
+            for( uint64_t stop = window.Start; window.End - stop > sa.NsTimeAggregationWindow; )
+            {
+                stop += sa.NsTimeAggregationWindow;
+                sweep.Boundaries.push_back( stop );
+            }
+
+            if( window.End > window.Start )
+            {
+                sweep.Boundaries.push_back( window.End );
+            }
+        }
+
+        // Kept reports are released only before all the windows not output yet
+        sweep.RemainingStarts[windowCount - 1] = windows[windowCount - 1].Start;
+
+        for( uint32_t i = windowCount - 1; i > 0; --i )
+        {
+            sweep.RemainingStarts[i - 1] = ( std::min )( windows[i - 1].Start, sweep.RemainingStarts[i] );
+        }
+
+        sweep.FirstBoundaries.push_back( static_cast<uint32_t>( sweep.Boundaries.size() ) );
+
+        sweep.Events = sweep.Boundaries;
+        std::sort( sweep.Events.begin(), sweep.Events.end() );
+        sweep.Events.erase( std::unique( sweep.Events.begin(), sweep.Events.end() ), sweep.Events.end() );
+
+        sweep.FirstSnapshot = 0;
+        sweep.NextWindow    = 0;
+        sweep.FirstPending  = 0;
+        sweep.PendingCount  = 0;
+
+        // The stream is aggregated as a single window covering all the windows
+        TTimeWindowLatest* coveringWindow = new( std::nothrow ) TTimeWindowLatest[1];
+
+        if( coveringWindow == nullptr )
+        {
+            m_windowSweep = TWindowSweep();
+            return CC_ERROR_NO_MEMORY;
+        }
+
+        coveringWindow[0].Start = sweep.Events.front();
+        coveringWindow[0].End   = sweep.Events.back();
+
+        MD_SAFE_DELETE_ARRAY( sa.TimeWindows );
+
+        sa.TimeWindows     = coveringWindow;
+        sa.TimeWindowCount = 1;
+
+        return CC_OK;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     IsWindowSweep
+    //
+    // Description:
+    //     Returns true if overlapping or unsorted time windows are aggregated with a single pass sweep.
+    //
+    // Output:
+    //     bool - true if the window sweep is used.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    bool CCalculationContext::IsWindowSweep() const
+    {
+        return !m_windowSweep.FirstBoundaries.empty();
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     OutputSweptWindows
+    //
+    // Description:
+    //     Outputs swept windows with all their boundaries reached, or all the remaining
+    //     windows if the aggregation is finished, in the caller order. A window is made of
+    //     the first kept report at or after its start, which skips calculation, followed by
+    //     the kept reports at its next boundaries. If the data ends within the window,
+    //     the last kept report ends it. Windows without data aren't output. Kept reports
+    //     before the earliest start of the windows not output yet are released.
+    //
+    // Input:
+    //     bool isFinished - true if no more reports will be kept.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::OutputSweptWindows( bool isFinished )
+    {
+        TStreamAggregationContext& sa            = m_aggregationContext.StreamAggregationContext;
+        TWindowSweep&              sweep         = m_windowSweep;
+        const uint32_t             rawReportSize = sa.RawReportSize;
+        const uint32_t             windowCount   = static_cast<uint32_t>( sweep.FirstBoundaries.size() - 1 );
+        const uint64_t*            timestamps    = sweep.SnapshotTimestamps.data();
+        const size_t               first         = sweep.FirstSnapshot;
+        const size_t               count         = sweep.SnapshotTimestamps.size();
+
+        for( ; sweep.NextWindow < windowCount; ++sweep.NextWindow )
+        {
+            const uint64_t* boundary    = sweep.Boundaries.data() + sweep.FirstBoundaries[sweep.NextWindow];
+            const uint64_t* boundaryEnd = sweep.Boundaries.data() + sweep.FirstBoundaries[sweep.NextWindow + 1];
+            const uint64_t  windowEnd   = *( boundaryEnd - 1 );
+
+            if( !isFinished && ( count == first || timestamps[count - 1] < windowEnd ) )
+            {
+                break;
+            }
+
+            // Each window is output at once, at most a report per its boundary
+            ReserveAggregatedReports( static_cast<uint32_t>( boundaryEnd - boundary ) );
+
+            size_t   snapshot    = std::lower_bound( timestamps + first, timestamps + count, *boundary ) - timestamps;
+            uint8_t* out         = sa.Out + sa.OutAggregatedRawDataSize;
+            uint32_t reportCount = 0;
+
+            auto outputReport = [&]( size_t index )
+            {
+                uint8_t* report = out + static_cast<size_t>( reportCount ) * rawReportSize;
+
+                iu_memcpy_s( report, rawReportSize, sweep.Snapshots.data() + index * rawReportSize, rawReportSize );
+                *reinterpret_cast<uint64_t*>( report ) = reportCount == 0 ? MD_REPORT_ID_SKIP_CALCULATION : 0; // ReportId
+
+                ++reportCount;
+            };
+
+            if( snapshot == count || timestamps[snapshot] >= windowEnd )
+            {
+                // No data within the window
+                continue;
+            }
+
+            outputReport( snapshot );
+
+            for( ++boundary; boundary < boundaryEnd; ++boundary )
+            {
+                if( *boundary <= timestamps[snapshot] )
+                {
+                    // Boundary before the data start
+                    continue;
+                }
+
+                const size_t next = std::lower_bound( timestamps + snapshot + 1, timestamps + count, *boundary ) - timestamps;
+
+                if( next == count || timestamps[next] != *boundary )
+                {
+                    // The data ends within the window
+                    MD_ASSERT( next == count );
+
+                    if( next - 1 > snapshot )
+                    {
+                        outputReport( next - 1 );
+                    }
+                    break;
+                }
+
+                snapshot = next;
+                outputReport( snapshot );
+            }
+
+            if( reportCount > 1 )
+            {
+                // The first report skips calculation, so each window starts a new one as in Interpolate
+                sa.OutAggregatedRawDataSize += reportCount * rawReportSize;
+            }
+        }
+
+        // Release kept reports not needed by the next windows
+        sweep.FirstSnapshot = ( sweep.NextWindow < windowCount )
+            ? static_cast<uint32_t>( std::lower_bound( timestamps + first, timestamps + count, sweep.RemainingStarts[sweep.NextWindow] ) - timestamps )
+            : static_cast<uint32_t>( count );
+
+        if( sweep.FirstSnapshot > 0 && sweep.FirstSnapshot * 2 >= count )
+        {
+            // Removed once released reports are the majority, so each report is moved once on average
+            sweep.Snapshots.erase( sweep.Snapshots.begin(), sweep.Snapshots.begin() + static_cast<size_t>( sweep.FirstSnapshot ) * rawReportSize );
+            sweep.SnapshotTimestamps.erase( sweep.SnapshotTimestamps.begin(), sweep.SnapshotTimestamps.begin() + sweep.FirstSnapshot );
+            sweep.FirstSnapshot = 0;
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     AggregateSweptSingleWindow
+    //
+    // Description:
+    //     Single window aggregation with the window sweep. Raw data is aggregated with
+    //     AggregateStreamData only when all the windows output so far are returned, and
+    //     the output windows are kept as pending reports. Each call returns the next
+    //     aggregation window of them in the caller order: the window start report, which
+    //     skips calculation, with the next report, or a single next report. Raw data isn't
+    //     processed while pending reports are returned.
+    //
+    // Input:
+    //     const uint8_t** rawData                  - pointer to an array of pointers to raw data buffers to be aggregated.
+    //     const uint32_t* rawDataSizes             - pointer to an array of sizes corresponding to each raw data buffer.
+    //     uint8_t*        outAggregatedRawData     - pointer to the output buffer for up to two aggregated reports.
+    //     bool            lastDataPortion          - Indicates if this is the last portion of data.
+    //
+    // Output:
+    //     TCompletionCode                          - CC_OK on success, CC_NOT_ENOUGH_DATA if more data is needed.
+    //     uint32_t*       outProcessedRawDataCount - pointer to an array that will receive the count of processed raw data for each data set.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CCalculationContext::AggregateSweptSingleWindow( const uint8_t** rawData, const uint32_t* rawDataSizes, uint8_t* outAggregatedRawData, uint32_t* outProcessedRawDataCount, bool lastDataPortion )
+    {
+        TStreamAggregationContext& sa            = m_aggregationContext.StreamAggregationContext;
+        TWindowSweep&              sweep         = m_windowSweep;
+        const uint32_t             rawReportSize = sa.RawReportSize;
+
+        MD_CHECK_PTR_RET( outAggregatedRawData, CC_ERROR_INVALID_PARAMETER );
+        MD_CHECK_PTR_RET( outProcessedRawDataCount, CC_ERROR_INVALID_PARAMETER );
+
+        for( uint32_t i = 0; i < m_dataSetCount; ++i )
+        {
+            outProcessedRawDataCount[i] = 0;
+        }
+
+        if( sweep.FirstPending == sweep.PendingCount && m_state != CALCULATION_CONTEXT_STATE_FINISHED )
+        {
+            // Each swept window is output once, with at most a report per its boundary
+            const size_t pendingSize = sweep.Boundaries.size() * rawReportSize;
+            uint32_t     outSize     = 0;
+
+            if( sweep.PendingReports.size() < pendingSize )
+            {
+                sweep.PendingReports.resize( pendingSize );
+            }
+
+            TCompletionCode ret = AggregateStreamData( rawData, rawDataSizes, sweep.PendingReports.data(), &outSize, lastDataPortion );
+            MD_CHECK_CC_RET( ret );
+
+            sweep.FirstPending = 0;
+            sweep.PendingCount = outSize / rawReportSize;
+
+            for( uint32_t i = 0; i < m_dataSetCount; ++i )
+            {
+                outProcessedRawDataCount[i] = static_cast<uint32_t>( sa.OutReportCount[i] * rawReportSize );
+            }
+        }
+
+        sa.Out                      = outAggregatedRawData;
+        sa.OutAggregatedRawDataSize = 0;
+
+        if( sweep.FirstPending == sweep.PendingCount )
+        {
+            return m_state == CALCULATION_CONTEXT_STATE_FINISHED
+                ? CC_OK
+                : CC_NOT_ENOUGH_DATA;
+        }
+
+        const uint8_t* report = sweep.PendingReports.data() + static_cast<size_t>( sweep.FirstPending ) * rawReportSize;
+
+        // A window start is always followed by a report of the same window, see OutputSweptWindows
+        const uint32_t reportCount = ( *reinterpret_cast<const uint64_t*>( report ) == MD_REPORT_ID_SKIP_CALCULATION ) ? 2 : 1;
+
+        MD_ASSERT( sweep.FirstPending + reportCount <= sweep.PendingCount );
+
+        iu_memcpy_s( outAggregatedRawData, reportCount * rawReportSize, report, reportCount * rawReportSize );
+
+        sa.OutAggregatedRawDataSize = reportCount * rawReportSize;
+        sweep.FirstPending += reportCount;
+
+        return CC_OK;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     CacheRemainingReports
+    //
+    // Description:
+    //     Caches any remaining raw reports for each data set in the stream aggregation context
+    //     that have not yet been processed. For each data set, if additional reports are available
+    //     and not needed for immediate processing, the remaining raw reports from the current call
+    //     are appended to cached reports as a new segment, so previously cached reports are never
+    //     copied again. It then marks the data set as having cached reports and increments
+    //     the output report count. This ensures that all unprocessed reports are preserved for
+    //     future aggregation or interpolation steps, preventing data loss across multiple
+    //     aggregation windows. Consumed segments are released by ReleaseConsumedReports.
+    //
+    // Output:
+    //     TCompletionCode - CC_OK on success.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CCalculationContext::CacheRemainingReports()
+    {
+        TStreamAggregationContext& sa          = m_aggregationContext.StreamAggregationContext;
+        uint32_t                   reportCount = 0;
+
+        for( uint32_t i = 0; i < m_dataSetCount; ++i )
+        {
+            reportCount += sa.RawReportCount[i] - sa.OutReportCount[i];
+        }
+
+        auto cacheReports = [&]( uint32_t i )
+        {
+            uint32_t remainingReportCount = sa.RawReportCount[i] - sa.OutReportCount[i];
+
+            if( !sa.NeedReport[i] && remainingReportCount > 0 )
+            {
+                const size_t remainingRawDataSize = static_cast<size_t>( remainingReportCount ) * sa.RawReportSize; // remaining raw data size from this call
+                const size_t firstRawReport       = GetRawReportIndex( i );
+
+                TCachedReports&       cached  = m_cachedReports[i];
+                const TReportHeaders& headers = m_reportHeaders[i];
+                TCachedReportSegment  segment = std::move( cached.Spare );
+
+                // Reports are appended as a new segment, previously cached ones aren't copied again.
+                // Headers of cached reports are taken from this call, they are never read again.
+                segment.ReportCount = remainingReportCount;
+                segment.RawData.assign( sa.RawData[i], sa.RawData[i] + remainingRawDataSize );
+                segment.ReportReasons.assign( headers.RawReportReasons.begin() + firstRawReport, headers.RawReportReasons.begin() + firstRawReport + remainingReportCount );
+                segment.Timestamps.assign( headers.RawTimestamps.begin() + firstRawReport, headers.RawTimestamps.begin() + firstRawReport + remainingReportCount );
+
+                cached.Spare = TCachedReportSegment();
+                cached.Segments.push_back( std::move( segment ) );
+
+                if( !sa.IsCachedReport[i] )
+                {
+                    // All previous segments are consumed, the new one becomes the current one
+                    cached.ConsumedSegmentCount = static_cast<uint32_t>( cached.Segments.size() - 1 );
+                    cached.CurrentReport        = 0;
+                    sa.CachedReportPtrs[i]      = cached.Segments.back().RawData.data();
+                }
+
+                sa.IsCachedReport[i] = true;
+                sa.OutReportCount[i] += remainingReportCount;
+            }
+        };
+
+        // Data sets are cached in parallel, see RunPerDataSet.
+        RunPerDataSet( reportCount, cacheReports );
+
+        return CC_OK;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     CalculateFusedReports
+    //
+    // Description:
+    //     Calculates aggregated reports and appends calculated reports (and max values,
+    //     if requested) to the output of AggregateAndCalculateMetrics. The last report is
+    //     saved by the calculator, so the next reports continue the calculation.
+    //
+    // Input:
+    //     const uint8_t* rawData     - aggregated reports.
+    //     uint32_t       rawDataSize - size of aggregated reports in bytes.
+    //
+    // Output:
+    //     TCompletionCode - CC_OK on success, or an appropriate error code on failure.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CCalculationContext::CalculateFusedReports( const uint8_t* rawData, uint32_t rawDataSize )
+    {
+        MD_CHECK_PTR_RET( m_metricSet, CC_ERROR_INVALID_PARAMETER );
+
+        TMetricSetParamsLatest* params = m_metricSet->GetParams();
+        MD_CHECK_PTR_RET( params, CC_ERROR_INVALID_PARAMETER );
+
+        TFusedCalculation& fc                    = m_fusedCalculation;
+        const uint32_t     outReportValues       = params->MetricsCount + params->InformationCount;
+        const uint32_t     maxValuesReportValues = params->MetricsCount;
+        const uint32_t     rawReportCount        = rawDataSize / m_calculationContext.CommonCalculationContext.RawReportSize;
+        const size_t       reportCount           = static_cast<size_t>( fc.OutReportCount ) + rawReportCount;
+
+        // Output buffers only grow, so steady calls don't allocate
+        if( fc.Out.size() < reportCount * outReportValues )
+        {
+            fc.Out.resize( reportCount * outReportValues );
+        }
+        if( fc.IsMaxValues && fc.OutMaxValues.size() < reportCount * maxValuesReportValues )
+        {
+            fc.OutMaxValues.resize( reportCount * maxValuesReportValues );
+        }
+
+        TTypedValue_1_0* out            = fc.Out.data() + static_cast<size_t>( fc.OutReportCount ) * outReportValues;
+        TTypedValue_1_0* outMaxValues   = fc.IsMaxValues ? fc.OutMaxValues.data() + static_cast<size_t>( fc.OutReportCount ) * maxValuesReportValues : nullptr;
+        uint32_t         outReportCount = 0;
+
+        const TCompletionCode ret = CalculateReports(
+            rawData,
+            rawDataSize,
+            out,
+            rawReportCount * outReportValues * sizeof( TTypedValue_1_0 ),
+            &outReportCount,
+            outMaxValues,
+            fc.IsMaxValues ? rawReportCount * maxValuesReportValues * sizeof( TTypedValue_1_0 ) : 0,
+            nullptr );
+
+        fc.OutReportCount += outReportCount;
+
+        return ret;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     CalculateAggregatedReports
+    //
+    // Description:
+    //     Within AggregateAndCalculateMetrics, calculates reports aggregated so far and
+    //     starts the aggregated output over. The first calculation error is kept and
+    //     returned when the aggregation ends.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::CalculateAggregatedReports()
+    {
+        TStreamAggregationContext& sa = m_aggregationContext.StreamAggregationContext;
+        TFusedCalculation&         fc = m_fusedCalculation;
+
+        if( !fc.IsEnabled )
+        {
+            return;
+        }
+
+        AggregateQueuedReports();
+
+        if( sa.OutAggregatedRawDataSize == 0 )
+        {
+            return;
+        }
+
+        const TCompletionCode ret = CalculateFusedReports( sa.Out, sa.OutAggregatedRawDataSize );
+
+        if( fc.Result == CC_OK )
+        {
+            fc.Result = ret;
+        }
+
+        sa.OutAggregatedRawDataSize = 0;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CCalculationContext
+    //
+    // Method:
+    //     ReserveAggregatedReports
+    //
+    // Description:
+    //     Within AggregateAndCalculateMetrics, makes room for the given count of
+    //     aggregated reports in the output. Reports aggregated so far are calculated
+    //     first if they don't leave enough room, the output grows only if a single
+    //     swept window doesn't fit.
+    //
+    // Input:
+    //     uint32_t reportCount - aggregated reports about to be output.
+    //
+    ////////////////////////////////////////////////////////////////////////////////
+    void CCalculationContext::ReserveAggregatedReports( uint32_t reportCount )
+    {
+        TStreamAggregationContext& sa = m_aggregationContext.StreamAggregationContext;
+        TFusedCalculation&         fc = m_fusedCalculation;
+
+        if( !fc.IsEnabled )
+        {
+            return;
+        }
+
+        const size_t size = static_cast<size_t>( reportCount ) * sa.RawReportSize;
+
+        if( sa.OutAggregatedRawDataSize + size > fc.RawData.size() )
+        {
+            CalculateAggregatedReports();
+        }
+        if( size > fc.RawData.size() )
+        {
+            fc.RawData.resize( size );
+            sa.Out = fc.RawData.data();
+        }
     }
 } // namespace MetricsDiscoveryInternal
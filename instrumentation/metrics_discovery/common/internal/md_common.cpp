@@ -313,6 +313,66 @@ namespace MetricsDiscovery
     {
         return nullptr;
     }
+    IMetricSet_1_17::~IMetricSet_1_17()
+    {
+    }
+    TCompletionCode IMetricSet_1_17::SetCalculationProjection( [[maybe_unused]] const uint32_t* metricIndices, [[maybe_unused]] uint32_t metricIndicesCount )
+    {
+        return CC_ERROR_NOT_SUPPORTED;
+    }
+    TCompletionCode IMetricSet_1_17::SetCalculationProjectionByNames( [[maybe_unused]] const char** symbolNames, [[maybe_unused]] uint32_t symbolNamesCount )
+    {
+        return CC_ERROR_NOT_SUPPORTED;
+    }
+    TCompletionCode IMetricSet_1_17::CalculateMetricColumns( [[maybe_unused]] const uint8_t* rawData, [[maybe_unused]] uint32_t rawDataSize, [[maybe_unused]] TCalculationOutputDescriptor_1_17* outDescriptor, [[maybe_unused]] uint32_t* outReportCount )
+    {
+        return CC_ERROR_NOT_SUPPORTED;
+    }
+    TCompletionCode IMetricSet_1_17::SetCalculationThreadCount( [[maybe_unused]] uint32_t threadCount )
+    {
+        return CC_ERROR_NOT_SUPPORTED;
+    }
+    TCompletionCode IMetricSet_1_17::CreateStreamCalculation( [[maybe_unused]] bool calculateMaxValues, [[maybe_unused]] IStreamCalculation_1_17** streamCalculation )
+    {
+        return CC_ERROR_NOT_SUPPORTED;
+    }
+    TCompletionCode IMetricSet_1_17::DestroyStreamCalculation( [[maybe_unused]] IStreamCalculation_1_17* streamCalculation )
+    {
+        return CC_ERROR_NOT_SUPPORTED;
+    }
+    TCompletionCode IMetricSet_1_17::CreateRangeIndex( [[maybe_unused]] const uint8_t* rawData, [[maybe_unused]] uint32_t rawDataSize, [[maybe_unused]] bool calculateMaxValues, [[maybe_unused]] IRangeIndex_1_17** rangeIndex )
+    {
+        return CC_ERROR_NOT_SUPPORTED;
+    }
+    TCompletionCode IMetricSet_1_17::DestroyRangeIndex( [[maybe_unused]] IRangeIndex_1_17* rangeIndex )
+    {
+        return CC_ERROR_NOT_SUPPORTED;
+    }
+
+    // Stream calculation interface.
+    IStreamCalculation_1_17::~IStreamCalculation_1_17()
+    {
+    }
+    TCompletionCode IStreamCalculation_1_17::Push( [[maybe_unused]] const uint8_t* rawData, [[maybe_unused]] uint32_t rawDataSize, [[maybe_unused]] const TTypedValue_1_0** out, [[maybe_unused]] const TTypedValue_1_0** outMaxValues, [[maybe_unused]] uint32_t* outReportCount )
+    {
+        return CC_ERROR_NOT_SUPPORTED;
+    }
+    void IStreamCalculation_1_17::Reset( void )
+    {
+    }
+
+    // Range index interface.
+    IRangeIndex_1_17::~IRangeIndex_1_17()
+    {
+    }
+    TCompletionCode IRangeIndex_1_17::GetTimeRange( [[maybe_unused]] uint64_t* outStartTimestamp, [[maybe_unused]] uint64_t* outEndTimestamp )
+    {
+        return CC_ERROR_NOT_SUPPORTED;
+    }
+    TCompletionCode IRangeIndex_1_17::CalculateRange( [[maybe_unused]] uint64_t startTimestamp, [[maybe_unused]] uint64_t endTimestamp, [[maybe_unused]] const TTypedValue_1_0** out, [[maybe_unused]] const TTypedValue_1_0** outMaxValues )
+    {
+        return CC_ERROR_NOT_SUPPORTED;
+    }
 
     // Metric interface.
     IMetric_1_0::~IMetric_1_0()
@@ -518,6 +578,21 @@ namespace MetricsDiscovery
     {
         return CC_ERROR_NOT_SUPPORTED;
     }
+    ICalculationContext_1_17::~ICalculationContext_1_17()
+    {
+    }
+    TCompletionCode ICalculationContext_1_17::CalculateMetricColumns( [[maybe_unused]] const uint8_t* rawData, [[maybe_unused]] uint32_t rawDataSize, [[maybe_unused]] TCalculationOutputDescriptor_1_17* outDescriptor, [[maybe_unused]] uint32_t* outReportCount )
+    {
+        return CC_ERROR_NOT_SUPPORTED;
+    }
+    TCompletionCode ICalculationContext_1_17::SetCalculationThreadCount( [[maybe_unused]] uint32_t threadCount )
+    {
+        return CC_ERROR_NOT_SUPPORTED;
+    }
+    TCompletionCode ICalculationContext_1_17::AggregateAndCalculateMetrics( [[maybe_unused]] const uint8_t** rawData, [[maybe_unused]] const uint32_t* rawDataSizes, [[maybe_unused]] const TTypedValue_1_0** out, [[maybe_unused]] uint32_t* outReportCount, [[maybe_unused]] const TTypedValue_1_0** outMaxValues, [[maybe_unused]] bool lastDataPortion )
+    {
+        return CC_ERROR_NOT_SUPPORTED;
+    }
 
     // Adapter interface.
     IAdapter_1_6::~IAdapter_1_6()
@@ -13,11 +13,14 @@ SPDX-License-Identifier: MIT
 #include "md_equation.h"
 #include "md_adapter.h"
 #include "md_metrics_device.h"
+#include "md_metrics_calculator.h"
 
 #include "md_utils.h"
 
 #include <cstring>
+#include <algorithm>
 #include <array>
+#include <string_view>
 
 namespace MetricsDiscoveryInternal
 {
@@ -330,6 +333,13 @@ namespace MetricsDiscoveryInternal
     //////////////////////////////////////////////////////////////////////////////
     CEquation::CEquation( CMetricsDevice& device )
         : m_elementsVector()
+        , m_program()
+        , m_optimizedProgram()
+        , m_programType( EQUATION_PROGRAM_TYPE_MIXED )
+        , m_optimizedProgramType( EQUATION_PROGRAM_TYPE_MIXED )
+        , m_instructionMask( 0 )
+        , m_maxStackDepth( 0 )
+        , m_isProgramValid( false )
         , m_equationString( nullptr )
         , m_device( device )
     {
@@ -349,9 +359,18 @@ namespace MetricsDiscoveryInternal
     //////////////////////////////////////////////////////////////////////////////
     CEquation::CEquation( const CEquation& other )
         : m_elementsVector( other.m_elementsVector )
+        , m_program()
+        , m_optimizedProgram()
+        , m_programType( EQUATION_PROGRAM_TYPE_MIXED )
+        , m_optimizedProgramType( EQUATION_PROGRAM_TYPE_MIXED )
+        , m_instructionMask( 0 )
+        , m_maxStackDepth( 0 )
+        , m_isProgramValid( false )
         , m_equationString( GetCopiedCString( other.m_equationString, other.m_device.GetAdapter().GetAdapterId() ) )
         , m_device( other.m_device )
     {
+        // Instructions refer to symbol names owned by elements, so they cannot be copied.
+        Compile();
     }
 
     //////////////////////////////////////////////////////////////////////////////
@@ -678,9 +697,716 @@ namespace MetricsDiscoveryInternal
 
         m_equationString = GetCopiedCString( equationString, adapterId );
         MD_SAFE_DELETE_ARRAY( string );
+
+        Compile();
         return true;
     }
 
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CEquation
+    //
+    // Method:
+    //     Compile
+    //
+    // Description:
+    //     Lowers equation elements into a program of instructions used during
+    //     metrics calculation. Read offsets and masks are precomputed and global
+    //     symbols are bound to their values, so evaluation doesn't require any
+    //     string operations.
+    //     The maximum evaluation stack depth is computed and the program is validated,
+    //     so well-formed equations can be evaluated without stack checks. Equations
+    //     deeper than MAX_STACK_DEPTH aren't validated, they are evaluated with checks
+    //     on a stack reserved for their depth.
+    //     Must be called again whenever elements are modified
+    //     (e.g. metric indices are updated after API filtering).
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CEquation::Compile()
+    {
+        const size_t elementsCount = m_elementsVector.size();
+        uint32_t     stackDepth    = 0;
+
+        m_program.clear();
+        m_program.reserve( elementsCount );
+
+        m_instructionMask = 0;
+        m_maxStackDepth   = 0;
+        m_isProgramValid  = elementsCount > 0;
+
+        for( const auto& element : m_elementsVector )
+        {
+            TEquationInstruction instruction = {};
+
+            CompileElement( element, instruction );
+
+            m_instructionMask |= ( 1U << instruction.Code );
+
+            switch( instruction.Code )
+            {
+                case EQUATION_INSTR_OPERATION:
+                    if( stackDepth < 2 )
+                    {
+                        m_isProgramValid = false;
+                    }
+                    else
+                    {
+                        --stackDepth;
+                    }
+                    break;
+
+                case EQUATION_INSTR_STD_NORM_GPU_DURATION:
+                case EQUATION_INSTR_STD_NORM_EU_AGGR_DURATION:
+                    // Standard normalization is valid only as a whole equation
+                    m_isProgramValid = m_isProgramValid && ( elementsCount == 1 );
+                    ++stackDepth;
+                    break;
+
+                default:
+                    ++stackDepth;
+                    break;
+            }
+
+            m_maxStackDepth = ( std::max )( m_maxStackDepth, stackDepth );
+
+            m_program.push_back( instruction );
+        }
+
+        // Only the result should remain on the stack
+        m_isProgramValid = m_isProgramValid && ( stackDepth == 1 );
+
+        if( m_maxStackDepth > MAX_STACK_DEPTH )
+        {
+            MD_LOG_A( m_device.GetAdapter().GetAdapterId(), LOG_DEBUG, "equation evaluated with stack checks, stack depth: %u, max: %u", m_maxStackDepth, MAX_STACK_DEPTH );
+            m_isProgramValid = false;
+        }
+
+        m_programType = SpecializeProgram( m_program );
+
+        Optimize();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CEquation
+    //
+    // Method:
+    //     BindGlobalSymbols
+    //
+    // Description:
+    //     Binds global symbols of the program to the values aggregated across devices
+    //     and optimizes the program again, so the aggregated values are folded the same
+    //     as values of a single device. Dynamic symbols are bound as well, aggregated
+    //     values aren't redetected. Symbols that aren't aggregated remain bound to
+    //     the device of the equation. Used for equation copies owned by calculation plans.
+    //
+    // Input:
+    //     CCalculatorSymbols& symbols - global symbols aggregated across devices
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CEquation::BindGlobalSymbols( CCalculatorSymbols& symbols )
+    {
+        m_instructionMask = 0;
+
+        for( auto& instruction : m_program )
+        {
+            if( instruction.Code == EQUATION_INSTR_GLOBAL_SYMBOL || instruction.Code == EQUATION_INSTR_GLOBAL_SYMBOL_DYNAMIC )
+            {
+                if( auto symbolValue = symbols.GetAggregatedSymbolValue( instruction.SymbolName );
+                    symbolValue )
+                {
+                    instruction.Code        = EQUATION_INSTR_GLOBAL_SYMBOL;
+                    instruction.SymbolValue = symbolValue;
+                }
+            }
+
+            m_instructionMask |= ( 1U << instruction.Code );
+        }
+
+        Optimize();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CEquation
+    //
+    // Method:
+    //     Optimize
+    //
+    // Description:
+    //     Builds optimized program by folding constant subexpressions (immediates and
+    //     global symbols which don't change during calculations) into immediates and
+    //     by removing identity operations, e.g. "x 1 UMUL" or "0 x UADD".
+    //     Only symbols with values fixed at detection are folded, dynamic symbols are
+    //     redetected on use, so the program is optimized once when compiled.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CEquation::Optimize()
+    {
+        m_optimizedProgram.clear();
+
+        if( !m_isProgramValid )
+        {
+            // Leave invalid programs as they are, the checked evaluation will report errors
+            m_optimizedProgram     = m_program;
+            m_optimizedProgramType = EQUATION_PROGRAM_TYPE_MIXED;
+            return;
+        }
+
+        std::array<TEquationOperand, MAX_STACK_DEPTH> operands      = {};
+        uint32_t                                      operandsCount = 0;
+
+        m_optimizedProgram.reserve( m_program.size() );
+
+        for( const auto& instruction : m_program )
+        {
+            if( instruction.Code != EQUATION_INSTR_OPERATION )
+            {
+                EmitOperand( instruction, operands[operandsCount++] );
+                continue;
+            }
+
+            const TEquationOperand& operandLast = operands[--operandsCount];
+            TEquationOperand&       operandPrev = operands[operandsCount - 1];
+
+            if( operandPrev.IsConstant && operandLast.IsConstant )
+            {
+                TEquationInstruction folded = {};
+                folded.Code                 = EQUATION_INSTR_IMMEDIATE;
+                folded.MetricIndex          = -1;
+                folded.Value                = CMetricsCalculator::CalculateEquationElemOperation( instruction.Operation, operandPrev.Value, operandLast.Value );
+
+                m_optimizedProgram.resize( operandPrev.Start );
+                EmitOperand( folded, operandPrev );
+            }
+            else if( !SimplifyIdentity( instruction, operandPrev, operandLast ) )
+            {
+                m_optimizedProgram.push_back( instruction );
+
+                operandPrev.Type       = GetOperationType( instruction.Operation );
+                operandPrev.IsConstant = false;
+            }
+        }
+
+        m_optimizedProgramType = SpecializeProgram( m_optimizedProgram );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CEquation
+    //
+    // Method:
+    //     SpecializeProgram
+    //
+    // Description:
+    //     Infers program type from its operations. If all operations are unsigned
+    //     integer 64b (or all are floating point) operations, every operand is casted
+    //     to that type before use, so the program can be calculated on raw values
+    //     without typed value dispatch. Immediates of such programs are converted
+    //     to the program type.
+    //
+    // Input:
+    //     std::vector<TEquationInstruction>& program - (IN/OUT) validated program
+    //
+    // Output:
+    //     TEquationProgramType - program type
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TEquationProgramType CEquation::SpecializeProgram( std::vector<TEquationInstruction>& program )
+    {
+        // The result of a program without operations has the type of its operand
+        if( !m_isProgramValid || program.empty() || program.back().Code != EQUATION_INSTR_OPERATION )
+        {
+            return EQUATION_PROGRAM_TYPE_MIXED;
+        }
+
+        TValueType operationsType = VALUE_TYPE_LAST;
+
+        for( const auto& instruction : program )
+        {
+            if( instruction.Code != EQUATION_INSTR_OPERATION )
+            {
+                continue;
+            }
+
+            const TValueType operationType = GetOperationType( instruction.Operation );
+
+            if( operationType == VALUE_TYPE_BOOL || ( operationsType != VALUE_TYPE_LAST && operationsType != operationType ) )
+            {
+                return EQUATION_PROGRAM_TYPE_MIXED;
+            }
+
+            operationsType = operationType;
+        }
+
+        for( auto& instruction : program )
+        {
+            if( instruction.Code != EQUATION_INSTR_IMMEDIATE )
+            {
+                continue;
+            }
+
+            if( operationsType == VALUE_TYPE_UINT64 )
+            {
+                instruction.Value.ValueUInt64 = CMetricsCalculator::CastToUInt64( instruction.Value );
+            }
+            else
+            {
+                instruction.Value.ValueFloat = CMetricsCalculator::CastToFloat( instruction.Value );
+            }
+
+            instruction.Value.ValueType = operationsType;
+        }
+
+        return ( operationsType == VALUE_TYPE_UINT64 )
+            ? EQUATION_PROGRAM_TYPE_UINT64
+            : EQUATION_PROGRAM_TYPE_FLOAT;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CEquation
+    //
+    // Method:
+    //     EmitOperand
+    //
+    // Description:
+    //     Appends an operand instruction to the optimized program. Global symbols
+    //     which are not redetected during calculations are emitted as immediates.
+    //
+    // Input:
+    //     const TEquationInstruction& instruction - operand instruction
+    //     TEquationOperand&           operand     - (OUT) operand information
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CEquation::EmitOperand( const TEquationInstruction& instruction, TEquationOperand& operand )
+    {
+        operand.Start      = static_cast<uint32_t>( m_optimizedProgram.size() );
+        operand.IsConstant = false;
+        operand.Type       = GetInstructionType( instruction );
+
+        m_optimizedProgram.push_back( instruction );
+
+        auto& emitted = m_optimizedProgram.back();
+
+        if( emitted.Code == EQUATION_INSTR_GLOBAL_SYMBOL && emitted.SymbolValue != nullptr )
+        {
+            switch( emitted.SymbolValue->ValueType )
+            {
+                case VALUE_TYPE_UINT32:
+                case VALUE_TYPE_UINT64:
+                case VALUE_TYPE_FLOAT:
+                case VALUE_TYPE_BOOL:
+                    emitted.Code        = EQUATION_INSTR_IMMEDIATE;
+                    emitted.Value       = *emitted.SymbolValue;
+                    emitted.SymbolValue = nullptr;
+                    operand.Type        = emitted.Value.ValueType;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        if( emitted.Code == EQUATION_INSTR_IMMEDIATE )
+        {
+            operand.IsConstant = true;
+            operand.Value      = emitted.Value;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CEquation
+    //
+    // Method:
+    //     SimplifyIdentity
+    //
+    // Description:
+    //     Removes an operation with an identity constant operand (x 1 UMUL, x 0 UADD, ...)
+    //     or replaces an operation with an absorbing constant operand (x 0 UMUL, x 0 AND)
+    //     by the constant. Identities are removed only if the remaining subexpression
+    //     has the same type as the operation result.
+    //
+    // Input:
+    //     const TEquationInstruction& instruction - operation instruction
+    //     TEquationOperand&           operandPrev - (IN/OUT) previous operand, result operand
+    //     const TEquationOperand&     operandLast - last operand
+    //
+    // Output:
+    //     bool - true if the operation has been simplified
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    bool CEquation::SimplifyIdentity( const TEquationInstruction& instruction, TEquationOperand& operandPrev, const TEquationOperand& operandLast )
+    {
+        const TEquationOperation operation  = instruction.Operation;
+        const TValueType         resultType = GetOperationType( operation );
+
+        auto isUInt64 = [&]( const TEquationOperand& operand, const uint64_t value )
+        {
+            return operand.IsConstant && CMetricsCalculator::CastToUInt64( operand.Value ) == value;
+        };
+
+        auto isFloat = [&]( const TEquationOperand& operand, const float value )
+        {
+            return operand.IsConstant && CMetricsCalculator::CastToFloat( operand.Value ) == value;
+        };
+
+        bool isRightIdentity = false;
+        bool isLeftIdentity  = false;
+        bool isAbsorbing     = false;
+
+        switch( operation )
+        {
+            case EQUATION_OPER_UADD:
+            case EQUATION_OPER_OR:
+            case EQUATION_OPER_XOR:
+                isRightIdentity = isUInt64( operandLast, 0 );
+                isLeftIdentity  = isUInt64( operandPrev, 0 );
+                break;
+
+            case EQUATION_OPER_USUB:
+            case EQUATION_OPER_LSHIFT:
+            case EQUATION_OPER_RSHIFT:
+                isRightIdentity = isUInt64( operandLast, 0 );
+                break;
+
+            case EQUATION_OPER_UMUL:
+                isRightIdentity = isUInt64( operandLast, 1 );
+                isLeftIdentity  = isUInt64( operandPrev, 1 );
+                isAbsorbing     = isUInt64( operandLast, 0 ) || isUInt64( operandPrev, 0 );
+                break;
+
+            case EQUATION_OPER_AND:
+                isAbsorbing = isUInt64( operandLast, 0 ) || isUInt64( operandPrev, 0 );
+                break;
+
+            case EQUATION_OPER_UDIV:
+                isRightIdentity = isUInt64( operandLast, 1 );
+                break;
+
+            case EQUATION_OPER_FADD:
+                isRightIdentity = isFloat( operandLast, 0.0f );
+                isLeftIdentity  = isFloat( operandPrev, 0.0f );
+                break;
+
+            case EQUATION_OPER_FSUB:
+                isRightIdentity = isFloat( operandLast, 0.0f );
+                break;
+
+            case EQUATION_OPER_FMUL:
+                isRightIdentity = isFloat( operandLast, 1.0f );
+                isLeftIdentity  = isFloat( operandPrev, 1.0f );
+                break;
+
+            case EQUATION_OPER_FDIV:
+                isRightIdentity = isFloat( operandLast, 1.0f );
+                break;
+
+            default:
+                break;
+        }
+
+        if( isAbsorbing )
+        {
+            TEquationInstruction folded = {};
+            folded.Code                 = EQUATION_INSTR_IMMEDIATE;
+            folded.MetricIndex          = -1;
+            folded.Value.ValueType      = VALUE_TYPE_UINT64;
+            folded.Value.ValueUInt64    = 0;
+
+            m_optimizedProgram.resize( operandPrev.Start );
+            EmitOperand( folded, operandPrev );
+            return true;
+        }
+
+        if( isRightIdentity && operandPrev.Type == resultType )
+        {
+            // Remove the constant, the previous operand is the result
+            m_optimizedProgram.resize( operandLast.Start );
+            return true;
+        }
+
+        if( isLeftIdentity && operandLast.Type == resultType )
+        {
+            // Remove the constant, the last operand is the result
+            m_optimizedProgram.erase( m_optimizedProgram.begin() + operandPrev.Start );
+            operandPrev.Type       = operandLast.Type;
+            operandPrev.IsConstant = false;
+            return true;
+        }
+
+        return false;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CEquation
+    //
+    // Method:
+    //     GetInstructionType
+    //
+    // Description:
+    //     Returns statically known type of the value produced by an operand instruction.
+    //
+    // Input:
+    //     const TEquationInstruction& instruction - operand instruction
+    //
+    // Output:
+    //     TValueType - value type, VALUE_TYPE_LAST if the type is known only during calculations
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TValueType CEquation::GetInstructionType( const TEquationInstruction& instruction )
+    {
+        switch( instruction.Code )
+        {
+            case EQUATION_INSTR_READ_UINT8:
+            case EQUATION_INSTR_READ_UINT16:
+            case EQUATION_INSTR_READ_UINT32:
+            case EQUATION_INSTR_READ_UINT64:
+            case EQUATION_INSTR_READ_40BIT_CNTR:
+            case EQUATION_INSTR_READ_BITFIELD:
+            case EQUATION_INSTR_PREVIOUS_CONTEXT_ID:
+            case EQUATION_INSTR_INFORMATION_SYMBOL:
+                return VALUE_TYPE_UINT64;
+
+            case EQUATION_INSTR_IMMEDIATE:
+                return instruction.Value.ValueType;
+
+            case EQUATION_INSTR_GLOBAL_SYMBOL:
+                return ( instruction.SymbolValue != nullptr )
+                    ? instruction.SymbolValue->ValueType
+                    : VALUE_TYPE_UINT64;
+
+            case EQUATION_INSTR_OPERATION:
+                return GetOperationType( instruction.Operation );
+
+            default:
+                // Float reads may be converted by delta functions, local counters
+                // and metrics depend on the metric set
+                return VALUE_TYPE_LAST;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CEquation
+    //
+    // Method:
+    //     GetOperationType
+    //
+    // Description:
+    //     Returns type of the value produced by an equation operation.
+    //
+    // Input:
+    //     const TEquationOperation operation - equation operation
+    //
+    // Output:
+    //     TValueType - value type
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TValueType CEquation::GetOperationType( const TEquationOperation operation )
+    {
+        switch( operation )
+        {
+            case EQUATION_OPER_FADD:
+            case EQUATION_OPER_FSUB:
+            case EQUATION_OPER_FMUL:
+            case EQUATION_OPER_FDIV:
+            case EQUATION_OPER_FMIN:
+            case EQUATION_OPER_FMAX:
+                return VALUE_TYPE_FLOAT;
+
+            case EQUATION_OPER_AND_L:
+            case EQUATION_OPER_EQUALS:
+            case EQUATION_OPER_UGT:
+            case EQUATION_OPER_ULT:
+            case EQUATION_OPER_UGTE:
+            case EQUATION_OPER_ULTE:
+            case EQUATION_OPER_FGT:
+            case EQUATION_OPER_FLT:
+            case EQUATION_OPER_FGTE:
+            case EQUATION_OPER_FLTE:
+                return VALUE_TYPE_BOOL;
+
+            default:
+                return VALUE_TYPE_UINT64;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CEquation
+    //
+    // Method:
+    //     CompileElement
+    //
+    // Description:
+    //     Lowers a single equation element into an instruction.
+    //
+    // Input:
+    //     const CEquationElementInternal& element     - equation element
+    //     TEquationInstruction&           instruction - (OUT) compiled instruction
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CEquation::CompileElement( const CEquationElementInternal& element, TEquationInstruction& instruction )
+    {
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        instruction.Code        = EQUATION_INSTR_NOT_SUPPORTED;
+        instruction.MetricIndex = element.MetricIndexInternal;
+        instruction.SymbolName  = element.SymbolName;
+
+        switch( element.Type )
+        {
+            case EQUATION_ELEM_RD_UINT8:
+                instruction.Code       = EQUATION_INSTR_READ_UINT8;
+                instruction.ByteOffset = element.ReadParams.ByteOffset;
+                break;
+
+            case EQUATION_ELEM_RD_UINT16:
+                instruction.Code       = EQUATION_INSTR_READ_UINT16;
+                instruction.ByteOffset = element.ReadParams.ByteOffset;
+                break;
+
+            case EQUATION_ELEM_RD_UINT32:
+                instruction.Code       = EQUATION_INSTR_READ_UINT32;
+                instruction.ByteOffset = element.ReadParams.ByteOffset;
+                break;
+
+            case EQUATION_ELEM_RD_UINT64:
+                instruction.Code       = EQUATION_INSTR_READ_UINT64;
+                instruction.ByteOffset = element.ReadParams.ByteOffset;
+                break;
+
+            case EQUATION_ELEM_RD_FLOAT:
+                instruction.Code       = EQUATION_INSTR_READ_FLOAT;
+                instruction.ByteOffset = element.ReadParams.ByteOffset;
+                break;
+
+            case EQUATION_ELEM_RD_40BIT_CNTR:
+                instruction.Code          = EQUATION_INSTR_READ_40BIT_CNTR;
+                instruction.ByteOffset    = element.ReadParams.ByteOffset;
+                instruction.ByteOffsetExt = element.ReadParams.ByteOffsetExt;
+                break;
+
+            case EQUATION_ELEM_RD_BITFIELD:
+            {
+                const uint32_t bitOffset = element.ReadParams.BitOffset;
+                const uint32_t bitCount  = element.ReadParams.BitsCount;
+
+                instruction.Code       = EQUATION_INSTR_READ_BITFIELD;
+                instruction.ByteOffset = element.ReadParams.ByteOffset;
+
+                if( ( bitCount > 32 ) || ( bitCount == 0 ) || ( bitCount + bitOffset > 32 ) )
+                {
+                    // Invalid bitfield is read as 0
+                    MD_LOG_A( adapterId, LOG_ERROR, "error: invalid bitfield, bitOffset: %u, bitCount: %u", bitOffset, bitCount );
+                    instruction.BitOffset = 0;
+                    instruction.BitMask   = 0;
+                }
+                else
+                {
+                    instruction.BitOffset = bitOffset;
+                    instruction.BitMask   = MD_BITMASK_RANGE( bitOffset, bitOffset + bitCount - 1 );
+                }
+                break;
+            }
+
+            case EQUATION_ELEM_IMM_UINT64:
+                instruction.Code              = EQUATION_INSTR_IMMEDIATE;
+                instruction.Value.ValueType   = VALUE_TYPE_UINT64;
+                instruction.Value.ValueUInt64 = element.ImmediateUInt64;
+                break;
+
+            case EQUATION_ELEM_IMM_FLOAT:
+                instruction.Code             = EQUATION_INSTR_IMMEDIATE;
+                instruction.Value.ValueType  = VALUE_TYPE_FLOAT;
+                instruction.Value.ValueFloat = element.ImmediateFloat;
+                break;
+
+            case EQUATION_ELEM_GLOBAL_SYMBOL:
+            {
+                TGlobalSymbol* symbol = element.SymbolName
+                    ? m_device.GetSymbolSet().GetSymbolByName( element.SymbolName )
+                    : nullptr;
+
+                if( symbol == nullptr )
+                {
+                    // Resolved as 0
+                    instruction.Code        = EQUATION_INSTR_GLOBAL_SYMBOL;
+                    instruction.SymbolValue = nullptr;
+                }
+                else if( symbol->symbolType == SYMBOL_TYPE_DYNAMIC )
+                {
+                    // Dynamic symbols may change during runtime, redetect them on use
+                    instruction.Code        = EQUATION_INSTR_GLOBAL_SYMBOL_DYNAMIC;
+                    instruction.SymbolValue = nullptr;
+                }
+                else
+                {
+                    instruction.Code        = EQUATION_INSTR_GLOBAL_SYMBOL;
+                    instruction.SymbolValue = &symbol->symbol.SymbolTypedValue;
+                }
+                break;
+            }
+
+            case EQUATION_ELEM_INFORMATION_SYMBOL:
+                instruction.Code = ( element.SymbolName && std::string_view( element.SymbolName ) == "PreviousContextId" )
+                    ? EQUATION_INSTR_PREVIOUS_CONTEXT_ID
+                    : EQUATION_INSTR_INFORMATION_SYMBOL;
+                break;
+
+            case EQUATION_ELEM_LOCAL_COUNTER_SYMBOL:
+                instruction.Code            = EQUATION_INSTR_LOCAL_COUNTER;
+                instruction.IsGpuCoreClocks = element.SymbolName && std::string_view( element.SymbolName ) == "GpuCoreClocks";
+
+                // Exception for missing global symbols (GtSlice[X]XeCore[Y]) in read equations.
+                instruction.IsMissingSymbolAllowed =
+                    IsPlatformMatch( m_device.GetPlatformIndex(), GENERATION_ACM, GENERATION_PVC, GENERATION_MTL, GENERATION_ARL ) &&
+                    element.SymbolName && strstr( element.SymbolName, "GtSlice" ) != nullptr;
+                break;
+
+            case EQUATION_ELEM_SELF_COUNTER_VALUE:
+                instruction.Code = EQUATION_INSTR_SELF_COUNTER;
+                break;
+
+            case EQUATION_ELEM_LOCAL_METRIC_SYMBOL:
+                instruction.Code = EQUATION_INSTR_LOCAL_METRIC;
+                break;
+
+            case EQUATION_ELEM_PREV_METRIC_SYMBOL:
+                instruction.Code = EQUATION_INSTR_PREV_METRIC;
+                break;
+
+            case EQUATION_ELEM_OPERATION:
+                instruction.Code      = EQUATION_INSTR_OPERATION;
+                instruction.Operation = element.Operation;
+                break;
+
+            case EQUATION_ELEM_STD_NORM_GPU_DURATION:
+                instruction.Code = EQUATION_INSTR_STD_NORM_GPU_DURATION;
+                break;
+
+            case EQUATION_ELEM_STD_NORM_EU_AGGR_DURATION:
+                instruction.Code = EQUATION_INSTR_STD_NORM_EU_AGGR_DURATION;
+                break;
+
+            default:
+                instruction.Code = EQUATION_INSTR_NOT_SUPPORTED;
+                break;
+        }
+    }
+
     //////////////////////////////////////////////////////////////////////////////
     //
     // Class:
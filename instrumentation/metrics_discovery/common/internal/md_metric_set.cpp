@@ -23,11 +23,14 @@ SPDX-License-Identifier: MIT
 #include "md_metric_enumerator.h"
 #include "md_metric_prototype_manager.h"
 #include "md_metrics_calculator.h"
+#include "md_range_index.h"
+#include "md_stream_calculation.h"
 
 #include "md_calculation.h"
 #include "md_driver_ifc.h"
 #include "md_utils.h"
 
+#include <algorithm>
 #include <cstring>
 #include <unordered_map>
 
@@ -88,7 +91,19 @@ namespace MetricsDiscoveryInternal
         , m_aggregationEnabled( aggregationEnabled )
         , m_isReadRegsCfgSet( false )
         , m_pmRegsConfigInfo{}
+        , m_calculatorSymbols( nullptr )
         , m_metricsCalculator( nullptr )
+        , m_calculationPlan{}
+        , m_calculationMutex()
+        , m_calculationThreadCount( 1 )
+        , m_preparedPlanGeneration( 0 )
+        , m_streamCalculations()
+        , m_rangeIndexes()
+        , m_calculationSessionMutex()
+        , m_calculationSession( nullptr )
+        , m_isCalculationSessionUsed( false )
+        , m_idleCalculationSessions()
+        , m_projectedMetrics()
         , m_prototypeManagerType( METRIC_PROTOTYPE_MANAGER_TYPE_OA )
         , m_isFlexible( false )
         , m_isOpened( false )
@@ -154,7 +169,22 @@ namespace MetricsDiscoveryInternal
 
         ClearVector( m_otherMetricsVector );
         ClearVector( m_otherInformationVector );
+
+        ClearVector( m_streamCalculations );
+        ClearVector( m_rangeIndexes );
+
+        DestroyCalculationSession( m_calculationSession );
+
+        for( auto& session : m_idleCalculationSessions )
+        {
+            DestroyCalculationSession( session );
+        }
+        m_idleCalculationSessions.clear();
+
+        DeleteBoundEquations( m_calculationPlan );
+
         MD_SAFE_DELETE( m_metricsCalculator );
+        MD_SAFE_DELETE( m_calculatorSymbols );
 
         MD_SAFE_DELETE( m_availabilityEquation );
         MD_SAFE_DELETE( m_prototypeManager );
@@ -647,10 +677,14 @@ namespace MetricsDiscoveryInternal
             return nullptr;
         }
 
+        std::unique_lock<std::shared_mutex> lock( m_calculationMutex );
+
         m_metricsVector.push_back( metric );
         m_params.MetricsCount = static_cast<uint32_t>( m_metricsVector.size() );
         m_isCustom            = true;
 
+        InvalidateCalculationPlan();
+
         // Refresh cached filtered metrics
         RefreshCachedMetricsAndInformation();
 
@@ -966,6 +1000,11 @@ namespace MetricsDiscoveryInternal
         // End configuration.
         MD_CHECK_CC( RefreshConfigRegisters() );
 
+        if( BuildCalculationPlan() != CC_OK )
+        {
+            MD_LOG_A( m_device.GetAdapter().GetAdapterId(), LOG_WARNING, "Calculation plan will be built on calculation" );
+        }
+
         m_isOpened = false;
 
         return CC_OK;
@@ -1114,6 +1153,8 @@ namespace MetricsDiscoveryInternal
             return nullptr;
         }
 
+        std::unique_lock<std::shared_mutex> lock( m_calculationMutex );
+
         if( metric->IsAvailabilityEquationTrue() )
         {
             if( IsMetricAlreadyAdded( symbolName ) )
@@ -1126,6 +1167,8 @@ namespace MetricsDiscoveryInternal
                 metric->SetIdInSetParam( count );
                 m_metricsVector.push_back( metric );
                 m_params.MetricsCount = count + 1;
+
+                InvalidateCalculationPlan();
             }
         }
         else
@@ -1165,6 +1208,8 @@ namespace MetricsDiscoveryInternal
 
         MD_CHECK_PTR_RET_A( adapterId, metric, nullptr );
 
+        std::unique_lock<std::shared_mutex> lock( m_calculationMutex );
+
         if( IsMetricAlreadyAdded( metric->GetParams()->SymbolName ) )
         {
             m_otherMetricsVector.push_back( metric );
@@ -1173,6 +1218,8 @@ namespace MetricsDiscoveryInternal
         {
             m_metricsVector.push_back( metric );
             m_params.MetricsCount = static_cast<uint32_t>( m_metricsVector.size() );
+
+            InvalidateCalculationPlan();
         }
 
         return metric;
@@ -1217,11 +1264,15 @@ namespace MetricsDiscoveryInternal
             return nullptr;
         }
 
+        std::unique_lock<std::shared_mutex> lock( m_calculationMutex );
+
         if( information->IsAvailabilityEquationTrue() )
         {
             information->SetIdInSetParam( static_cast<uint32_t>( m_informationVector.size() ) );
             m_informationVector.push_back( information );
             m_params.InformationCount = static_cast<uint32_t>( m_informationVector.size() ) + m_concurrentGroup->GetInformationCount();
+
+            InvalidateCalculationPlan();
         }
         else
         {
@@ -1253,9 +1304,13 @@ namespace MetricsDiscoveryInternal
     {
         MD_CHECK_PTR_RET_A( m_device.GetAdapter().GetAdapterId(), information, nullptr );
 
+        std::unique_lock<std::shared_mutex> lock( m_calculationMutex );
+
         m_informationVector.push_back( information );
         m_params.InformationCount = static_cast<uint32_t>( m_informationVector.size() ) + m_concurrentGroup->GetInformationCount();
 
+        InvalidateCalculationPlan();
+
         return information;
     }
 
@@ -1628,6 +1683,88 @@ namespace MetricsDiscoveryInternal
         }
     }
 
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     GetReportLayout
+    //
+    // Description:
+    //     Returns header fields offsets and PEC / NOA counter regions from report type.
+    //     Report types without known layout have an empty layout.
+    //
+    // Input:
+    //     TReportLayout& layout - (OUT) report layout
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CMetricSet::GetReportLayout( TReportLayout& layout )
+    {
+        uint32_t pecCount    = 0;
+        uint32_t pecElemSize = 0;
+        uint32_t noaCount    = 0;
+        uint32_t noaElemSize = 0;
+
+        switch( m_reportType )
+        {
+            case OA_REPORT_TYPE_576B_PEC64LL:
+                pecCount    = 64;
+                pecElemSize = sizeof( uint64_t );
+                break;
+
+            case OA_REPORT_TYPE_640B_PEC64LL_NOA16:
+                pecCount    = 64;
+                pecElemSize = sizeof( uint64_t );
+                noaCount    = 16;
+                noaElemSize = sizeof( uint32_t );
+                break;
+
+            case OA_REPORT_TYPE_192B_MPEC8LL_NOA16:
+                pecCount    = 8;
+                pecElemSize = sizeof( uint64_t );
+                noaCount    = 16;
+                noaElemSize = sizeof( uint32_t );
+                break;
+
+            case OA_REPORT_TYPE_128B_MPEC8_NOA16:
+                pecCount    = 8;
+                pecElemSize = sizeof( uint32_t );
+                noaCount    = 16;
+                noaElemSize = sizeof( uint32_t );
+                break;
+
+            case OA_REPORT_TYPE_128B_MERT_PEC8:
+                pecCount    = 8;
+                pecElemSize = sizeof( uint32_t );
+                break;
+
+            case OA_REPORT_TYPE_192B_MERT_PEC8LL:
+                pecCount    = 8;
+                pecElemSize = sizeof( uint64_t );
+                break;
+
+            default:
+                layout = {};
+                return;
+        }
+
+        layout                 = {};
+        layout.HeaderSize      = 4 * sizeof( uint64_t ); // 4 header fields, 8 bytes each
+        layout.TimestampOffset = 1 * sizeof( uint64_t );
+        layout.GpuTicksOffset  = 3 * sizeof( uint64_t );
+
+        layout.Regions[REPORT_REGION_PEC].Offset   = layout.HeaderSize;
+        layout.Regions[REPORT_REGION_PEC].Count    = pecCount;
+        layout.Regions[REPORT_REGION_PEC].ElemSize = pecElemSize;
+
+        layout.Regions[REPORT_REGION_NOA].Offset   = layout.HeaderSize + pecCount * pecElemSize;
+        layout.Regions[REPORT_REGION_NOA].Count    = noaCount;
+        layout.Regions[REPORT_REGION_NOA].ElemSize = noaElemSize;
+
+        layout.CountersCount = pecCount + noaCount;
+    }
+
     //////////////////////////////////////////////////////////////////////////////
     //
     // Class:
@@ -2263,6 +2400,9 @@ namespace MetricsDiscoveryInternal
 
         MD_LOG_ENTER_A( adapterId );
 
+        // Filtering recompiles equations and rebuilds the plan, calculations can't read them meanwhile
+        std::unique_lock<std::shared_mutex> lock( m_calculationMutex );
+
         if( m_isOpened )
         {
             MD_LOG_A( adapterId, LOG_ERROR, "Cannot do filtering if metric set is opened" );
@@ -2293,6 +2433,131 @@ namespace MetricsDiscoveryInternal
         return CC_OK;
     }
 
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     SetCalculationProjection
+    //
+    // Description:
+    //     Selects metrics written to reports calculated by CalculateMetrics and
+    //     CalculateAsyncMetrics. Calculated report contains selected metrics in the
+    //     given order followed by all information, max values report contains only
+    //     selected metrics. Metrics that selected ones depend on are calculated too.
+    //     Indices refer to API filtered metrics, so API filtering must be enabled first.
+    //     Projection is reset when API filtering is changed.
+    //
+    // Input:
+    //     const uint32_t* metricIndices      - indices of metrics to calculate, nullptr to calculate all metrics
+    //     uint32_t        metricIndicesCount - metric indices count, 0 to calculate all metrics
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::SetCalculationProjection( const uint32_t* metricIndices, uint32_t metricIndicesCount )
+    {
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        MD_LOG_ENTER_A( adapterId );
+
+        std::unique_lock<std::shared_mutex> lock( m_calculationMutex );
+
+        if( !m_isFiltered )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: API filtering must be enabled first" );
+            MD_LOG_EXIT_A( adapterId );
+            return CC_ERROR_GENERAL;
+        }
+
+        if( metricIndices == nullptr || metricIndicesCount == 0 )
+        {
+            MD_LOG_A( adapterId, LOG_INFO, "disabling calculation projection" );
+            m_projectedMetrics.clear();
+            InvalidateCalculationPlan();
+            MD_LOG_EXIT_A( adapterId );
+            return CC_OK;
+        }
+
+        for( uint32_t i = 0; i < metricIndicesCount; ++i )
+        {
+            if( metricIndices[i] >= m_currentParams->MetricsCount )
+            {
+                MD_LOG_A( adapterId, LOG_ERROR, "error: invalid metric index: %u, metrics count: %u", metricIndices[i], m_currentParams->MetricsCount );
+                MD_LOG_EXIT_A( adapterId );
+                return CC_ERROR_INVALID_PARAMETER;
+            }
+        }
+
+        MD_LOG_A( adapterId, LOG_INFO, "enabling calculation projection, metrics count: %u", metricIndicesCount );
+        m_projectedMetrics.assign( metricIndices, metricIndices + metricIndicesCount );
+        InvalidateCalculationPlan();
+
+        MD_LOG_EXIT_A( adapterId );
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     SetCalculationProjectionByNames
+    //
+    // Description:
+    //     Selects metrics written to calculated reports by their symbol names.
+    //     See SetCalculationProjection with metric indices.
+    //
+    // Input:
+    //     const char** symbolNames      - symbol names of metrics to calculate, nullptr to calculate all metrics
+    //     uint32_t     symbolNamesCount - symbol names count, 0 to calculate all metrics
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::SetCalculationProjectionByNames( const char** symbolNames, uint32_t symbolNamesCount )
+    {
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        if( symbolNames == nullptr || symbolNamesCount == 0 )
+        {
+            return SetCalculationProjection( nullptr, 0 );
+        }
+
+        std::vector<uint32_t> metricIndices( symbolNamesCount );
+
+        for( uint32_t i = 0; i < symbolNamesCount; ++i )
+        {
+            MD_CHECK_PTR_RET_A( adapterId, symbolNames[i], CC_ERROR_INVALID_PARAMETER );
+
+            uint32_t index = 0;
+
+            for( ; index < m_currentParams->MetricsCount; ++index )
+            {
+                auto metric = GetMetricExplicit( index );
+
+                if( metric != nullptr && strcmp( metric->GetParams()->SymbolName, symbolNames[i] ) == 0 )
+                {
+                    break;
+                }
+            }
+
+            if( index == m_currentParams->MetricsCount )
+            {
+                MD_LOG_A( adapterId, LOG_ERROR, "error: metric not found: %s", symbolNames[i] );
+                return CC_ERROR_INVALID_PARAMETER;
+            }
+
+            metricIndices[i] = index;
+        }
+
+        return SetCalculationProjection( metricIndices.data(), symbolNamesCount );
+    }
+
     //////////////////////////////////////////////////////////////////////////////
     //
     // Class:
@@ -2386,6 +2651,11 @@ namespace MetricsDiscoveryInternal
 
         UpdateMetricIndicesInEquations();
 
+        if( BuildCalculationPlan() != CC_OK )
+        {
+            MD_LOG_A( adapterId, LOG_WARNING, "Calculation plan will be built on calculation" );
+        }
+
         MD_LOG_A( adapterId, LOG_DEBUG, "API filtering %s", m_isFiltered ? "enabled" : "disabled" );
         MD_LOG_EXIT_A( adapterId );
     }
@@ -2457,6 +2727,9 @@ namespace MetricsDiscoveryInternal
                             }
                         }
                     }
+
+                    // Bake updated indices into the compiled equation
+                    static_cast<CEquation*>( equation )->Compile();
                 }
             }
         }
@@ -2501,6 +2774,11 @@ namespace MetricsDiscoveryInternal
             m_isFiltered               = false;
         }
 
+        // Projected metric indices refer to the previously used metrics
+        m_projectedMetrics.clear();
+
+        InvalidateCalculationPlan();
+
         MD_LOG_A( adapterId, LOG_DEBUG, "Use API filtered variables: %s", enable ? "TRUE" : "FALSE" );
     }
 
@@ -2613,73 +2891,120 @@ namespace MetricsDiscoveryInternal
     //     CMetricSet
     //
     // Method:
-    //     CalculateMetrics
+    //     BuildCalculationPlan
     //
     // Description:
-    //     Conducts the whole process of metrics and information calculation for multiple reports.
-    //     It's API agnostic - user doesn't have to worry about API he has used.
-    //     User has to provide input buffer and its size, output buffer and its size with enough space for
-    //     all calculated metrics and information.
-    //     The amount of input reports is calculated based on rawData size and the size of single raw report.
-    //
-    // Input:
-    //     const uint8_t*   rawData                - raw report data
-    //     uint32_t         rawDataSize            - size of raw report data
-    //     TTypedValue_1_0* out                    - (OUT) buffer for calculated reports
-    //     uint32_t         outSize                - size of the provided output buffer
-    //     uint32_t*        outReportCount         - (OUT - optional) how much reports were calculated and are stored in the out buffer
-    //     bool             enableContextFiltering - if true enable context filtering during calculation (obsolete)
+    //     Gathers equations, delta functions, result types and information read
+    //     descriptors of the current metrics and information into flat arrays
+    //     used by metrics calculator.
     //
     // Output:
     //     TCompletionCode - *CC_OK* means success
     //
     //////////////////////////////////////////////////////////////////////////////
-    TCompletionCode CMetricSet::CalculateMetrics( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, bool enableContextFiltering )
+    TCompletionCode CMetricSet::BuildCalculationPlan()
     {
-        if( enableContextFiltering )
+        const uint32_t adapterId        = m_device.GetAdapter().GetAdapterId();
+        const uint32_t metricsCount     = m_currentParams->MetricsCount;
+        const uint32_t informationCount = m_currentParams->InformationCount;
+        const bool     isStream         = ( m_currentParams->ApiMask & API_TYPE_IOSTREAM ) != 0;
+        auto&          plan             = m_calculationPlan;
+
+        InvalidateCalculationPlan();
+        DeleteBoundEquations( plan );
+
+        plan.QueryReadEquations.resize( metricsCount );
+        plan.IoReadEquations.resize( metricsCount );
+        plan.NormEquations.resize( metricsCount );
+        plan.MaxValueEquations.resize( metricsCount );
+        plan.DeltaFunctions.resize( metricsCount );
+        plan.ResultTypes.resize( metricsCount );
+        plan.NormalizationKinds.resize( metricsCount );
+        plan.Informations.resize( informationCount );
+
+        for( uint32_t i = 0; i < metricsCount; ++i )
         {
-            MD_LOG_A( m_device.GetAdapter().GetAdapterId(), LOG_ERROR, "error: context filtering not supported" );
-            return CC_ERROR_NOT_SUPPORTED;
+            auto metric = GetMetricExplicit( i );
+            MD_CHECK_PTR_RET_A( adapterId, metric, CC_ERROR_GENERAL );
+
+            auto& metricParams = *metric->GetParams();
+
+            plan.QueryReadEquations[i] = static_cast<CEquation*>( metricParams.QueryReadEquation );
+            plan.IoReadEquations[i]    = static_cast<CEquation*>( metricParams.IoReadEquation );
+            plan.NormEquations[i]      = static_cast<CEquation*>( metricParams.NormEquation );
+            plan.MaxValueEquations[i]  = static_cast<CEquation*>( metricParams.MaxValueEquation );
+            plan.DeltaFunctions[i]     = metricParams.DeltaFunction;
+            plan.ResultTypes[i]        = metricParams.ResultType;
+            plan.NormalizationKinds[i] = metricParams.NormEquation
+                ? NORMALIZATION_KIND_EQUATION
+                : NORMALIZATION_KIND_DELTA;
+
+            if( plan.GpuCoreClocksIndex == -1 && std::string_view( metricParams.SymbolName ) == "GpuCoreClocks" )
+            {
+                plan.GpuCoreClocksIndex = static_cast<int32_t>( i );
+            }
         }
 
-        return CalculateMetrics( rawData, rawDataSize, out, outSize, outReportCount, nullptr, 0 );
-    }
+        for( uint32_t i = 0; i < informationCount; ++i )
+        {
+            auto information = GetInformation( i );
+            MD_CHECK_PTR_RET_A( adapterId, information, CC_ERROR_GENERAL );
 
-    //////////////////////////////////////////////////////////////////////////////
-    //
-    // Class:
-    //     CMetricSet
-    //
-    // Method:
-    //     CalculateMetrics
-    //
-    // Description:
-    //     Conducts the whole process of metrics and information calculation for multiple reports.
-    //     It's API agnostic - user doesn't have to worry about API he has used.
-    //     User has to provide input buffer and its size, output buffer and its size with enough space for
-    //     all calculated metrics and information.
-    //     The amount of input reports is calculated based on rawData size and the size of single raw report.
-    //
-    //     Optional MaxValues calculation added, if MaxValueEquation isn't defined for the metric its current
-    //     normalized value is used.
-    //
-    // Input:
-    //     const uint8_t*   rawData                - raw report data
-    //     uint32_t         rawDataSize            - size of raw report data in bytes
-    //     TTypedValue_1_0* out                    - (OUT) buffer for calculated reports
-    //     uint32_t         outSize                - size of the provided output buffer in bytes
-    //     uint32_t*        outReportCount         - (OUT - optional) how much reports were calculated and are stored in the out buffer
-    //     TTypedValue_1_0* outMaxValues           - (OUT - optional) should have a memory for at least 'MetricCount * RawReportCount' values, can be nullptr. Calculated maxValues for each metric.
-    //                                               If MaxValueEquation isn't defined for the metric, MaxValue will be equal to the current, normalized metric value.
-    //     uint32_t         outMaxValuesSize       - size of the provided buffer for max values in bytes
-    //
-    // Output:
-    //     TCompletionCode - *CC_OK* means success
-    //
-    //////////////////////////////////////////////////////////////////////////////
-    TCompletionCode CMetricSet::CalculateMetrics( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize )
-    {
-        return CalculateMetrics<false>( rawData, rawDataSize, out, outSize, outReportCount, outMaxValues, outMaxValuesSize );
+            auto& informationParams = *information->GetParams();
+
+            plan.Informations[i].ReadEquation = static_cast<CEquation*>( isStream ? informationParams.IoReadEquation : informationParams.QueryReadEquation );
+            plan.Informations[i].IsFlag       = ( informationParams.InfoType == INFORMATION_TYPE_FLAG );
+        }
+
+        GetReportLayout( plan.ReportLayout );
+
+        auto ret = BuildCalculationProjection( plan );
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        // Reports using previous calculated report can't be calculated independently
+        auto usesPrevMetric = []( const CEquation* equation )
+        {
+            if( equation != nullptr )
+            {
+                for( const auto& instruction : equation->GetProgram() )
+                {
+                    if( instruction.Code == EQUATION_INSTR_PREV_METRIC )
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        };
+
+        for( const uint32_t i : plan.CalculatedMetrics )
+        {
+            if( usesPrevMetric( plan.QueryReadEquations[i] ) ||
+                usesPrevMetric( plan.IoReadEquations[i] ) ||
+                usesPrevMetric( plan.NormEquations[i] ) ||
+                usesPrevMetric( plan.MaxValueEquations[i] ) )
+            {
+                plan.HasPrevMetrics = true;
+                break;
+            }
+        }
+
+        for( const auto& information : plan.Informations )
+        {
+            plan.HasPrevMetrics = plan.HasPrevMetrics || usesPrevMetric( information.ReadEquation );
+        }
+
+        plan.MetricsCount     = metricsCount;
+        plan.InformationCount = informationCount;
+        plan.IsValid          = true;
+
+        // Contexts prepared for the previous plan are prepared again
+        if( ++plan.Generation == 0 )
+        {
+            plan.Generation = 1;
+        }
+
+        return CC_OK;
     }
 
     //////////////////////////////////////////////////////////////////////////////
@@ -2688,37 +3013,1152 @@ namespace MetricsDiscoveryInternal
     //     CMetricSet
     //
     // Method:
-    //     CalculateAsyncMetrics
+    //     BuildCalculationProjection
     //
     // Description:
-    //     Conducts the whole process of metrics and information calculation for multiple reports.
-    //     It's API agnostic - user doesn't have to worry about API he has used.
-    //     User has to provide input buffer and its size, output buffer and its size with enough space for
-    //     all calculated metrics and information. This method supports only IoStream. Query is not supported.
-    //     Timer reports are not calculated in this method.
-    //     The amount of input reports is calculated based on rawData size and the size of single raw report.
-    //
-    //     Optional MaxValues calculation added, if MaxValueEquation isn't defined for the metric its current
-    //     normalized value is used.
+    //     Determines metrics to calculate and to write to calculated reports.
+    //     If calculation projection is set, only projected metrics and metrics they
+    //     depend on through local counter, local metric and previous metric symbols
+    //     are calculated. GpuCoreClocks is always calculated, because standard
+    //     normalization equations use it.
     //
     // Input:
-    //     const uint8_t*   rawData                - raw report data
-    //     uint32_t         rawDataSize            - size of raw report data in bytes
-    //     TTypedValue_1_0* out                    - (OUT) buffer for calculated reports
-    //     uint32_t         outSize                - size of the provided output buffer in bytes
-    //     uint32_t*        outReportCount         - (OUT - optional) how much reports were calculated and are stored in the out buffer
-    //     TTypedValue_1_0* outMaxValues           - (OUT - optional) should have a memory for at least 'MetricCount * RawReportCount' values, can be nullptr. Calculated maxValues for each metric.
-    //                                               If MaxValueEquation isn't defined for the metric, MaxValue will be equal to the current, normalized metric value.
-    //     uint32_t         outMaxValuesSize       - size of the provided buffer for max values in bytes
+    //     TCalculationPlan& plan - (IN/OUT) calculation plan with equations gathered
     //
     // Output:
     //     TCompletionCode - *CC_OK* means success
     //
     //////////////////////////////////////////////////////////////////////////////
-    TCompletionCode CMetricSet::CalculateAsyncMetrics( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize )
+    TCompletionCode CMetricSet::BuildCalculationProjection( TCalculationPlan& plan )
     {
-        return CalculateMetrics<true>( rawData, rawDataSize, out, outSize, outReportCount, outMaxValues, outMaxValuesSize );
-    }
+        const uint32_t adapterId    = m_device.GetAdapter().GetAdapterId();
+        const uint32_t metricsCount = static_cast<uint32_t>( plan.NormEquations.size() );
+
+        plan.IsProjected = !m_projectedMetrics.empty();
+        plan.CalculatedMetrics.clear();
+        plan.OutMetrics.clear();
+
+        if( !plan.IsProjected )
+        {
+            plan.CalculatedMetrics.resize( metricsCount );
+            plan.OutMetrics.resize( metricsCount );
+
+            for( uint32_t i = 0; i < metricsCount; ++i )
+            {
+                plan.CalculatedMetrics[i] = i;
+                plan.OutMetrics[i]        = i;
+            }
+
+            return CC_OK;
+        }
+
+        std::vector<bool>     isCalculated( metricsCount, false );
+        std::vector<uint32_t> pendingMetrics;
+
+        auto addMetric = [&]( int32_t index )
+        {
+            if( index >= 0 && static_cast<uint32_t>( index ) < metricsCount && !isCalculated[index] )
+            {
+                isCalculated[index] = true;
+                pendingMetrics.push_back( static_cast<uint32_t>( index ) );
+            }
+        };
+
+        auto addDependencies = [&]( const CEquation* equation )
+        {
+            if( equation == nullptr )
+            {
+                return;
+            }
+
+            for( const auto& instruction : equation->GetProgram() )
+            {
+                if( instruction.Code == EQUATION_INSTR_LOCAL_COUNTER || instruction.Code == EQUATION_INSTR_LOCAL_METRIC || instruction.Code == EQUATION_INSTR_PREV_METRIC )
+                {
+                    addMetric( instruction.MetricIndex );
+                }
+            }
+        };
+
+        for( const uint32_t index : m_projectedMetrics )
+        {
+            if( index >= metricsCount )
+            {
+                MD_LOG_A( adapterId, LOG_ERROR, "error: projected metric index out of range: %u, metrics count: %u", index, metricsCount );
+                return CC_ERROR_INVALID_PARAMETER;
+            }
+
+            addMetric( static_cast<int32_t>( index ) );
+            plan.OutMetrics.push_back( index );
+        }
+
+        addMetric( plan.GpuCoreClocksIndex );
+
+        // Transitive closure of metric dependencies
+        while( !pendingMetrics.empty() )
+        {
+            const uint32_t index = pendingMetrics.back();
+            pendingMetrics.pop_back();
+
+            addDependencies( plan.QueryReadEquations[index] );
+            addDependencies( plan.IoReadEquations[index] );
+            addDependencies( plan.NormEquations[index] );
+            addDependencies( plan.MaxValueEquations[index] );
+        }
+
+        // Metrics equations use only preceding metrics, so they are calculated in the original order
+        for( uint32_t i = 0; i < metricsCount; ++i )
+        {
+            if( isCalculated[i] )
+            {
+                plan.CalculatedMetrics.push_back( i );
+            }
+        }
+
+        MD_LOG_A( adapterId, LOG_DEBUG, "projected metrics: %u, calculated metrics: %u of %u", static_cast<uint32_t>( plan.OutMetrics.size() ), static_cast<uint32_t>( plan.CalculatedMetrics.size() ), metricsCount );
+
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     InvalidateCalculationPlan
+    //
+    // Description:
+    //     Marks calculation plan as outdated, e.g. after metrics are added or API
+    //     filtering is changed. The plan is rebuilt before the next calculation.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CMetricSet::InvalidateCalculationPlan()
+    {
+        m_calculationPlan.IsValid            = false;
+        m_calculationPlan.MetricsCount       = 0;
+        m_calculationPlan.InformationCount   = 0;
+        m_calculationPlan.GpuCoreClocksIndex = -1;
+        m_calculationPlan.IsProjected        = false;
+        m_calculationPlan.HasPrevMetrics     = false;
+        m_calculationPlan.HasKernels         = false;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     CalculateMetrics
+    //
+    // Description:
+    //     Conducts the whole process of metrics and information calculation for multiple reports.
+    //     It's API agnostic - user doesn't have to worry about API he has used.
+    //     User has to provide input buffer and its size, output buffer and its size with enough space for
+    //     all calculated metrics and information.
+    //     The amount of input reports is calculated based on rawData size and the size of single raw report.
+    //
+    // Input:
+    //     const uint8_t*   rawData                - raw report data
+    //     uint32_t         rawDataSize            - size of raw report data
+    //     TTypedValue_1_0* out                    - (OUT) buffer for calculated reports
+    //     uint32_t         outSize                - size of the provided output buffer
+    //     uint32_t*        outReportCount         - (OUT - optional) how much reports were calculated and are stored in the out buffer
+    //     bool             enableContextFiltering - if true only deltas starting in a report of the filtered context
+    //                                               are calculated. The filtered context is the context of the first
+    //                                               report of the stream, it's kept with the saved last report.
+    //                                               IoStream only.
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::CalculateMetrics( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, bool enableContextFiltering )
+    {
+        return CalculateMetrics<false>( rawData, rawDataSize, out, outSize, outReportCount, nullptr, 0, nullptr, enableContextFiltering );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     CalculateMetrics
+    //
+    // Description:
+    //     Conducts the whole process of metrics and information calculation for multiple reports.
+    //     It's API agnostic - user doesn't have to worry about API he has used.
+    //     User has to provide input buffer and its size, output buffer and its size with enough space for
+    //     all calculated metrics and information.
+    //     The amount of input reports is calculated based on rawData size and the size of single raw report.
+    //
+    //     Optional MaxValues calculation added, if MaxValueEquation isn't defined for the metric its current
+    //     normalized value is used.
+    //
+    // Input:
+    //     const uint8_t*   rawData                - raw report data
+    //     uint32_t         rawDataSize            - size of raw report data in bytes
+    //     TTypedValue_1_0* out                    - (OUT) buffer for calculated reports
+    //     uint32_t         outSize                - size of the provided output buffer in bytes
+    //     uint32_t*        outReportCount         - (OUT - optional) how much reports were calculated and are stored in the out buffer
+    //     TTypedValue_1_0* outMaxValues           - (OUT - optional) should have a memory for at least 'MetricCount * RawReportCount' values, can be nullptr. Calculated maxValues for each metric.
+    //                                               If MaxValueEquation isn't defined for the metric, MaxValue will be equal to the current, normalized metric value.
+    //     uint32_t         outMaxValuesSize       - size of the provided buffer for max values in bytes
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::CalculateMetrics( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize )
+    {
+        return CalculateMetrics<false>( rawData, rawDataSize, out, outSize, outReportCount, outMaxValues, outMaxValuesSize, nullptr, false );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     CalculateAsyncMetrics
+    //
+    // Description:
+    //     Conducts the whole process of metrics and information calculation for multiple reports.
+    //     It's API agnostic - user doesn't have to worry about API he has used.
+    //     User has to provide input buffer and its size, output buffer and its size with enough space for
+    //     all calculated metrics and information. This method supports only IoStream. Query is not supported.
+    //     Timer reports are not calculated in this method.
+    //     The amount of input reports is calculated based on rawData size and the size of single raw report.
+    //
+    //     Optional MaxValues calculation added, if MaxValueEquation isn't defined for the metric its current
+    //     normalized value is used.
+    //
+    // Input:
+    //     const uint8_t*   rawData                - raw report data
+    //     uint32_t         rawDataSize            - size of raw report data in bytes
+    //     TTypedValue_1_0* out                    - (OUT) buffer for calculated reports
+    //     uint32_t         outSize                - size of the provided output buffer in bytes
+    //     uint32_t*        outReportCount         - (OUT - optional) how much reports were calculated and are stored in the out buffer
+    //     TTypedValue_1_0* outMaxValues           - (OUT - optional) should have a memory for at least 'MetricCount * RawReportCount' values, can be nullptr. Calculated maxValues for each metric.
+    //                                               If MaxValueEquation isn't defined for the metric, MaxValue will be equal to the current, normalized metric value.
+    //     uint32_t         outMaxValuesSize       - size of the provided buffer for max values in bytes
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::CalculateAsyncMetrics( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize )
+    {
+        return CalculateMetrics<true>( rawData, rawDataSize, out, outSize, outReportCount, outMaxValues, outMaxValuesSize, nullptr, false );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     CalculateMetricColumns
+    //
+    // Description:
+    //     Calculates metrics and information for multiple reports like CalculateMetrics,
+    //     but writes output metrics to separate columns typed by the metric result type.
+    //     Column i holds the i-th output metric: projected one or i-th metric of the set.
+    //     Information is written as TTypedValue_1_0 rows to the optional OutInformation buffer.
+    //
+    // Input:
+    //     const uint8_t*                      rawData        - raw report data
+    //     uint32_t                            rawDataSize    - size of raw report data in bytes
+    //     TCalculationOutputDescriptorLatest* outDescriptor  - (OUT) output columns, each should have a room
+    //                                                          for at least raw report count values
+    //     uint32_t*                           outReportCount - (OUT - optional) how much reports were calculated
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::CalculateMetricColumns( const uint8_t* rawData, uint32_t rawDataSize, TCalculationOutputDescriptorLatest* outDescriptor, uint32_t* outReportCount )
+    {
+        MD_CHECK_PTR_RET_A( m_device.GetAdapter().GetAdapterId(), outDescriptor, CC_ERROR_INVALID_PARAMETER );
+
+        return CalculateMetrics<false>( rawData, rawDataSize, nullptr, 0, outReportCount, nullptr, 0, outDescriptor, false );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     SetCalculationThreadCount
+    //
+    // Description:
+    //     Sets count of threads used by CalculateMetrics and CalculateMetricColumns.
+    //     Raw reports are split into consecutive chunks calculated with separate
+    //     calculators and written to their places in the output, so results are the
+    //     same as from a single thread. Small inputs and metric sets with equations
+    //     using previous calculated report are calculated on the calling thread.
+    //     Async calculation always uses the calling thread.
+    //
+    // Input:
+    //     uint32_t threadCount - thread count, 0 means hardware concurrency,
+    //                            1 (default) means the calling thread only
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::SetCalculationThreadCount( uint32_t threadCount )
+    {
+        m_calculationThreadCount.store( threadCount );
+
+        MD_LOG_A( m_device.GetAdapter().GetAdapterId(), LOG_DEBUG, "calculation thread count: %u", threadCount );
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     CreateStreamCalculation
+    //
+    // Description:
+    //     Creates a stream calculation for IoStream raw data pushed in consecutive
+    //     portions. The stream calculation has its own calculation session, so it
+    //     doesn't share the saved report with CalculateMetrics calls and other
+    //     stream calculations. API filtering has to be enabled first.
+    //
+    // Input:
+    //     bool                       calculateMaxValues - if true, max values are calculated as well
+    //     IStreamCalculationLatest** streamCalculation  - (OUT) created stream calculation
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::CreateStreamCalculation( bool calculateMaxValues, IStreamCalculationLatest** streamCalculation )
+    {
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        MD_LOG_ENTER_A( adapterId );
+        MD_CHECK_PTR_RET_A( adapterId, streamCalculation, CC_ERROR_INVALID_PARAMETER );
+
+        *streamCalculation = nullptr;
+
+        if( !m_isFiltered )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: API filtering must be enabled first" );
+            MD_LOG_EXIT_A( adapterId );
+            return CC_ERROR_GENERAL;
+        }
+        if( ( m_currentParams->ApiMask & API_TYPE_IOSTREAM ) == 0 )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "Stream calculation is only supported for IoStream measurements" );
+            MD_LOG_EXIT_A( adapterId );
+            return CC_ERROR_NOT_SUPPORTED;
+        }
+
+        auto ret = PrepareCalculationPlan();
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        CStreamCalculation* stream = new( std::nothrow ) CStreamCalculation( *this, calculateMaxValues );
+        MD_CHECK_PTR_RET_A( adapterId, stream, CC_ERROR_NO_MEMORY );
+
+        ret = stream->Initialize();
+        if( ret != CC_OK )
+        {
+            MD_SAFE_DELETE( stream );
+            MD_LOG_A( adapterId, LOG_ERROR, "error: unable to initialize stream calculation" );
+            MD_LOG_EXIT_A( adapterId );
+            return ret;
+        }
+
+        std::unique_lock<std::shared_mutex> lock( m_calculationMutex );
+
+        m_streamCalculations.push_back( stream );
+        *streamCalculation = stream;
+
+        MD_LOG_EXIT_A( adapterId );
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     DestroyStreamCalculation
+    //
+    // Description:
+    //     Destroys a stream calculation created by CreateStreamCalculation.
+    //     Stream calculations not destroyed by the user are destroyed with the metric set.
+    //
+    // Input:
+    //     IStreamCalculationLatest* streamCalculation - stream calculation to destroy
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::DestroyStreamCalculation( IStreamCalculationLatest* streamCalculation )
+    {
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        MD_LOG_ENTER_A( adapterId );
+        MD_CHECK_PTR_RET_A( adapterId, streamCalculation, CC_ERROR_INVALID_PARAMETER );
+
+        std::unique_lock<std::shared_mutex> lock( m_calculationMutex );
+
+        auto it = std::find( m_streamCalculations.begin(), m_streamCalculations.end(), streamCalculation );
+        if( it == m_streamCalculations.end() )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: stream calculation wasn't created by this metric set" );
+            MD_LOG_EXIT_A( adapterId );
+            return CC_ERROR_INVALID_PARAMETER;
+        }
+
+        CStreamCalculation* stream = *it;
+        m_streamCalculations.erase( it );
+
+        lock.unlock();
+
+        MD_SAFE_DELETE( stream );
+
+        MD_LOG_EXIT_A( adapterId );
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     CreateRangeIndex
+    //
+    // Description:
+    //     Creates a range index of IoStream raw data, calculating metrics between any
+    //     two timestamps of the data. Cumulative counters are computed from the raw data
+    //     here, the raw data isn't used afterwards. The range index has its own
+    //     calculation session, like a stream calculation. API filtering has to be
+    //     enabled first.
+    //
+    // Input:
+    //     const uint8_t*      rawData            - raw report data, timestamps ascending
+    //     uint32_t            rawDataSize        - size of raw report data in bytes, at least two reports
+    //     bool                calculateMaxValues - if true, max values are calculated as well
+    //     IRangeIndexLatest** rangeIndex         - (OUT) created range index
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::CreateRangeIndex( const uint8_t* rawData, uint32_t rawDataSize, bool calculateMaxValues, IRangeIndexLatest** rangeIndex )
+    {
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        MD_LOG_ENTER_A( adapterId );
+        MD_CHECK_PTR_RET_A( adapterId, rangeIndex, CC_ERROR_INVALID_PARAMETER );
+        MD_CHECK_PTR_RET_A( adapterId, rawData, CC_ERROR_INVALID_PARAMETER );
+
+        *rangeIndex = nullptr;
+
+        if( !m_isFiltered )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: API filtering must be enabled first" );
+            MD_LOG_EXIT_A( adapterId );
+            return CC_ERROR_GENERAL;
+        }
+        if( ( m_currentParams->ApiMask & API_TYPE_IOSTREAM ) == 0 )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "Range index is only supported for IoStream measurements" );
+            MD_LOG_EXIT_A( adapterId );
+            return CC_ERROR_NOT_SUPPORTED;
+        }
+
+        auto ret = PrepareCalculationPlan();
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        CRangeIndex* index = new( std::nothrow ) CRangeIndex( *this, calculateMaxValues );
+        MD_CHECK_PTR_RET_A( adapterId, index, CC_ERROR_NO_MEMORY );
+
+        ret = index->Initialize( rawData, rawDataSize );
+        if( ret != CC_OK )
+        {
+            MD_SAFE_DELETE( index );
+            MD_LOG_A( adapterId, LOG_ERROR, "error: unable to initialize range index" );
+            MD_LOG_EXIT_A( adapterId );
+            return ret;
+        }
+
+        std::unique_lock<std::shared_mutex> lock( m_calculationMutex );
+
+        m_rangeIndexes.push_back( index );
+        *rangeIndex = index;
+
+        MD_LOG_EXIT_A( adapterId );
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     DestroyRangeIndex
+    //
+    // Description:
+    //     Destroys a range index created by CreateRangeIndex.
+    //     Range indexes not destroyed by the user are destroyed with the metric set.
+    //
+    // Input:
+    //     IRangeIndexLatest* rangeIndex - range index to destroy
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::DestroyRangeIndex( IRangeIndexLatest* rangeIndex )
+    {
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        MD_LOG_ENTER_A( adapterId );
+        MD_CHECK_PTR_RET_A( adapterId, rangeIndex, CC_ERROR_INVALID_PARAMETER );
+
+        std::unique_lock<std::shared_mutex> lock( m_calculationMutex );
+
+        auto it = std::find( m_rangeIndexes.begin(), m_rangeIndexes.end(), rangeIndex );
+        if( it == m_rangeIndexes.end() )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: range index wasn't created by this metric set" );
+            MD_LOG_EXIT_A( adapterId );
+            return CC_ERROR_INVALID_PARAMETER;
+        }
+
+        CRangeIndex* index = *it;
+        m_rangeIndexes.erase( it );
+
+        lock.unlock();
+
+        MD_SAFE_DELETE( index );
+
+        MD_LOG_EXIT_A( adapterId );
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     CalculateMetrics
+    //
+    // Template Parameter:
+    //     async - Determines if the calculation is performed for async reports or not.
+    //
+    // Description:
+    //     Conducts the whole process of metrics and information calculation for multiple reports.
+    //     It's API agnostic - user doesn't have to worry about API he has used.
+    //     User has to provide input buffer and its size, output buffer and its size with enough space for
+    //     all calculated metrics and information.
+    //     If async, method supports only IoStream. Query is not supported. Timer reports are not calculated in this method.
+    //     The amount of input reports is calculated based on rawData size and the size of single raw report.
+    //
+    //     Optional MaxValues calculation added, if MaxValueEquation isn't defined for the metric its current
+    //     normalized value is used.
+    //
+    // Input:
+    //     const uint8_t*   rawData                - raw report data
+    //     uint32_t         rawDataSize            - size of raw report data in bytes
+    //     TTypedValue_1_0* out                    - (OUT) buffer for calculated reports
+    //     uint32_t         outSize                - size of the provided output buffer in bytes
+    //     uint32_t*        outReportCount         - (OUT - optional) how much reports were calculated and are stored in the out buffer
+    //     TTypedValue_1_0* outMaxValues           - (OUT - optional) should have a memory for at least 'MetricCount * RawReportCount' values, can be nullptr. Calculated maxValues for each metric.
+    //                                               If MaxValueEquation isn't defined for the metric, MaxValue will be equal to the current, normalized metric value.
+    //     uint32_t         outMaxValuesSize       - size of the provided buffer for max values in bytes
+    //     TCalculationOutputDescriptorLatest* outDescriptor - (OUT - optional) output columns, used instead of out and outMaxValues
+    //     bool             contextFiltering       - if true only deltas starting in the filtered context are calculated
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <bool async>
+    TCompletionCode CMetricSet::CalculateMetrics( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize, TCalculationOutputDescriptorLatest* outDescriptor, bool contextFiltering )
+    {
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        MD_LOG_ENTER_A( adapterId );
+
+        // The plan can't be changed by the metric set setters until the calculation ends.
+        // Calls only share the plan, each one calculates with its own session.
+        std::shared_lock<std::shared_mutex> planLock;
+
+        auto ret = LockCalculationPlan( planLock );
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        constexpr uint32_t streamMask = API_TYPE_IOSTREAM;
+
+        const auto measurementType = ( m_currentParams->ApiMask & streamMask )
+            ? MEASUREMENT_TYPE_SNAPSHOT_IO
+            : MEASUREMENT_TYPE_DELTA_QUERY;
+
+        if constexpr( async )
+        {
+            if( measurementType != MEASUREMENT_TYPE_SNAPSHOT_IO )
+            {
+                MD_LOG_A( adapterId, LOG_ERROR, "Async metrics calculation is only supported for IoStream measurements" );
+                MD_LOG_EXIT_A( adapterId );
+                return CC_ERROR_NOT_SUPPORTED;
+            }
+        }
+
+        MD_CHECK_PTR_RET_A( adapterId, rawData, CC_ERROR_INVALID_PARAMETER );
+        if( outDescriptor == nullptr )
+        {
+            MD_CHECK_PTR_RET_A( adapterId, out, CC_ERROR_INVALID_PARAMETER );
+        }
+
+        if( !rawDataSize )
+        {
+            MD_LOG_A( adapterId, LOG_DEBUG, "nothing to calculate, rawDataSize: 0" );
+            MD_LOG_EXIT_A( adapterId );
+            return CC_OK;
+        }
+        if( !outMaxValues || !outMaxValuesSize )
+        {
+            MD_LOG_A( adapterId, LOG_DEBUG, "max values won't be calculated, outMaxValues: %p, outMaxValuesSize: %u", outMaxValues, outMaxValuesSize );
+            outMaxValues     = nullptr;
+            outMaxValuesSize = 0;
+        }
+
+        if( !m_isFiltered )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: API filtering must be enabled first" );
+            MD_LOG_EXIT_A( adapterId );
+            return CC_ERROR_GENERAL;
+        }
+        if( ( m_currentParams->MetricsCount + m_currentParams->InformationCount ) == 0 )
+        {
+            // May happen when unsupported API is used in MetricSet filtering
+            MD_LOG_A( adapterId, LOG_WARNING, "nothing to calculate, empty MetricSet" );
+            MD_LOG_EXIT_A( adapterId );
+            return CC_OK;
+        }
+
+        const uint32_t rawReportSize = ( measurementType == MEASUREMENT_TYPE_SNAPSHOT_IO )
+            ? m_currentParams->RawReportSize
+            : m_currentParams->QueryReportSize;
+
+        const uint32_t rawReportCount = rawDataSize / rawReportSize;
+
+        // Validation
+        ret = outDescriptor
+            ? ValidateOutputDescriptor( outDescriptor, rawDataSize, rawReportSize, rawReportCount )
+            : ValidateCalculateMetricsParams( rawDataSize, rawReportSize, outSize, rawReportCount, outMaxValuesSize );
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        TCalculationSession* session = nullptr;
+
+        ret = AcquireCalculationSession( measurementType, &session );
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        // Initialize context
+        ret = InitializeCalculationContext( *session, out, outMaxValues, outDescriptor, rawData, rawReportCount, contextFiltering );
+        if( ret != CC_OK )
+        {
+            ReleaseCalculationSession( session );
+            MD_LOG_A( adapterId, LOG_ERROR, "error: cannot initialize calculation context" );
+            MD_LOG_EXIT_A( adapterId );
+            return ret;
+        }
+
+        TCalculationContext& calculationContext = session->Context;
+        CCalculationManager* calculationManager = session->CalculationManager;
+
+        MD_LOG_A( adapterId, LOG_DEBUG, "about to calculate %u raw reports", rawReportCount );
+
+        // CALCULATE METRICS
+        if constexpr( async )
+        {
+            while( calculationManager->CalculateNextAsyncReport( calculationContext ) )
+            { // void
+            }
+        }
+        else
+        {
+            ret = calculationManager->CalculateReports( calculationContext, m_calculationThreadCount.load() );
+        }
+
+        MD_LOG_A( adapterId, LOG_DEBUG, "calculated %u out reports", calculationContext.CommonCalculationContext.OutReportCount );
+        MD_LOG_A( adapterId, LOG_DEBUG, "max values%s calculated", ( outDescriptor ? outDescriptor->MaxValueColumns != nullptr : outMaxValues != nullptr ) ? "" : " not" );
+
+        if( outReportCount )
+        {
+            *outReportCount = calculationContext.CommonCalculationContext.OutReportCount;
+        }
+
+        // User buffers aren't kept in the session
+        calculationContext.CommonCalculationContext.Out           = nullptr;
+        calculationContext.CommonCalculationContext.OutMaxValues  = nullptr;
+        calculationContext.CommonCalculationContext.OutDescriptor = nullptr;
+        calculationContext.CommonCalculationContext.RawData       = nullptr;
+
+        ReleaseCalculationSession( session );
+
+        MD_LOG_EXIT_A( adapterId );
+        return ret;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     CalculateIoMeasurementInformation
+    //
+    // Description:
+    //     Calculates IoMeasurementInformation obtained on every ReadIoStream.
+    //
+    // Input:
+    //     TTypedValue_1_0* out     - (OUT) buffer for calculated IoMeasurementInformation
+    //     uint32_t         outSize - output buffer size, should be at least
+    //                                IoMeasurementInformation count * sizeof(TTypedValue_1_0)
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::CalculateIoMeasurementInformation( TTypedValue_1_0* out, uint32_t outSize )
+    {
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        MD_LOG_ENTER_A( adapterId );
+
+        MD_CHECK_PTR_RET_A( adapterId, m_concurrentGroup, CC_ERROR_GENERAL );
+        MD_CHECK_PTR_RET_A( adapterId, out, CC_ERROR_INVALID_PARAMETER );
+
+        if( outSize < m_concurrentGroup->GetParams()->IoMeasurementInformationCount * sizeof( TTypedValue_1_0 ) )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: output buffer has incorrect size" );
+            MD_LOG_A( adapterId, LOG_DEBUG, "outSize: %u", outSize );
+            MD_LOG_EXIT_A( adapterId );
+            return CC_ERROR_INVALID_PARAMETER;
+        }
+
+        auto metricsCalculator = GetMetricsCalculator();
+        MD_CHECK_PTR_RET_A( adapterId, metricsCalculator, CC_ERROR_GENERAL );
+
+        metricsCalculator->ReadIoMeasurementInformation( *m_concurrentGroup, out );
+        MD_LOG_A( adapterId, LOG_DEBUG, "calculated %u out io information", m_concurrentGroup->GetParams()->IoMeasurementInformationCount );
+
+        MD_LOG_EXIT_A( adapterId );
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     ValidateCalculateMetricsParams
+    //
+    // Description:
+    //     Validates parameters passed to CalculateMetrics.
+    //     Subjects of validation: i.a. input and output buffer alignments, output buffer size.
+    //
+    // Input:
+    //     uint32_t rawDataSize      - raw report data size
+    //     uint32_t rawReportSize    - size of one individual raw report
+    //     uint32_t outSize          - size of out buffer in bytes
+    //     uint32_t rawReportCount   - raw report count
+    //     uint32_t outMaxValuesSize - size of max values buffer in bytes
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::ValidateCalculateMetricsParams( uint32_t rawDataSize, uint32_t rawReportSize, uint32_t outSize, uint32_t rawReportCount, uint32_t outMaxValuesSize )
+    {
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        auto plan = GetCalculationPlan();
+        MD_CHECK_PTR_RET_A( adapterId, plan, CC_ERROR_GENERAL );
+
+        // Metrics count in calculated report, only projected metrics are written
+        const uint32_t outMetricsCount = static_cast<uint32_t>( plan->OutMetrics.size() );
+
+        // Size of one individual calculated report in bytes
+        uint32_t outReportSize = ( outMetricsCount + m_currentParams->InformationCount ) * sizeof( TTypedValue_1_0 );
+        // Size of one individual calculated max values report in bytes
+        uint32_t maxValuesReportSize = outMetricsCount * sizeof( TTypedValue_1_0 );
+
+        MD_ASSERT_A( adapterId, rawReportSize != 0 );
+
+        if( rawDataSize % rawReportSize != 0 )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: input buffer has incorrect size" );
+            MD_LOG_A( adapterId, LOG_DEBUG, "rawDataSize: %u, rawReportSize: %u", rawDataSize, rawReportSize );
+            return CC_ERROR_INVALID_PARAMETER;
+        }
+        if( outReportSize == 0 )
+        {
+            MD_LOG_A( adapterId, LOG_DEBUG, "outReportSize: 0. Nothing to calculate." );
+            return CC_OK;
+        }
+        if( outSize % outReportSize != 0 )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: output buffer has incorrect size" );
+            MD_LOG_A( adapterId, LOG_DEBUG, "outSize: %u, outReportSize: %u", outSize, outReportSize );
+            return CC_ERROR_INVALID_PARAMETER;
+        }
+        if( rawReportCount > ( outSize / outReportSize ) )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: output buffer to small" );
+            MD_LOG_A( adapterId, LOG_DEBUG, "rawReportCount: %u, outSize: %u, outReportSize: %u", rawReportCount, outSize, outReportSize );
+            return CC_ERROR_INVALID_PARAMETER;
+        }
+        if( outMaxValuesSize && maxValuesReportSize && rawReportCount > ( outMaxValuesSize / maxValuesReportSize ) )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: maxValues buffer to small" );
+            MD_LOG_A( adapterId, LOG_DEBUG, "rawReportCount: %u, outMaxValuesSize: %u, maxValueReportSize: %u", rawReportCount, outMaxValuesSize, maxValuesReportSize );
+            return CC_ERROR_INVALID_PARAMETER;
+        }
+
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     InitializeCalculationManager
+    //
+    // Description:
+    //     Creates or destroys CalculationManager adequate to the given measurement type.
+    //
+    // Input:
+    //     TMeasurementType      measurementType     - type of measurement for which manager will be created
+    //     CCalculationManager** calculationManager  - (OUT) pointer to the newly created CalculationManager, null if error
+    //     bool                  init                - if true initialization,
+    //                                                 if false deinitialization
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CMetricSet::InitializeCalculationManager( TMeasurementType measurementType, CCalculationManager** calculationManager, bool init )
+    {
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        if( !init )
+        {
+            MD_SAFE_DELETE( *calculationManager );
+            MD_LOG_A( adapterId, LOG_DEBUG, "calculation manager deinitialization" );
+            return;
+        }
+
+        MD_ASSERT_A( adapterId, *calculationManager == nullptr );
+        switch( measurementType )
+        {
+            case MEASUREMENT_TYPE_DELTA_QUERY:
+                *calculationManager = new( std::nothrow ) CMetricsCalculationManager<MEASUREMENT_TYPE_DELTA_QUERY>();
+                MD_LOG_A( adapterId, LOG_DEBUG, "query calculation manager created" );
+                return;
+
+            case MEASUREMENT_TYPE_SNAPSHOT_IO:
+                *calculationManager = new( std::nothrow ) CMetricsCalculationManager<MEASUREMENT_TYPE_SNAPSHOT_IO>();
+                MD_LOG_A( adapterId, LOG_DEBUG, "ioStream calculation manager created" );
+                return;
+
+            default:
+                *calculationManager = nullptr;
+                MD_LOG_A( adapterId, LOG_ERROR, "not supported measurement type" );
+                return;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     InitializeCalculationContext
+    //
+    // Description:
+    //     Initializes calculation context of the session with user provided data.
+    //     The context is reset and prepared by the calculation manager only if it
+    //     isn't prepared for the current calculation plan, otherwise only input and
+    //     output are set. After execution the context is ready for metrics calculations.
+    //
+    // Input:
+    //     TCalculationSession&                session          - (IN/OUT) calculation session
+    //     TTypedValue_1_0*                    out              - output buffer
+    //     TTypedValue_1_0*                    outMaxValues     - output buffer for MaxValues, can be nullptr
+    //     TCalculationOutputDescriptorLatest* outDescriptor    - output columns, can be nullptr
+    //     const uint8_t*                      rawData          - input buffer with raw report data
+    //     uint32_t                            rawReportCount   - raw report count
+    //     bool                                contextFiltering - if true only reports of the filtered context
+    //                                                            are calculated, IoStream only
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::InitializeCalculationContext( TCalculationSession& session, TTypedValue_1_0* out, TTypedValue_1_0* outMaxValues, TCalculationOutputDescriptorLatest* outDescriptor, const uint8_t* rawData, uint32_t rawReportCount, bool contextFiltering )
+    {
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        auto plan = GetCalculationPlan();
+        MD_CHECK_PTR_RET_A( adapterId, plan, CC_ERROR_GENERAL );
+
+        TCalculationContext&       context = session.Context;
+        TCommonCalculationContext& common  = context.CommonCalculationContext;
+
+        if( session.PlanGeneration != plan->Generation )
+        {
+            // Initialize context
+            session.CalculationManager->ResetContext( context );
+            common.DeltaValues     = session.Calculator->GetDeltaValues( m_currentParams->MetricsCount );
+            common.Calculator      = session.Calculator;
+            common.MetricSet       = this;
+            common.ConcurrentGroup = m_concurrentGroup;
+            if( session.CalculationManager->PrepareContext( context ) != CC_OK )
+            {
+                session.PlanGeneration = 0;
+                MD_LOG_A( adapterId, LOG_ERROR, "error: unable to prepare calculation context" );
+                return CC_ERROR_GENERAL;
+            }
+
+            session.PlanGeneration = plan->Generation;
+
+            MD_LOG_A( adapterId, LOG_DEBUG, "calculation context initialized" );
+            MD_LOG_A( adapterId, LOG_DEBUG, "metricSet: %s", common.MetricSet->GetParams()->ShortName );
+        }
+
+        common.Out             = out;
+        common.OutMaxValues    = outMaxValues;
+        common.OutDescriptor   = outDescriptor;
+        common.OutReportCount  = 0;
+        common.OutReportOffset = 0;
+        common.RawData         = rawData;
+        common.RawReportCount  = rawReportCount;
+
+        if( session.MeasurementType == MEASUREMENT_TYPE_SNAPSHOT_IO )
+        {
+            TStreamCalculationContext& sc = context.StreamCalculationContext;
+
+            sc.PrevRawDataPtr      = sc.RawData;
+            sc.PrevRawReportNumber = 0;
+            sc.LastRawDataPtr      = sc.RawData;
+            sc.LastRawReportNumber = 0;
+            sc.BatchReportCount    = 0;
+            sc.DoContextFiltering  = contextFiltering;
+            sc.ContextSelection    = nullptr;
+            sc.ReportReasons       = nullptr;
+
+            if( contextFiltering && sc.ContextIdIdx < 0 )
+            {
+                sc.DoContextFiltering = false;
+                MD_LOG_A( adapterId, LOG_ERROR, "error: can't find required information for context filtering" );
+                return CC_ERROR_NOT_SUPPORTED;
+            }
+        }
+        else if( contextFiltering )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: context filtering is only supported for IoStream" );
+            return CC_ERROR_NOT_SUPPORTED;
+        }
+
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     AreMetricParamsValid
+    //
+    // Description:
+    //     Checks the correctness of the given metric parameters.
+    //
+    // Input:
+    //     const char* symbolicName     -
+    //     const char* shortName        -
+    //     const char* longName         -
+    //     const char* groupName        -
+    //     TMetricType metricType       -
+    //     TMetricResultType resultType -
+    //     const char* units            -
+    //     THwUnitType hwType           -
+    //     const char* alias            -
+    //
+    // Output:
+    //     bool -
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    bool CMetricSet::AreMetricParamsValid( const char* symbolName, const char* shortName, const char* longName, const char* groupName, TMetricType metricType, TMetricResultType resultType, const char* units, THwUnitType hwType, const char* alias )
+    {
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        if( ( symbolName == nullptr ) || ( strcmp( symbolName, "" ) == 0 ) )
+        {
+            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, symbolName );
+            return false;
+        }
+        if( ( shortName == nullptr ) || ( strcmp( shortName, "" ) == 0 ) )
+        {
+            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, shortName );
+            return false;
+        }
+        if( ( longName == nullptr ) || ( strcmp( longName, "" ) == 0 ) )
+        {
+            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, longName );
+            return false;
+        }
+        if( ( groupName == nullptr ) || ( strcmp( groupName, "" ) == 0 ) )
+        {
+            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, groupName );
+            return false;
+        }
+        if( (uint32_t) metricType >= METRIC_TYPE_LAST )
+        {
+            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, metricType );
+            return false;
+        }
+        if( (uint32_t) resultType >= RESULT_LAST )
+        {
+            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, resultType );
+            return false;
+        }
+        if( ( units == nullptr ) || ( strcmp( units, "" ) == 0 ) )
+        {
+            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, units );
+            return false;
+        }
+        if( (uint32_t) hwType >= HW_UNIT_LAST )
+        {
+            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, hwType );
+            return false;
+        }
+        if( alias == nullptr )
+        {
+            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, alias );
+            return false;
+        }
+
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     IsCustomApiMaskValid
+    //
+    // Description:
+    //     Validates API mask used in IsCustomApiMaskValid method.
+    //     IoStream and Query measurements can be mixed.
+    //
+    // Input:
+    //    const uint32_t apiMask - api mask
+    //
+    // Output:
+    //     bool                  - true if valid, false otherwise
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    bool CMetricSet::IsCustomApiMaskValid( const uint32_t apiMask )
+    {
+        if( apiMask != 0 && apiMask != API_TYPE_ALL )
+        {
+            const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+            const bool     isStream  = ( apiMask & API_TYPE_IOSTREAM );
+            const bool     isQuery   = ( apiMask & MD_QUERY_API_MASK );
+
+            if( !isStream && !isQuery )
+            {
+                MD_LOG_A( adapterId, LOG_DEBUG, "ERROR: Wrong apiMask!, apiMask: %x", apiMask );
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     HasInformation
+    //
+    // Description:
+    //     Returns true if in the m_informationVector there is an information with the given
+    //     symbol name.
+    //
+    // Input:
+    //     const char * symbolName - information name to look for
+    //
+    // Output:
+    //     bool - true if found
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    bool CMetricSet::HasInformation( const char* symbolName )
+    {
+        MD_CHECK_PTR_RET_A( m_device.GetAdapter().GetAdapterId(), symbolName, false );
+
+        for( uint32_t i = 0; i < m_params.InformationCount; ++i )
+        {
+            auto information = GetInformation( i );
+            if( information && information->GetParams()->SymbolName != nullptr && strcmp( information->GetParams()->SymbolName, symbolName ) == 0 )
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     GetMetricsCalculator
+    //
+    // Description:
+    //     Returns metrics calculator.
+    //
+    // Output:
+    //     CMetricsCalculator* - metrics calculator or *nullptr* if error
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    CMetricsCalculator* CMetricSet::GetMetricsCalculator()
+    {
+        if( m_metricsCalculator == nullptr )
+        {
+            std::vector<std::reference_wrapper<CMetricsDevice>> devices = { m_device };
+
+            InitializeMetricsCalculator( devices );
+        }
+
+        return m_metricsCalculator;
+    }
 
     //////////////////////////////////////////////////////////////////////////////
     //
@@ -2726,142 +4166,177 @@ namespace MetricsDiscoveryInternal
     //     CMetricSet
     //
     // Method:
-    //     CalculateMetrics
+    //     GetMetricsDevice
     //
-    // Template Parameter:
-    //     async - Determines if the calculation is performed for async reports or not.
+    // Description:
+    //     Returns metrics device.
+    //
+    // Output:
+    //     CMetricsDevice& - reference to metrics device associated with metrics set
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    CMetricsDevice& CMetricSet::GetMetricsDevice()
+    {
+        return m_device;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     GetPlatformMask
     //
     // Description:
-    //     Conducts the whole process of metrics and information calculation for multiple reports.
-    //     It's API agnostic - user doesn't have to worry about API he has used.
-    //     User has to provide input buffer and its size, output buffer and its size with enough space for
-    //     all calculated metrics and information.
-    //     If async, method supports only IoStream. Query is not supported. Timer reports are not calculated in this method.
-    //     The amount of input reports is calculated based on rawData size and the size of single raw report.
+    //     Returns platform mask byte array member.
     //
-    //     Optional MaxValues calculation added, if MaxValueEquation isn't defined for the metric its current
-    //     normalized value is used.
+    // Output:
+    //     TByteArrayLatest* -
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TByteArrayLatest* CMetricSet::GetPlatformMask()
+    {
+        return m_platformMask;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     GetCalculationPlan
+    //
+    // Description:
+    //     Returns calculation plan for the current (API filtered or not) metrics
+    //     and information. The plan is rebuilt if it's been invalidated, so
+    //     the calculation mutex has to be locked exclusively, unless the plan is
+    //     locked by LockCalculationPlan.
+    //
+    // Output:
+    //     TCalculationPlan* - calculation plan or *nullptr* if error
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCalculationPlan* CMetricSet::GetCalculationPlan()
+    {
+        if( !m_calculationPlan.IsValid || m_calculationPlan.MetricsCount != m_currentParams->MetricsCount || m_calculationPlan.InformationCount != m_currentParams->InformationCount )
+        {
+            if( BuildCalculationPlan() != CC_OK )
+            {
+                return nullptr;
+            }
+        }
+
+        return &m_calculationPlan;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     ValidateOutputDescriptor
+    //
+    // Description:
+    //     Validates output columns passed to CalculateMetricColumns. Each column has to
+    //     have a room for outReportCount values of the metric result type, bool columns
+    //     for outReportCount bits.
     //
     // Input:
-    //     const uint8_t*   rawData                - raw report data
-    //     uint32_t         rawDataSize            - size of raw report data in bytes
-    //     TTypedValue_1_0* out                    - (OUT) buffer for calculated reports
-    //     uint32_t         outSize                - size of the provided output buffer in bytes
-    //     uint32_t*        outReportCount         - (OUT - optional) how much reports were calculated and are stored in the out buffer
-    //     TTypedValue_1_0* outMaxValues           - (OUT - optional) should have a memory for at least 'MetricCount * RawReportCount' values, can be nullptr. Calculated maxValues for each metric.
-    //                                               If MaxValueEquation isn't defined for the metric, MaxValue will be equal to the current, normalized metric value.
-    //     uint32_t         outMaxValuesSize       - size of the provided buffer for max values in bytes
+    //     const TCalculationOutputDescriptorLatest* outDescriptor  - output columns
+    //     uint32_t                                  rawDataSize    - raw report data size
+    //     uint32_t                                  rawReportSize  - size of one individual raw report
+    //     uint32_t                                  outReportCount - max count of calculated reports
     //
     // Output:
     //     TCompletionCode - *CC_OK* means success
     //
     //////////////////////////////////////////////////////////////////////////////
-    template <bool async>
-    TCompletionCode CMetricSet::CalculateMetrics( const uint8_t* rawData, uint32_t rawDataSize, TTypedValue_1_0* out, uint32_t outSize, uint32_t* outReportCount, TTypedValue_1_0* outMaxValues, uint32_t outMaxValuesSize )
+    TCompletionCode CMetricSet::ValidateOutputDescriptor( const TCalculationOutputDescriptorLatest* outDescriptor, uint32_t rawDataSize, uint32_t rawReportSize, uint32_t outReportCount )
     {
         const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
 
-        MD_LOG_ENTER_A( adapterId );
-
-        constexpr uint32_t streamMask = API_TYPE_IOSTREAM;
+        MD_CHECK_PTR_RET_A( adapterId, outDescriptor, CC_ERROR_INVALID_PARAMETER );
 
-        const auto measurementType = ( m_currentParams->ApiMask & streamMask )
-            ? MEASUREMENT_TYPE_SNAPSHOT_IO
-            : MEASUREMENT_TYPE_DELTA_QUERY;
+        auto plan = GetCalculationPlan();
+        MD_CHECK_PTR_RET_A( adapterId, plan, CC_ERROR_GENERAL );
 
-        if constexpr( async )
-        {
-            if( measurementType != MEASUREMENT_TYPE_SNAPSHOT_IO )
-            {
-                MD_LOG_A( adapterId, LOG_ERROR, "Async metrics calculation is only supported for IoStream measurements" );
-                MD_LOG_EXIT_A( adapterId );
-                return CC_ERROR_NOT_SUPPORTED;
-            }
-        }
+        const uint32_t outMetricsCount = static_cast<uint32_t>( plan->OutMetrics.size() );
 
-        MD_CHECK_PTR_RET_A( adapterId, rawData, CC_ERROR_INVALID_PARAMETER );
-        MD_CHECK_PTR_RET_A( adapterId, out, CC_ERROR_INVALID_PARAMETER );
+        MD_ASSERT_A( adapterId, rawReportSize != 0 );
 
-        if( !rawDataSize )
-        {
-            MD_LOG_A( adapterId, LOG_DEBUG, "nothing to calculate, rawDataSize: 0" );
-            MD_LOG_EXIT_A( adapterId );
-            return CC_OK;
-        }
-        if( !outMaxValues || !outMaxValuesSize )
+        if( rawDataSize % rawReportSize != 0 )
         {
-            MD_LOG_A( adapterId, LOG_DEBUG, "max values won't be calculated, outMaxValues: %p, outMaxValuesSize: %u", outMaxValues, outMaxValuesSize );
-            outMaxValues     = nullptr;
-            outMaxValuesSize = 0;
+            MD_LOG_A( adapterId, LOG_ERROR, "error: input buffer has incorrect size" );
+            MD_LOG_A( adapterId, LOG_DEBUG, "rawDataSize: %u, rawReportSize: %u", rawDataSize, rawReportSize );
+            return CC_ERROR_INVALID_PARAMETER;
         }
-
-        if( !m_isFiltered )
+        if( outDescriptor->MetricColumnCount != outMetricsCount )
         {
-            MD_LOG_A( adapterId, LOG_ERROR, "error: API filtering must be enabled first" );
-            MD_LOG_EXIT_A( adapterId );
-            return CC_ERROR_GENERAL;
+            MD_LOG_A( adapterId, LOG_ERROR, "error: incorrect metric column count" );
+            MD_LOG_A( adapterId, LOG_DEBUG, "metricColumnCount: %u, outMetricsCount: %u", outDescriptor->MetricColumnCount, outMetricsCount );
+            return CC_ERROR_INVALID_PARAMETER;
         }
-        if( ( m_currentParams->MetricsCount + m_currentParams->InformationCount ) == 0 )
+        if( outMetricsCount > 0 )
         {
-            // May happen when unsupported API is used in MetricSet filtering
-            MD_LOG_A( adapterId, LOG_WARNING, "nothing to calculate, empty MetricSet" );
-            MD_LOG_EXIT_A( adapterId );
-            return CC_OK;
+            MD_CHECK_PTR_RET_A( adapterId, outDescriptor->MetricColumns, CC_ERROR_INVALID_PARAMETER );
         }
 
-        const uint32_t rawReportSize = ( measurementType == MEASUREMENT_TYPE_SNAPSHOT_IO )
-            ? m_currentParams->RawReportSize
-            : m_currentParams->QueryReportSize;
-
-        const uint32_t rawReportCount = rawDataSize / rawReportSize;
-
-        // Validation
-        auto ret = ValidateCalculateMetricsParams( rawDataSize, rawReportSize, outSize, rawReportCount, outMaxValuesSize );
-        MD_CHECK_CC_RET_A( adapterId, ret );
+        auto isColumnValid = [&]( const TMetricColumnLatest& column, TMetricResultType resultType )
+        {
+            uint64_t requiredSize = 0;
 
-        // Initialize manager and context
-        TCalculationContext  calculationContext = {};
-        CCalculationManager* calculationManager = nullptr;
+            switch( resultType )
+            {
+                case RESULT_UINT32:
+                    requiredSize = static_cast<uint64_t>( outReportCount ) * sizeof( uint32_t );
+                    break;
+                case RESULT_UINT64:
+                    requiredSize = static_cast<uint64_t>( outReportCount ) * sizeof( uint64_t );
+                    break;
+                case RESULT_FLOAT:
+                    requiredSize = static_cast<uint64_t>( outReportCount ) * sizeof( float );
+                    break;
+                case RESULT_BOOL:
+                    requiredSize = ( static_cast<uint64_t>( outReportCount ) + MD_BYTE - 1 ) / MD_BYTE;
+                    break;
+                default:
+                    return false;
+            }
 
-        InitializeCalculationManager( measurementType, &calculationManager, true );
-        MD_CHECK_PTR_RET_A( adapterId, calculationManager, CC_ERROR_NO_MEMORY );
+            return ( column.Data != nullptr || requiredSize == 0 ) && column.Size >= requiredSize;
+        };
 
-        ret = InitializeCalculationContext( calculationContext, calculationManager, measurementType, out, outMaxValues, rawData, rawReportCount, true );
-        if( ret != CC_OK )
+        for( uint32_t i = 0; i < outMetricsCount; ++i )
         {
-            goto deinitialize_manager;
-        }
-
-        MD_LOG_A( adapterId, LOG_DEBUG, "about to calculate %u raw reports", rawReportCount );
+            const TMetricResultType resultType = plan->ResultTypes[plan->OutMetrics[i]];
 
-        // CALCULATE METRICS
-        if constexpr( async )
-        {
-            while( calculationManager->CalculateNextAsyncReport( calculationContext ) )
-            { // void
+            if( !isColumnValid( outDescriptor->MetricColumns[i], resultType ) )
+            {
+                MD_LOG_A( adapterId, LOG_ERROR, "error: metric column %u has incorrect size", i );
+                MD_LOG_A( adapterId, LOG_DEBUG, "size: %u, outReportCount: %u, resultType: %u", outDescriptor->MetricColumns[i].Size, outReportCount, static_cast<uint32_t>( resultType ) );
+                return CC_ERROR_INVALID_PARAMETER;
             }
-        }
-        else
-        {
-            while( calculationManager->CalculateNextReport( calculationContext ) )
-            { // void
+            if( outDescriptor->MaxValueColumns && !isColumnValid( outDescriptor->MaxValueColumns[i], resultType ) )
+            {
+                MD_LOG_A( adapterId, LOG_ERROR, "error: max value column %u has incorrect size", i );
+                MD_LOG_A( adapterId, LOG_DEBUG, "size: %u, outReportCount: %u, resultType: %u", outDescriptor->MaxValueColumns[i].Size, outReportCount, static_cast<uint32_t>( resultType ) );
+                return CC_ERROR_INVALID_PARAMETER;
             }
         }
 
-        MD_LOG_A( adapterId, LOG_DEBUG, "calculated %u out reports", calculationContext.CommonCalculationContext.OutReportCount );
-        MD_LOG_A( adapterId, LOG_DEBUG, "max values%s calculated", outMaxValues ? "" : " not" );
+        const uint64_t informationSize = static_cast<uint64_t>( m_currentParams->InformationCount ) * outReportCount * sizeof( TTypedValue_1_0 );
 
-        if( outReportCount )
+        if( outDescriptor->OutInformation && outDescriptor->OutInformationSize < informationSize )
         {
-            *outReportCount = calculationContext.CommonCalculationContext.OutReportCount;
+            MD_LOG_A( adapterId, LOG_ERROR, "error: information buffer to small" );
+            MD_LOG_A( adapterId, LOG_DEBUG, "outInformationSize: %u, outReportCount: %u", outDescriptor->OutInformationSize, outReportCount );
+            return CC_ERROR_INVALID_PARAMETER;
         }
 
-        InitializeCalculationContext( calculationContext, nullptr, measurementType, nullptr, nullptr, nullptr, 0, false );
-    deinitialize_manager:
-        InitializeCalculationManager( measurementType, &calculationManager, false );
-
-        MD_LOG_EXIT_A( adapterId );
-        return ret;
+        return CC_OK;
     }
 
     //////////////////////////////////////////////////////////////////////////////
@@ -2870,44 +4345,46 @@ namespace MetricsDiscoveryInternal
     //     CMetricSet
     //
     // Method:
-    //     CalculateIoMeasurementInformation
+    //     InitializeMetricsCalculator
     //
     // Description:
-    //     Calculates IoMeasurementInformation obtained on every ReadIoStream.
+    //     Initializes metrics calculator if not already initialized.
     //
     // Input:
-    //     TTypedValue_1_0* out     - (OUT) buffer for calculated IoMeasurementInformation
-    //     uint32_t         outSize - output buffer size, should be at least
-    //                                IoMeasurementInformation count * sizeof(TTypedValue_1_0)
+    //    std::vector<std::reference_wrapper<CMetricsDevice>>& devices - vector of metrics devices, used to get symbols
     //
     // Output:
-    //     TCompletionCode - *CC_OK* means success
+    //     TCompletionCode - *CC_OK* if metrics calculator has been initialized successfully, *CC_ERROR_NO_MEMORY* if memory allocation failed.
     //
     //////////////////////////////////////////////////////////////////////////////
-    TCompletionCode CMetricSet::CalculateIoMeasurementInformation( TTypedValue_1_0* out, uint32_t outSize )
+    TCompletionCode CMetricSet::InitializeMetricsCalculator( std::vector<std::reference_wrapper<CMetricsDevice>>& devices )
     {
-        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
-
-        MD_LOG_ENTER_A( adapterId );
+        if( m_metricsCalculator == nullptr )
+        {
+            const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
 
-        MD_CHECK_PTR_RET_A( adapterId, m_concurrentGroup, CC_ERROR_GENERAL );
-        MD_CHECK_PTR_RET_A( adapterId, out, CC_ERROR_INVALID_PARAMETER );
+            if( m_calculatorSymbols == nullptr )
+            {
+                m_calculatorSymbols = ( devices.size() == 1 )
+                    ? new( std::nothrow ) CCalculatorSymbols( devices[0].get() )
+                    : new( std::nothrow ) CCalculatorSymbols( devices );
 
-        if( outSize < m_concurrentGroup->GetParams()->IoMeasurementInformationCount * sizeof( TTypedValue_1_0 ) )
-        {
-            MD_LOG_A( adapterId, LOG_ERROR, "error: output buffer has incorrect size" );
-            MD_LOG_A( adapterId, LOG_DEBUG, "outSize: %u", outSize );
-            MD_LOG_EXIT_A( adapterId );
-            return CC_ERROR_INVALID_PARAMETER;
-        }
+                if( m_calculatorSymbols == nullptr )
+                {
+                    MD_LOG_A( adapterId, LOG_ERROR, "ERROR: Cannot allocate memory for CCalculatorSymbols" );
+                    return CC_ERROR_NO_MEMORY;
+                }
+            }
 
-        auto metricsCalculator = GetMetricsCalculator();
-        MD_CHECK_PTR_RET_A( adapterId, metricsCalculator, CC_ERROR_GENERAL );
+            m_metricsCalculator = new( std::nothrow ) CMetricsCalculator( *m_calculatorSymbols );
 
-        metricsCalculator->ReadIoMeasurementInformation( *m_concurrentGroup, out );
-        MD_LOG_A( adapterId, LOG_DEBUG, "calculated %u out io information", m_concurrentGroup->GetParams()->IoMeasurementInformationCount );
+            if( m_metricsCalculator == nullptr )
+            {
+                MD_LOG_A( adapterId, LOG_ERROR, "ERROR: Cannot allocate memory for CMetricsCalculator" );
+                return CC_ERROR_NO_MEMORY;
+            }
+        }
 
-        MD_LOG_EXIT_A( adapterId );
         return CC_OK;
     }
 
@@ -2917,65 +4394,53 @@ namespace MetricsDiscoveryInternal
     //     CMetricSet
     //
     // Method:
-    //     ValidateCalculateMetricsParams
+    //     DiscardSavedReports
     //
     // Description:
-    //     Validates parameters passed to CalculateMetrics.
-    //     Subjects of validation: i.a. input and output buffer alignments, output buffer size.
-    //
-    // Input:
-    //     uint32_t rawDataSize      - raw report data size
-    //     uint32_t rawReportSize    - size of one individual raw report
-    //     uint32_t outSize          - size of out buffer in bytes
-    //     uint32_t rawReportCount   - raw report count
-    //     uint32_t outMaxValuesSize - size of max values buffer in bytes
-    //
-    // Output:
-    //     TCompletionCode - *CC_OK* means success
+    //     Discards the last raw reports saved by all the calculators of the metric set,
+    //     so the next IoStream calculation doesn't continue the previous stream.
     //
     //////////////////////////////////////////////////////////////////////////////
-    TCompletionCode CMetricSet::ValidateCalculateMetricsParams( uint32_t rawDataSize, uint32_t rawReportSize, uint32_t outSize, uint32_t rawReportCount, uint32_t outMaxValuesSize )
+    void CMetricSet::DiscardSavedReports()
     {
-        // Size of one individual calculated report in bytes
-        uint32_t outReportSize = ( m_currentParams->MetricsCount + m_currentParams->InformationCount ) * sizeof( TTypedValue_1_0 );
-        // Size of one individual calculated max values report in bytes
-        uint32_t maxValuesReportSize = m_currentParams->MetricsCount * sizeof( TTypedValue_1_0 );
-
-        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+        std::unique_lock<std::shared_mutex> lock( m_calculationMutex );
 
-        MD_ASSERT_A( adapterId, rawReportSize != 0 );
-
-        if( rawDataSize % rawReportSize != 0 )
-        {
-            MD_LOG_A( adapterId, LOG_ERROR, "error: input buffer has incorrect size" );
-            MD_LOG_A( adapterId, LOG_DEBUG, "rawDataSize: %u, rawReportSize: %u", rawDataSize, rawReportSize );
-            return CC_ERROR_INVALID_PARAMETER;
-        }
-        if( outReportSize == 0 )
-        {
-            MD_LOG_A( adapterId, LOG_DEBUG, "outReportSize: 0. Nothing to calculate." );
-            return CC_OK;
-        }
-        if( outSize % outReportSize != 0 )
-        {
-            MD_LOG_A( adapterId, LOG_ERROR, "error: output buffer has incorrect size" );
-            MD_LOG_A( adapterId, LOG_DEBUG, "outSize: %u, outReportSize: %u", outSize, outReportSize );
-            return CC_ERROR_INVALID_PARAMETER;
-        }
-        if( rawReportCount > ( outSize / outReportSize ) )
+        if( m_metricsCalculator != nullptr )
         {
-            MD_LOG_A( adapterId, LOG_ERROR, "error: output buffer to small" );
-            MD_LOG_A( adapterId, LOG_DEBUG, "rawReportCount: %u, outSize: %u, outReportSize: %u", rawReportCount, outSize, outReportSize );
-            return CC_ERROR_INVALID_PARAMETER;
+            m_metricsCalculator->DiscardSavedReport();
         }
-        if( outMaxValuesSize && maxValuesReportSize && rawReportCount > ( outMaxValuesSize / maxValuesReportSize ) )
+
+        if( m_calculationSession != nullptr )
         {
-            MD_LOG_A( adapterId, LOG_ERROR, "error: maxValues buffer to small" );
-            MD_LOG_A( adapterId, LOG_DEBUG, "rawReportCount: %u, outMaxValuesSize: %u, maxValueReportSize: %u", rawReportCount, outMaxValuesSize, maxValuesReportSize );
-            return CC_ERROR_INVALID_PARAMETER;
+            m_calculationSession->Calculator->DiscardSavedReport();
         }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricSet
+    //
+    // Method:
+    //     PrepareCalculationPlan
+    //
+    // Description:
+    //     Builds calculation plan and matches metric kernels under the lock, so
+    //     concurrent calculations only read the metric set. Equation programs are
+    //     folded when compiled and aren't changed here, equations calculated with
+    //     symbols aggregated across devices are replaced with bound copies, see
+    //     BindCalculationPlan. Has to be called before calculations are started
+    //     on other threads.
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CMetricSet::PrepareCalculationPlan()
+    {
+        std::unique_lock<std::shared_mutex> lock( m_calculationMutex );
 
-        return CC_OK;
+        return PrepareCalculationPlanInternal();
     }
 
     //////////////////////////////////////////////////////////////////////////////
@@ -2984,46 +4449,42 @@ namespace MetricsDiscoveryInternal
     //     CMetricSet
     //
     // Method:
-    //     InitializeCalculationManager
+    //     LockCalculationPlan
     //
     // Description:
-    //     Creates or destroys CalculationManager adequate to the given measurement type.
+    //     Locks prepared calculation plan for reading. Setters changing the plan
+    //     wait until the lock is released, so the plan, equations and current
+    //     metrics may be read without rebuilding until the calculation ends.
+    //     If the plan has been changed it's prepared first, see PrepareCalculationPlan.
     //
     // Input:
-    //     TMeasurementType      measurementType     - type of measurement for which manager will be created
-    //     CCalculationManager** calculationManager  - (OUT) pointer to the newly created CalculationManager, null if error
-    //     bool                  init                - if true initialization,
-    //                                                 if false deinitialization
+    //     std::shared_lock<std::shared_mutex>& lock - (OUT) lock of the plan, held by the caller
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
     //
     //////////////////////////////////////////////////////////////////////////////
-    void CMetricSet::InitializeCalculationManager( TMeasurementType measurementType, CCalculationManager** calculationManager, bool init )
+    TCompletionCode CMetricSet::LockCalculationPlan( std::shared_lock<std::shared_mutex>& lock )
     {
         const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
 
-        if( !init )
+        while( true )
         {
-            MD_SAFE_DELETE( *calculationManager );
-            MD_LOG_A( adapterId, LOG_DEBUG, "calculation manager deinitialization" );
-            return;
-        }
+            lock = std::shared_lock<std::shared_mutex>( m_calculationMutex );
 
-        MD_ASSERT_A( adapterId, *calculationManager == nullptr );
-        switch( measurementType )
-        {
-            case MEASUREMENT_TYPE_DELTA_QUERY:
-                *calculationManager = new( std::nothrow ) CMetricsCalculationManager<MEASUREMENT_TYPE_DELTA_QUERY>();
-                MD_LOG_A( adapterId, LOG_DEBUG, "query calculation manager created" );
-                return;
+            if( m_calculationPlan.IsValid &&
+                m_calculationPlan.MetricsCount == m_currentParams->MetricsCount &&
+                m_calculationPlan.InformationCount == m_currentParams->InformationCount &&
+                m_calculationPlan.Generation == m_preparedPlanGeneration )
+            {
+                return CC_OK;
+            }
 
-            case MEASUREMENT_TYPE_SNAPSHOT_IO:
-                *calculationManager = new( std::nothrow ) CMetricsCalculationManager<MEASUREMENT_TYPE_SNAPSHOT_IO>();
-                MD_LOG_A( adapterId, LOG_DEBUG, "ioStream calculation manager created" );
-                return;
+            // The plan has been changed, so it's prepared exclusively and checked again
+            lock.unlock();
 
-            default:
-                *calculationManager = nullptr;
-                MD_LOG_A( adapterId, LOG_ERROR, "not supported measurement type" );
-                return;
+            auto ret = PrepareCalculationPlan();
+            MD_CHECK_CC_RET_A( adapterId, ret );
         }
     }
 
@@ -3033,66 +4494,52 @@ namespace MetricsDiscoveryInternal
     //     CMetricSet
     //
     // Method:
-    //     InitializeCalculationContext
+    //     PrepareCalculationPlanInternal
     //
     // Description:
-    //     Resets calculation context and initializes it with user provided data.
-    //     After execution the context is ready for metrics calculations.
-    //
-    // Input:
-    //     TCalculationContext& context            - (OUT) calculation context
-    //     CalcManager*         calculationManager - already initialized calculation manager
-    //     TMeasurementType     measurementType    - type of measurements
-    //     TTypedValue_1_0*     out                - output buffer
-    //     TTypedValue_1_0*     outMaxValues       - output buffer for MaxValues, can be nullptr
-    //     const uint8_t*       rawData            - input buffer with raw report data
-    //     uint32_t             rawReportCount     - raw report count
-    //     bool                 init               - if true initialization,
-    //                                               if false deinitialization
+    //     Builds calculation plan, binds it to aggregated symbols and matches metric
+    //     kernels, see PrepareCalculationPlan. The calculation mutex has to be locked
+    //     by the caller.
     //
     // Output:
     //     TCompletionCode - *CC_OK* means success
     //
     //////////////////////////////////////////////////////////////////////////////
-    TCompletionCode CMetricSet::InitializeCalculationContext( TCalculationContext& context, CCalculationManager* calculationManager, TMeasurementType measurementType, TTypedValue_1_0* out, TTypedValue_1_0* outMaxValues, const uint8_t* rawData, uint32_t rawReportCount, bool init )
+    TCompletionCode CMetricSet::PrepareCalculationPlanInternal()
     {
         const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
 
-        MD_LOG_ENTER_A( adapterId );
-        if( !init )
+        MD_CHECK_PTR_RET_A( adapterId, GetMetricsCalculator(), CC_ERROR_NO_MEMORY );
+
+        auto plan = GetCalculationPlan();
+        MD_CHECK_PTR_RET_A( adapterId, plan, CC_ERROR_GENERAL );
+
+        // Kernels are already matched for the plan
+        if( m_preparedPlanGeneration == plan->Generation )
         {
-            MD_SAFE_DELETE_ARRAY( context.CommonCalculationContext.DeltaValues );
-            MD_LOG_A( adapterId, LOG_DEBUG, "calculation context deinitialization" );
-            MD_LOG_EXIT_A( adapterId );
             return CC_OK;
         }
 
-        // Initialize context
-        calculationManager->ResetContext( context );
-        context.CommonCalculationContext.DeltaValues = new( std::nothrow ) TTypedValue_1_0[m_currentParams->MetricsCount];
-        MD_CHECK_PTR_RET_A( adapterId, context.CommonCalculationContext.DeltaValues, CC_ERROR_NO_MEMORY );
-        context.CommonCalculationContext.Calculator      = GetMetricsCalculator();
-        context.CommonCalculationContext.MetricSet       = this;
-        context.CommonCalculationContext.ConcurrentGroup = m_concurrentGroup;
-        context.CommonCalculationContext.Out             = out;
-        context.CommonCalculationContext.OutMaxValues    = outMaxValues;
-        context.CommonCalculationContext.RawData         = rawData;
-        context.CommonCalculationContext.RawReportCount  = rawReportCount;
-        if( measurementType == MEASUREMENT_TYPE_SNAPSHOT_IO )
-        {
-            context.StreamCalculationContext.DoContextFiltering = false;
-        }
-        if( calculationManager->PrepareContext( context ) != CC_OK )
-        {
-            // Deinitialize and return error
-            InitializeCalculationContext( context, nullptr, measurementType, nullptr, nullptr, nullptr, 0, false );
-            MD_LOG_EXIT_A( adapterId );
-            return CC_ERROR_GENERAL;
+        // Equations are bound to symbols of a single device, kernels are matched on the bound copies
+        if( m_calculatorSymbols->HasAggregatedSymbols() )
+        {
+            auto ret = BindCalculationPlan( *plan );
+            MD_CHECK_CC_RET_A( adapterId, ret );
         }
 
-        MD_LOG_A( adapterId, LOG_DEBUG, "calculation context initialized" );
-        MD_LOG_A( adapterId, LOG_DEBUG, "metricSet: %s", context.CommonCalculationContext.MetricSet->GetParams()->ShortName );
-        MD_LOG_EXIT_A( adapterId );
+        // Metric sets as generated are calculated with native kernels where equations match,
+        // custom metrics and flexible metric sets are interpreted
+        plan->HasKernels = false;
+
+        if( !m_isFlexible && !m_isCustom )
+        {
+            m_metricsCalculator->MatchMetricKernels( *plan );
+
+            plan->HasKernels = true;
+        }
+
+        m_preparedPlanGeneration = plan->Generation;
+
         return CC_OK;
     }
 
@@ -3102,77 +4549,67 @@ namespace MetricsDiscoveryInternal
     //     CMetricSet
     //
     // Method:
-    //     AreMetricParamsValid
+    //     BindCalculationPlan
     //
     // Description:
-    //     Checks the correctness of the given metric parameters.
+    //     Replaces equations of the plan with copies bound to global symbols
+    //     aggregated across devices, with the aggregated values folded into
+    //     their programs. So the values aren't looked up during calculations.
+    //     The copies are owned by the plan until it's built again.
     //
     // Input:
-    //     const char* symbolicName     -
-    //     const char* shortName        -
-    //     const char* longName         -
-    //     const char* groupName        -
-    //     TMetricType metricType       -
-    //     TMetricResultType resultType -
-    //     const char* units            -
-    //     THwUnitType hwType           -
-    //     const char* alias            -
+    //     TCalculationPlan& plan - (IN/OUT) built calculation plan
     //
     // Output:
-    //     bool -
+    //     TCompletionCode - *CC_OK* means success
     //
     //////////////////////////////////////////////////////////////////////////////
-    bool CMetricSet::AreMetricParamsValid( const char* symbolName, const char* shortName, const char* longName, const char* groupName, TMetricType metricType, TMetricResultType resultType, const char* units, THwUnitType hwType, const char* alias )
+    TCompletionCode CMetricSet::BindCalculationPlan( TCalculationPlan& plan )
     {
         const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
 
-        if( ( symbolName == nullptr ) || ( strcmp( symbolName, "" ) == 0 ) )
-        {
-            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, symbolName );
-            return false;
-        }
-        if( ( shortName == nullptr ) || ( strcmp( shortName, "" ) == 0 ) )
-        {
-            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, shortName );
-            return false;
-        }
-        if( ( longName == nullptr ) || ( strcmp( longName, "" ) == 0 ) )
-        {
-            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, longName );
-            return false;
-        }
-        if( ( groupName == nullptr ) || ( strcmp( groupName, "" ) == 0 ) )
-        {
-            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, groupName );
-            return false;
-        }
-        if( (uint32_t) metricType >= METRIC_TYPE_LAST )
-        {
-            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, metricType );
-            return false;
-        }
-        if( (uint32_t) resultType >= RESULT_LAST )
+        auto bindEquation = [&]( CEquation*& equation )
         {
-            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, resultType );
-            return false;
-        }
-        if( ( units == nullptr ) || ( strcmp( units, "" ) == 0 ) )
-        {
-            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, units );
-            return false;
-        }
-        if( (uint32_t) hwType >= HW_UNIT_LAST )
+            if( equation == nullptr )
+            {
+                return true;
+            }
+
+            CEquation* boundEquation = new( std::nothrow ) CEquation( *equation );
+            if( boundEquation == nullptr )
+            {
+                return false;
+            }
+
+            boundEquation->BindGlobalSymbols( *m_calculatorSymbols );
+            plan.BoundEquations.push_back( boundEquation );
+
+            equation = boundEquation;
+            return true;
+        };
+
+        for( uint32_t i = 0; i < plan.MetricsCount; ++i )
         {
-            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, hwType );
-            return false;
+            if( !bindEquation( plan.QueryReadEquations[i] ) ||
+                !bindEquation( plan.IoReadEquations[i] ) ||
+                !bindEquation( plan.NormEquations[i] ) ||
+                !bindEquation( plan.MaxValueEquations[i] ) )
+            {
+                MD_LOG_A( adapterId, LOG_ERROR, "ERROR: Cannot allocate memory for bound equation" );
+                return CC_ERROR_NO_MEMORY;
+            }
         }
-        if( alias == nullptr )
+
+        for( auto& information : plan.Informations )
         {
-            MD_LOG_INVALID_PARAMETER_A( adapterId, LOG_ERROR, alias );
-            return false;
+            if( !bindEquation( information.ReadEquation ) )
+            {
+                MD_LOG_A( adapterId, LOG_ERROR, "ERROR: Cannot allocate memory for bound equation" );
+                return CC_ERROR_NO_MEMORY;
+            }
         }
 
-        return true;
+        return CC_OK;
     }
 
     //////////////////////////////////////////////////////////////////////////////
@@ -3181,35 +4618,22 @@ namespace MetricsDiscoveryInternal
     //     CMetricSet
     //
     // Method:
-    //     IsCustomApiMaskValid
+    //     DeleteBoundEquations
     //
     // Description:
-    //     Validates API mask used in IsCustomApiMaskValid method.
-    //     IoStream and Query measurements can be mixed.
+    //     Deletes equation copies bound by BindCalculationPlan.
     //
     // Input:
-    //    const uint32_t apiMask - api mask
-    //
-    // Output:
-    //     bool                  - true if valid, false otherwise
+    //     TCalculationPlan& plan - (IN/OUT) calculation plan
     //
     //////////////////////////////////////////////////////////////////////////////
-    bool CMetricSet::IsCustomApiMaskValid( const uint32_t apiMask )
+    void CMetricSet::DeleteBoundEquations( TCalculationPlan& plan )
     {
-        if( apiMask != 0 && apiMask != API_TYPE_ALL )
+        for( auto& equation : plan.BoundEquations )
         {
-            const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
-            const bool     isStream  = ( apiMask & API_TYPE_IOSTREAM );
-            const bool     isQuery   = ( apiMask & MD_QUERY_API_MASK );
-
-            if( !isStream && !isQuery )
-            {
-                MD_LOG_A( adapterId, LOG_DEBUG, "ERROR: Wrong apiMask!, apiMask: %x", apiMask );
-                return false;
-            }
+            MD_SAFE_DELETE( equation );
         }
-
-        return true;
+        plan.BoundEquations.clear();
     }
 
     //////////////////////////////////////////////////////////////////////////////
@@ -3218,33 +4642,86 @@ namespace MetricsDiscoveryInternal
     //     CMetricSet
     //
     // Method:
-    //     HasInformation
+    //     AcquireCalculationSession
     //
     // Description:
-    //     Returns true if in the m_informationVector there is an information with the given
-    //     symbol name.
+    //     Returns a calculation session for a CalculateMetrics call. The session holds
+    //     a calculator (saved report, previous values, stacks and batch buffers),
+    //     calculation manager and context, so only the prepared plan is shared with
+    //     other calls. Sequential calls get the session of the metric set, so they
+    //     continue the same IoStream from any thread. Calls overlapping it get an idle
+    //     session, created if there is none, which starts a new stream. Sessions are
+    //     reused until the metric set is destroyed. The plan has to be locked by the
+    //     caller, see LockCalculationPlan, and the session released after the calculation.
     //
     // Input:
-    //     const char * symbolName - information name to look for
+    //     TMeasurementType measurementType - type of measurements
     //
     // Output:
-    //     bool - true if found
+    //     TCalculationSession** session - (OUT) calculation session used only by the caller
+    //     TCompletionCode               - *CC_OK* means success
     //
     //////////////////////////////////////////////////////////////////////////////
-    bool CMetricSet::HasInformation( const char* symbolName )
+    TCompletionCode CMetricSet::AcquireCalculationSession( TMeasurementType measurementType, TCalculationSession** session )
     {
-        MD_CHECK_PTR_RET_A( m_device.GetAdapter().GetAdapterId(), symbolName, false );
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        TCalculationSession* acquiredSession = nullptr;
+        bool                 isStreamSession = false;
+        TCompletionCode      ret             = CC_OK;
 
-        for( uint32_t i = 0; i < m_params.InformationCount; ++i )
         {
-            auto information = GetInformation( i );
-            if( information && information->GetParams()->SymbolName != nullptr && strcmp( information->GetParams()->SymbolName, symbolName ) == 0 )
+            std::lock_guard<std::mutex> sessionLock( m_calculationSessionMutex );
+
+            if( !m_isCalculationSessionUsed )
             {
-                return true;
+                if( m_calculationSession == nullptr )
+                {
+                    ret = CreateCalculationSession( measurementType, &m_calculationSession );
+                    MD_CHECK_CC_RET_A( adapterId, ret );
+                }
+
+                acquiredSession            = m_calculationSession;
+                isStreamSession            = true;
+                m_isCalculationSessionUsed = true;
+            }
+            else if( !m_idleCalculationSessions.empty() )
+            {
+                acquiredSession = m_idleCalculationSessions.back();
+                m_idleCalculationSessions.pop_back();
             }
         }
 
-        return false;
+        if( acquiredSession == nullptr )
+        {
+            ret = CreateCalculationSession( measurementType, &acquiredSession );
+            MD_CHECK_CC_RET_A( adapterId, ret );
+        }
+        else if( !isStreamSession )
+        {
+            // Overlapping calls don't continue a stream of another call
+            acquiredSession->Calculator->DiscardSavedReport();
+        }
+
+        // Manager is created again only if measurement type changes, e.g. after API filtering
+        if( acquiredSession->CalculationManager == nullptr || acquiredSession->MeasurementType != measurementType )
+        {
+            InitializeCalculationManager( acquiredSession->MeasurementType, &acquiredSession->CalculationManager, false );
+            InitializeCalculationManager( measurementType, &acquiredSession->CalculationManager, true );
+
+            acquiredSession->MeasurementType = measurementType;
+            acquiredSession->PlanGeneration  = 0;
+
+            if( acquiredSession->CalculationManager == nullptr )
+            {
+                ReleaseCalculationSession( acquiredSession );
+                MD_LOG_A( adapterId, LOG_ERROR, "ERROR: Cannot allocate memory for calculation manager" );
+                return CC_ERROR_NO_MEMORY;
+            }
+        }
+
+        *session = acquiredSession;
+        return CC_OK;
     }
 
     //////////////////////////////////////////////////////////////////////////////
@@ -3253,25 +4730,28 @@ namespace MetricsDiscoveryInternal
     //     CMetricSet
     //
     // Method:
-    //     GetMetricsCalculator
+    //     ReleaseCalculationSession
     //
     // Description:
-    //     Returns metrics calculator.
+    //     Returns a session acquired by AcquireCalculationSession, so it can be used
+    //     by the next CalculateMetrics calls.
     //
-    // Output:
-    //     CMetricsCalculator* - metrics calculator or *nullptr* if error
+    // Input:
+    //     TCalculationSession* session - calculation session
     //
     //////////////////////////////////////////////////////////////////////////////
-    CMetricsCalculator* CMetricSet::GetMetricsCalculator()
+    void CMetricSet::ReleaseCalculationSession( TCalculationSession* session )
     {
-        if( m_metricsCalculator == nullptr )
-        {
-            std::vector<std::reference_wrapper<CMetricsDevice>> devices = { m_device };
+        std::lock_guard<std::mutex> sessionLock( m_calculationSessionMutex );
 
-            InitializeMetricsCalculator( devices );
+        if( session == m_calculationSession )
+        {
+            m_isCalculationSessionUsed = false;
+        }
+        else
+        {
+            m_idleCalculationSessions.push_back( session );
         }
-
-        return m_metricsCalculator;
     }
 
     //////////////////////////////////////////////////////////////////////////////
@@ -3280,18 +4760,46 @@ namespace MetricsDiscoveryInternal
     //     CMetricSet
     //
     // Method:
-    //     GetMetricsDevice
+    //     CreateCalculationSession
     //
     // Description:
-    //     Returns metrics device.
+    //     Creates a calculation session with a new calculator and calculation manager
+    //     adequate to the given measurement type. The context is prepared on the first
+    //     InitializeCalculationContext call. Metrics calculator has to be initialized.
+    //
+    // Input:
+    //     TMeasurementType measurementType - type of measurements
     //
     // Output:
-    //     CMetricsDevice& - reference to metrics device associated with metrics set
+    //     TCalculationSession** session - (OUT) created calculation session, null if error
+    //     TCompletionCode               - *CC_OK* means success
     //
     //////////////////////////////////////////////////////////////////////////////
-    CMetricsDevice& CMetricSet::GetMetricsDevice()
+    TCompletionCode CMetricSet::CreateCalculationSession( TMeasurementType measurementType, TCalculationSession** session )
     {
-        return m_device;
+        const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
+
+        MD_CHECK_PTR_RET_A( adapterId, m_calculatorSymbols, CC_ERROR_GENERAL );
+
+        TCalculationSession* newSession = new( std::nothrow ) TCalculationSession();
+
+        if( newSession != nullptr )
+        {
+            newSession->Calculator      = new( std::nothrow ) CMetricsCalculator( *m_calculatorSymbols );
+            newSession->MeasurementType = measurementType;
+            InitializeCalculationManager( measurementType, &newSession->CalculationManager, true );
+        }
+
+        if( newSession == nullptr || newSession->Calculator == nullptr || newSession->CalculationManager == nullptr )
+        {
+            DestroyCalculationSession( newSession );
+            *session = nullptr;
+            MD_LOG_A( adapterId, LOG_ERROR, "ERROR: Cannot allocate memory for calculation session" );
+            return CC_ERROR_NO_MEMORY;
+        }
+
+        *session = newSession;
+        return CC_OK;
     }
 
     //////////////////////////////////////////////////////////////////////////////
@@ -3300,18 +4808,25 @@ namespace MetricsDiscoveryInternal
     //     CMetricSet
     //
     // Method:
-    //     GetPlatformMask
+    //     DestroyCalculationSession
     //
     // Description:
-    //     Returns platform mask byte array member.
+    //     Destroys a calculation session created by CreateCalculationSession.
     //
-    // Output:
-    //     TByteArrayLatest* -
+    // Input:
+    //     TCalculationSession*& session - (IN/OUT) calculation session, set to null
     //
     //////////////////////////////////////////////////////////////////////////////
-    TByteArrayLatest* CMetricSet::GetPlatformMask()
+    void CMetricSet::DestroyCalculationSession( TCalculationSession*& session )
     {
-        return m_platformMask;
+        if( session == nullptr )
+        {
+            return;
+        }
+
+        MD_SAFE_DELETE( session->Calculator );
+        InitializeCalculationManager( session->MeasurementType, &session->CalculationManager, false );
+        MD_SAFE_DELETE( session );
     }
 
     //////////////////////////////////////////////////////////////////////////////
@@ -3320,36 +4835,18 @@ namespace MetricsDiscoveryInternal
     //     CMetricSet
     //
     // Method:
-    //     InitializeMetricsCalculator
+    //     GetCalculationThreadCount
     //
     // Description:
-    //     Initializes metrics calculator if not already initialized.
-    //
-    // Input:
-    //    std::vector<std::reference_wrapper<CMetricsDevice>>& devices - vector of metrics devices, used to get symbols
+    //     Returns count of threads set by SetCalculationThreadCount.
     //
     // Output:
-    //     TCompletionCode - *CC_OK* if metrics calculator has been initialized successfully, *CC_ERROR_NO_MEMORY* if memory allocation failed.
+    //     uint32_t - thread count, 0 means hardware concurrency
     //
     //////////////////////////////////////////////////////////////////////////////
-    TCompletionCode CMetricSet::InitializeMetricsCalculator( std::vector<std::reference_wrapper<CMetricsDevice>>& devices )
+    uint32_t CMetricSet::GetCalculationThreadCount()
     {
-        if( m_metricsCalculator == nullptr )
-        {
-            const uint32_t adapterId = m_device.GetAdapter().GetAdapterId();
-
-            m_metricsCalculator = ( devices.size() == 1 )
-                ? new( std::nothrow ) CMetricsCalculator( devices[0].get() )
-                : new( std::nothrow ) CMetricsCalculator( devices );
-
-            if( m_metricsCalculator == nullptr )
-            {
-                MD_LOG_A( adapterId, LOG_ERROR, "ERROR: Cannot allocate memory for CMetricsCalculator" );
-                return CC_ERROR_NO_MEMORY;
-            }
-        }
-
-        return CC_OK;
+        return m_calculationThreadCount.load();
     }
 
     //////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,481 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2026 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+//     File Name:  md_range_index.cpp
+
+//     Abstract:   C++ Metrics Discovery internal range index implementation
+
+#include "md_range_index.h"
+#include "md_adapter.h"
+#include "md_metric_set.h"
+#include "md_metrics_calculator.h"
+#include "md_metrics_device.h"
+#include "md_report_kernels.h"
+#include "md_utils.h"
+
+#include <algorithm>
+
+namespace MetricsDiscoveryInternal
+{
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CRangeIndex
+    //
+    // Method:
+    //     CRangeIndex
+    //
+    // Description:
+    //     Constructor.
+    //
+    // Input:
+    //     CMetricSet& metricSet          - metric set used for calculations
+    //     bool        calculateMaxValues - if true, max values are calculated as well
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    CRangeIndex::CRangeIndex( CMetricSet& metricSet, bool calculateMaxValues )
+        : m_metricSet( metricSet )
+        , m_session( nullptr )
+        , m_calculateMaxValues( calculateMaxValues )
+        , m_planGeneration( 0 )
+        , m_outReportValues( 0 )
+        , m_maxValuesReportValues( 0 )
+        , m_rawReportSize( 0 )
+        , m_timestampOffset( 0 )
+        , m_counterCount( 0 )
+        , m_gpuTimestampFrequency( 0 )
+        , m_regions()
+        , m_timestamps()
+        , m_prefixSums()
+        , m_rangeCounters()
+        , m_rangeDeltas()
+        , m_rangeReports()
+        , m_out()
+        , m_outMaxValues()
+    {
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CRangeIndex
+    //
+    // Method:
+    //     ~CRangeIndex
+    //
+    // Description:
+    //     Destructor.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    CRangeIndex::~CRangeIndex()
+    {
+        m_metricSet.DestroyCalculationSession( m_session );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CRangeIndex
+    //
+    // Method:
+    //     Initialize
+    //
+    // Description:
+    //     Creates calculation session of the range index and computes cumulative
+    //     counters at each raw report. A counter delta between two consecutive raw
+    //     reports is wrapped to the counter size, as in the metric calculation, and
+    //     added to the previous cumulative value, so the cumulative values truncated
+    //     to the counter size are the raw counters again.
+    //
+    // Input:
+    //     const uint8_t* rawData     - raw report data, ascending timestamps
+    //     uint32_t       rawDataSize - size of raw report data in bytes
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CRangeIndex::Initialize( const uint8_t* rawData, uint32_t rawDataSize )
+    {
+        auto&          device    = m_metricSet.GetMetricsDevice();
+        const uint32_t adapterId = device.GetAdapter().GetAdapterId();
+
+        auto ret = m_metricSet.CreateCalculationSession( MEASUREMENT_TYPE_SNAPSHOT_IO, &m_session );
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        std::shared_lock<std::shared_mutex> planLock;
+
+        ret = m_metricSet.LockCalculationPlan( planLock );
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        ret = PreparePlan();
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        const TReportLayout& layout = m_metricSet.GetCalculationPlan()->ReportLayout;
+
+        if( layout.HeaderSize == 0 )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: counters layout of the report type isn't known" );
+            return CC_ERROR_NOT_SUPPORTED;
+        }
+        if( rawDataSize % m_rawReportSize != 0 || rawDataSize / m_rawReportSize < 2 )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: at least two raw reports are required" );
+            MD_LOG_A( adapterId, LOG_DEBUG, "rawDataSize: %u, rawReportSize: %u", rawDataSize, m_rawReportSize );
+            return CC_ERROR_INVALID_PARAMETER;
+        }
+
+        TTypedValueLatest* freqValue = device.GetGlobalSymbolValueByName( "GpuTimestampFrequency" );
+        MD_CHECK_PTR_RET_A( adapterId, freqValue, CC_ERROR_GENERAL );
+
+        const uint32_t rawReportCount = rawDataSize / m_rawReportSize;
+
+        m_gpuTimestampFrequency = freqValue->ValueUInt32;
+        m_timestampOffset       = layout.TimestampOffset;
+        m_counterCount          = 1 + layout.CountersCount;
+
+        m_regions.clear();
+        m_regions.push_back( { layout.GpuTicksOffset, 1, sizeof( uint64_t ) } );
+        for( uint32_t i = 0; i < REPORT_REGION_LAST; ++i )
+        {
+            if( layout.Regions[i].Count > 0 )
+            {
+                m_regions.push_back( layout.Regions[i] );
+            }
+        }
+
+        m_timestamps.resize( rawReportCount );
+        m_prefixSums.resize( static_cast<size_t>( rawReportCount ) * m_counterCount );
+        m_rangeCounters.resize( 2 * static_cast<size_t>( m_counterCount ) );
+        m_rangeDeltas.resize( REPORT_COLUMN_GPU_TICKS + static_cast<size_t>( m_counterCount ) );
+
+        for( uint32_t i = 0; i < rawReportCount; ++i )
+        {
+            const uint8_t*  rawReport = rawData + static_cast<size_t>( i ) * m_rawReportSize;
+            uint64_t*       row       = m_prefixSums.data() + static_cast<size_t>( i ) * m_counterCount;
+            const uint64_t* prevRow   = ( i > 0 ) ? row - m_counterCount : row;
+
+            m_timestamps[i] = *reinterpret_cast<const uint64_t*>( rawReport + m_timestampOffset );
+
+            if( i > 0 && m_timestamps[i] < m_timestamps[i - 1] )
+            {
+                MD_LOG_A( adapterId, LOG_ERROR, "error: raw report timestamps aren't ascending" );
+                MD_LOG_A( adapterId, LOG_DEBUG, "report: %u", i );
+                return CC_ERROR_INVALID_PARAMETER;
+            }
+
+            uint32_t column = 0;
+            for( const auto& region : m_regions )
+            {
+                const bool     is64Bit = ( region.ElemSize == sizeof( uint64_t ) );
+                const uint64_t mask    = is64Bit ? UINT64_MAX : UINT32_MAX;
+
+                for( uint32_t j = 0; j < region.Count; ++j, ++column )
+                {
+                    const uint8_t* counter = rawReport + region.Offset + j * region.ElemSize;
+                    const uint64_t value   = is64Bit
+                          ? *reinterpret_cast<const uint64_t*>( counter )
+                          : *reinterpret_cast<const uint32_t*>( counter );
+
+                    row[column] = ( i == 0 )
+                        ? value
+                        : prevRow[column] + ( ( value - prevRow[column] ) & mask );
+                }
+            }
+        }
+
+        // Fields other than counters are taken from the first raw report
+        m_rangeReports.resize( 2 * static_cast<size_t>( m_rawReportSize ) );
+        iu_memcpy_s( m_rangeReports.data(), m_rawReportSize, rawData, m_rawReportSize );
+        iu_memcpy_s( m_rangeReports.data() + m_rawReportSize, m_rawReportSize, rawData, m_rawReportSize );
+
+        MD_LOG_A( adapterId, LOG_DEBUG, "range index created, reports: %u, counters: %u", rawReportCount, m_counterCount );
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CRangeIndex
+    //
+    // Method:
+    //     GetTimeRange
+    //
+    // Description:
+    //     Returns timestamps of the first and the last indexed raw report.
+    //
+    // Input:
+    //     uint64_t* outStartTimestamp - (OUT) first raw report timestamp in ns
+    //     uint64_t* outEndTimestamp   - (OUT) last raw report timestamp in ns
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CRangeIndex::GetTimeRange( uint64_t* outStartTimestamp, uint64_t* outEndTimestamp )
+    {
+        auto&          device    = m_metricSet.GetMetricsDevice();
+        const uint32_t adapterId = device.GetAdapter().GetAdapterId();
+
+        MD_CHECK_PTR_RET_A( adapterId, outStartTimestamp, CC_ERROR_INVALID_PARAMETER );
+        MD_CHECK_PTR_RET_A( adapterId, outEndTimestamp, CC_ERROR_INVALID_PARAMETER );
+
+        *outStartTimestamp = device.ConvertGpuTimestampToNs( m_timestamps.front(), m_gpuTimestampFrequency );
+        *outEndTimestamp   = device.ConvertGpuTimestampToNs( m_timestamps.back(), m_gpuTimestampFrequency );
+
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CRangeIndex
+    //
+    // Method:
+    //     CalculateRange
+    //
+    // Description:
+    //     Calculates metrics and information between two timestamps. Cumulative
+    //     counters at both timestamps are interpolated between the surrounding raw
+    //     reports and their 64 bit differences are the counter deltas of the range,
+    //     so the cost doesn't depend on the range length and ranges longer than one
+    //     wrap period of the counters are calculated correctly. The deltas are read and
+    //     normalized directly, raw reports at both timestamps are used only for reads
+    //     other than report columns and for information. The calculated report is stored
+    //     in the range index and valid until the next CalculateRange.
+    //
+    // Input:
+    //     uint64_t                startTimestamp - range start in ns, clamped to the time range
+    //     uint64_t                endTimestamp   - range end in ns, clamped to the time range
+    //     const TTypedValue_1_0** out            - (OUT) calculated report
+    //     const TTypedValue_1_0** outMaxValues   - (OUT - optional) calculated max values, null if not calculated
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CRangeIndex::CalculateRange( uint64_t startTimestamp, uint64_t endTimestamp, const TTypedValue_1_0** out, const TTypedValue_1_0** outMaxValues )
+    {
+        auto&          device    = m_metricSet.GetMetricsDevice();
+        const uint32_t adapterId = device.GetAdapter().GetAdapterId();
+
+        MD_CHECK_PTR_RET_A( adapterId, out, CC_ERROR_INVALID_PARAMETER );
+
+        *out = nullptr;
+        if( outMaxValues )
+        {
+            *outMaxValues = nullptr;
+        }
+
+        // The plan can't be changed by the metric set setters until the range is calculated
+        std::shared_lock<std::shared_mutex> planLock;
+
+        auto ret = m_metricSet.LockCalculationPlan( planLock );
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        ret = PreparePlan();
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        if( m_outReportValues == 0 )
+        {
+            // May happen when unsupported API is used in MetricSet filtering
+            return CC_OK;
+        }
+
+        const uint64_t start = std::clamp( device.ConvertNsToGpuTimestamp( startTimestamp, m_gpuTimestampFrequency ), m_timestamps.front(), m_timestamps.back() );
+        const uint64_t end   = std::clamp( device.ConvertNsToGpuTimestamp( endTimestamp, m_gpuTimestampFrequency ), m_timestamps.front(), m_timestamps.back() );
+
+        if( start >= end )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: empty range" );
+            MD_LOG_A( adapterId, LOG_DEBUG, "startTimestamp: %llu, endTimestamp: %llu", startTimestamp, endTimestamp );
+            return CC_ERROR_INVALID_PARAMETER;
+        }
+
+        uint64_t* const startCounters = m_rangeCounters.data();
+        uint64_t* const endCounters   = startCounters + m_counterCount;
+        uint8_t* const  startReport   = m_rangeReports.data();
+        uint8_t* const  endReport     = startReport + m_rawReportSize;
+
+        InterpolateReport( start, startCounters, startReport );
+        InterpolateReport( end, endCounters, endReport );
+
+        // Deltas per report column, counters aren't truncated to their sizes
+        m_rangeDeltas[REPORT_COLUMN_TIMESTAMP] = end - start;
+
+        for( uint32_t i = 0; i < m_counterCount; ++i )
+        {
+            m_rangeDeltas[REPORT_COLUMN_GPU_TICKS + i] = endCounters[i] - startCounters[i];
+        }
+
+        m_out.resize( m_outReportValues );
+        if( m_calculateMaxValues )
+        {
+            m_outMaxValues.resize( m_maxValuesReportValues );
+        }
+
+        TTypedValue_1_0* maxValues = m_calculateMaxValues ? m_outMaxValues.data() : nullptr;
+
+        ret = m_metricSet.InitializeCalculationContext( *m_session, m_out.data(), maxValues, nullptr, m_rangeReports.data(), 2, false );
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        auto plan = m_metricSet.GetCalculationPlan();
+        MD_CHECK_PTR_RET_A( adapterId, plan, CC_ERROR_GENERAL );
+
+        // Same steps as an IoStream report calculation, with the range deltas
+        TStreamCalculationContext& sc                  = m_session->Context.StreamCalculationContext;
+        CMetricsCalculator&        calculator          = *m_session->Calculator;
+        TTypedValue_1_0*           calculatedValues    = calculator.GetCalculatedValues( *plan, sc, 1 );
+        TTypedValue_1_0*           calculatedMaxValues = calculator.GetCalculatedMaxValues( *plan, sc, 1 );
+
+        ret = calculator.ReadMetricsFromIoReport( endReport, startReport, sc.DeltaValues, m_metricSet, m_rangeDeltas.data() );
+
+        sc.RawData = nullptr;
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        calculator.NormalizeMetrics( sc.DeltaValues, calculatedValues, m_metricSet );
+        calculator.ReadInformation( endReport, calculatedValues + plan->MetricsCount, m_metricSet, sc.ContextIdIdx );
+
+        if( calculatedMaxValues )
+        {
+            calculator.CalculateMaxValues( sc.DeltaValues, calculatedValues, calculatedMaxValues, m_metricSet );
+        }
+
+        calculator.WriteCalculatedReports( *plan, sc, 1 );
+
+        *out = m_out.data();
+        if( outMaxValues )
+        {
+            *outMaxValues = maxValues;
+        }
+
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CRangeIndex
+    //
+    // Method:
+    //     InterpolateReport
+    //
+    // Description:
+    //     Interpolates cumulative counters at the given timestamp from the surrounding
+    //     raw reports, found by binary search, and writes a raw report with them.
+    //     Interpolation is the same as in the stream aggregation. Header fields are
+    //     written as for interpolated aggregation reports.
+    //
+    // Input:
+    //     uint64_t  timestamp   - GPU timestamp in ticks, within the indexed time range
+    //     uint64_t* outCounters - (OUT) m_counterCount cumulative counters
+    //     uint8_t*  outReport   - (OUT) raw report
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CRangeIndex::InterpolateReport( uint64_t timestamp, uint64_t* outCounters, uint8_t* outReport )
+    {
+        const uint32_t lastPair = static_cast<uint32_t>( m_timestamps.size() ) - 2;
+        const auto     next     = std::upper_bound( m_timestamps.begin(), m_timestamps.end(), timestamp );
+        const uint32_t pair     = ( std::min )( static_cast<uint32_t>( next - m_timestamps.begin() ) - 1, lastPair );
+
+        const uint64_t* prevRow  = m_prefixSums.data() + static_cast<size_t>( pair ) * m_counterCount;
+        const uint64_t* lastRow  = prevRow + m_counterCount;
+        const uint64_t  alphaQ32 = CReportKernels::GetInterpolationAlpha( timestamp, m_timestamps[pair], m_timestamps[pair + 1] );
+
+        CReportKernels::InterpolateCounters(
+            reinterpret_cast<const uint8_t*>( prevRow ),
+            reinterpret_cast<const uint8_t*>( lastRow ),
+            m_counterCount,
+            sizeof( uint64_t ),
+            alphaQ32,
+            reinterpret_cast<uint8_t*>( outCounters ) );
+
+        // Header fields
+        *reinterpret_cast<uint64_t*>( outReport + 0 )                 = 0;         // ReportId
+        *reinterpret_cast<uint64_t*>( outReport + m_timestampOffset ) = timestamp; // Timestamp
+        *reinterpret_cast<uint64_t*>( outReport + 16 )                = 0;         // ContextId
+
+        // Cumulative counters truncated to the counter sizes
+        uint32_t column = 0;
+        for( const auto& region : m_regions )
+        {
+            for( uint32_t j = 0; j < region.Count; ++j, ++column )
+            {
+                uint8_t* counter = outReport + region.Offset + j * region.ElemSize;
+
+                if( region.ElemSize == sizeof( uint64_t ) )
+                {
+                    *reinterpret_cast<uint64_t*>( counter ) = outCounters[column];
+                }
+                else
+                {
+                    *reinterpret_cast<uint32_t*>( counter ) = static_cast<uint32_t>( outCounters[column] );
+                }
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CRangeIndex
+    //
+    // Method:
+    //     PreparePlan
+    //
+    // Description:
+    //     Validates the metric set and report sizes again, only if the calculation
+    //     plan has changed since the last query. The plan is locked by the caller.
+    //     Indexed counters stay valid only while the raw report size is the same.
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CRangeIndex::PreparePlan()
+    {
+        const uint32_t adapterId = m_metricSet.GetMetricsDevice().GetAdapter().GetAdapterId();
+
+        auto plan = m_metricSet.GetCalculationPlan();
+        MD_CHECK_PTR_RET_A( adapterId, plan, CC_ERROR_GENERAL );
+
+        if( m_planGeneration == plan->Generation )
+        {
+            return CC_OK;
+        }
+
+        const auto params = m_metricSet.GetParams();
+
+        if( !m_metricSet.IsFiltered() || ( params->ApiMask & API_TYPE_IOSTREAM ) == 0 )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: metric set isn't filtered for IoStream" );
+            return CC_ERROR_NOT_SUPPORTED;
+        }
+        if( params->RawReportSize == 0 )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: raw report size is 0" );
+            return CC_ERROR_GENERAL;
+        }
+        if( m_rawReportSize != 0 && m_rawReportSize != params->RawReportSize )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: raw report size changed since the range index was created" );
+            return CC_ERROR_GENERAL;
+        }
+
+        // Metrics count in calculated report, only projected metrics are written
+        const uint32_t outMetricsCount = static_cast<uint32_t>( plan->OutMetrics.size() );
+
+        m_rawReportSize         = params->RawReportSize;
+        m_outReportValues       = outMetricsCount + params->InformationCount;
+        m_maxValuesReportValues = outMetricsCount;
+        m_planGeneration        = plan->Generation;
+
+        MD_LOG_A( adapterId, LOG_DEBUG, "range index prepared, metrics: %u, information: %u", outMetricsCount, params->InformationCount );
+        return CC_OK;
+    }
+} // namespace MetricsDiscoveryInternal
@@ -0,0 +1,260 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2026 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+//     File Name:  md_stream_calculation.cpp
+
+//     Abstract:   C++ Metrics Discovery internal stream calculation implementation
+
+#include "md_stream_calculation.h"
+#include "md_adapter.h"
+#include "md_metric_set.h"
+#include "md_metrics_calculator.h"
+#include "md_metrics_device.h"
+#include "md_utils.h"
+
+namespace MetricsDiscoveryInternal
+{
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CStreamCalculation
+    //
+    // Method:
+    //     CStreamCalculation
+    //
+    // Description:
+    //     Constructor.
+    //
+    // Input:
+    //     CMetricSet& metricSet          - metric set used for calculations
+    //     bool        calculateMaxValues - if true, max values are calculated as well
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    CStreamCalculation::CStreamCalculation( CMetricSet& metricSet, bool calculateMaxValues )
+        : m_metricSet( metricSet )
+        , m_session( nullptr )
+        , m_calculateMaxValues( calculateMaxValues )
+        , m_planGeneration( 0 )
+        , m_rawReportSize( 0 )
+        , m_outReportValues( 0 )
+        , m_maxValuesReportValues( 0 )
+        , m_out()
+        , m_outMaxValues()
+    {
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CStreamCalculation
+    //
+    // Method:
+    //     ~CStreamCalculation
+    //
+    // Description:
+    //     Destructor.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    CStreamCalculation::~CStreamCalculation()
+    {
+        m_metricSet.DestroyCalculationSession( m_session );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CStreamCalculation
+    //
+    // Method:
+    //     Initialize
+    //
+    // Description:
+    //     Creates calculation session of the stream calculation.
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CStreamCalculation::Initialize()
+    {
+        return m_metricSet.CreateCalculationSession( MEASUREMENT_TYPE_SNAPSHOT_IO, &m_session );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CStreamCalculation
+    //
+    // Method:
+    //     Push
+    //
+    // Description:
+    //     Calculates metrics and information from the next portion of IoStream raw data.
+    //     The first raw report of the stream is only saved, each next one is calculated
+    //     as a delta to the previous one, also across portions. Calculated reports are
+    //     stored in the stream calculation and valid until the next Push or Reset.
+    //     Parameters are fully validated only when the calculation plan of the metric
+    //     set changes, otherwise only the raw data size is checked.
+    //
+    // Input:
+    //     const uint8_t*          rawData        - raw report data
+    //     uint32_t                rawDataSize    - size of raw report data in bytes
+    //     const TTypedValue_1_0** out            - (OUT) calculated reports
+    //     const TTypedValue_1_0** outMaxValues   - (OUT - optional) calculated max values, null if not calculated
+    //     uint32_t*               outReportCount - (OUT) calculated report count
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CStreamCalculation::Push( const uint8_t* rawData, uint32_t rawDataSize, const TTypedValue_1_0** out, const TTypedValue_1_0** outMaxValues, uint32_t* outReportCount )
+    {
+        const uint32_t adapterId = m_metricSet.GetMetricsDevice().GetAdapter().GetAdapterId();
+
+        MD_CHECK_PTR_RET_A( adapterId, out, CC_ERROR_INVALID_PARAMETER );
+        MD_CHECK_PTR_RET_A( adapterId, outReportCount, CC_ERROR_INVALID_PARAMETER );
+
+        *out            = nullptr;
+        *outReportCount = 0;
+        if( outMaxValues )
+        {
+            *outMaxValues = nullptr;
+        }
+
+        if( rawDataSize == 0 )
+        {
+            return CC_OK;
+        }
+
+        MD_CHECK_PTR_RET_A( adapterId, rawData, CC_ERROR_INVALID_PARAMETER );
+
+        // The plan can't be changed by the metric set setters until the push ends
+        std::shared_lock<std::shared_mutex> planLock;
+
+        auto ret = m_metricSet.LockCalculationPlan( planLock );
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        ret = PreparePlan();
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        if( m_outReportValues == 0 )
+        {
+            // May happen when unsupported API is used in MetricSet filtering
+            return CC_OK;
+        }
+        if( rawDataSize % m_rawReportSize != 0 )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: input buffer has incorrect size" );
+            MD_LOG_A( adapterId, LOG_DEBUG, "rawDataSize: %u, rawReportSize: %u", rawDataSize, m_rawReportSize );
+            return CC_ERROR_INVALID_PARAMETER;
+        }
+
+        const uint32_t rawReportCount = rawDataSize / m_rawReportSize;
+
+        // Output buffers only grow, so steady pushes don't allocate
+        if( m_out.size() < static_cast<size_t>( rawReportCount ) * m_outReportValues )
+        {
+            m_out.resize( static_cast<size_t>( rawReportCount ) * m_outReportValues );
+        }
+        if( m_calculateMaxValues && m_outMaxValues.size() < static_cast<size_t>( rawReportCount ) * m_maxValuesReportValues )
+        {
+            m_outMaxValues.resize( static_cast<size_t>( rawReportCount ) * m_maxValuesReportValues );
+        }
+
+        TTypedValue_1_0* maxValues = m_calculateMaxValues ? m_outMaxValues.data() : nullptr;
+
+        ret = m_metricSet.InitializeCalculationContext( *m_session, m_out.data(), maxValues, nullptr, rawData, rawReportCount, false );
+        MD_CHECK_CC_RET_A( adapterId, ret );
+
+        TCalculationContext& calculationContext = m_session->Context;
+
+        ret = m_session->CalculationManager->CalculateReports( calculationContext, m_metricSet.GetCalculationThreadCount() );
+
+        *out            = m_out.data();
+        *outReportCount = calculationContext.CommonCalculationContext.OutReportCount;
+        if( outMaxValues )
+        {
+            *outMaxValues = maxValues;
+        }
+
+        // Raw data isn't kept, the last raw report is saved by the calculator
+        calculationContext.CommonCalculationContext.RawData = nullptr;
+
+        return ret;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CStreamCalculation
+    //
+    // Method:
+    //     Reset
+    //
+    // Description:
+    //     Discards the carried over raw report, the next Push starts a new stream.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CStreamCalculation::Reset( void )
+    {
+        m_session->Calculator->DiscardSavedReport();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CStreamCalculation
+    //
+    // Method:
+    //     PreparePlan
+    //
+    // Description:
+    //     Validates the metric set and report sizes again, only if the calculation
+    //     plan has changed since the last push. The plan is locked by the caller.
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CStreamCalculation::PreparePlan()
+    {
+        const uint32_t adapterId = m_metricSet.GetMetricsDevice().GetAdapter().GetAdapterId();
+
+        auto plan = m_metricSet.GetCalculationPlan();
+        MD_CHECK_PTR_RET_A( adapterId, plan, CC_ERROR_GENERAL );
+
+        if( m_planGeneration == plan->Generation )
+        {
+            return CC_OK;
+        }
+
+        const auto params = m_metricSet.GetParams();
+
+        if( !m_metricSet.IsFiltered() || ( params->ApiMask & API_TYPE_IOSTREAM ) == 0 )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: metric set isn't filtered for IoStream" );
+            return CC_ERROR_NOT_SUPPORTED;
+        }
+        if( params->RawReportSize == 0 )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: raw report size is 0" );
+            return CC_ERROR_GENERAL;
+        }
+
+        // Metrics count in calculated report, only projected metrics are written
+        const uint32_t outMetricsCount = static_cast<uint32_t>( plan->OutMetrics.size() );
+
+        m_rawReportSize         = params->RawReportSize;
+        m_outReportValues       = outMetricsCount + params->InformationCount;
+        m_maxValuesReportValues = outMetricsCount;
+        m_planGeneration        = plan->Generation;
+
+        MD_LOG_A( adapterId, LOG_DEBUG, "stream calculation prepared, metrics: %u, information: %u", outMetricsCount, params->InformationCount );
+        return CC_OK;
+    }
+} // namespace MetricsDiscoveryInternal
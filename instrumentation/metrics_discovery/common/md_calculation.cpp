@@ -23,6 +23,7 @@ SPDX-License-Identifier: MIT
 #include <algorithm>
 #include <cstring>
 #include <functional>
+#include <thread>
 
 namespace MetricsDiscoveryInternal
 {
@@ -39,6 +40,33 @@ namespace MetricsDiscoveryInternal
     template <>
     void CMetricsCalculationManager<MEASUREMENT_TYPE_SNAPSHOT_IO>::ProcessCalculation( TStreamCalculationContext* sc, bool async, uint32_t adapterId );
 
+    template <>
+    void CMetricsCalculationManager<MEASUREMENT_TYPE_SNAPSHOT_IO>::QueueCalculation( TStreamCalculationContext* sc, uint32_t adapterId );
+
+    template <>
+    void CMetricsCalculationManager<MEASUREMENT_TYPE_SNAPSHOT_IO>::FlushCalculation( TStreamCalculationContext* sc, uint32_t adapterId );
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricsCalculationManager
+    //
+    // Method:
+    //     ~CMetricsCalculationManager
+    //
+    // Description:
+    //     Destructor. Deletes calculators of the chunks kept for the next calls.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <TMeasurementType measurementType>
+    CMetricsCalculationManager<measurementType>::~CMetricsCalculationManager()
+    {
+        for( auto& calculator : m_chunkCalculators )
+        {
+            MD_SAFE_DELETE( calculator );
+        }
+    }
+
     //////////////////////////////////////////////////////////////////////////////
     //
     // Class:
@@ -194,7 +222,7 @@ namespace MetricsDiscoveryInternal
     //     Calculates a single report for a IoStream measurements using raw data and
     //     other state variables stored in the given calculation context.
     //     If context filtering is enabled calculation is performed only if starting raw report
-    //     is from appropriate context id.
+    //     is from the filtered context, see ContextSelection.
     //
     // Input:
     //     TCalculationContext& context - (IN/OUT) calculation context
@@ -222,6 +250,10 @@ namespace MetricsDiscoveryInternal
         {
             // Nothing to be calculated
             MD_LOG_A( adapterId, LOG_DEBUG, "Calculation complete" );
+
+            // Queued reports may use saved report, calculate them before it's overwritten
+            FlushCalculation( sc, adapterId );
+
             if( CC_OK != sc->Calculator->SaveReport( sc->LastRawDataPtr ) )
             {
                 MD_LOG_A( adapterId, LOG_DEBUG, "Unable to store last raw report for reuse." );
@@ -238,25 +270,28 @@ namespace MetricsDiscoveryInternal
             MD_ASSERT_A( adapterId, sc->PrevRawDataPtr != nullptr );
         }
 
-        bool calculateReport = true;
-
         // If not using saved report
         if( sc->PrevRawReportNumber != MD_SAVED_REPORT_NUMBER )
         {
             sc->LastRawDataPtr      = sc->PrevRawDataPtr + sc->RawReportSize;
             sc->LastRawReportNumber = sc->PrevRawReportNumber + 1;
+        }
 
-            const uint64_t reportId = *reinterpret_cast<const uint64_t*>( sc->LastRawDataPtr );
+        // A report starting a new calculation window is not calculated, also against the saved report
+        const uint64_t reportId        = *reinterpret_cast<const uint64_t*>( sc->LastRawDataPtr );
+        bool           calculateReport = reportId != MD_REPORT_ID_SKIP_CALCULATION;
 
-            if( reportId == MD_REPORT_ID_SKIP_CALCULATION )
-            {
-                calculateReport = false;
-            }
+        // With context filtering only deltas starting in the filtered context are calculated
+        if( calculateReport && sc->DoContextFiltering )
+        {
+            calculateReport = ( sc->PrevRawReportNumber == MD_SAVED_REPORT_NUMBER )
+                ? sc->SavedReportSelected
+                : sc->ContextSelection[sc->PrevRawReportNumber] != 0;
         }
 
         if( calculateReport )
         {
-            ProcessCalculation( sc, false, adapterId );
+            QueueCalculation( sc, adapterId );
         }
 
         // Prev is now Last
@@ -265,6 +300,8 @@ namespace MetricsDiscoveryInternal
 
         if( isSingleReport )
         {
+            FlushCalculation( sc, adapterId );
+
             // If there is a single report in calculation, do not discard saved report and save the current report.
             if( CC_OK != sc->Calculator->SaveReport( sc->LastRawDataPtr ) )
             {
@@ -316,23 +353,28 @@ namespace MetricsDiscoveryInternal
             return false;
         }
 
-        const uint32_t metricsCount = qc->MetricSet->GetParams()->MetricsCount;
+        auto plan = qc->MetricSet->GetCalculationPlan();
+        MD_CHECK_PTR_RET_A( adapterId, plan, false );
+
+        const uint32_t   metricsCount        = plan->MetricsCount;
+        TTypedValue_1_0* calculatedValues    = qc->Calculator->GetCalculatedValues( *plan, *qc, 1 );
+        TTypedValue_1_0* calculatedMaxValues = qc->Calculator->GetCalculatedMaxValues( *plan, *qc, 1 );
 
         // METRICS
         qc->Calculator->ReadMetricsFromQueryReport( qc->RawData, qc->DeltaValues, *qc->MetricSet );
         // NORMALIZATION
-        qc->Calculator->NormalizeMetrics( qc->DeltaValues, qc->Out, *qc->MetricSet );
+        qc->Calculator->NormalizeMetrics( qc->DeltaValues, calculatedValues, *qc->MetricSet );
         // INFORMATION
-        qc->Calculator->ReadInformation( qc->RawData, qc->Out + metricsCount, *qc->MetricSet, -1 );
+        qc->Calculator->ReadInformation( qc->RawData, calculatedValues + metricsCount, *qc->MetricSet, -1 );
         // MAX VALUES
-        if( qc->OutMaxValues )
+        if( calculatedMaxValues )
         {
-            qc->Calculator->CalculateMaxValues( qc->DeltaValues, qc->Out, qc->OutMaxValues, *qc->MetricSet );
-            qc->OutMaxValues += metricsCount;
+            qc->Calculator->CalculateMaxValues( qc->DeltaValues, calculatedValues, calculatedMaxValues, *qc->MetricSet );
         }
+        // OUTPUT
+        qc->Calculator->WriteCalculatedReports( *plan, *qc, 1 );
 
         qc->RawData += qc->RawReportSize;
-        qc->Out += qc->MetricsAndInformationCount;
 
         qc->OutReportCount++;
 
@@ -367,7 +409,13 @@ namespace MetricsDiscoveryInternal
         TStreamCalculationContext* sc = &context.StreamCalculationContext;
         MD_CHECK_PTR_RET( sc->Calculator, false );
 
-        const uint64_t reportReason = sc->Calculator->ReadInformationByIndex( sc->LastRawDataPtr, *sc->MetricSet, sc->ReportReasonIdx );
+        // Report reasons of all the raw reports are read once, before the first one
+        if( sc->LastRawReportNumber == 0 )
+        {
+            sc->ReportReasons = sc->Calculator->ReadReportReasons( sc->RawData, sc->RawReportCount, sc->RawReportSize, *sc->MetricSet, sc->ReportReasonIdx );
+        }
+
+        const uint64_t reportReason = sc->ReportReasons[( sc->LastRawDataPtr - sc->RawData ) / sc->RawReportSize];
 
         const uint32_t adapterId = sc->Calculator->GetMetricsDevice().GetAdapter().GetAdapterId();
 
@@ -443,6 +491,400 @@ namespace MetricsDiscoveryInternal
         return false;
     }
 
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricsCalculationManager<MEASUREMENT_TYPE_SNAPSHOT_IO>
+    //
+    // Method:
+    //     CalculateReports
+    //
+    // Description:
+    //     Calculates all IoStream reports of the given calculation context. With more
+    //     than one thread raw reports are split into chunks of consecutive reports.
+    //     Each chunk starts with the last raw report of the previous one, so the same
+    //     report pairs are calculated as on a single thread. Chunks start at reports
+    //     that are calculated and whose calculated report index is a multiple of 8,
+    //     so chunks don't share bytes of bool output columns.
+    //     With context filtering ContextId of all the raw reports is scanned first,
+    //     a new stream is filtered for the context of its first report.
+    //
+    // Input:
+    //     TCalculationContext& context     - (IN/OUT) calculation context
+    //     uint32_t             threadCount - thread count, 0 means hardware concurrency
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <>
+    TCompletionCode CMetricsCalculationManager<MEASUREMENT_TYPE_SNAPSHOT_IO>::CalculateReports( TCalculationContext& context, uint32_t threadCount )
+    {
+        TStreamCalculationContext* sc = &context.StreamCalculationContext;
+        MD_CHECK_PTR_RET( sc->Calculator, CC_ERROR_INVALID_PARAMETER );
+
+        if( sc->DoContextFiltering && sc->RawReportCount > 0 )
+        {
+            CMetricsCalculator& calculator = *sc->Calculator;
+
+            if( !calculator.SavedReportPresent() )
+            {
+                calculator.SetFilteredContextId( calculator.ReadInformationByIndex( sc->RawData, *sc->MetricSet, sc->ContextIdIdx ) );
+            }
+
+            sc->FilteredContextId   = calculator.GetFilteredContextId();
+            sc->SavedReportSelected = calculator.SavedReportPresent() && calculator.ReadInformationByIndex( calculator.GetSavedReport(), *sc->MetricSet, sc->ContextIdIdx ) == sc->FilteredContextId;
+            sc->ContextSelection    = calculator.SelectContextReports( sc->RawData, sc->RawReportCount, sc->RawReportSize, *sc->MetricSet, sc->ContextIdIdx, sc->FilteredContextId );
+        }
+
+        const uint32_t chunkCount = GetChunkCount( *sc, threadCount );
+
+        if( chunkCount > 1 )
+        {
+            const uint32_t rawReportCount     = sc->RawReportCount;
+            const uint32_t rawReportSize      = sc->RawReportSize;
+            const bool     savedReportPresent = sc->Calculator->SavedReportPresent();
+            uint32_t       outReportCount     = 0;
+            uint32_t       lastCalculated     = 0;
+
+            // Reports are calculated unless skipped, the first one only with the saved one and,
+            // with context filtering, only if the previous report is from the filtered context
+            auto isCalculated = [&]( uint32_t index )
+            {
+                if( *reinterpret_cast<const uint64_t*>( sc->RawData + index * rawReportSize ) == MD_REPORT_ID_SKIP_CALCULATION )
+                {
+                    return false;
+                }
+
+                if( index == 0 )
+                {
+                    return savedReportPresent && ( !sc->DoContextFiltering || sc->SavedReportSelected );
+                }
+
+                return !sc->DoContextFiltering || sc->ContextSelection[index - 1] != 0;
+            };
+
+            // Chunks are kept for the next calls, so they don't allocate
+            std::vector<TCalculationChunk>& chunks = m_chunks;
+            chunks.clear();
+            chunks.push_back( { 0, 0, 0, sc->Calculator->GetPreviousContextId() } );
+
+            for( uint32_t i = 0; i < rawReportCount; ++i )
+            {
+                const bool isReport   = isCalculated( i );
+                const auto chunkBegin = static_cast<uint64_t>( rawReportCount ) * chunks.size() / chunkCount;
+
+                if( chunks.size() < chunkCount && i >= chunkBegin && isReport && ( outReportCount % MD_BYTE ) == 0 )
+                {
+                    // PreviousContextId of the chunk is context id of the last report calculated before it
+                    const uint64_t contextIdPrev = ( outReportCount > 0 && sc->ContextIdIdx != -1 )
+                        ? sc->Calculator->ReadInformationByIndex( sc->RawData + lastCalculated * rawReportSize, *sc->MetricSet, sc->ContextIdIdx )
+                        : chunks.front().PreviousContextId;
+
+                    chunks.back().RawReportCount = i - chunks.back().FirstRawReport;
+                    chunks.push_back( { i - 1, 0, outReportCount, contextIdPrev } );
+                }
+
+                if( isReport )
+                {
+                    lastCalculated = i;
+                    ++outReportCount;
+                }
+            }
+
+            chunks.back().RawReportCount = rawReportCount - chunks.back().FirstRawReport;
+
+            if( chunks.size() > 1 && CalculateChunks( context, chunks, threadCount ) == CC_OK )
+            {
+                return CC_OK;
+            }
+        }
+
+        while( CalculateNextReport( context ) )
+        { // void
+        }
+
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricsCalculationManager<MEASUREMENT_TYPE_DELTA_QUERY>
+    //
+    // Method:
+    //     CalculateReports
+    //
+    // Description:
+    //     Calculates all Query reports of the given calculation context. Query reports
+    //     are independent, with more than one thread they are split into chunks of
+    //     equal size, a multiple of 8 reports.
+    //
+    // Input:
+    //     TCalculationContext& context     - (IN/OUT) calculation context
+    //     uint32_t             threadCount - thread count, 0 means hardware concurrency
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <>
+    TCompletionCode CMetricsCalculationManager<MEASUREMENT_TYPE_DELTA_QUERY>::CalculateReports( TCalculationContext& context, uint32_t threadCount )
+    {
+        TQueryCalculationContext* qc = &context.QueryCalculationContext;
+        MD_CHECK_PTR_RET( qc->Calculator, CC_ERROR_INVALID_PARAMETER );
+
+        const uint32_t chunkCount = GetChunkCount( *qc, threadCount );
+
+        if( chunkCount > 1 )
+        {
+            const uint32_t rawReportCount = qc->RawReportCount;
+            const uint32_t chunkSize      = ( ( rawReportCount + chunkCount - 1 ) / chunkCount + MD_BYTE - 1 ) / MD_BYTE * MD_BYTE;
+
+            std::vector<TCalculationChunk>& chunks = m_chunks;
+            chunks.clear();
+
+            for( uint32_t first = 0; first < rawReportCount; first += chunkSize )
+            {
+                chunks.push_back( { first, ( std::min )( chunkSize, rawReportCount - first ), first, 0 } );
+            }
+
+            if( chunks.size() > 1 && CalculateChunks( context, chunks, threadCount ) == CC_OK )
+            {
+                return CC_OK;
+            }
+        }
+
+        while( CalculateNextReport( context ) )
+        { // void
+        }
+
+        return CC_OK;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricsCalculationManager
+    //
+    // Method:
+    //     GetChunkCount
+    //
+    // Description:
+    //     Returns count of chunks the raw reports of the given calculation context
+    //     should be split into. Reports are calculated in a single chunk if there
+    //     are too few of them or metrics use previous calculated report. The plan
+    //     has to be prepared by the caller, see CMetricSet::PrepareCalculationPlan.
+    //
+    // Input:
+    //     TCommonCalculationContext& context     - calculation context
+    //     uint32_t                   threadCount - thread count, 0 means hardware concurrency
+    //
+    // Output:
+    //     uint32_t - chunk count, 1 if reports should be calculated on the calling thread
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <TMeasurementType measurementType>
+    uint32_t CMetricsCalculationManager<measurementType>::GetChunkCount( TCommonCalculationContext& context, uint32_t threadCount )
+    {
+        const uint32_t adapterId  = context.Calculator->GetMetricsDevice().GetAdapter().GetAdapterId();
+        const uint32_t chunkCount = ( std::min )( GetThreadCount( threadCount ), context.RawReportCount / MD_CALCULATION_MIN_CHUNK_REPORT_COUNT );
+
+        if( chunkCount < 2 )
+        {
+            return 1;
+        }
+
+        auto plan = context.MetricSet->GetCalculationPlan();
+        MD_CHECK_PTR_RET_A( adapterId, plan, 1 );
+
+        if( plan->HasPrevMetrics )
+        {
+            MD_LOG_A( adapterId, LOG_DEBUG, "metrics use previous calculated report, calculation on a single thread" );
+            return 1;
+        }
+
+        return chunkCount;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricsCalculationManager
+    //
+    // Method:
+    //     GetThreadCount
+    //
+    // Description:
+    //     Returns count of threads to calculate on for the given thread count setting.
+    //
+    // Input:
+    //     uint32_t threadCount - thread count, 0 means hardware concurrency
+    //
+    // Output:
+    //     uint32_t - thread count, at most MD_CALCULATION_MAX_THREAD_COUNT
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <TMeasurementType measurementType>
+    uint32_t CMetricsCalculationManager<measurementType>::GetThreadCount( uint32_t threadCount )
+    {
+        if( threadCount == 0 )
+        {
+            threadCount = std::thread::hardware_concurrency();
+        }
+
+        return ( std::min )( threadCount, static_cast<uint32_t>( MD_CALCULATION_MAX_THREAD_COUNT ) );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricsCalculationManager
+    //
+    // Method:
+    //     CalculateChunks
+    //
+    // Description:
+    //     Calculates the given chunks of raw reports concurrently on the worker pool of
+    //     the manager. Every chunk has its own copy of the calculation context and its
+    //     own calculator, calculated reports are written to the output at the chunk
+    //     offset. The last chunk is calculated with the context calculator, so the
+    //     calculator ends in the same state (saved report, previous context id) as
+    //     after calculation on a single thread. Workers are kept for the next calls
+    //     while the thread count doesn't change. If fewer workers can be started,
+    //     each thread calculates more chunks. Calculators and contexts of the chunks
+    //     are kept for the next calls too, only missing calculators are created.
+    //
+    // Input:
+    //     TCalculationContext&                  context     - (IN/OUT) calculation context
+    //     const std::vector<TCalculationChunk>& chunks      - chunks of raw reports, in order
+    //     uint32_t                              threadCount - thread count, 0 means hardware concurrency
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success, otherwise nothing was calculated
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <TMeasurementType measurementType>
+    TCompletionCode CMetricsCalculationManager<measurementType>::CalculateChunks( TCalculationContext& context, const std::vector<TCalculationChunk>& chunks, uint32_t threadCount )
+    {
+        TCommonCalculationContext& common     = context.CommonCalculationContext;
+        const uint32_t             adapterId  = common.Calculator->GetMetricsDevice().GetAdapter().GetAdapterId();
+        const uint32_t             chunkCount = static_cast<uint32_t>( chunks.size() );
+
+        auto plan = common.MetricSet->GetCalculationPlan();
+        MD_CHECK_PTR_RET_A( adapterId, plan, CC_ERROR_GENERAL );
+
+        const uint32_t outMetricsCount = static_cast<uint32_t>( plan->OutMetrics.size() );
+        const uint32_t outReportSize   = outMetricsCount + plan->InformationCount;
+
+        while( m_chunkCalculators.size() < chunkCount - 1 )
+        {
+            CMetricsCalculator* calculator = new( std::nothrow ) CMetricsCalculator( common.Calculator->GetSymbols() );
+
+            if( calculator == nullptr )
+            {
+                MD_LOG_A( adapterId, LOG_ERROR, "error: unable to allocate calculator of chunk %zu", m_chunkCalculators.size() );
+                return CC_ERROR_NO_MEMORY;
+            }
+
+            m_chunkCalculators.push_back( calculator );
+        }
+
+        std::vector<TCalculationContext>& chunkContexts = m_chunkContexts;
+        chunkContexts.assign( chunkCount, context );
+
+        for( uint32_t i = 0; i < chunkCount; ++i )
+        {
+            const TCalculationChunk&   chunk            = chunks[i];
+            TCommonCalculationContext& chunkContext     = chunkContexts[i].CommonCalculationContext;
+            const bool                 hasOwnCalculator = i < chunkCount - 1;
+            CMetricsCalculator*        calculator       = hasOwnCalculator ? m_chunkCalculators[i] : common.Calculator;
+
+            chunkContext.Calculator      = calculator;
+            chunkContext.DeltaValues     = hasOwnCalculator ? calculator->GetDeltaValues( plan->MetricsCount ) : common.DeltaValues;
+            chunkContext.RawData         = common.RawData + static_cast<size_t>( chunk.FirstRawReport ) * common.RawReportSize;
+            chunkContext.RawReportCount  = chunk.RawReportCount;
+            chunkContext.OutReportCount  = 0;
+            chunkContext.OutReportOffset = common.OutReportOffset + chunk.OutReportOffset;
+
+            if( chunkContext.OutDescriptor == nullptr )
+            {
+                chunkContext.Out += static_cast<size_t>( chunk.OutReportOffset ) * outReportSize;
+
+                if( chunkContext.OutMaxValues )
+                {
+                    chunkContext.OutMaxValues += static_cast<size_t>( chunk.OutReportOffset ) * outMetricsCount;
+                }
+            }
+
+            if constexpr( measurementType == MEASUREMENT_TYPE_SNAPSHOT_IO )
+            {
+                TStreamCalculationContext& sc = chunkContexts[i].StreamCalculationContext;
+
+                sc.PrevRawDataPtr      = sc.RawData;
+                sc.PrevRawReportNumber = 0;
+                sc.LastRawDataPtr      = sc.RawData;
+                sc.LastRawReportNumber = 0;
+                sc.BatchReportCount    = 0;
+
+                if( sc.DoContextFiltering )
+                {
+                    sc.ContextSelection += chunk.FirstRawReport;
+                }
+
+                if( hasOwnCalculator )
+                {
+                    calculator->Reset( common.RawReportSize, common.MetricsAndInformationCount );
+                }
+
+                // Only the first chunk continues from the saved report
+                if( i == 0 && common.Calculator->SavedReportPresent() )
+                {
+                    if( calculator->SaveReport( common.Calculator->GetSavedReport() ) != CC_OK )
+                    {
+                        MD_LOG_A( adapterId, LOG_ERROR, "error: unable to copy saved report to the first chunk" );
+                        return CC_ERROR_GENERAL;
+                    }
+                }
+                else
+                {
+                    // Calculators of the chunks keep the last report of the previous call
+                    calculator->DiscardSavedReport();
+                }
+
+                calculator->SetPreviousContextId( chunk.PreviousContextId );
+            }
+            else if( hasOwnCalculator )
+            {
+                calculator->Reset();
+            }
+        }
+
+        auto calculateChunk = [&]( uint32_t index )
+        {
+            while( CalculateNextReport( chunkContexts[index] ) )
+            { // void
+            }
+        };
+
+        m_workerPool.Start( GetThreadCount( threadCount ) );
+        m_workerPool.Run( chunkCount, calculateChunk );
+
+        MD_LOG_A( adapterId, LOG_DEBUG, "calculated %u chunks on %u threads", chunkCount, ( std::min )( chunkCount, m_workerPool.GetThreadCount() ) );
+
+        // Continue with the last chunk context, as if all the reports were calculated in it
+        const TCommonCalculationContext initialContext = common;
+        const uint32_t                  outReportCount = chunks.back().OutReportOffset + chunkContexts.back().CommonCalculationContext.OutReportCount;
+
+        context                = chunkContexts.back();
+        common.RawData         = initialContext.RawData;
+        common.RawReportCount  = initialContext.RawReportCount;
+        common.OutReportOffset = initialContext.OutReportOffset;
+        common.OutReportCount  = outReportCount;
+
+        return CC_OK;
+    }
+
     //////////////////////////////////////////////////////////////////////////////
     //
     // Class:
@@ -522,7 +964,6 @@ namespace MetricsDiscoveryInternal
         sa.LastRawDataPtrs         = new( std::nothrow ) const uint8_t*[sa.DataSetCount]();
         sa.PrevSavedReportPtrs     = new( std::nothrow ) uint8_t*[sa.DataSetCount]();
         sa.LastSavedReportPtrs     = new( std::nothrow ) uint8_t*[sa.DataSetCount]();
-        sa.CachedReportPtrsBase    = new( std::nothrow ) uint8_t*[sa.DataSetCount]();
         sa.CachedReportPtrs        = new( std::nothrow ) uint8_t*[sa.DataSetCount]();
         sa.InterpolatedReportPtrs  = new( std::nothrow ) uint8_t*[sa.DataSetCount]();
         sa.OutAggregatedRawDataPtr = new( std::nothrow ) uint8_t[sa.RawReportSize * 2]();
@@ -531,7 +972,6 @@ namespace MetricsDiscoveryInternal
         sa.CurrentTs               = new( std::nothrow ) uint64_t[sa.DataSetCount]();
         sa.NeedReport              = new( std::nothrow ) bool[sa.DataSetCount]();
         sa.IsCachedReport          = new( std::nothrow ) bool[sa.DataSetCount]();
-        sa.CachedReportPtrsSize    = new( std::nothrow ) uint32_t[sa.DataSetCount]();
         sa.IsPrevRawDataPresent    = new( std::nothrow ) bool[sa.DataSetCount]();
         sa.IsLastRawDataPresent    = new( std::nothrow ) bool[sa.DataSetCount]();
         sa.SkipReportAfterRc6      = new( std::nothrow ) bool[sa.DataSetCount]();
@@ -543,14 +983,12 @@ namespace MetricsDiscoveryInternal
             sa.PrevSavedReportPtrs &&
             sa.LastSavedReportPtrs &&
             sa.RawData &&
-            sa.CachedReportPtrsBase &&
             sa.CachedReportPtrs &&
             sa.InterpolatedReportPtrs &&
             sa.OutAggregatedRawDataPtr &&
             sa.CurrentTs &&
             sa.NeedReport &&
             sa.IsCachedReport &&
-            sa.CachedReportPtrsSize &&
             sa.IsPrevRawDataPresent &&
             sa.IsLastRawDataPresent &&
             sa.SkipReportAfterRc6 )
@@ -565,7 +1003,6 @@ namespace MetricsDiscoveryInternal
                 sa.IsPrevRawDataPresent[i]   = false;
                 sa.IsLastRawDataPresent[i]   = false;
                 sa.SkipReportAfterRc6[i]     = false;
-                sa.CachedReportPtrsSize[i]   = 0;
 
                 if( !sa.PrevSavedReportPtrs[i] || !sa.LastSavedReportPtrs[i] || !sa.InterpolatedReportPtrs[i] )
                 {
@@ -1119,19 +1556,23 @@ namespace MetricsDiscoveryInternal
     template <>
     void CMetricsCalculationManager<MEASUREMENT_TYPE_SNAPSHOT_IO>::ProcessCalculation( TStreamCalculationContext* sc, bool async, uint32_t adapterId )
     {
-        const uint32_t metricsCount = sc->MetricSet->GetParams()->MetricsCount;
+        auto plan = sc->MetricSet->GetCalculationPlan();
+        MD_CHECK_PTR_RET_A( adapterId, plan, MD_EMPTY );
+
+        const uint32_t   metricsCount        = plan->MetricsCount;
+        TTypedValue_1_0* calculatedValues    = sc->Calculator->GetCalculatedValues( *plan, *sc, 1 );
+        TTypedValue_1_0* calculatedMaxValues = sc->Calculator->GetCalculatedMaxValues( *plan, *sc, 1 );
 
         // METRICS
         sc->Calculator->ReadMetricsFromIoReport( sc->LastRawDataPtr, sc->PrevRawDataPtr, sc->DeltaValues, *sc->MetricSet );
         // NORMALIZATION
-        sc->Calculator->NormalizeMetrics( sc->DeltaValues, sc->Out, *sc->MetricSet );
+        sc->Calculator->NormalizeMetrics( sc->DeltaValues, calculatedValues, *sc->MetricSet );
         // INFORMATION
-        sc->Calculator->ReadInformation( sc->LastRawDataPtr, sc->Out + metricsCount, *sc->MetricSet, sc->ContextIdIdx );
+        sc->Calculator->ReadInformation( sc->LastRawDataPtr, calculatedValues + metricsCount, *sc->MetricSet, sc->ContextIdIdx );
         // MAX VALUES
-        if( sc->OutMaxValues )
+        if( calculatedMaxValues )
         {
-            sc->Calculator->CalculateMaxValues( sc->DeltaValues, sc->Out, sc->OutMaxValues, *sc->MetricSet );
-            sc->OutMaxValues += metricsCount;
+            sc->Calculator->CalculateMaxValues( sc->DeltaValues, calculatedValues, calculatedMaxValues, *sc->MetricSet );
         }
 
         if( async )
@@ -1143,12 +1584,103 @@ namespace MetricsDiscoveryInternal
         }
 
         // Save calculated report for reuse
-        if( CC_OK != sc->Calculator->SaveCalculatedReport( sc->Out ) )
+        if( CC_OK != sc->Calculator->SaveCalculatedReport( calculatedValues ) )
         {
             MD_LOG_A( adapterId, LOG_DEBUG, "Unable to store previous calculated report for reuse." );
         }
 
-        sc->Out += sc->MetricsAndInformationCount;
+        // OUTPUT
+        sc->Calculator->WriteCalculatedReports( *plan, *sc, 1 );
+
         sc->OutReportCount++;
     }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricsCalculationManager<MEASUREMENT_TYPE_SNAPSHOT_IO>
+    //
+    // Method:
+    //     QueueCalculation
+    //
+    // Description:
+    //     Queues the current prev and last report pair for batch calculation.
+    //     Queued reports are calculated when the batch is full or the calculation
+    //     is complete.
+    //
+    // Input:
+    //     uint32_t adapterId - The adapter ID used for logging and assertion purposes.
+    //
+    // [In,Out]:
+    //     TStreamCalculationContext* sc - stream calculation context
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <>
+    void CMetricsCalculationManager<MEASUREMENT_TYPE_SNAPSHOT_IO>::QueueCalculation( TStreamCalculationContext* sc, uint32_t adapterId )
+    {
+        sc->BatchPrevRawDataPtrs[sc->BatchReportCount] = sc->PrevRawDataPtr;
+        sc->BatchLastRawDataPtrs[sc->BatchReportCount] = sc->LastRawDataPtr;
+        sc->BatchReportCount++;
+
+        if( sc->BatchReportCount == MD_CALCULATION_BATCH_SIZE )
+        {
+            FlushCalculation( sc, adapterId );
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricsCalculationManager<MEASUREMENT_TYPE_SNAPSHOT_IO>
+    //
+    // Method:
+    //     FlushCalculation
+    //
+    // Description:
+    //     Calculates all queued report pairs at once. Every equation is calculated
+    //     for the whole batch before the next one, results are the same as from
+    //     calculating the reports one by one.
+    //
+    // Input:
+    //     uint32_t adapterId - The adapter ID used for logging and assertion purposes.
+    //
+    // [In,Out]:
+    //     TStreamCalculationContext* sc - stream calculation context
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <>
+    void CMetricsCalculationManager<MEASUREMENT_TYPE_SNAPSHOT_IO>::FlushCalculation( TStreamCalculationContext* sc, uint32_t adapterId )
+    {
+        const uint32_t reportCount = sc->BatchReportCount;
+
+        if( reportCount == 0 )
+        {
+            return;
+        }
+
+        auto plan = sc->MetricSet->GetCalculationPlan();
+        if( plan == nullptr )
+        {
+            MD_LOG_A( adapterId, LOG_ERROR, "error: unable to get calculation plan, %u queued reports dropped", reportCount );
+            sc->BatchReportCount = 0;
+            return;
+        }
+
+        TTypedValue_1_0* calculatedValues    = sc->Calculator->GetCalculatedValues( *plan, *sc, reportCount );
+        TTypedValue_1_0* calculatedMaxValues = sc->Calculator->GetCalculatedMaxValues( *plan, *sc, reportCount );
+
+        if( CC_OK != sc->Calculator->CalculateIoReports( sc->BatchLastRawDataPtrs, sc->BatchPrevRawDataPtrs, reportCount, calculatedValues, calculatedMaxValues, *sc->MetricSet, sc->ContextIdIdx ) )
+        {
+            MD_LOG_A( adapterId, LOG_DEBUG, "Unable to calculate %u queued reports.", reportCount );
+        }
+
+        sc->Calculator->WriteCalculatedReports( *plan, *sc, reportCount );
+
+        sc->OutReportCount += reportCount;
+        sc->BatchReportCount = 0;
+    }
+
+    // Explicit instantiations, the destructor is defined in this file only //
+    template class CMetricsCalculationManager<MEASUREMENT_TYPE_SNAPSHOT_IO>;
+    template class CMetricsCalculationManager<MEASUREMENT_TYPE_DELTA_QUERY>;
 } // namespace MetricsDiscoveryInternal
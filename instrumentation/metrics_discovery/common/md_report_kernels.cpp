@@ -0,0 +1,2108 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2026 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+//     File Name:  md_report_kernels.cpp
+
+//     Abstract:   C++ metrics discovery raw report SIMD kernels implementation.
+//                 SIMD kernels are compiled for their instruction sets with function
+//                 target attributes, so the library itself doesn't require them.
+
+#include "md_report_kernels.h"
+#include "md_debug.h"
+
+#include <cstring>
+#include <vector>
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+    #define MD_REPORT_KERNELS_X86
+    #include <immintrin.h>
+    #if defined( _MSC_VER )
+        #include <intrin.h>
+    #endif
+#endif
+
+#if defined( MD_REPORT_KERNELS_X86 ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+    #define MD_TARGET_SSE42 __attribute__( ( target( "sse4.2" ) ) )
+    #define MD_TARGET_AVX2  __attribute__( ( target( "avx2" ) ) )
+#else
+    #define MD_TARGET_SSE42
+    #define MD_TARGET_AVX2
+#endif
+
+namespace MetricsDiscoveryInternal
+{
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     CalculateRegionDeltas
+    //
+    // Description:
+    //     Calculates DELTA_N_BITS deltas of all the counters of the given report region.
+    //
+    // Input:
+    //     const TReportCounterRegion& region        - counter region
+    //     const uint8_t*              rawReportLast - (IN) last (next) single raw report
+    //     const uint8_t*              rawReportPrev - (IN) previous single raw report
+    //     uint32_t                    bitsCount     - counters bits count
+    //     uint64_t*                   outDeltas     - (OUT) deltas, region.Count values
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CReportKernels::CalculateRegionDeltas( const TReportCounterRegion& region, const uint8_t* rawReportLast, const uint8_t* rawReportPrev, uint32_t bitsCount, uint64_t* outDeltas )
+    {
+        CalculateDeltas( GetKernelLevel(), rawReportLast + region.Offset, rawReportPrev + region.Offset, region.Count, region.ElemSize, bitsCount, outDeltas );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     CalculateColumnDeltas
+    //
+    // Description:
+    //     Calculates DELTA_N_BITS deltas of a transposed report column, i.e. deltas
+    //     of a single counter for a block of reports.
+    //
+    // Input:
+    //     const uint64_t* columnLast - (IN) last (next) reports column
+    //     const uint64_t* columnPrev - (IN) previous reports column
+    //     uint32_t        count      - reports count
+    //     uint32_t        bitsCount  - counter bits count
+    //     uint64_t*       outDeltas  - (OUT) deltas, count values
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CReportKernels::CalculateColumnDeltas( const uint64_t* columnLast, const uint64_t* columnPrev, uint32_t count, uint32_t bitsCount, uint64_t* outDeltas )
+    {
+        CalculateDeltas( GetKernelLevel(), reinterpret_cast<const uint8_t*>( columnLast ), reinterpret_cast<const uint8_t*>( columnPrev ), count, sizeof( uint64_t ), bitsCount, outDeltas );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     TransposeReports
+    //
+    // Description:
+    //     Transposes a block of reports to columns, see TReportColumn. Counters are
+    //     zero extended to 64 bits. Column k of report j is written to
+    //     outColumns[k * columnStride + j]. Reports have to have a known layout.
+    //
+    // Input:
+    //     const TReportLayout&  layout       - report layout
+    //     const uint8_t* const* rawReports   - (IN) raw reports
+    //     uint32_t              reportCount  - reports count, up to columnStride
+    //     uint32_t              columnStride - column size in values
+    //     uint64_t*             outColumns   - (OUT) columns, REPORT_COLUMN_COUNTERS + layout.CountersCount
+    //                                          columns of columnStride values
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CReportKernels::TransposeReports( const TReportLayout& layout, const uint8_t* const* rawReports, uint32_t reportCount, uint32_t columnStride, uint64_t* outColumns )
+    {
+        MD_ASSERT( layout.HeaderSize != 0 );
+        MD_ASSERT( reportCount <= columnStride );
+
+        uint64_t* timestamps = outColumns + REPORT_COLUMN_TIMESTAMP * columnStride;
+        uint64_t* gpuTicks   = outColumns + REPORT_COLUMN_GPU_TICKS * columnStride;
+
+        for( uint32_t j = 0; j < reportCount; ++j )
+        {
+            timestamps[j] = *reinterpret_cast<const uint64_t*>( rawReports[j] + layout.TimestampOffset );
+            gpuTicks[j]   = *reinterpret_cast<const uint64_t*>( rawReports[j] + layout.GpuTicksOffset );
+        }
+
+        const TReportKernelLevel kernelLevel = GetKernelLevel();
+        uint64_t*                columns     = outColumns + REPORT_COLUMN_COUNTERS * columnStride;
+
+        for( uint32_t r = 0; r < REPORT_REGION_LAST; ++r )
+        {
+            const TReportCounterRegion& region  = layout.Regions[r];
+            const bool                  is64Bit = ( region.ElemSize == sizeof( uint64_t ) );
+
+            if( region.Count == 0 )
+            {
+                continue;
+            }
+
+            MD_ASSERT( region.ElemSize == sizeof( uint64_t ) || region.ElemSize == sizeof( uint32_t ) );
+
+            switch( kernelLevel )
+            {
+                case REPORT_KERNEL_LEVEL_AVX2:
+                    if( is64Bit )
+                    {
+                        TransposeRegion64Avx2( rawReports, reportCount, region.Offset, region.Count, columnStride, columns );
+                    }
+                    else
+                    {
+                        TransposeRegion32Avx2( rawReports, reportCount, region.Offset, region.Count, columnStride, columns );
+                    }
+                    break;
+
+                case REPORT_KERNEL_LEVEL_SSE42:
+                    if( is64Bit )
+                    {
+                        TransposeRegion64Sse42( rawReports, reportCount, region.Offset, region.Count, columnStride, columns );
+                    }
+                    else
+                    {
+                        TransposeRegion32Sse42( rawReports, reportCount, region.Offset, region.Count, columnStride, columns );
+                    }
+                    break;
+
+                default:
+                    if( is64Bit )
+                    {
+                        TransposeRegionScalar<uint64_t>( rawReports, reportCount, region.Offset, region.Count, columnStride, columns );
+                    }
+                    else
+                    {
+                        TransposeRegionScalar<uint32_t>( rawReports, reportCount, region.Offset, region.Count, columnStride, columns );
+                    }
+                    break;
+            }
+
+            columns += static_cast<size_t>( region.Count ) * columnStride;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     SelectReports
+    //
+    // Description:
+    //     Selects reports with a masked header field equal to the given value, e.g.
+    //     reports of a single context. Fields of consecutive reports are compared
+    //     a vector at a time, outSelection[j] is set to 1 if report j is selected,
+    //     to 0 otherwise.
+    //
+    // Input:
+    //     const uint8_t* rawData      - (IN) consecutive raw reports
+    //     uint32_t       reportCount  - reports count
+    //     uint32_t       reportSize   - single report size in bytes
+    //     uint32_t       fieldOffset  - field offset in a report
+    //     uint32_t       fieldSize    - field size in bytes, 4 or 8
+    //     uint64_t       fieldMask    - mask applied to the field before comparison
+    //     uint64_t       value        - value of the masked field of selected reports
+    //     uint8_t*       outSelection - (OUT) selection, reportCount values
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CReportKernels::SelectReports( const uint8_t* rawData, uint32_t reportCount, uint32_t reportSize, uint32_t fieldOffset, uint32_t fieldSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection )
+    {
+        const bool is64Bit = ( fieldSize == sizeof( uint64_t ) );
+
+        MD_ASSERT( fieldSize == sizeof( uint64_t ) || fieldSize == sizeof( uint32_t ) );
+
+        if( !is64Bit )
+        {
+            fieldMask &= 0xFFFFFFFFULL;
+        }
+
+        if( ( value & ~fieldMask ) != 0 )
+        {
+            // No masked field is equal to the value
+            for( uint32_t j = 0; j < reportCount; ++j )
+            {
+                outSelection[j] = 0;
+            }
+            return;
+        }
+
+        const uint8_t* fields = rawData + fieldOffset;
+
+        switch( GetKernelLevel() )
+        {
+            case REPORT_KERNEL_LEVEL_AVX2:
+                if( is64Bit )
+                {
+                    SelectReports64Avx2( fields, reportCount, reportSize, fieldMask, value, outSelection );
+                }
+                else
+                {
+                    SelectReports32Avx2( fields, reportCount, reportSize, fieldMask, value, outSelection );
+                }
+                break;
+
+            case REPORT_KERNEL_LEVEL_SSE42:
+                if( is64Bit )
+                {
+                    SelectReports64Sse42( fields, reportCount, reportSize, fieldMask, value, outSelection );
+                }
+                else
+                {
+                    SelectReports32Sse42( fields, reportCount, reportSize, fieldMask, value, outSelection );
+                }
+                break;
+
+            default:
+                if( is64Bit )
+                {
+                    SelectReportsScalar<uint64_t>( fields, reportCount, reportSize, fieldMask, value, outSelection );
+                }
+                else
+                {
+                    SelectReportsScalar<uint32_t>( fields, reportCount, reportSize, fieldMask, value, outSelection );
+                }
+                break;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     ExtractFields
+    //
+    // Description:
+    //     Extracts a header field of consecutive reports, e.g. report reason or
+    //     timestamp: outValues[j] = ( field of report j >> fieldShift ) & fieldMask.
+    //     Fields are zero extended to 64 bits before the shift, like read equations do.
+    //
+    // Input:
+    //     const uint8_t* rawData     - (IN) consecutive raw reports
+    //     uint32_t       reportCount - reports count
+    //     uint32_t       reportSize  - single report size in bytes
+    //     uint32_t       fieldOffset - field offset in a report
+    //     uint32_t       fieldSize   - field size in bytes, 4 or 8
+    //     uint32_t       fieldShift  - right shift applied to the field, less than 64
+    //     uint64_t       fieldMask   - mask applied to the shifted field
+    //     uint64_t*      outValues   - (OUT) values, reportCount values
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CReportKernels::ExtractFields( const uint8_t* rawData, uint32_t reportCount, uint32_t reportSize, uint32_t fieldOffset, uint32_t fieldSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues )
+    {
+        const bool     is64Bit = ( fieldSize == sizeof( uint64_t ) );
+        const uint8_t* fields  = rawData + fieldOffset;
+
+        MD_ASSERT( fieldSize == sizeof( uint64_t ) || fieldSize == sizeof( uint32_t ) );
+        MD_ASSERT( fieldShift < 64 );
+
+        switch( GetKernelLevel() )
+        {
+            case REPORT_KERNEL_LEVEL_AVX2:
+                if( is64Bit )
+                {
+                    ExtractFields64Avx2( fields, reportCount, reportSize, fieldShift, fieldMask, outValues );
+                }
+                else
+                {
+                    ExtractFields32Avx2( fields, reportCount, reportSize, fieldShift, fieldMask, outValues );
+                }
+                break;
+
+            case REPORT_KERNEL_LEVEL_SSE42:
+                if( is64Bit )
+                {
+                    ExtractFields64Sse42( fields, reportCount, reportSize, fieldShift, fieldMask, outValues );
+                }
+                else
+                {
+                    ExtractFields32Sse42( fields, reportCount, reportSize, fieldShift, fieldMask, outValues );
+                }
+                break;
+
+            default:
+                if( is64Bit )
+                {
+                    ExtractFieldsScalar<uint64_t>( fields, reportCount, reportSize, fieldShift, fieldMask, outValues );
+                }
+                else
+                {
+                    ExtractFieldsScalar<uint32_t>( fields, reportCount, reportSize, fieldShift, fieldMask, outValues );
+                }
+                break;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     InterpolateCounters
+    //
+    // Description:
+    //     Linearly interpolates counters between two reports:
+    //         out = prev + ( ( ( last - prev ) mod 2^N ) * alphaQ32 ) >> 32,
+    //     so counter overflows between the reports are handled. The product is
+    //     calculated exactly, the result is rounded down. Compared to a double alpha
+    //     the result may be smaller by at most ( last - prev ) / 2^32 + 1, i.e. by one
+    //     for 32 bit counters. alphaQ32 equal to 1 << 32 returns the last counters.
+    //
+    // Input:
+    //     const uint8_t* prev     - (IN) counters of the previous report
+    //     const uint8_t* last     - (IN) counters of the last report
+    //     uint32_t       count    - counters count
+    //     uint32_t       elemSize - counter size in bytes, 4 or 8
+    //     uint64_t       alphaQ32 - interpolation point in Q32, up to 1 << 32
+    //     uint8_t*       out      - (OUT) interpolated counters
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CReportKernels::InterpolateCounters( const uint8_t* prev, const uint8_t* last, uint32_t count, uint32_t elemSize, uint64_t alphaQ32, uint8_t* out )
+    {
+        const bool is64Bit = ( elemSize == sizeof( uint64_t ) );
+
+        MD_ASSERT( elemSize == sizeof( uint64_t ) || elemSize == sizeof( uint32_t ) );
+
+        if( alphaQ32 >= ( 1ULL << 32 ) )
+        {
+            std::memcpy( out, last, static_cast<size_t>( count ) * elemSize );
+            return;
+        }
+
+        switch( GetKernelLevel() )
+        {
+            case REPORT_KERNEL_LEVEL_AVX2:
+                if( is64Bit )
+                {
+                    InterpolateCounters64Avx2( prev, last, count, alphaQ32, out );
+                }
+                else
+                {
+                    InterpolateCounters32Avx2( prev, last, count, alphaQ32, out );
+                }
+                break;
+
+            case REPORT_KERNEL_LEVEL_SSE42:
+                if( is64Bit )
+                {
+                    InterpolateCounters64Sse42( prev, last, count, alphaQ32, out );
+                }
+                else
+                {
+                    InterpolateCounters32Sse42( prev, last, count, alphaQ32, out );
+                }
+                break;
+
+            default:
+                if( is64Bit )
+                {
+                    InterpolateCountersScalar<uint64_t>( prev, last, count, alphaQ32, out );
+                }
+                else
+                {
+                    InterpolateCountersScalar<uint32_t>( prev, last, count, alphaQ32, out );
+                }
+                break;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     GetInterpolationAlpha
+    //
+    // Description:
+    //     Returns Q32 interpolation point of a timestamp between two report timestamps,
+    //     clamped to [0, 1 << 32]. Equal report timestamps give 1 << 32, i.e. the last
+    //     report, as interpolation with a double alpha does.
+    //
+    // Input:
+    //     uint64_t timestamp     - interpolated timestamp
+    //     uint64_t timestampPrev - timestamp of the previous report
+    //     uint64_t timestampLast - timestamp of the last report
+    //
+    // Output:
+    //     uint64_t - interpolation point in Q32
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    uint64_t CReportKernels::GetInterpolationAlpha( uint64_t timestamp, uint64_t timestampPrev, uint64_t timestampLast )
+    {
+        if( timestampLast <= timestampPrev || timestamp >= timestampLast )
+        {
+            return 1ULL << 32;
+        }
+        if( timestamp <= timestampPrev )
+        {
+            return 0;
+        }
+
+        const double alpha = static_cast<double>( timestamp - timestampPrev ) / static_cast<double>( timestampLast - timestampPrev );
+
+        const uint64_t alphaQ32 = static_cast<uint64_t>( alpha * 4294967296.0 );
+
+        return ( alphaQ32 < ( 1ULL << 32 ) ) ? alphaQ32 : ( 1ULL << 32 );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     GetKernelLevel
+    //
+    // Description:
+    //     Returns instruction set level of the used delta kernels. CPU is checked
+    //     only once.
+    //
+    // Output:
+    //     TReportKernelLevel - delta kernel level
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TReportKernelLevel CReportKernels::GetKernelLevel()
+    {
+        static const TReportKernelLevel kernelLevel = DetectKernelLevel();
+
+        return kernelLevel;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     DetectKernelLevel
+    //
+    // Description:
+    //     Checks CPU features with CPUID. AVX2 requires also OS support for
+    //     saving YMM registers.
+    //
+    // Output:
+    //     TReportKernelLevel - the highest delta kernel level supported by the CPU
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TReportKernelLevel CReportKernels::DetectKernelLevel()
+    {
+#if defined( MD_REPORT_KERNELS_X86 ) && defined( _MSC_VER )
+        int32_t cpuInfo[4] = {};
+
+        __cpuid( cpuInfo, 0 );
+        const int32_t maxLeaf = cpuInfo[0];
+
+        __cpuid( cpuInfo, 1 );
+        const bool sse42   = ( cpuInfo[2] & ( 1 << 20 ) ) != 0;
+        const bool osxsave = ( cpuInfo[2] & ( 1 << 27 ) ) != 0;
+        const bool avx     = ( cpuInfo[2] & ( 1 << 28 ) ) != 0;
+        bool       avx2    = false;
+
+        if( maxLeaf >= 7 && osxsave && avx && ( _xgetbv( 0 ) & 0x6 ) == 0x6 )
+        {
+            __cpuidex( cpuInfo, 7, 0 );
+            avx2 = ( cpuInfo[1] & ( 1 << 5 ) ) != 0;
+        }
+#elif defined( MD_REPORT_KERNELS_X86 )
+        __builtin_cpu_init();
+
+        const bool sse42 = __builtin_cpu_supports( "sse4.2" );
+        const bool avx2  = __builtin_cpu_supports( "avx2" );
+#else
+        const bool sse42 = false;
+        const bool avx2  = false;
+#endif
+
+        const TReportKernelLevel kernelLevel = avx2
+            ? REPORT_KERNEL_LEVEL_AVX2
+            : sse42 ? REPORT_KERNEL_LEVEL_SSE42 : REPORT_KERNEL_LEVEL_SCALAR;
+
+#if defined( _DEBUG ) || defined( _RELEASE_INTERNAL )
+        // Cross-check of the selected kernels with the scalar ones
+        if( !SelfTest( kernelLevel ) )
+        {
+            MD_LOG( LOG_ERROR, "report kernels level %u differ from scalar kernels, scalar kernels are used", static_cast<uint32_t>( kernelLevel ) );
+            MD_ASSERT( false );
+            return REPORT_KERNEL_LEVEL_SCALAR;
+        }
+#endif
+
+        return kernelLevel;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     SelfTest
+    //
+    // Description:
+    //     Compares results of the delta, transpose, select, extract and interpolate
+    //     kernels of the given level with the scalar kernels, bit by bit. Inputs are
+    //     pseudo random reports with a fixed seed, counters include wrapped ones
+    //     (previous greater than the last) and the extreme values. Counts cover
+    //     both full vectors and tails. The level has to be supported by the CPU,
+    //     i.e. up to GetKernelLevel. Used in debug builds when kernels are selected.
+    //
+    // Input:
+    //     TReportKernelLevel level - kernel level to check
+    //
+    // Output:
+    //     bool - true if all the kernels give the same results as scalar ones
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    bool CReportKernels::SelfTest( TReportKernelLevel level )
+    {
+        const uint32_t iterationCount = 64;
+        const uint32_t maxCount       = 45;
+        const uint32_t maxReportSize  = 264;
+        const uint32_t maxColumnCount = maxReportSize / sizeof( uint32_t );
+        uint64_t       seed           = 0x9E3779B97F4A7C15ULL;
+
+        if( level == REPORT_KERNEL_LEVEL_SCALAR )
+        {
+            return true;
+        }
+
+        auto random = [&seed]() -> uint64_t
+        {
+            // xorshift64
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            return seed;
+        };
+
+        auto randomCounter = [&random]() -> uint64_t
+        {
+            switch( random() % 8 )
+            {
+                case 0:
+                    return 0ULL;
+                case 1:
+                    return ~0ULL;
+                case 2:
+                    return ~0ULL - random() % 16;
+                case 3:
+                    return random() % 16;
+                default:
+                    return random();
+            }
+        };
+
+        auto fillCounters = [&randomCounter]( uint8_t* out, uint32_t count, uint32_t elemSize )
+        {
+            for( uint32_t i = 0; i < count; ++i )
+            {
+                const uint64_t value = randomCounter();
+                std::memcpy( out + static_cast<size_t>( i ) * elemSize, &value, elemSize );
+            }
+        };
+
+        std::vector<uint8_t>        last( maxCount * sizeof( uint64_t ) );
+        std::vector<uint8_t>        prev( maxCount * sizeof( uint64_t ) );
+        std::vector<uint8_t>        rawData( maxCount * maxReportSize );
+        std::vector<const uint8_t*> rawReports( maxCount );
+        std::vector<uint64_t>       expected( maxColumnCount * ( maxCount + 2 ) );
+        std::vector<uint64_t>       result( maxColumnCount * ( maxCount + 2 ) );
+        std::vector<uint8_t>        expectedBytes( maxCount * sizeof( uint64_t ) );
+        std::vector<uint8_t>        resultBytes( maxCount * sizeof( uint64_t ) );
+
+        const uint32_t bitsCounts[] = { 32, 36, 40, 48, 63, 64 };
+
+        for( uint32_t iteration = 0; iteration < iterationCount; ++iteration )
+        {
+            for( const uint32_t elemSize : { static_cast<uint32_t>( sizeof( uint32_t ) ), static_cast<uint32_t>( sizeof( uint64_t ) ) } )
+            {
+                const bool     is64Bit = ( elemSize == sizeof( uint64_t ) );
+                const uint32_t count   = 1 + static_cast<uint32_t>( random() % maxCount );
+
+                // Deltas
+                const uint32_t bitsCount  = bitsCounts[random() % ( sizeof( bitsCounts ) / sizeof( bitsCounts[0] ) )];
+                const uint64_t wrapBit    = ( bitsCount < 64 ) ? ( 1ULL << bitsCount ) : 0ULL;
+                const uint64_t wrapBorrow = ( bitsCount < 64 ) ? 0ULL : 1ULL;
+
+                fillCounters( last.data(), count, elemSize );
+                fillCounters( prev.data(), count, elemSize );
+
+                if( is64Bit )
+                {
+                    CalculateDeltasScalar<uint64_t>( last.data(), prev.data(), count, wrapBit, wrapBorrow, expected.data() );
+                }
+                else
+                {
+                    CalculateDeltasScalar<uint32_t>( last.data(), prev.data(), count, wrapBit, wrapBorrow, expected.data() );
+                }
+
+                switch( level )
+                {
+                    case REPORT_KERNEL_LEVEL_AVX2:
+                        if( is64Bit )
+                        {
+                            CalculateDeltas64Avx2( last.data(), prev.data(), count, wrapBit, wrapBorrow, result.data() );
+                        }
+                        else
+                        {
+                            CalculateDeltas32Avx2( last.data(), prev.data(), count, wrapBit, wrapBorrow, result.data() );
+                        }
+                        break;
+
+                    default:
+                        if( is64Bit )
+                        {
+                            CalculateDeltas64Sse42( last.data(), prev.data(), count, wrapBit, wrapBorrow, result.data() );
+                        }
+                        else
+                        {
+                            CalculateDeltas32Sse42( last.data(), prev.data(), count, wrapBit, wrapBorrow, result.data() );
+                        }
+                        break;
+                }
+
+                if( std::memcmp( expected.data(), result.data(), count * sizeof( uint64_t ) ) != 0 )
+                {
+                    MD_LOG( LOG_ERROR, "delta kernel mismatch, element size %u, bits count %u", elemSize, bitsCount );
+                    return false;
+                }
+
+                // Interpolation
+                const uint64_t alphaQ32 = ( iteration == 0 ) ? 0ULL : ( iteration == 1 ) ? ( 1ULL << 32 ) - 1 : random() & 0xFFFFFFFFULL;
+
+                if( is64Bit )
+                {
+                    InterpolateCountersScalar<uint64_t>( prev.data(), last.data(), count, alphaQ32, expectedBytes.data() );
+                }
+                else
+                {
+                    InterpolateCountersScalar<uint32_t>( prev.data(), last.data(), count, alphaQ32, expectedBytes.data() );
+                }
+
+                switch( level )
+                {
+                    case REPORT_KERNEL_LEVEL_AVX2:
+                        if( is64Bit )
+                        {
+                            InterpolateCounters64Avx2( prev.data(), last.data(), count, alphaQ32, resultBytes.data() );
+                        }
+                        else
+                        {
+                            InterpolateCounters32Avx2( prev.data(), last.data(), count, alphaQ32, resultBytes.data() );
+                        }
+                        break;
+
+                    default:
+                        if( is64Bit )
+                        {
+                            InterpolateCounters64Sse42( prev.data(), last.data(), count, alphaQ32, resultBytes.data() );
+                        }
+                        else
+                        {
+                            InterpolateCounters32Sse42( prev.data(), last.data(), count, alphaQ32, resultBytes.data() );
+                        }
+                        break;
+                }
+
+                if( std::memcmp( expectedBytes.data(), resultBytes.data(), count * elemSize ) != 0 )
+                {
+                    MD_LOG( LOG_ERROR, "interpolation kernel mismatch, element size %u, alpha %llu", elemSize, static_cast<unsigned long long>( alphaQ32 ) );
+                    return false;
+                }
+
+                // Transposition of a region of reports
+                const uint32_t reportCount  = 1 + static_cast<uint32_t>( random() % maxCount );
+                const uint32_t columnStride = reportCount + static_cast<uint32_t>( random() % 3 );
+                const uint32_t counterCount = 1 + static_cast<uint32_t>( random() % ( maxReportSize / elemSize - 4 ) );
+                const uint32_t regionOffset = elemSize * static_cast<uint32_t>( random() % 4 );
+                const size_t   columnsSize  = static_cast<size_t>( counterCount ) * columnStride * sizeof( uint64_t );
+
+                fillCounters( rawData.data(), maxCount * maxReportSize / elemSize, elemSize );
+
+                for( uint32_t j = 0; j < reportCount; ++j )
+                {
+                    rawReports[j] = rawData.data() + static_cast<size_t>( j ) * maxReportSize;
+                }
+
+                std::memset( expected.data(), 0xCD, columnsSize );
+                std::memset( result.data(), 0xCD, columnsSize );
+
+                if( is64Bit )
+                {
+                    TransposeRegionScalar<uint64_t>( rawReports.data(), reportCount, regionOffset, counterCount, columnStride, expected.data() );
+                }
+                else
+                {
+                    TransposeRegionScalar<uint32_t>( rawReports.data(), reportCount, regionOffset, counterCount, columnStride, expected.data() );
+                }
+
+                switch( level )
+                {
+                    case REPORT_KERNEL_LEVEL_AVX2:
+                        if( is64Bit )
+                        {
+                            TransposeRegion64Avx2( rawReports.data(), reportCount, regionOffset, counterCount, columnStride, result.data() );
+                        }
+                        else
+                        {
+                            TransposeRegion32Avx2( rawReports.data(), reportCount, regionOffset, counterCount, columnStride, result.data() );
+                        }
+                        break;
+
+                    default:
+                        if( is64Bit )
+                        {
+                            TransposeRegion64Sse42( rawReports.data(), reportCount, regionOffset, counterCount, columnStride, result.data() );
+                        }
+                        else
+                        {
+                            TransposeRegion32Sse42( rawReports.data(), reportCount, regionOffset, counterCount, columnStride, result.data() );
+                        }
+                        break;
+                }
+
+                if( std::memcmp( expected.data(), result.data(), columnsSize ) != 0 )
+                {
+                    MD_LOG( LOG_ERROR, "transpose kernel mismatch, element size %u, %u counters of %u reports", elemSize, counterCount, reportCount );
+                    return false;
+                }
+
+                // Selection and extraction of a header field
+                const uint32_t reportSize  = sizeof( uint64_t ) * ( 1 + static_cast<uint32_t>( random() % ( maxReportSize / sizeof( uint64_t ) ) ) );
+                const uint32_t fieldOffset = elemSize * static_cast<uint32_t>( random() % ( ( reportSize - elemSize ) / elemSize + 1 ) );
+                const uint64_t fieldMask   = ( random() % 2 ) ? ~0ULL : random();
+                const uint32_t fieldShift  = static_cast<uint32_t>( random() % 64 );
+                const uint8_t* fields      = rawData.data() + fieldOffset;
+
+                for( uint32_t j = 1; j < reportCount; ++j )
+                {
+                    // Some reports with the same field, to be selected
+                    if( random() % 2 )
+                    {
+                        std::memcpy( rawData.data() + static_cast<size_t>( j ) * reportSize + fieldOffset, fields, elemSize );
+                    }
+                }
+
+                const uint64_t selectMask = is64Bit ? fieldMask : ( fieldMask & 0xFFFFFFFFULL );
+                uint64_t       value      = 0;
+
+                std::memcpy( &value, fields, elemSize );
+                value &= selectMask;
+
+                if( is64Bit )
+                {
+                    SelectReportsScalar<uint64_t>( fields, reportCount, reportSize, selectMask, value, expectedBytes.data() );
+                }
+                else
+                {
+                    SelectReportsScalar<uint32_t>( fields, reportCount, reportSize, selectMask, value, expectedBytes.data() );
+                }
+
+                switch( level )
+                {
+                    case REPORT_KERNEL_LEVEL_AVX2:
+                        if( is64Bit )
+                        {
+                            SelectReports64Avx2( fields, reportCount, reportSize, selectMask, value, resultBytes.data() );
+                        }
+                        else
+                        {
+                            SelectReports32Avx2( fields, reportCount, reportSize, selectMask, value, resultBytes.data() );
+                        }
+                        break;
+
+                    default:
+                        if( is64Bit )
+                        {
+                            SelectReports64Sse42( fields, reportCount, reportSize, selectMask, value, resultBytes.data() );
+                        }
+                        else
+                        {
+                            SelectReports32Sse42( fields, reportCount, reportSize, selectMask, value, resultBytes.data() );
+                        }
+                        break;
+                }
+
+                if( std::memcmp( expectedBytes.data(), resultBytes.data(), reportCount ) != 0 )
+                {
+                    MD_LOG( LOG_ERROR, "select kernel mismatch, field size %u, report size %u", elemSize, reportSize );
+                    return false;
+                }
+
+                if( is64Bit )
+                {
+                    ExtractFieldsScalar<uint64_t>( fields, reportCount, reportSize, fieldShift, fieldMask, expected.data() );
+                }
+                else
+                {
+                    ExtractFieldsScalar<uint32_t>( fields, reportCount, reportSize, fieldShift, fieldMask, expected.data() );
+                }
+
+                switch( level )
+                {
+                    case REPORT_KERNEL_LEVEL_AVX2:
+                        if( is64Bit )
+                        {
+                            ExtractFields64Avx2( fields, reportCount, reportSize, fieldShift, fieldMask, result.data() );
+                        }
+                        else
+                        {
+                            ExtractFields32Avx2( fields, reportCount, reportSize, fieldShift, fieldMask, result.data() );
+                        }
+                        break;
+
+                    default:
+                        if( is64Bit )
+                        {
+                            ExtractFields64Sse42( fields, reportCount, reportSize, fieldShift, fieldMask, result.data() );
+                        }
+                        else
+                        {
+                            ExtractFields32Sse42( fields, reportCount, reportSize, fieldShift, fieldMask, result.data() );
+                        }
+                        break;
+                }
+
+                if( std::memcmp( expected.data(), result.data(), reportCount * sizeof( uint64_t ) ) != 0 )
+                {
+                    MD_LOG( LOG_ERROR, "extract kernel mismatch, field size %u, shift %u", elemSize, fieldShift );
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     CalculateDeltas
+    //
+    // Description:
+    //     Calculates DELTA_N_BITS deltas of two arrays of counters of the same size.
+    //     Wrapped counters (previous value greater than the last one) are corrected
+    //     the same way as in CMetricsCalculator::CalculateDeltaFunction:
+    //         bitsCount <  64: ( last | 1 << bitsCount ) - prev
+    //         bitsCount == 64: max - prev + last
+    //         bitsCount >  64: 0
+    //
+    // Input:
+    //     TReportKernelLevel level     - kernels level, at most the detected one
+    //     const uint8_t*     last      - (IN) last (next) counters
+    //     const uint8_t*     prev      - (IN) previous counters
+    //     uint32_t           count     - counters count
+    //     uint32_t           elemSize  - single counter size in bytes, 4 or 8
+    //     uint32_t           bitsCount - counters bits count
+    //     uint64_t*          outDeltas - (OUT) deltas, count values
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CReportKernels::CalculateDeltas( TReportKernelLevel level, const uint8_t* last, const uint8_t* prev, uint32_t count, uint32_t elemSize, uint32_t bitsCount, uint64_t* outDeltas )
+    {
+        if( bitsCount > 64 )
+        {
+            for( uint32_t i = 0; i < count; ++i )
+            {
+                outDeltas[i] = 0ULL;
+            }
+            return;
+        }
+
+        // ( last | wrapBit ) - prev - wrapBorrow is the wrapped delta for any bits count
+        const uint64_t wrapBit    = ( bitsCount < 64 ) ? ( 1ULL << bitsCount ) : 0ULL;
+        const uint64_t wrapBorrow = ( bitsCount < 64 ) ? 0ULL : 1ULL;
+        const bool     is64Bit    = ( elemSize == sizeof( uint64_t ) );
+
+        MD_ASSERT( elemSize == sizeof( uint64_t ) || elemSize == sizeof( uint32_t ) );
+
+        switch( level )
+        {
+            case REPORT_KERNEL_LEVEL_AVX2:
+                if( is64Bit )
+                {
+                    CalculateDeltas64Avx2( last, prev, count, wrapBit, wrapBorrow, outDeltas );
+                }
+                else
+                {
+                    CalculateDeltas32Avx2( last, prev, count, wrapBit, wrapBorrow, outDeltas );
+                }
+                break;
+
+            case REPORT_KERNEL_LEVEL_SSE42:
+                if( is64Bit )
+                {
+                    CalculateDeltas64Sse42( last, prev, count, wrapBit, wrapBorrow, outDeltas );
+                }
+                else
+                {
+                    CalculateDeltas32Sse42( last, prev, count, wrapBit, wrapBorrow, outDeltas );
+                }
+                break;
+
+            default:
+                if( is64Bit )
+                {
+                    CalculateDeltasScalar<uint64_t>( last, prev, count, wrapBit, wrapBorrow, outDeltas );
+                }
+                else
+                {
+                    CalculateDeltasScalar<uint32_t>( last, prev, count, wrapBit, wrapBorrow, outDeltas );
+                }
+                break;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     CalculateDeltasScalar
+    //
+    // Description:
+    //     Scalar delta kernel, used on CPUs without SSE4.2 and for region tails.
+    //
+    // Input:
+    //     const uint8_t* last       - (IN) last (next) region counters
+    //     const uint8_t* prev       - (IN) previous region counters
+    //     uint32_t       count      - counters count
+    //     uint64_t       wrapBit    - bit added to the last value of a wrapped counter
+    //     uint64_t       wrapBorrow - value subtracted from the delta of a wrapped counter
+    //     uint64_t*      outDeltas  - (OUT) deltas
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <typename TCounter>
+    void CReportKernels::CalculateDeltasScalar( const uint8_t* last, const uint8_t* prev, uint32_t count, uint64_t wrapBit, uint64_t wrapBorrow, uint64_t* outDeltas )
+    {
+        const TCounter* lastCounters = reinterpret_cast<const TCounter*>( last );
+        const TCounter* prevCounters = reinterpret_cast<const TCounter*>( prev );
+
+        for( uint32_t i = 0; i < count; ++i )
+        {
+            const uint64_t lastValue = static_cast<uint64_t>( lastCounters[i] );
+            const uint64_t prevValue = static_cast<uint64_t>( prevCounters[i] );
+
+            outDeltas[i] = ( prevValue > lastValue )
+                ? ( lastValue | wrapBit ) - prevValue - wrapBorrow
+                : lastValue - prevValue;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     TransposeRegionScalar
+    //
+    // Description:
+    //     Scalar transpose kernel, used on CPUs without SSE4.2 and for block tails.
+    //
+    // Input:
+    //     const uint8_t* const* rawReports   - (IN) raw reports
+    //     uint32_t              reportCount  - reports count
+    //     uint32_t              regionOffset - region offset in a report
+    //     uint32_t              counterCount - region counters count
+    //     uint32_t              columnStride - column size in values
+    //     uint64_t*             outColumns   - (OUT) region counter columns
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <typename TCounter>
+    void CReportKernels::TransposeRegionScalar( const uint8_t* const* rawReports, uint32_t reportCount, uint32_t regionOffset, uint32_t counterCount, uint32_t columnStride, uint64_t* outColumns )
+    {
+        for( uint32_t c = 0; c < counterCount; ++c )
+        {
+            uint64_t* column = outColumns + static_cast<size_t>( c ) * columnStride;
+
+            for( uint32_t j = 0; j < reportCount; ++j )
+            {
+                column[j] = static_cast<uint64_t>( reinterpret_cast<const TCounter*>( rawReports[j] + regionOffset )[c] );
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     SelectReportsScalar
+    //
+    // Description:
+    //     Scalar selection kernel, used on CPUs without SSE4.2 and for tails.
+    //
+    // Input:
+    //     const uint8_t* fields       - (IN) field of the first report
+    //     uint32_t       reportCount  - reports count
+    //     uint32_t       reportSize   - single report size in bytes
+    //     uint64_t       fieldMask    - mask applied to the field before comparison
+    //     uint64_t       value        - value of the masked field of selected reports
+    //     uint8_t*       outSelection - (OUT) selection
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <typename TField>
+    void CReportKernels::SelectReportsScalar( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection )
+    {
+        for( uint32_t j = 0; j < reportCount; ++j )
+        {
+            const uint64_t field = static_cast<uint64_t>( *reinterpret_cast<const TField*>( fields + static_cast<size_t>( j ) * reportSize ) );
+
+            outSelection[j] = ( ( field & fieldMask ) == value ) ? 1 : 0;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     ExtractFieldsScalar
+    //
+    // Description:
+    //     Scalar extraction kernel, used on CPUs without SSE4.2 and for tails.
+    //
+    // Input:
+    //     const uint8_t* fields      - (IN) field of the first report
+    //     uint32_t       reportCount - reports count
+    //     uint32_t       reportSize  - single report size in bytes
+    //     uint32_t       fieldShift  - right shift applied to the field, less than 64
+    //     uint64_t       fieldMask   - mask applied to the shifted field
+    //     uint64_t*      outValues   - (OUT) values
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <typename TField>
+    void CReportKernels::ExtractFieldsScalar( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues )
+    {
+        for( uint32_t j = 0; j < reportCount; ++j )
+        {
+            const uint64_t field = static_cast<uint64_t>( *reinterpret_cast<const TField*>( fields + static_cast<size_t>( j ) * reportSize ) );
+
+            outValues[j] = ( field >> fieldShift ) & fieldMask;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     InterpolateCountersScalar
+    //
+    // Description:
+    //     Scalar interpolation kernel, used on CPUs without SSE4.2 and for tails.
+    //     The delta is split to 32 bit halves, so the product with alpha is exact.
+    //
+    // Input:
+    //     const uint8_t* prev     - (IN) counters of the previous report
+    //     const uint8_t* last     - (IN) counters of the last report
+    //     uint32_t       count    - counters count
+    //     uint64_t       alphaQ32 - interpolation point in Q32, less than 1 << 32
+    //     uint8_t*       out      - (OUT) interpolated counters
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <typename TCounter>
+    void CReportKernels::InterpolateCountersScalar( const uint8_t* prev, const uint8_t* last, uint32_t count, uint64_t alphaQ32, uint8_t* out )
+    {
+        for( uint32_t j = 0; j < count; ++j )
+        {
+            TCounter valuePrev = 0;
+            TCounter valueLast = 0;
+
+            std::memcpy( &valuePrev, prev + j * sizeof( TCounter ), sizeof( TCounter ) );
+            std::memcpy( &valueLast, last + j * sizeof( TCounter ), sizeof( TCounter ) );
+
+            const uint64_t delta        = static_cast<TCounter>( valueLast - valuePrev );
+            const uint64_t partial      = ( delta >> 32 ) * alphaQ32 + ( ( ( delta & 0xFFFFFFFFULL ) * alphaQ32 ) >> 32 );
+            const TCounter interpolated = static_cast<TCounter>( valuePrev + static_cast<TCounter>( partial ) );
+
+            std::memcpy( out + j * sizeof( TCounter ), &interpolated, sizeof( TCounter ) );
+        }
+    }
+
+#if defined( MD_REPORT_KERNELS_X86 )
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     CalculateDeltas32Sse42
+    //
+    // Description:
+    //     SSE4.2 delta kernel for 32 bit counters. Counters are zero extended to
+    //     64 bits, unsigned compare is done on values with flipped sign bits.
+    //
+    // Input:
+    //     const uint8_t* last       - (IN) last (next) region counters
+    //     const uint8_t* prev       - (IN) previous region counters
+    //     uint32_t       count      - counters count
+    //     uint64_t       wrapBit    - bit added to the last value of a wrapped counter
+    //     uint64_t       wrapBorrow - value subtracted from the delta of a wrapped counter
+    //     uint64_t*      outDeltas  - (OUT) deltas
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_SSE42 void CReportKernels::CalculateDeltas32Sse42( const uint8_t* last, const uint8_t* prev, uint32_t count, uint64_t wrapBit, uint64_t wrapBorrow, uint64_t* outDeltas )
+    {
+        const __m128i signBit  = _mm_set1_epi64x( static_cast<int64_t>( 1ULL << 63 ) );
+        const __m128i wrapBitV = _mm_set1_epi64x( static_cast<int64_t>( wrapBit ) );
+        const __m128i borrowV  = _mm_set1_epi64x( static_cast<int64_t>( wrapBorrow ) );
+        uint32_t      i        = 0;
+
+        for( ; i + 2 <= count; i += 2 )
+        {
+            const __m128i lastValues = _mm_cvtepu32_epi64( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( last + i * sizeof( uint32_t ) ) ) );
+            const __m128i prevValues = _mm_cvtepu32_epi64( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( prev + i * sizeof( uint32_t ) ) ) );
+            const __m128i isWrapped  = _mm_cmpgt_epi64( _mm_xor_si128( prevValues, signBit ), _mm_xor_si128( lastValues, signBit ) );
+            const __m128i delta      = _mm_sub_epi64( lastValues, prevValues );
+            const __m128i wrapDelta  = _mm_sub_epi64( _mm_sub_epi64( _mm_or_si128( lastValues, wrapBitV ), prevValues ), borrowV );
+
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( outDeltas + i ), _mm_blendv_epi8( delta, wrapDelta, isWrapped ) );
+        }
+
+        CalculateDeltasScalar<uint32_t>( last + i * sizeof( uint32_t ), prev + i * sizeof( uint32_t ), count - i, wrapBit, wrapBorrow, outDeltas + i );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     CalculateDeltas64Sse42
+    //
+    // Description:
+    //     SSE4.2 delta kernel for 64 bit counters.
+    //
+    // Input:
+    //     const uint8_t* last       - (IN) last (next) region counters
+    //     const uint8_t* prev       - (IN) previous region counters
+    //     uint32_t       count      - counters count
+    //     uint64_t       wrapBit    - bit added to the last value of a wrapped counter
+    //     uint64_t       wrapBorrow - value subtracted from the delta of a wrapped counter
+    //     uint64_t*      outDeltas  - (OUT) deltas
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_SSE42 void CReportKernels::CalculateDeltas64Sse42( const uint8_t* last, const uint8_t* prev, uint32_t count, uint64_t wrapBit, uint64_t wrapBorrow, uint64_t* outDeltas )
+    {
+        const __m128i signBit  = _mm_set1_epi64x( static_cast<int64_t>( 1ULL << 63 ) );
+        const __m128i wrapBitV = _mm_set1_epi64x( static_cast<int64_t>( wrapBit ) );
+        const __m128i borrowV  = _mm_set1_epi64x( static_cast<int64_t>( wrapBorrow ) );
+        uint32_t      i        = 0;
+
+        for( ; i + 2 <= count; i += 2 )
+        {
+            const __m128i lastValues = _mm_loadu_si128( reinterpret_cast<const __m128i*>( last + i * sizeof( uint64_t ) ) );
+            const __m128i prevValues = _mm_loadu_si128( reinterpret_cast<const __m128i*>( prev + i * sizeof( uint64_t ) ) );
+            const __m128i isWrapped  = _mm_cmpgt_epi64( _mm_xor_si128( prevValues, signBit ), _mm_xor_si128( lastValues, signBit ) );
+            const __m128i delta      = _mm_sub_epi64( lastValues, prevValues );
+            const __m128i wrapDelta  = _mm_sub_epi64( _mm_sub_epi64( _mm_or_si128( lastValues, wrapBitV ), prevValues ), borrowV );
+
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( outDeltas + i ), _mm_blendv_epi8( delta, wrapDelta, isWrapped ) );
+        }
+
+        CalculateDeltasScalar<uint64_t>( last + i * sizeof( uint64_t ), prev + i * sizeof( uint64_t ), count - i, wrapBit, wrapBorrow, outDeltas + i );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     CalculateDeltas32Avx2
+    //
+    // Description:
+    //     AVX2 delta kernel for 32 bit counters.
+    //
+    // Input:
+    //     const uint8_t* last       - (IN) last (next) region counters
+    //     const uint8_t* prev       - (IN) previous region counters
+    //     uint32_t       count      - counters count
+    //     uint64_t       wrapBit    - bit added to the last value of a wrapped counter
+    //     uint64_t       wrapBorrow - value subtracted from the delta of a wrapped counter
+    //     uint64_t*      outDeltas  - (OUT) deltas
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_AVX2 void CReportKernels::CalculateDeltas32Avx2( const uint8_t* last, const uint8_t* prev, uint32_t count, uint64_t wrapBit, uint64_t wrapBorrow, uint64_t* outDeltas )
+    {
+        const __m256i signBit  = _mm256_set1_epi64x( static_cast<int64_t>( 1ULL << 63 ) );
+        const __m256i wrapBitV = _mm256_set1_epi64x( static_cast<int64_t>( wrapBit ) );
+        const __m256i borrowV  = _mm256_set1_epi64x( static_cast<int64_t>( wrapBorrow ) );
+        uint32_t      i        = 0;
+
+        for( ; i + 4 <= count; i += 4 )
+        {
+            const __m256i lastValues = _mm256_cvtepu32_epi64( _mm_loadu_si128( reinterpret_cast<const __m128i*>( last + i * sizeof( uint32_t ) ) ) );
+            const __m256i prevValues = _mm256_cvtepu32_epi64( _mm_loadu_si128( reinterpret_cast<const __m128i*>( prev + i * sizeof( uint32_t ) ) ) );
+            const __m256i isWrapped  = _mm256_cmpgt_epi64( _mm256_xor_si256( prevValues, signBit ), _mm256_xor_si256( lastValues, signBit ) );
+            const __m256i delta      = _mm256_sub_epi64( lastValues, prevValues );
+            const __m256i wrapDelta  = _mm256_sub_epi64( _mm256_sub_epi64( _mm256_or_si256( lastValues, wrapBitV ), prevValues ), borrowV );
+
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( outDeltas + i ), _mm256_blendv_epi8( delta, wrapDelta, isWrapped ) );
+        }
+
+        CalculateDeltasScalar<uint32_t>( last + i * sizeof( uint32_t ), prev + i * sizeof( uint32_t ), count - i, wrapBit, wrapBorrow, outDeltas + i );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     CalculateDeltas64Avx2
+    //
+    // Description:
+    //     AVX2 delta kernel for 64 bit counters.
+    //
+    // Input:
+    //     const uint8_t* last       - (IN) last (next) region counters
+    //     const uint8_t* prev       - (IN) previous region counters
+    //     uint32_t       count      - counters count
+    //     uint64_t       wrapBit    - bit added to the last value of a wrapped counter
+    //     uint64_t       wrapBorrow - value subtracted from the delta of a wrapped counter
+    //     uint64_t*      outDeltas  - (OUT) deltas
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_AVX2 void CReportKernels::CalculateDeltas64Avx2( const uint8_t* last, const uint8_t* prev, uint32_t count, uint64_t wrapBit, uint64_t wrapBorrow, uint64_t* outDeltas )
+    {
+        const __m256i signBit  = _mm256_set1_epi64x( static_cast<int64_t>( 1ULL << 63 ) );
+        const __m256i wrapBitV = _mm256_set1_epi64x( static_cast<int64_t>( wrapBit ) );
+        const __m256i borrowV  = _mm256_set1_epi64x( static_cast<int64_t>( wrapBorrow ) );
+        uint32_t      i        = 0;
+
+        for( ; i + 4 <= count; i += 4 )
+        {
+            const __m256i lastValues = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( last + i * sizeof( uint64_t ) ) );
+            const __m256i prevValues = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( prev + i * sizeof( uint64_t ) ) );
+            const __m256i isWrapped  = _mm256_cmpgt_epi64( _mm256_xor_si256( prevValues, signBit ), _mm256_xor_si256( lastValues, signBit ) );
+            const __m256i delta      = _mm256_sub_epi64( lastValues, prevValues );
+            const __m256i wrapDelta  = _mm256_sub_epi64( _mm256_sub_epi64( _mm256_or_si256( lastValues, wrapBitV ), prevValues ), borrowV );
+
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( outDeltas + i ), _mm256_blendv_epi8( delta, wrapDelta, isWrapped ) );
+        }
+
+        CalculateDeltasScalar<uint64_t>( last + i * sizeof( uint64_t ), prev + i * sizeof( uint64_t ), count - i, wrapBit, wrapBorrow, outDeltas + i );
+    }
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     TransposeRegion32Sse42
+    //
+    // Description:
+    //     SSE4.2 transpose kernel for 32 bit counters.
+    //
+    // Input:
+    //     const uint8_t* const* rawReports   - (IN) raw reports
+    //     uint32_t              reportCount  - reports count
+    //     uint32_t              regionOffset - region offset in a report
+    //     uint32_t              counterCount - region counters count
+    //     uint32_t              columnStride - column size in values
+    //     uint64_t*             outColumns   - (OUT) region counter columns
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_SSE42 void CReportKernels::TransposeRegion32Sse42( const uint8_t* const* rawReports, uint32_t reportCount, uint32_t regionOffset, uint32_t counterCount, uint32_t columnStride, uint64_t* outColumns )
+    {
+        // 4 x 4 blocks: 4 counters of 4 reports
+        for( uint32_t c = 0; c + 4 <= counterCount; c += 4 )
+        {
+            uint64_t* columns = outColumns + static_cast<size_t>( c ) * columnStride;
+
+            for( uint32_t j = 0; j + 4 <= reportCount; j += 4 )
+            {
+                const __m128i row0 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( rawReports[j + 0] + regionOffset + c * sizeof( uint32_t ) ) );
+                const __m128i row1 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( rawReports[j + 1] + regionOffset + c * sizeof( uint32_t ) ) );
+                const __m128i row2 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( rawReports[j + 2] + regionOffset + c * sizeof( uint32_t ) ) );
+                const __m128i row3 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( rawReports[j + 3] + regionOffset + c * sizeof( uint32_t ) ) );
+
+                // ( r0c0, r1c0, r0c1, r1c1 ), ( r0c2, r1c2, r0c3, r1c3 ) and the same for rows 2 and 3
+                const __m128i low01  = _mm_unpacklo_epi32( row0, row1 );
+                const __m128i high01 = _mm_unpackhi_epi32( row0, row1 );
+                const __m128i low23  = _mm_unpacklo_epi32( row2, row3 );
+                const __m128i high23 = _mm_unpackhi_epi32( row2, row3 );
+
+                const __m128i column0 = _mm_unpacklo_epi64( low01, low23 );
+                const __m128i column1 = _mm_unpackhi_epi64( low01, low23 );
+                const __m128i column2 = _mm_unpacklo_epi64( high01, high23 );
+                const __m128i column3 = _mm_unpackhi_epi64( high01, high23 );
+
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( columns + 0 * columnStride + j ), _mm_cvtepu32_epi64( column0 ) );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( columns + 0 * columnStride + j + 2 ), _mm_cvtepu32_epi64( _mm_srli_si128( column0, 8 ) ) );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( columns + 1 * columnStride + j ), _mm_cvtepu32_epi64( column1 ) );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( columns + 1 * columnStride + j + 2 ), _mm_cvtepu32_epi64( _mm_srli_si128( column1, 8 ) ) );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( columns + 2 * columnStride + j ), _mm_cvtepu32_epi64( column2 ) );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( columns + 2 * columnStride + j + 2 ), _mm_cvtepu32_epi64( _mm_srli_si128( column2, 8 ) ) );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( columns + 3 * columnStride + j ), _mm_cvtepu32_epi64( column3 ) );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( columns + 3 * columnStride + j + 2 ), _mm_cvtepu32_epi64( _mm_srli_si128( column3, 8 ) ) );
+            }
+        }
+
+        const uint32_t blockCounters = counterCount - counterCount % 4;
+        const uint32_t blockReports  = reportCount - reportCount % 4;
+
+        // Counters after full blocks
+        TransposeRegionScalar<uint32_t>( rawReports, reportCount, regionOffset + blockCounters * sizeof( uint32_t ), counterCount - blockCounters, columnStride, outColumns + static_cast<size_t>( blockCounters ) * columnStride );
+
+        // Reports after full blocks
+        TransposeRegionScalar<uint32_t>( rawReports + blockReports, reportCount - blockReports, regionOffset, blockCounters, columnStride, outColumns + blockReports );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     TransposeRegion64Sse42
+    //
+    // Description:
+    //     SSE4.2 transpose kernel for 64 bit counters.
+    //
+    // Input:
+    //     const uint8_t* const* rawReports   - (IN) raw reports
+    //     uint32_t              reportCount  - reports count
+    //     uint32_t              regionOffset - region offset in a report
+    //     uint32_t              counterCount - region counters count
+    //     uint32_t              columnStride - column size in values
+    //     uint64_t*             outColumns   - (OUT) region counter columns
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_SSE42 void CReportKernels::TransposeRegion64Sse42( const uint8_t* const* rawReports, uint32_t reportCount, uint32_t regionOffset, uint32_t counterCount, uint32_t columnStride, uint64_t* outColumns )
+    {
+        // 2 x 2 blocks: 2 counters of 2 reports
+        for( uint32_t c = 0; c + 2 <= counterCount; c += 2 )
+        {
+            uint64_t* columns = outColumns + static_cast<size_t>( c ) * columnStride;
+
+            for( uint32_t j = 0; j + 2 <= reportCount; j += 2 )
+            {
+                const __m128i row0 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( rawReports[j + 0] + regionOffset + c * sizeof( uint64_t ) ) );
+                const __m128i row1 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( rawReports[j + 1] + regionOffset + c * sizeof( uint64_t ) ) );
+
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( columns + 0 * columnStride + j ), _mm_unpacklo_epi64( row0, row1 ) );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( columns + 1 * columnStride + j ), _mm_unpackhi_epi64( row0, row1 ) );
+            }
+        }
+
+        const uint32_t blockCounters = counterCount - counterCount % 2;
+        const uint32_t blockReports  = reportCount - reportCount % 2;
+
+        // Counters after full blocks
+        TransposeRegionScalar<uint64_t>( rawReports, reportCount, regionOffset + blockCounters * sizeof( uint64_t ), counterCount - blockCounters, columnStride, outColumns + static_cast<size_t>( blockCounters ) * columnStride );
+
+        // Reports after full blocks
+        TransposeRegionScalar<uint64_t>( rawReports + blockReports, reportCount - blockReports, regionOffset, blockCounters, columnStride, outColumns + blockReports );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     TransposeRegion32Avx2
+    //
+    // Description:
+    //     AVX2 transpose kernel for 32 bit counters.
+    //
+    // Input:
+    //     const uint8_t* const* rawReports   - (IN) raw reports
+    //     uint32_t              reportCount  - reports count
+    //     uint32_t              regionOffset - region offset in a report
+    //     uint32_t              counterCount - region counters count
+    //     uint32_t              columnStride - column size in values
+    //     uint64_t*             outColumns   - (OUT) region counter columns
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_AVX2 void CReportKernels::TransposeRegion32Avx2( const uint8_t* const* rawReports, uint32_t reportCount, uint32_t regionOffset, uint32_t counterCount, uint32_t columnStride, uint64_t* outColumns )
+    {
+        // 4 x 4 blocks: 4 counters of 4 reports
+        for( uint32_t c = 0; c + 4 <= counterCount; c += 4 )
+        {
+            uint64_t* columns = outColumns + static_cast<size_t>( c ) * columnStride;
+
+            for( uint32_t j = 0; j + 4 <= reportCount; j += 4 )
+            {
+                const __m128i row0 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( rawReports[j + 0] + regionOffset + c * sizeof( uint32_t ) ) );
+                const __m128i row1 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( rawReports[j + 1] + regionOffset + c * sizeof( uint32_t ) ) );
+                const __m128i row2 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( rawReports[j + 2] + regionOffset + c * sizeof( uint32_t ) ) );
+                const __m128i row3 = _mm_loadu_si128( reinterpret_cast<const __m128i*>( rawReports[j + 3] + regionOffset + c * sizeof( uint32_t ) ) );
+
+                // ( r0c0, r1c0, r0c1, r1c1 ), ( r0c2, r1c2, r0c3, r1c3 ) and the same for rows 2 and 3
+                const __m128i low01  = _mm_unpacklo_epi32( row0, row1 );
+                const __m128i high01 = _mm_unpackhi_epi32( row0, row1 );
+                const __m128i low23  = _mm_unpacklo_epi32( row2, row3 );
+                const __m128i high23 = _mm_unpackhi_epi32( row2, row3 );
+
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( columns + 0 * columnStride + j ), _mm256_cvtepu32_epi64( _mm_unpacklo_epi64( low01, low23 ) ) );
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( columns + 1 * columnStride + j ), _mm256_cvtepu32_epi64( _mm_unpackhi_epi64( low01, low23 ) ) );
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( columns + 2 * columnStride + j ), _mm256_cvtepu32_epi64( _mm_unpacklo_epi64( high01, high23 ) ) );
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( columns + 3 * columnStride + j ), _mm256_cvtepu32_epi64( _mm_unpackhi_epi64( high01, high23 ) ) );
+            }
+        }
+
+        const uint32_t blockCounters = counterCount - counterCount % 4;
+        const uint32_t blockReports  = reportCount - reportCount % 4;
+
+        // Counters after full blocks
+        TransposeRegionScalar<uint32_t>( rawReports, reportCount, regionOffset + blockCounters * sizeof( uint32_t ), counterCount - blockCounters, columnStride, outColumns + static_cast<size_t>( blockCounters ) * columnStride );
+
+        // Reports after full blocks
+        TransposeRegionScalar<uint32_t>( rawReports + blockReports, reportCount - blockReports, regionOffset, blockCounters, columnStride, outColumns + blockReports );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     TransposeRegion64Avx2
+    //
+    // Description:
+    //     AVX2 transpose kernel for 64 bit counters.
+    //
+    // Input:
+    //     const uint8_t* const* rawReports   - (IN) raw reports
+    //     uint32_t              reportCount  - reports count
+    //     uint32_t              regionOffset - region offset in a report
+    //     uint32_t              counterCount - region counters count
+    //     uint32_t              columnStride - column size in values
+    //     uint64_t*             outColumns   - (OUT) region counter columns
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_AVX2 void CReportKernels::TransposeRegion64Avx2( const uint8_t* const* rawReports, uint32_t reportCount, uint32_t regionOffset, uint32_t counterCount, uint32_t columnStride, uint64_t* outColumns )
+    {
+        // 4 x 4 blocks: 4 counters of 4 reports
+        for( uint32_t c = 0; c + 4 <= counterCount; c += 4 )
+        {
+            uint64_t* columns = outColumns + static_cast<size_t>( c ) * columnStride;
+
+            for( uint32_t j = 0; j + 4 <= reportCount; j += 4 )
+            {
+                const __m256i row0 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( rawReports[j + 0] + regionOffset + c * sizeof( uint64_t ) ) );
+                const __m256i row1 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( rawReports[j + 1] + regionOffset + c * sizeof( uint64_t ) ) );
+                const __m256i row2 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( rawReports[j + 2] + regionOffset + c * sizeof( uint64_t ) ) );
+                const __m256i row3 = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( rawReports[j + 3] + regionOffset + c * sizeof( uint64_t ) ) );
+
+                // ( r0c0, r1c0, r0c2, r1c2 ), ( r0c1, r1c1, r0c3, r1c3 ) and the same for rows 2 and 3
+                const __m256i low01  = _mm256_unpacklo_epi64( row0, row1 );
+                const __m256i high01 = _mm256_unpackhi_epi64( row0, row1 );
+                const __m256i low23  = _mm256_unpacklo_epi64( row2, row3 );
+                const __m256i high23 = _mm256_unpackhi_epi64( row2, row3 );
+
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( columns + 0 * columnStride + j ), _mm256_permute2x128_si256( low01, low23, 0x20 ) );
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( columns + 1 * columnStride + j ), _mm256_permute2x128_si256( high01, high23, 0x20 ) );
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( columns + 2 * columnStride + j ), _mm256_permute2x128_si256( low01, low23, 0x31 ) );
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( columns + 3 * columnStride + j ), _mm256_permute2x128_si256( high01, high23, 0x31 ) );
+            }
+        }
+
+        const uint32_t blockCounters = counterCount - counterCount % 4;
+        const uint32_t blockReports  = reportCount - reportCount % 4;
+
+        // Counters after full blocks
+        TransposeRegionScalar<uint64_t>( rawReports, reportCount, regionOffset + blockCounters * sizeof( uint64_t ), counterCount - blockCounters, columnStride, outColumns + static_cast<size_t>( blockCounters ) * columnStride );
+
+        // Reports after full blocks
+        TransposeRegionScalar<uint64_t>( rawReports + blockReports, reportCount - blockReports, regionOffset, blockCounters, columnStride, outColumns + blockReports );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     SelectReports32Sse42
+    //
+    // Description:
+    //     SSE4.2 selection kernel for 32 bit fields, 4 reports at a time.
+    //
+    // Input:
+    //     const uint8_t* fields       - (IN) field of the first report
+    //     uint32_t       reportCount  - reports count
+    //     uint32_t       reportSize   - single report size in bytes
+    //     uint64_t       fieldMask    - mask applied to the field before comparison
+    //     uint64_t       value        - value of the masked field of selected reports
+    //     uint8_t*       outSelection - (OUT) selection
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_SSE42 void CReportKernels::SelectReports32Sse42( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection )
+    {
+        const __m128i maskV  = _mm_set1_epi32( static_cast<int32_t>( fieldMask ) );
+        const __m128i valueV = _mm_set1_epi32( static_cast<int32_t>( value ) );
+        uint32_t      j      = 0;
+
+        for( ; j + 4 <= reportCount; j += 4 )
+        {
+            const uint8_t* field  = fields + static_cast<size_t>( j ) * reportSize;
+            const __m128i  values = _mm_set_epi32(
+                *reinterpret_cast<const int32_t*>( field + 3 * reportSize ),
+                *reinterpret_cast<const int32_t*>( field + 2 * reportSize ),
+                *reinterpret_cast<const int32_t*>( field + reportSize ),
+                *reinterpret_cast<const int32_t*>( field ) );
+
+            const int selected = _mm_movemask_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( values, maskV ), valueV ) ) );
+
+            for( uint32_t k = 0; k < 4; ++k )
+            {
+                outSelection[j + k] = static_cast<uint8_t>( ( selected >> k ) & 1 );
+            }
+        }
+
+        SelectReportsScalar<uint32_t>( fields + static_cast<size_t>( j ) * reportSize, reportCount - j, reportSize, fieldMask, value, outSelection + j );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     SelectReports64Sse42
+    //
+    // Description:
+    //     SSE4.2 selection kernel for 64 bit fields, 2 reports at a time.
+    //
+    // Input:
+    //     const uint8_t* fields       - (IN) field of the first report
+    //     uint32_t       reportCount  - reports count
+    //     uint32_t       reportSize   - single report size in bytes
+    //     uint64_t       fieldMask    - mask applied to the field before comparison
+    //     uint64_t       value        - value of the masked field of selected reports
+    //     uint8_t*       outSelection - (OUT) selection
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_SSE42 void CReportKernels::SelectReports64Sse42( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection )
+    {
+        const __m128i maskV  = _mm_set1_epi64x( static_cast<int64_t>( fieldMask ) );
+        const __m128i valueV = _mm_set1_epi64x( static_cast<int64_t>( value ) );
+        uint32_t      j      = 0;
+
+        for( ; j + 2 <= reportCount; j += 2 )
+        {
+            const uint8_t* field  = fields + static_cast<size_t>( j ) * reportSize;
+            const __m128i  values = _mm_set_epi64x(
+                *reinterpret_cast<const int64_t*>( field + reportSize ),
+                *reinterpret_cast<const int64_t*>( field ) );
+
+            const int selected = _mm_movemask_pd( _mm_castsi128_pd( _mm_cmpeq_epi64( _mm_and_si128( values, maskV ), valueV ) ) );
+
+            outSelection[j]     = static_cast<uint8_t>( selected & 1 );
+            outSelection[j + 1] = static_cast<uint8_t>( ( selected >> 1 ) & 1 );
+        }
+
+        SelectReportsScalar<uint64_t>( fields + static_cast<size_t>( j ) * reportSize, reportCount - j, reportSize, fieldMask, value, outSelection + j );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     SelectReports32Avx2
+    //
+    // Description:
+    //     AVX2 selection kernel for 32 bit fields, fields of 8 reports are gathered
+    //     with a single instruction.
+    //
+    // Input:
+    //     const uint8_t* fields       - (IN) field of the first report
+    //     uint32_t       reportCount  - reports count
+    //     uint32_t       reportSize   - single report size in bytes
+    //     uint64_t       fieldMask    - mask applied to the field before comparison
+    //     uint64_t       value        - value of the masked field of selected reports
+    //     uint8_t*       outSelection - (OUT) selection
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_AVX2 void CReportKernels::SelectReports32Avx2( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection )
+    {
+        const __m256i maskV   = _mm256_set1_epi32( static_cast<int32_t>( fieldMask ) );
+        const __m256i valueV  = _mm256_set1_epi32( static_cast<int32_t>( value ) );
+        const __m256i offsets = _mm256_mullo_epi32( _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 ), _mm256_set1_epi32( static_cast<int32_t>( reportSize ) ) );
+        uint32_t      j       = 0;
+
+        for( ; j + 8 <= reportCount; j += 8 )
+        {
+            const __m256i values   = _mm256_i32gather_epi32( reinterpret_cast<const int*>( fields + static_cast<size_t>( j ) * reportSize ), offsets, 1 );
+            const int     selected = _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( _mm256_and_si256( values, maskV ), valueV ) ) );
+
+            for( uint32_t k = 0; k < 8; ++k )
+            {
+                outSelection[j + k] = static_cast<uint8_t>( ( selected >> k ) & 1 );
+            }
+        }
+
+        SelectReportsScalar<uint32_t>( fields + static_cast<size_t>( j ) * reportSize, reportCount - j, reportSize, fieldMask, value, outSelection + j );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     SelectReports64Avx2
+    //
+    // Description:
+    //     AVX2 selection kernel for 64 bit fields, fields of 4 reports are gathered
+    //     with a single instruction.
+    //
+    // Input:
+    //     const uint8_t* fields       - (IN) field of the first report
+    //     uint32_t       reportCount  - reports count
+    //     uint32_t       reportSize   - single report size in bytes
+    //     uint64_t       fieldMask    - mask applied to the field before comparison
+    //     uint64_t       value        - value of the masked field of selected reports
+    //     uint8_t*       outSelection - (OUT) selection
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_AVX2 void CReportKernels::SelectReports64Avx2( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection )
+    {
+        const __m256i maskV   = _mm256_set1_epi64x( static_cast<int64_t>( fieldMask ) );
+        const __m256i valueV  = _mm256_set1_epi64x( static_cast<int64_t>( value ) );
+        const __m128i offsets = _mm_mullo_epi32( _mm_setr_epi32( 0, 1, 2, 3 ), _mm_set1_epi32( static_cast<int32_t>( reportSize ) ) );
+        uint32_t      j       = 0;
+
+        for( ; j + 4 <= reportCount; j += 4 )
+        {
+            const __m256i values   = _mm256_i32gather_epi64( reinterpret_cast<const long long*>( fields + static_cast<size_t>( j ) * reportSize ), offsets, 1 );
+            const int     selected = _mm256_movemask_pd( _mm256_castsi256_pd( _mm256_cmpeq_epi64( _mm256_and_si256( values, maskV ), valueV ) ) );
+
+            for( uint32_t k = 0; k < 4; ++k )
+            {
+                outSelection[j + k] = static_cast<uint8_t>( ( selected >> k ) & 1 );
+            }
+        }
+
+        SelectReportsScalar<uint64_t>( fields + static_cast<size_t>( j ) * reportSize, reportCount - j, reportSize, fieldMask, value, outSelection + j );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     ExtractFields32Sse42
+    //
+    // Description:
+    //     SSE4.2 extraction kernel for 32 bit fields, 4 reports at a time.
+    //
+    // Input:
+    //     const uint8_t* fields      - (IN) field of the first report
+    //     uint32_t       reportCount - reports count
+    //     uint32_t       reportSize  - single report size in bytes
+    //     uint32_t       fieldShift  - right shift applied to the field, less than 64
+    //     uint64_t       fieldMask   - mask applied to the shifted field
+    //     uint64_t*      outValues   - (OUT) values
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_SSE42 void CReportKernels::ExtractFields32Sse42( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues )
+    {
+        // Zero extended field shifted by 32 bits or more is 0, as 32 bit vector shift
+        const __m128i shiftV = _mm_cvtsi32_si128( static_cast<int32_t>( fieldShift ) );
+        const __m128i maskV  = _mm_set1_epi32( static_cast<int32_t>( fieldMask & 0xFFFFFFFFULL ) );
+        uint32_t      j      = 0;
+
+        for( ; j + 4 <= reportCount; j += 4 )
+        {
+            const uint8_t* field  = fields + static_cast<size_t>( j ) * reportSize;
+            const __m128i  values = _mm_set_epi32(
+                *reinterpret_cast<const int32_t*>( field + 3 * reportSize ),
+                *reinterpret_cast<const int32_t*>( field + 2 * reportSize ),
+                *reinterpret_cast<const int32_t*>( field + reportSize ),
+                *reinterpret_cast<const int32_t*>( field ) );
+
+            const __m128i extracted = _mm_and_si128( _mm_srl_epi32( values, shiftV ), maskV );
+
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( outValues + j ), _mm_cvtepu32_epi64( extracted ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( outValues + j + 2 ), _mm_cvtepu32_epi64( _mm_srli_si128( extracted, 8 ) ) );
+        }
+
+        ExtractFieldsScalar<uint32_t>( fields + static_cast<size_t>( j ) * reportSize, reportCount - j, reportSize, fieldShift, fieldMask, outValues + j );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     ExtractFields64Sse42
+    //
+    // Description:
+    //     SSE4.2 extraction kernel for 64 bit fields, 2 reports at a time.
+    //
+    // Input:
+    //     const uint8_t* fields      - (IN) field of the first report
+    //     uint32_t       reportCount - reports count
+    //     uint32_t       reportSize  - single report size in bytes
+    //     uint32_t       fieldShift  - right shift applied to the field, less than 64
+    //     uint64_t       fieldMask   - mask applied to the shifted field
+    //     uint64_t*      outValues   - (OUT) values
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_SSE42 void CReportKernels::ExtractFields64Sse42( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues )
+    {
+        const __m128i shiftV = _mm_cvtsi32_si128( static_cast<int32_t>( fieldShift ) );
+        const __m128i maskV  = _mm_set1_epi64x( static_cast<int64_t>( fieldMask ) );
+        uint32_t      j      = 0;
+
+        for( ; j + 2 <= reportCount; j += 2 )
+        {
+            const uint8_t* field  = fields + static_cast<size_t>( j ) * reportSize;
+            const __m128i  values = _mm_set_epi64x(
+                *reinterpret_cast<const int64_t*>( field + reportSize ),
+                *reinterpret_cast<const int64_t*>( field ) );
+
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( outValues + j ), _mm_and_si128( _mm_srl_epi64( values, shiftV ), maskV ) );
+        }
+
+        ExtractFieldsScalar<uint64_t>( fields + static_cast<size_t>( j ) * reportSize, reportCount - j, reportSize, fieldShift, fieldMask, outValues + j );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     ExtractFields32Avx2
+    //
+    // Description:
+    //     AVX2 extraction kernel for 32 bit fields, fields of 8 reports are gathered
+    //     with a single instruction.
+    //
+    // Input:
+    //     const uint8_t* fields      - (IN) field of the first report
+    //     uint32_t       reportCount - reports count
+    //     uint32_t       reportSize  - single report size in bytes
+    //     uint32_t       fieldShift  - right shift applied to the field, less than 64
+    //     uint64_t       fieldMask   - mask applied to the shifted field
+    //     uint64_t*      outValues   - (OUT) values
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_AVX2 void CReportKernels::ExtractFields32Avx2( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues )
+    {
+        // Zero extended field shifted by 32 bits or more is 0, as 32 bit vector shift
+        const __m128i shiftV  = _mm_cvtsi32_si128( static_cast<int32_t>( fieldShift ) );
+        const __m256i maskV   = _mm256_set1_epi32( static_cast<int32_t>( fieldMask & 0xFFFFFFFFULL ) );
+        const __m256i offsets = _mm256_mullo_epi32( _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 ), _mm256_set1_epi32( static_cast<int32_t>( reportSize ) ) );
+        uint32_t      j       = 0;
+
+        for( ; j + 8 <= reportCount; j += 8 )
+        {
+            const __m256i values    = _mm256_i32gather_epi32( reinterpret_cast<const int*>( fields + static_cast<size_t>( j ) * reportSize ), offsets, 1 );
+            const __m256i extracted = _mm256_and_si256( _mm256_srl_epi32( values, shiftV ), maskV );
+
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( outValues + j ), _mm256_cvtepu32_epi64( _mm256_castsi256_si128( extracted ) ) );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( outValues + j + 4 ), _mm256_cvtepu32_epi64( _mm256_extracti128_si256( extracted, 1 ) ) );
+        }
+
+        ExtractFieldsScalar<uint32_t>( fields + static_cast<size_t>( j ) * reportSize, reportCount - j, reportSize, fieldShift, fieldMask, outValues + j );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     ExtractFields64Avx2
+    //
+    // Description:
+    //     AVX2 extraction kernel for 64 bit fields, fields of 4 reports are gathered
+    //     with a single instruction.
+    //
+    // Input:
+    //     const uint8_t* fields      - (IN) field of the first report
+    //     uint32_t       reportCount - reports count
+    //     uint32_t       reportSize  - single report size in bytes
+    //     uint32_t       fieldShift  - right shift applied to the field, less than 64
+    //     uint64_t       fieldMask   - mask applied to the shifted field
+    //     uint64_t*      outValues   - (OUT) values
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_AVX2 void CReportKernels::ExtractFields64Avx2( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues )
+    {
+        const __m128i shiftV  = _mm_cvtsi32_si128( static_cast<int32_t>( fieldShift ) );
+        const __m256i maskV   = _mm256_set1_epi64x( static_cast<int64_t>( fieldMask ) );
+        const __m128i offsets = _mm_mullo_epi32( _mm_setr_epi32( 0, 1, 2, 3 ), _mm_set1_epi32( static_cast<int32_t>( reportSize ) ) );
+        uint32_t      j       = 0;
+
+        for( ; j + 4 <= reportCount; j += 4 )
+        {
+            const __m256i values = _mm256_i32gather_epi64( reinterpret_cast<const long long*>( fields + static_cast<size_t>( j ) * reportSize ), offsets, 1 );
+
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( outValues + j ), _mm256_and_si256( _mm256_srl_epi64( values, shiftV ), maskV ) );
+        }
+
+        ExtractFieldsScalar<uint64_t>( fields + static_cast<size_t>( j ) * reportSize, reportCount - j, reportSize, fieldShift, fieldMask, outValues + j );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     InterpolateCounters32Sse42
+    //
+    // Description:
+    //     SSE4.2 interpolation kernel for 32 bit counters, 4 counters at a time.
+    //     Even and odd counters are multiplied by alpha separately to 64 bit products.
+    //
+    // Input:
+    //     const uint8_t* prev     - (IN) counters of the previous report
+    //     const uint8_t* last     - (IN) counters of the last report
+    //     uint32_t       count    - counters count
+    //     uint64_t       alphaQ32 - interpolation point in Q32, less than 1 << 32
+    //     uint8_t*       out      - (OUT) interpolated counters
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_SSE42 void CReportKernels::InterpolateCounters32Sse42( const uint8_t* prev, const uint8_t* last, uint32_t count, uint64_t alphaQ32, uint8_t* out )
+    {
+        const __m128i alphaV = _mm_set1_epi64x( static_cast<int64_t>( alphaQ32 ) );
+        uint32_t      j      = 0;
+
+        for( ; j + 4 <= count; j += 4 )
+        {
+            const __m128i valuePrev = _mm_loadu_si128( reinterpret_cast<const __m128i*>( prev + j * sizeof( uint32_t ) ) );
+            const __m128i valueLast = _mm_loadu_si128( reinterpret_cast<const __m128i*>( last + j * sizeof( uint32_t ) ) );
+            const __m128i delta     = _mm_sub_epi32( valueLast, valuePrev );
+            const __m128i even      = _mm_srli_epi64( _mm_mul_epu32( delta, alphaV ), 32 );
+            const __m128i odd       = _mm_mul_epu32( _mm_srli_epi64( delta, 32 ), alphaV );
+
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( out + j * sizeof( uint32_t ) ), _mm_add_epi32( valuePrev, _mm_blend_epi16( even, odd, 0xCC ) ) );
+        }
+
+        InterpolateCountersScalar<uint32_t>( prev + j * sizeof( uint32_t ), last + j * sizeof( uint32_t ), count - j, alphaQ32, out + j * sizeof( uint32_t ) );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     InterpolateCounters64Sse42
+    //
+    // Description:
+    //     SSE4.2 interpolation kernel for 64 bit counters, 2 counters at a time.
+    //
+    // Input:
+    //     const uint8_t* prev     - (IN) counters of the previous report
+    //     const uint8_t* last     - (IN) counters of the last report
+    //     uint32_t       count    - counters count
+    //     uint64_t       alphaQ32 - interpolation point in Q32, less than 1 << 32
+    //     uint8_t*       out      - (OUT) interpolated counters
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_SSE42 void CReportKernels::InterpolateCounters64Sse42( const uint8_t* prev, const uint8_t* last, uint32_t count, uint64_t alphaQ32, uint8_t* out )
+    {
+        const __m128i alphaV = _mm_set1_epi64x( static_cast<int64_t>( alphaQ32 ) );
+        uint32_t      j      = 0;
+
+        for( ; j + 2 <= count; j += 2 )
+        {
+            const __m128i valuePrev = _mm_loadu_si128( reinterpret_cast<const __m128i*>( prev + j * sizeof( uint64_t ) ) );
+            const __m128i valueLast = _mm_loadu_si128( reinterpret_cast<const __m128i*>( last + j * sizeof( uint64_t ) ) );
+            const __m128i delta     = _mm_sub_epi64( valueLast, valuePrev );
+            const __m128i low       = _mm_srli_epi64( _mm_mul_epu32( delta, alphaV ), 32 );
+            const __m128i high      = _mm_mul_epu32( _mm_srli_epi64( delta, 32 ), alphaV );
+
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( out + j * sizeof( uint64_t ) ), _mm_add_epi64( valuePrev, _mm_add_epi64( high, low ) ) );
+        }
+
+        InterpolateCountersScalar<uint64_t>( prev + j * sizeof( uint64_t ), last + j * sizeof( uint64_t ), count - j, alphaQ32, out + j * sizeof( uint64_t ) );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     InterpolateCounters32Avx2
+    //
+    // Description:
+    //     AVX2 interpolation kernel for 32 bit counters, 8 counters at a time.
+    //     Even and odd counters are multiplied by alpha separately to 64 bit products.
+    //
+    // Input:
+    //     const uint8_t* prev     - (IN) counters of the previous report
+    //     const uint8_t* last     - (IN) counters of the last report
+    //     uint32_t       count    - counters count
+    //     uint64_t       alphaQ32 - interpolation point in Q32, less than 1 << 32
+    //     uint8_t*       out      - (OUT) interpolated counters
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_AVX2 void CReportKernels::InterpolateCounters32Avx2( const uint8_t* prev, const uint8_t* last, uint32_t count, uint64_t alphaQ32, uint8_t* out )
+    {
+        const __m256i alphaV = _mm256_set1_epi64x( static_cast<int64_t>( alphaQ32 ) );
+        uint32_t      j      = 0;
+
+        for( ; j + 8 <= count; j += 8 )
+        {
+            const __m256i valuePrev = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( prev + j * sizeof( uint32_t ) ) );
+            const __m256i valueLast = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( last + j * sizeof( uint32_t ) ) );
+            const __m256i delta     = _mm256_sub_epi32( valueLast, valuePrev );
+            const __m256i even      = _mm256_srli_epi64( _mm256_mul_epu32( delta, alphaV ), 32 );
+            const __m256i odd       = _mm256_mul_epu32( _mm256_srli_epi64( delta, 32 ), alphaV );
+
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + j * sizeof( uint32_t ) ), _mm256_add_epi32( valuePrev, _mm256_blend_epi32( even, odd, 0xAA ) ) );
+        }
+
+        InterpolateCountersScalar<uint32_t>( prev + j * sizeof( uint32_t ), last + j * sizeof( uint32_t ), count - j, alphaQ32, out + j * sizeof( uint32_t ) );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernels
+    //
+    // Method:
+    //     InterpolateCounters64Avx2
+    //
+    // Description:
+    //     AVX2 interpolation kernel for 64 bit counters, 4 counters at a time.
+    //
+    // Input:
+    //     const uint8_t* prev     - (IN) counters of the previous report
+    //     const uint8_t* last     - (IN) counters of the last report
+    //     uint32_t       count    - counters count
+    //     uint64_t       alphaQ32 - interpolation point in Q32, less than 1 << 32
+    //     uint8_t*       out      - (OUT) interpolated counters
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    MD_TARGET_AVX2 void CReportKernels::InterpolateCounters64Avx2( const uint8_t* prev, const uint8_t* last, uint32_t count, uint64_t alphaQ32, uint8_t* out )
+    {
+        const __m256i alphaV = _mm256_set1_epi64x( static_cast<int64_t>( alphaQ32 ) );
+        uint32_t      j      = 0;
+
+        for( ; j + 4 <= count; j += 4 )
+        {
+            const __m256i valuePrev = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( prev + j * sizeof( uint64_t ) ) );
+            const __m256i valueLast = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( last + j * sizeof( uint64_t ) ) );
+            const __m256i delta     = _mm256_sub_epi64( valueLast, valuePrev );
+            const __m256i low       = _mm256_srli_epi64( _mm256_mul_epu32( delta, alphaV ), 32 );
+            const __m256i high      = _mm256_mul_epu32( _mm256_srli_epi64( delta, 32 ), alphaV );
+
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + j * sizeof( uint64_t ) ), _mm256_add_epi64( valuePrev, _mm256_add_epi64( high, low ) ) );
+        }
+
+        InterpolateCountersScalar<uint64_t>( prev + j * sizeof( uint64_t ), last + j * sizeof( uint64_t ), count - j, alphaQ32, out + j * sizeof( uint64_t ) );
+    }
+#else
+    // Non x86 CPUs use only scalar kernels, DetectKernelLevel never selects these ones.
+    void CReportKernels::CalculateDeltas32Sse42( const uint8_t* last, const uint8_t* prev, uint32_t count, uint64_t wrapBit, uint64_t wrapBorrow, uint64_t* outDeltas )
+    {
+        CalculateDeltasScalar<uint32_t>( last, prev, count, wrapBit, wrapBorrow, outDeltas );
+    }
+
+    void CReportKernels::CalculateDeltas64Sse42( const uint8_t* last, const uint8_t* prev, uint32_t count, uint64_t wrapBit, uint64_t wrapBorrow, uint64_t* outDeltas )
+    {
+        CalculateDeltasScalar<uint64_t>( last, prev, count, wrapBit, wrapBorrow, outDeltas );
+    }
+
+    void CReportKernels::CalculateDeltas32Avx2( const uint8_t* last, const uint8_t* prev, uint32_t count, uint64_t wrapBit, uint64_t wrapBorrow, uint64_t* outDeltas )
+    {
+        CalculateDeltasScalar<uint32_t>( last, prev, count, wrapBit, wrapBorrow, outDeltas );
+    }
+
+    void CReportKernels::CalculateDeltas64Avx2( const uint8_t* last, const uint8_t* prev, uint32_t count, uint64_t wrapBit, uint64_t wrapBorrow, uint64_t* outDeltas )
+    {
+        CalculateDeltasScalar<uint64_t>( last, prev, count, wrapBit, wrapBorrow, outDeltas );
+    }
+
+    void CReportKernels::TransposeRegion32Sse42( const uint8_t* const* rawReports, uint32_t reportCount, uint32_t regionOffset, uint32_t counterCount, uint32_t columnStride, uint64_t* outColumns )
+    {
+        TransposeRegionScalar<uint32_t>( rawReports, reportCount, regionOffset, counterCount, columnStride, outColumns );
+    }
+
+    void CReportKernels::TransposeRegion64Sse42( const uint8_t* const* rawReports, uint32_t reportCount, uint32_t regionOffset, uint32_t counterCount, uint32_t columnStride, uint64_t* outColumns )
+    {
+        TransposeRegionScalar<uint64_t>( rawReports, reportCount, regionOffset, counterCount, columnStride, outColumns );
+    }
+
+    void CReportKernels::TransposeRegion32Avx2( const uint8_t* const* rawReports, uint32_t reportCount, uint32_t regionOffset, uint32_t counterCount, uint32_t columnStride, uint64_t* outColumns )
+    {
+        TransposeRegionScalar<uint32_t>( rawReports, reportCount, regionOffset, counterCount, columnStride, outColumns );
+    }
+
+    void CReportKernels::TransposeRegion64Avx2( const uint8_t* const* rawReports, uint32_t reportCount, uint32_t regionOffset, uint32_t counterCount, uint32_t columnStride, uint64_t* outColumns )
+    {
+        TransposeRegionScalar<uint64_t>( rawReports, reportCount, regionOffset, counterCount, columnStride, outColumns );
+    }
+    void CReportKernels::SelectReports32Sse42( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection )
+    {
+        SelectReportsScalar<uint32_t>( fields, reportCount, reportSize, fieldMask, value, outSelection );
+    }
+
+    void CReportKernels::SelectReports64Sse42( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection )
+    {
+        SelectReportsScalar<uint64_t>( fields, reportCount, reportSize, fieldMask, value, outSelection );
+    }
+
+    void CReportKernels::SelectReports32Avx2( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection )
+    {
+        SelectReportsScalar<uint32_t>( fields, reportCount, reportSize, fieldMask, value, outSelection );
+    }
+
+    void CReportKernels::SelectReports64Avx2( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint64_t fieldMask, uint64_t value, uint8_t* outSelection )
+    {
+        SelectReportsScalar<uint64_t>( fields, reportCount, reportSize, fieldMask, value, outSelection );
+    }
+    void CReportKernels::ExtractFields32Sse42( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues )
+    {
+        ExtractFieldsScalar<uint32_t>( fields, reportCount, reportSize, fieldShift, fieldMask, outValues );
+    }
+
+    void CReportKernels::ExtractFields64Sse42( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues )
+    {
+        ExtractFieldsScalar<uint64_t>( fields, reportCount, reportSize, fieldShift, fieldMask, outValues );
+    }
+
+    void CReportKernels::ExtractFields32Avx2( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues )
+    {
+        ExtractFieldsScalar<uint32_t>( fields, reportCount, reportSize, fieldShift, fieldMask, outValues );
+    }
+
+    void CReportKernels::ExtractFields64Avx2( const uint8_t* fields, uint32_t reportCount, uint32_t reportSize, uint32_t fieldShift, uint64_t fieldMask, uint64_t* outValues )
+    {
+        ExtractFieldsScalar<uint64_t>( fields, reportCount, reportSize, fieldShift, fieldMask, outValues );
+    }
+    void CReportKernels::InterpolateCounters32Sse42( const uint8_t* prev, const uint8_t* last, uint32_t count, uint64_t alphaQ32, uint8_t* out )
+    {
+        InterpolateCountersScalar<uint32_t>( prev, last, count, alphaQ32, out );
+    }
+
+    void CReportKernels::InterpolateCounters64Sse42( const uint8_t* prev, const uint8_t* last, uint32_t count, uint64_t alphaQ32, uint8_t* out )
+    {
+        InterpolateCountersScalar<uint64_t>( prev, last, count, alphaQ32, out );
+    }
+
+    void CReportKernels::InterpolateCounters32Avx2( const uint8_t* prev, const uint8_t* last, uint32_t count, uint64_t alphaQ32, uint8_t* out )
+    {
+        InterpolateCountersScalar<uint32_t>( prev, last, count, alphaQ32, out );
+    }
+
+    void CReportKernels::InterpolateCounters64Avx2( const uint8_t* prev, const uint8_t* last, uint32_t count, uint64_t alphaQ32, uint8_t* out )
+    {
+        InterpolateCountersScalar<uint64_t>( prev, last, count, alphaQ32, out );
+    }
+#endif
+} // namespace MetricsDiscoveryInternal
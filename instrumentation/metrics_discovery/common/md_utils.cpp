@@ -22,6 +22,8 @@ SPDX-License-Identifier: MIT
 #include "md_register_set.h"
 #include "md_metric_enumerator.h"
 #include "md_metric_prototype.h"
+#include "md_range_index.h"
+#include "md_stream_calculation.h"
 
 #include <cmath>
 #include <cstring>
@@ -1529,6 +1531,8 @@ namespace MetricsDiscoveryInternal
     template void ClearVector( std::vector<IOverride_1_2*>& );
     template void ClearVector( std::vector<CMetricEnumerator*>& );
     template void ClearVector( std::vector<CMetricPrototype*>& );
+    template void ClearVector( std::vector<CStreamCalculation*>& );
+    template void ClearVector( std::vector<CRangeIndex*>& );
     template void ClearVector( std::vector<TArchEvent*>& );
     template void ClearVector( std::vector<THwEvent*>& );
     template void ClearVector( std::vector<TMetricPrototypeOptionDescriptorLatest*>& );
@@ -0,0 +1,283 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2026 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+//     File Name:  md_worker_pool.cpp
+
+//     Abstract:   C++ metrics discovery pool of worker threads implementation
+
+#include "md_worker_pool.h"
+#include "md_debug.h"
+
+#include <system_error>
+
+namespace MetricsDiscoveryInternal
+{
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CWorkerPool
+    //
+    // Method:
+    //     CWorkerPool
+    //
+    // Description:
+    //     Constructor. Workers are created by Start.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    CWorkerPool::CWorkerPool()
+        : m_workers()
+        , m_mutex()
+        , m_startCondition()
+        , m_finishCondition()
+        , m_task( nullptr )
+        , m_taskCount( 0 )
+        , m_nextTask( 0 )
+        , m_busyWorkerCount( 0 )
+        , m_generation( 0 )
+        , m_stop( false )
+    {
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CWorkerPool
+    //
+    // Method:
+    //     ~CWorkerPool
+    //
+    // Description:
+    //     Destructor. Stops and joins the workers.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    CWorkerPool::~CWorkerPool()
+    {
+        Stop();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CWorkerPool
+    //
+    // Method:
+    //     Start
+    //
+    // Description:
+    //     Starts workers, so tasks run on the given count of threads including the
+    //     calling one. Workers are restarted only if the thread count changes. If
+    //     a worker can't be started, the pool runs on fewer threads.
+    //
+    // Input:
+    //     uint32_t threadCount - thread count including the calling thread
+    //
+    // Output:
+    //     uint32_t - thread count the pool runs on
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    uint32_t CWorkerPool::Start( uint32_t threadCount )
+    {
+        const uint32_t workerCount = threadCount > 1 ? threadCount - 1 : 0;
+
+        if( workerCount == m_workers.size() )
+        {
+            return GetThreadCount();
+        }
+
+        Stop();
+
+        m_workers.reserve( workerCount );
+
+        for( uint32_t i = 0; i < workerCount; ++i )
+        {
+            try
+            {
+                m_workers.emplace_back( &CWorkerPool::WorkerMain, this, m_generation );
+            }
+            catch( const std::system_error& )
+            {
+                break;
+            }
+        }
+
+        return GetThreadCount();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CWorkerPool
+    //
+    // Method:
+    //     Stop
+    //
+    // Description:
+    //     Stops and joins all the workers, then tasks run on the calling thread only.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CWorkerPool::Stop()
+    {
+        if( m_workers.empty() )
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+            m_stop = true;
+        }
+
+        m_startCondition.notify_all();
+
+        for( auto& worker : m_workers )
+        {
+            worker.join();
+        }
+
+        m_workers.clear();
+        m_stop = false;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CWorkerPool
+    //
+    // Method:
+    //     GetThreadCount
+    //
+    // Description:
+    //     Returns thread count the pool runs on, including the calling thread.
+    //
+    // Output:
+    //     uint32_t - thread count
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    uint32_t CWorkerPool::GetThreadCount() const
+    {
+        return static_cast<uint32_t>( m_workers.size() ) + 1;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CWorkerPool
+    //
+    // Method:
+    //     Run
+    //
+    // Description:
+    //     Runs tasks with indices 0 ... taskCount - 1 on the workers and the calling
+    //     thread, returns when all of them are finished. Tasks must be independent
+    //     from each other. Without workers or with a single task, tasks run on
+    //     the calling thread in order.
+    //
+    // Input:
+    //     uint32_t                               taskCount - task count
+    //     const std::function<void( uint32_t )>& task      - task called with a task index
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CWorkerPool::Run( uint32_t taskCount, const std::function<void( uint32_t )>& task )
+    {
+        if( m_workers.empty() || taskCount <= 1 )
+        {
+            for( uint32_t i = 0; i < taskCount; ++i )
+            {
+                task( i );
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( m_mutex );
+
+            MD_ASSERT( m_busyWorkerCount == 0 );
+
+            m_task            = &task;
+            m_taskCount       = taskCount;
+            m_busyWorkerCount = static_cast<uint32_t>( m_workers.size() );
+            m_nextTask.store( 0, std::memory_order_relaxed );
+            ++m_generation;
+        }
+
+        m_startCondition.notify_all();
+
+        RunTasks();
+
+        std::unique_lock<std::mutex> lock( m_mutex );
+        m_finishCondition.wait( lock, [this] { return m_busyWorkerCount == 0; } );
+
+        m_task      = nullptr;
+        m_taskCount = 0;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CWorkerPool
+    //
+    // Method:
+    //     WorkerMain
+    //
+    // Description:
+    //     Worker thread loop. Waits for the next Run, runs its tasks and signals
+    //     the calling thread when no more tasks are left.
+    //
+    // Input:
+    //     uint64_t generation - generation of the last Run before the worker start
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CWorkerPool::WorkerMain( uint64_t generation )
+    {
+        while( true )
+        {
+            {
+                std::unique_lock<std::mutex> lock( m_mutex );
+                m_startCondition.wait( lock, [this, generation] { return m_stop || m_generation != generation; } );
+
+                if( m_stop )
+                {
+                    return;
+                }
+
+                generation = m_generation;
+            }
+
+            RunTasks();
+
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+
+                if( --m_busyWorkerCount == 0 )
+                {
+                    m_finishCondition.notify_one();
+                }
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CWorkerPool
+    //
+    // Method:
+    //     RunTasks
+    //
+    // Description:
+    //     Runs tasks of the current Run until all of them are taken.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void CWorkerPool::RunTasks()
+    {
+        for( uint32_t i = m_nextTask.fetch_add( 1, std::memory_order_relaxed ); i < m_taskCount; i = m_nextTask.fetch_add( 1, std::memory_order_relaxed ) )
+        {
+            ( *m_task )( i );
+        }
+    }
+} // namespace MetricsDiscoveryInternal
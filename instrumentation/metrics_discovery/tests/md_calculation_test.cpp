@@ -0,0 +1,1278 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2026 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+//     File Name:  md_calculation_test.cpp
+
+//     Abstract:   Test of metric calculation paths which have to give the same results
+//                 as the reference path. Synthetic IoStream raw reports are calculated
+//                 with the first IoStream metric set of an offline metrics device, so
+//                 no adapter is needed. The test is skipped if metrics of the platform
+//                 aren't built. With --benchmark calculation of the metric set with
+//                 native kernels and with interpreted equations is timed.
+
+#include "md_metrics_calculator.h"
+#include "md_calculation_context.h"
+#include "md_metrics.h"
+#include "md_driver_ifc.h"
+#include "md_driver_ifc_offline.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace MetricsDiscovery;
+using namespace MetricsDiscoveryInternal;
+
+namespace
+{
+    constexpr int      TEST_SKIPPED                 = 77; // SKIP_RETURN_CODE of the test
+    constexpr uint32_t TEST_REPORT_COUNT            = 4096;
+    constexpr uint32_t TEST_THREAD_COUNT            = 4;
+    constexpr uint32_t TEST_OVERLAPPING_CALLS       = 4; // CalculateMetrics calls of each thread
+    constexpr uint32_t TEST_BENCHMARK_CALLS         = 50; // CalculateMetrics calls timed by --benchmark
+    constexpr uint32_t TEST_HEADER_SIZE             = 4 * sizeof( uint64_t );
+    constexpr uint32_t TEST_TIMESTAMP_OFFSET        = 1 * sizeof( uint64_t );
+    constexpr uint32_t TEST_CONTEXT_ID_OFFSET       = 2 * sizeof( uint64_t );
+    constexpr uint32_t TEST_GPU_TICKS_OFFSET        = 3 * sizeof( uint64_t );
+    constexpr uint64_t TEST_NS_PER_SECOND           = 1000000000;
+    constexpr uint32_t TEST_PLATFORM_INDEX          = GENERATION_LNL; // OA reports with 64 bit header fields
+    constexpr uint64_t TEST_GPU_TIMESTAMP_FREQUENCY = 19200000;
+    constexpr uint64_t TEST_REPORT_ID_TIMER         = 1 << 19; // Timer report reason, taken by the timer mode aggregation
+
+    // Aggregation window of about 2.5 raw reports, so there are more aggregated reports
+    // than calculated at once by AggregateAndCalculateMetrics
+    constexpr uint64_t TEST_AGGREGATION_WINDOW_TICKS = 2700;
+
+    typedef enum ETestResult
+    {
+        TEST_RESULT_PASSED,
+        TEST_RESULT_FAILED,
+        TEST_RESULT_SKIPPED, // The metric set doesn't support the tested calculation
+    } TTestResult;
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Creates IoStream raw reports with the header of OA report types with 64 bit
+    //     header fields: ascending timestamps and gpu ticks, and a context id changing
+    //     every few reports. Counters are treated as 64 bit values increasing by up to
+    //     the given increment, so 32 bit counters read from them also wrap.
+    //
+    // Input:
+    //     uint32_t rawReportSize    - raw report size in bytes
+    //     uint32_t rawReportCount   - raw report count
+    //     uint64_t counterIncrement - maximum counter increment between raw reports
+    //     uint32_t seed             - random generator seed
+    //
+    // Output:
+    //     std::vector<uint8_t> - raw reports
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    std::vector<uint8_t> CreateRawData( uint32_t rawReportSize, uint32_t rawReportCount, uint64_t counterIncrement, uint32_t seed )
+    {
+        std::mt19937_64       random( seed );
+        std::vector<uint8_t>  rawData( static_cast<size_t>( rawReportSize ) * rawReportCount, 0 );
+        std::vector<uint64_t> counters( ( rawReportSize - TEST_HEADER_SIZE ) / sizeof( uint64_t ), 0 );
+
+        uint64_t timestamp = 1000000 + random() % 1000;
+        uint64_t gpuTicks  = random() % 1000;
+        uint64_t contextId = 1;
+
+        for( uint32_t i = 0; i < rawReportCount; ++i )
+        {
+            uint8_t* rawReport = rawData.data() + static_cast<size_t>( i ) * rawReportSize;
+
+            timestamp += 1000 + random() % 100;
+            gpuTicks += 1500 + random() % 500;
+
+            if( random() % 16 == 0 )
+            {
+                contextId = 1 + random() % 2;
+            }
+
+            memcpy( rawReport + TEST_TIMESTAMP_OFFSET, &timestamp, sizeof( uint64_t ) );
+            memcpy( rawReport + TEST_CONTEXT_ID_OFFSET, &contextId, sizeof( uint64_t ) );
+            memcpy( rawReport + TEST_GPU_TICKS_OFFSET, &gpuTicks, sizeof( uint64_t ) );
+
+            for( size_t j = 0; j < counters.size(); ++j )
+            {
+                counters[j] += random() % counterIncrement;
+                memcpy( rawReport + TEST_HEADER_SIZE + j * sizeof( uint64_t ), &counters[j], sizeof( uint64_t ) );
+            }
+        }
+
+        return rawData;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Compares calculated values. Padding of typed values isn't compared and
+    //     floats are compared bitwise, as all paths have to calculate them the same.
+    //
+    // Input:
+    //     const TTypedValue_1_0* left       - calculated values
+    //     const TTypedValue_1_0* right      - calculated values
+    //     uint32_t               valueCount - value count
+    //
+    // Output:
+    //     bool - true if values are equal
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    bool AreValuesEqual( const TTypedValue_1_0* left, const TTypedValue_1_0* right, uint32_t valueCount )
+    {
+        for( uint32_t i = 0; i < valueCount; ++i )
+        {
+            if( left[i].ValueType != right[i].ValueType )
+            {
+                return false;
+            }
+
+            bool isEqual = true;
+
+            switch( left[i].ValueType )
+            {
+                case VALUE_TYPE_UINT32:
+                    isEqual = left[i].ValueUInt32 == right[i].ValueUInt32;
+                    break;
+
+                case VALUE_TYPE_FLOAT:
+                    isEqual = memcmp( &left[i].ValueFloat, &right[i].ValueFloat, sizeof( float ) ) == 0;
+                    break;
+
+                case VALUE_TYPE_BOOL:
+                    isEqual = left[i].ValueBool == right[i].ValueBool;
+                    break;
+
+                case VALUE_TYPE_CSTRING:
+                    isEqual = ( left[i].ValueCString == nullptr || right[i].ValueCString == nullptr )
+                        ? left[i].ValueCString == right[i].ValueCString
+                        : strcmp( left[i].ValueCString, right[i].ValueCString ) == 0;
+                    break;
+
+                default:
+                    isEqual = left[i].ValueUInt64 == right[i].ValueUInt64;
+                    break;
+            }
+
+            if( !isEqual )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Calculates raw data with a new stream calculation of the metric set.
+    //
+    // Input:
+    //     IMetricSetLatest&             metricSet - metric set
+    //     const std::vector<uint8_t>&   rawData   - raw reports
+    //     std::vector<TTypedValue_1_0>& out       - (OUT) calculated reports
+    //
+    // Output:
+    //     bool - true if calculated
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    bool CalculateStream( IMetricSetLatest& metricSet, const std::vector<uint8_t>& rawData, std::vector<TTypedValue_1_0>& out )
+    {
+        const uint32_t            valueCount        = metricSet.GetParams()->MetricsCount + metricSet.GetParams()->InformationCount;
+        IStreamCalculationLatest* streamCalculation = nullptr;
+        const TTypedValue_1_0*    values            = nullptr;
+        uint32_t                  reportCount       = 0;
+
+        if( metricSet.CreateStreamCalculation( false, &streamCalculation ) != CC_OK )
+        {
+            return false;
+        }
+
+        const bool isCalculated = streamCalculation->Push( rawData.data(), static_cast<uint32_t>( rawData.size() ), &values, nullptr, &reportCount ) == CC_OK;
+
+        if( isCalculated )
+        {
+            out.assign( values, values + static_cast<size_t>( reportCount ) * valueCount );
+        }
+
+        metricSet.DestroyStreamCalculation( streamCalculation );
+        return isCalculated;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Enables or disables native kernels matched for the calculation plan of the
+    //     metric set, so kernels can be compared with the interpreter. The plan has
+    //     to be prepared by a calculation first, kernels are matched again if the
+    //     plan is built again.
+    //
+    // Input:
+    //     IMetricSetLatest& metricSet - metric set
+    //     bool              isEnabled - true to calculate with kernels
+    //
+    // Output:
+    //     uint32_t - count of equations calculated with kernels if enabled
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    uint32_t SetKernelsEnabled( IMetricSetLatest& metricSet, bool isEnabled )
+    {
+        TCalculationPlan* plan        = static_cast<CMetricSet&>( metricSet ).GetCalculationPlan();
+        uint32_t          kernelCount = 0;
+
+        if( plan == nullptr || plan->ReadKernels.empty() )
+        {
+            return 0;
+        }
+
+        for( const uint32_t i : plan->CalculatedMetrics )
+        {
+            kernelCount += ( plan->ReadKernels[i].Type != METRIC_KERNEL_TYPE_NONE ) ? 1 : 0;
+            kernelCount += ( plan->NormKernels[i].Type != METRIC_KERNEL_TYPE_NONE ) ? 1 : 0;
+        }
+
+        plan->HasKernels = isEnabled;
+
+        return kernelCount;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Calculation with native kernels has to give the same reports as with
+    //     interpreted equations.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTestResult TestKernelCalculation( IMetricSetLatest& metricSet, const std::vector<uint8_t>& rawData )
+    {
+        std::vector<TTypedValue_1_0> kernels;
+        std::vector<TTypedValue_1_0> interpreted;
+
+        // Kernels are matched when the plan is prepared by the first calculation
+        if( !CalculateStream( metricSet, rawData, kernels ) )
+        {
+            return TEST_RESULT_FAILED;
+        }
+
+        if( SetKernelsEnabled( metricSet, false ) == 0 )
+        {
+            SetKernelsEnabled( metricSet, true );
+            return TEST_RESULT_SKIPPED;
+        }
+
+        const bool isCalculated = CalculateStream( metricSet, rawData, interpreted );
+
+        SetKernelsEnabled( metricSet, true );
+
+        const bool isEqual = isCalculated &&
+            kernels.size() == interpreted.size() &&
+            AreValuesEqual( kernels.data(), interpreted.data(), static_cast<uint32_t>( kernels.size() ) );
+
+        return isEqual ? TEST_RESULT_PASSED : TEST_RESULT_FAILED;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Times CalculateMetrics of the raw data on a single thread with native
+    //     kernels and with interpreted equations, and prints time per raw report
+    //     of both.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void BenchmarkKernels( IMetricSetLatest& metricSet, const std::vector<uint8_t>& rawData )
+    {
+        const uint32_t rawDataSize = static_cast<uint32_t>( rawData.size() );
+        const uint32_t reportCount = rawDataSize / metricSet.GetParams()->RawReportSize;
+        const uint32_t valueCount  = metricSet.GetParams()->MetricsCount + metricSet.GetParams()->InformationCount;
+
+        std::vector<TTypedValue_1_0> out( static_cast<size_t>( reportCount ) * valueCount );
+        const uint32_t               outSize = static_cast<uint32_t>( out.size() * sizeof( TTypedValue_1_0 ) );
+
+        auto measure = [&]()
+        {
+            uint32_t calculatedCount = 0;
+
+            // Warms up caches and prepares the plan
+            metricSet.CalculateMetrics( rawData.data(), rawDataSize, out.data(), outSize, nullptr, false );
+
+            const auto start = std::chrono::steady_clock::now();
+
+            for( uint32_t i = 0; i < TEST_BENCHMARK_CALLS; ++i )
+            {
+                uint32_t count = 0;
+
+                metricSet.CalculateMetrics( rawData.data(), rawDataSize, out.data(), outSize, &count, false );
+                calculatedCount += count;
+            }
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+            return calculatedCount > 0 ? elapsed.count() / calculatedCount : 0.0;
+        };
+
+        metricSet.SetCalculationThreadCount( 1 );
+
+        const double   kernelsNs   = measure();
+        const uint32_t kernelCount = SetKernelsEnabled( metricSet, false );
+        const double   interpretNs = measure();
+
+        SetKernelsEnabled( metricSet, true );
+
+        printf( "%u metrics, %u equations with kernels\n", metricSet.GetParams()->MetricsCount, kernelCount );
+        printf( "kernels: %8.1f ns per report, interpreted %8.1f ns per report\n", kernelsNs, interpretNs );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Chunked calculation on multiple threads has to give the same reports as
+    //     calculation on a single thread.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTestResult TestChunkedCalculation( IMetricSetLatest& metricSet, const std::vector<uint8_t>& rawData )
+    {
+        std::vector<TTypedValue_1_0> serial;
+        std::vector<TTypedValue_1_0> chunked;
+
+        const bool isCalculated =
+            metricSet.SetCalculationThreadCount( 1 ) == CC_OK &&
+            CalculateStream( metricSet, rawData, serial ) &&
+            metricSet.SetCalculationThreadCount( TEST_THREAD_COUNT ) == CC_OK &&
+            CalculateStream( metricSet, rawData, chunked );
+
+        metricSet.SetCalculationThreadCount( 1 );
+
+        const bool isEqual = isCalculated &&
+            serial.size() == chunked.size() &&
+            AreValuesEqual( serial.data(), chunked.data(), static_cast<uint32_t>( serial.size() ) );
+
+        return isEqual ? TEST_RESULT_PASSED : TEST_RESULT_FAILED;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Raw data pushed to a stream calculation in portions of any size has to give
+    //     the same reports as pushed at once, also after the stream is reset.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTestResult TestStreamCalculation( IMetricSetLatest& metricSet, const std::vector<uint8_t>& rawData )
+    {
+        const uint32_t rawReportSize  = metricSet.GetParams()->RawReportSize;
+        const uint32_t rawReportCount = static_cast<uint32_t>( rawData.size() / rawReportSize );
+        const uint32_t valueCount     = metricSet.GetParams()->MetricsCount + metricSet.GetParams()->InformationCount;
+        const uint32_t portionSizes[] = { 1, 0, 1, 2, 255, 1000 }; // In raw reports, the rest is pushed last
+
+        std::vector<TTypedValue_1_0> whole;
+        std::vector<TTypedValue_1_0> portions;
+        IStreamCalculationLatest*    streamCalculation = nullptr;
+
+        if( !CalculateStream( metricSet, rawData, whole ) ||
+            metricSet.CreateStreamCalculation( false, &streamCalculation ) != CC_OK )
+        {
+            return TEST_RESULT_FAILED;
+        }
+
+        bool isEqual = true;
+
+        for( uint32_t pass = 0; pass < 2 && isEqual; ++pass )
+        {
+            uint32_t first = 0;
+
+            portions.clear();
+
+            for( uint32_t i = 0; i <= std::size( portionSizes ) && isEqual; ++i )
+            {
+                const uint32_t         portionSize = ( i < std::size( portionSizes ) ) ? portionSizes[i] : rawReportCount - first;
+                const TTypedValue_1_0* values      = nullptr;
+                uint32_t               reportCount = 0;
+
+                isEqual = streamCalculation->Push( rawData.data() + static_cast<size_t>( first ) * rawReportSize, portionSize * rawReportSize, &values, nullptr, &reportCount ) == CC_OK;
+
+                if( isEqual )
+                {
+                    portions.insert( portions.end(), values, values + static_cast<size_t>( reportCount ) * valueCount );
+                }
+
+                first += portionSize;
+            }
+
+            isEqual = isEqual &&
+                whole.size() == portions.size() &&
+                AreValuesEqual( whole.data(), portions.data(), static_cast<uint32_t>( whole.size() ) );
+
+            streamCalculation->Reset();
+        }
+
+        metricSet.DestroyStreamCalculation( streamCalculation );
+
+        return isEqual ? TEST_RESULT_PASSED : TEST_RESULT_FAILED;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     CalculateMetrics calls overlapping on multiple threads have to give the same
+    //     reports as sequential calls. A call gets either the session of the metric set,
+    //     continuing the stream of the previous calls, or its own one starting a new stream.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTestResult TestOverlappingCalculation( IMetricSetLatest& metricSet, const std::vector<uint8_t>& rawData )
+    {
+        const TMetricSetParamsLatest* params         = metricSet.GetParams();
+        const uint32_t                rawDataSize    = static_cast<uint32_t>( rawData.size() );
+        const uint32_t                reportValues   = params->MetricsCount + params->InformationCount;
+        const size_t                  valueCount     = static_cast<size_t>( rawDataSize / params->RawReportSize ) * reportValues;
+        const uint32_t                outSize        = static_cast<uint32_t>( valueCount * sizeof( TTypedValue_1_0 ) );
+        uint32_t                      continuedCount = 0;
+
+        std::vector<TTypedValue_1_0> newStream;
+        std::vector<TTypedValue_1_0> continued( valueCount );
+
+        // Sequential calls leave the last raw report saved in the session of the metric set
+        const bool isCalculated =
+            CalculateStream( metricSet, rawData, newStream ) &&
+            metricSet.CalculateMetrics( rawData.data(), rawDataSize, continued.data(), outSize, nullptr, false ) == CC_OK &&
+            metricSet.CalculateMetrics( rawData.data(), rawDataSize, continued.data(), outSize, &continuedCount, false ) == CC_OK;
+
+        if( !isCalculated )
+        {
+            return TEST_RESULT_FAILED;
+        }
+
+        std::vector<std::thread> threads;
+        std::vector<uint32_t>    mismatchCounts( TEST_THREAD_COUNT, 0 );
+
+        for( uint32_t i = 0; i < TEST_THREAD_COUNT; ++i )
+        {
+            threads.emplace_back( [&, i]()
+                {
+                    std::vector<TTypedValue_1_0> out( valueCount );
+
+                    for( uint32_t j = 0; j < TEST_OVERLAPPING_CALLS; ++j )
+                    {
+                        uint32_t reportCount = 0;
+
+                        const bool isEqual =
+                            metricSet.CalculateMetrics( rawData.data(), rawDataSize, out.data(), outSize, &reportCount, false ) == CC_OK &&
+                            ( ( reportCount * reportValues == newStream.size() && AreValuesEqual( out.data(), newStream.data(), reportCount * reportValues ) ) ||
+                                ( reportCount == continuedCount && AreValuesEqual( out.data(), continued.data(), reportCount * reportValues ) ) );
+
+                        mismatchCounts[i] += isEqual ? 0 : 1;
+                    }
+                } );
+        }
+
+        uint32_t mismatchCount = 0;
+
+        for( uint32_t i = 0; i < TEST_THREAD_COUNT; ++i )
+        {
+            threads[i].join();
+            mismatchCount += mismatchCounts[i];
+        }
+
+        return ( mismatchCount == 0 ) ? TEST_RESULT_PASSED : TEST_RESULT_FAILED;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Chunked calculation with context filtering has to give the same reports
+    //     as calculation on a single thread. Calls through the metric set continue
+    //     a single stream, so the raw data is calculated once before, and both
+    //     calculations start from the same saved report and filtered context.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTestResult TestContextFiltering( IMetricSetLatest& metricSet, const std::vector<uint8_t>& rawData )
+    {
+        const TMetricSetParamsLatest* params         = metricSet.GetParams();
+        const uint32_t                rawDataSize    = static_cast<uint32_t>( rawData.size() );
+        const uint32_t                rawReportCount = rawDataSize / params->RawReportSize;
+        const size_t                  valueCount     = static_cast<size_t>( rawReportCount ) * ( params->MetricsCount + params->InformationCount );
+        const uint32_t                outSize        = static_cast<uint32_t>( valueCount * sizeof( TTypedValue_1_0 ) );
+
+        std::vector<TTypedValue_1_0> serial( valueCount );
+        std::vector<TTypedValue_1_0> chunked( valueCount );
+        uint32_t                     serialReportCount  = 0;
+        uint32_t                     chunkedReportCount = 0;
+
+        metricSet.SetCalculationThreadCount( 1 );
+
+        TCompletionCode ret = metricSet.CalculateMetrics( rawData.data(), rawDataSize, serial.data(), outSize, nullptr, true );
+
+        if( ret == CC_ERROR_NOT_SUPPORTED )
+        {
+            return TEST_RESULT_SKIPPED;
+        }
+
+        const bool isCalculated =
+            ret == CC_OK &&
+            metricSet.CalculateMetrics( rawData.data(), rawDataSize, serial.data(), outSize, &serialReportCount, true ) == CC_OK &&
+            metricSet.SetCalculationThreadCount( TEST_THREAD_COUNT ) == CC_OK &&
+            metricSet.CalculateMetrics( rawData.data(), rawDataSize, chunked.data(), outSize, &chunkedReportCount, true ) == CC_OK;
+
+        metricSet.SetCalculationThreadCount( 1 );
+
+        const bool isEqual = isCalculated &&
+            serialReportCount == chunkedReportCount &&
+            AreValuesEqual( serial.data(), chunked.data(), serialReportCount * ( params->MetricsCount + params->InformationCount ) );
+
+        return isEqual ? TEST_RESULT_PASSED : TEST_RESULT_FAILED;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Calculates metrics between the first and the last raw report with a range
+    //     index of the metric set. The range end is past the last raw report and is
+    //     clamped to it, so no rounding of ns timestamps changes the range.
+    //
+    // Input:
+    //     IMetricSetLatest&             metricSet   - metric set
+    //     const uint8_t*                rawData     - raw reports
+    //     uint32_t                      rawDataSize - raw reports size in bytes
+    //     std::vector<TTypedValue_1_0>& out         - (OUT) calculated report
+    //
+    // Output:
+    //     TCompletionCode - *CC_OK* means success
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TCompletionCode CalculateWholeRange( IMetricSetLatest& metricSet, const uint8_t* rawData, uint32_t rawDataSize, std::vector<TTypedValue_1_0>& out )
+    {
+        const uint32_t         valueCount     = metricSet.GetParams()->MetricsCount + metricSet.GetParams()->InformationCount;
+        IRangeIndexLatest*     rangeIndex     = nullptr;
+        const TTypedValue_1_0* values         = nullptr;
+        uint64_t               startTimestamp = 0;
+        uint64_t               endTimestamp   = 0;
+
+        TCompletionCode ret = metricSet.CreateRangeIndex( rawData, rawDataSize, false, &rangeIndex );
+
+        if( ret != CC_OK )
+        {
+            return ret;
+        }
+
+        ret = rangeIndex->GetTimeRange( &startTimestamp, &endTimestamp );
+
+        if( ret == CC_OK )
+        {
+            ret = rangeIndex->CalculateRange( 0, endTimestamp + TEST_NS_PER_SECOND, &values, nullptr );
+        }
+
+        if( ret == CC_OK )
+        {
+            out.assign( values, values + valueCount );
+        }
+
+        metricSet.DestroyRangeIndex( rangeIndex );
+        return ret;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     A range between two consecutive raw reports has to give the same metrics
+    //     as the two raw reports calculated by a stream calculation.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTestResult TestRangeIndex( IMetricSetLatest& metricSet, const std::vector<uint8_t>& rawData )
+    {
+        const uint32_t rawReportSize  = metricSet.GetParams()->RawReportSize;
+        const uint32_t rawReportCount = static_cast<uint32_t>( rawData.size() / rawReportSize );
+        const uint32_t metricsCount   = metricSet.GetParams()->MetricsCount;
+        const uint32_t firstReports[] = { 0, 1, rawReportCount / 2, rawReportCount - 2 };
+
+        for( const uint32_t first : firstReports )
+        {
+            const auto pairBegin = rawData.begin() + static_cast<size_t>( first ) * rawReportSize;
+
+            std::vector<uint8_t>         pair( pairBegin, pairBegin + 2 * rawReportSize );
+            std::vector<TTypedValue_1_0> range;
+            std::vector<TTypedValue_1_0> stream;
+
+            const TCompletionCode ret = CalculateWholeRange( metricSet, pair.data(), static_cast<uint32_t>( pair.size() ), range );
+
+            if( ret == CC_ERROR_NOT_SUPPORTED )
+            {
+                return TEST_RESULT_SKIPPED;
+            }
+
+            // Information is read from the first raw report of a range index, so only metrics are compared
+            if( ret != CC_OK ||
+                !CalculateStream( metricSet, pair, stream ) ||
+                stream.size() < metricsCount ||
+                !AreValuesEqual( range.data(), stream.data(), metricsCount ) )
+            {
+                return TEST_RESULT_FAILED;
+            }
+        }
+
+        return TEST_RESULT_PASSED;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     A range over raw reports with 32 bit counters wrapping several times has
+    //     to give the sum of the counter deltas between consecutive raw reports.
+    //     Compared are metrics that are a not normalized delta of a single counter.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTestResult TestRangeIndexWrap( IMetricSetLatest& metricSet )
+    {
+        const TMetricSetParamsLatest* params     = metricSet.GetParams();
+        const uint32_t                valueCount = params->MetricsCount + params->InformationCount;
+
+        // Counters increase by up to 2^30 between raw reports and by ~2^35 over all of them
+        const std::vector<uint8_t> rawData = CreateRawData( params->RawReportSize, 64, 1ull << 30, 2 );
+
+        std::vector<TTypedValue_1_0> range;
+        std::vector<TTypedValue_1_0> stream;
+
+        const TCompletionCode ret = CalculateWholeRange( metricSet, rawData.data(), static_cast<uint32_t>( rawData.size() ), range );
+
+        if( ret == CC_ERROR_NOT_SUPPORTED )
+        {
+            return TEST_RESULT_SKIPPED;
+        }
+        if( ret != CC_OK || !CalculateStream( metricSet, rawData, stream ) )
+        {
+            return TEST_RESULT_FAILED;
+        }
+
+        const size_t reportCount   = stream.size() / valueCount;
+        uint32_t     comparedCount = 0;
+
+        for( uint32_t i = 0; i < params->MetricsCount; ++i )
+        {
+            const TMetricParamsLatest* metricParams = metricSet.GetMetric( i )->GetParams();
+            IEquationLatest*           readEquation = metricParams->IoReadEquation;
+
+            const bool isCounterDelta =
+                metricParams->ResultType == RESULT_UINT64 &&
+                metricParams->DeltaFunction.FunctionType == DELTA_N_BITS &&
+                metricParams->DeltaFunction.BitsCount >= 32 &&
+                ( metricParams->NormEquation == nullptr || metricParams->NormEquation->GetEquationElementsCount() == 0 ) &&
+                readEquation != nullptr &&
+                readEquation->GetEquationElementsCount() == 1 &&
+                ( readEquation->GetEquationElement( 0 )->Type == EQUATION_ELEM_RD_UINT32 || readEquation->GetEquationElement( 0 )->Type == EQUATION_ELEM_RD_UINT64 ) &&
+                readEquation->GetEquationElement( 0 )->ReadParams.ByteOffset >= TEST_HEADER_SIZE;
+
+            if( !isCounterDelta )
+            {
+                continue;
+            }
+
+            uint64_t sum = 0;
+
+            for( size_t j = 0; j < reportCount; ++j )
+            {
+                sum += stream[j * valueCount + i].ValueUInt64;
+            }
+
+            if( range[i].ValueUInt64 != sum )
+            {
+                return TEST_RESULT_FAILED;
+            }
+
+            ++comparedCount;
+        }
+
+        return comparedCount > 0 ? TEST_RESULT_PASSED : TEST_RESULT_SKIPPED;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Creates an IoStream calculation context of a metric set aggregating over
+    //     time, optionally only within the given time windows. All the data sets
+    //     are of the same metric set.
+    //
+    // Input:
+    //     IMetricSetLatest&    metricSet           - metric set
+    //     TTimeWindowLatest*   timeWindows         - time windows in ns, can be null
+    //     uint32_t             timeWindowCount     - time window count
+    //     uint64_t             nsAggregationWindow - aggregation window in ns, 0 for timer mode
+    //     uint32_t             dataSetCount        - aggregated data set count
+    //
+    // Output:
+    //     ICalculationContextLatest* - calculation context, null if not created
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    ICalculationContextLatest* CreateCalculationContext( IMetricSetLatest& metricSet, TTimeWindowLatest* timeWindows, uint32_t timeWindowCount, uint64_t nsAggregationWindow, uint32_t dataSetCount = 1 )
+    {
+        std::vector<IMetricSet_1_16*>       metricSets( dataSetCount, &metricSet );
+        TCalculationContextDescriptorLatest descriptor = {};
+
+        descriptor.Type                                       = CALCULATION_CONTEXT_TYPE_IO_STREAM;
+        descriptor.DataSetCount                               = dataSetCount;
+        descriptor.MetricSets                                 = metricSets.data();
+        descriptor.IoStreamDescriptor.TimeWindows             = timeWindows;
+        descriptor.IoStreamDescriptor.TimeWindowCount         = timeWindowCount;
+        descriptor.IoStreamDescriptor.NsTimeAggregationWindow = nsAggregationWindow;
+
+        if( CCalculationContext::ValidateCalculationContextDescriptor( descriptor ) != CC_OK )
+        {
+            return nullptr;
+        }
+
+        // Created as by CAdapterGroup::CreateCalculationContext, the offline device has no adapter group
+        CCalculationContext* context = new( std::nothrow ) CCalculationContext();
+
+        if( context != nullptr && context->Initialize( descriptor ) != CC_OK )
+        {
+            delete context;
+            context = nullptr;
+        }
+
+        return context;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Destroys a calculation context created by CreateCalculationContext.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void DestroyCalculationContext( ICalculationContextLatest* context )
+    {
+        delete static_cast<CCalculationContext*>( context );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Aggregates raw data pushed in portions to the calculation context and
+    //     calculates the aggregated reports, either with AggregateAndCalculateMetrics
+    //     or with AggregateData followed by CalculateMetrics.
+    //
+    // Input:
+    //     ICalculationContextLatest&    context       - calculation context
+    //     const std::vector<uint8_t>&   rawData       - raw reports
+    //     uint32_t                      rawReportSize - raw report size in bytes
+    //     uint32_t                      portionCount  - count of raw data portions
+    //     bool                          isFused       - true to aggregate and calculate in one call
+    //     std::vector<TTypedValue_1_0>& out           - (OUT) calculated reports
+    //
+    // Output:
+    //     bool - true if calculated
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    bool AggregateAndCalculate( ICalculationContextLatest& context, const std::vector<uint8_t>& rawData, uint32_t rawReportSize, uint32_t portionCount, bool isFused, std::vector<TTypedValue_1_0>& out )
+    {
+        const uint32_t rawReportCount = static_cast<uint32_t>( rawData.size() / rawReportSize );
+        const uint32_t valueCount     = context.GetParams()->MetricsCount + context.GetParams()->InformationCount;
+
+        std::vector<uint8_t>         aggregatedRawData;
+        std::vector<TTypedValue_1_0> values;
+
+        out.clear();
+
+        for( uint32_t i = 0, first = 0; i < portionCount; ++i )
+        {
+            const bool     lastDataPortion = ( i + 1 == portionCount );
+            const uint32_t end             = lastDataPortion ? rawReportCount : rawReportCount / portionCount * ( i + 1 );
+            const uint8_t* portion         = rawData.data() + static_cast<size_t>( first ) * rawReportSize;
+            const uint32_t portionSize     = ( end - first ) * rawReportSize;
+            uint32_t       reportCount     = 0;
+
+            first = end;
+
+            if( isFused )
+            {
+                const TTypedValue_1_0* fusedValues = nullptr;
+
+                if( context.AggregateAndCalculateMetrics( &portion, &portionSize, &fusedValues, &reportCount, nullptr, lastDataPortion ) != CC_OK )
+                {
+                    return false;
+                }
+
+                out.insert( out.end(), fusedValues, fusedValues + static_cast<size_t>( reportCount ) * valueCount );
+                continue;
+            }
+
+            // Size of the aggregated raw data is returned for zero size
+            uint32_t aggregatedSize = 0;
+
+            if( context.AggregateData( &portion, &portionSize, nullptr, &aggregatedSize, lastDataPortion ) != CC_OK )
+            {
+                return false;
+            }
+
+            aggregatedRawData.resize( aggregatedSize );
+
+            if( aggregatedSize == 0 )
+            {
+                continue;
+            }
+
+            if( context.AggregateData( &portion, &portionSize, aggregatedRawData.data(), &aggregatedSize, lastDataPortion ) != CC_OK )
+            {
+                return false;
+            }
+
+            const uint32_t aggregatedReportCount = aggregatedSize / rawReportSize;
+
+            values.resize( static_cast<size_t>( aggregatedReportCount ) * valueCount );
+
+            if( aggregatedReportCount > 0 &&
+                context.CalculateMetrics( aggregatedRawData.data(), aggregatedSize, values.data(), static_cast<uint32_t>( values.size() * sizeof( TTypedValue_1_0 ) ), &reportCount, nullptr, 0 ) != CC_OK )
+            {
+                return false;
+            }
+
+            out.insert( out.end(), values.begin(), values.begin() + static_cast<size_t>( reportCount ) * valueCount );
+        }
+
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Aggregates raw data of all the data sets pushed in portions to the
+    //     calculation context with AggregateData.
+    //
+    // Input:
+    //     ICalculationContextLatest&               context       - calculation context
+    //     const std::vector<std::vector<uint8_t>>& rawData       - per data set, raw reports
+    //     uint32_t                                 rawReportSize - raw report size in bytes
+    //     uint32_t                                 portionCount  - count of raw data portions
+    //     std::vector<uint8_t>&                    out           - (OUT) aggregated raw reports
+    //
+    // Output:
+    //     bool - true if aggregated
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    bool AggregateDataSets( ICalculationContextLatest& context, const std::vector<std::vector<uint8_t>>& rawData, uint32_t rawReportSize, uint32_t portionCount, std::vector<uint8_t>& out )
+    {
+        const uint32_t dataSetCount = static_cast<uint32_t>( rawData.size() );
+
+        std::vector<const uint8_t*> portions( dataSetCount );
+        std::vector<uint32_t>       portionSizes( dataSetCount );
+        std::vector<uint8_t>        aggregatedRawData;
+
+        out.clear();
+
+        for( uint32_t i = 0; i < portionCount; ++i )
+        {
+            const bool lastDataPortion = ( i + 1 == portionCount );
+
+            for( uint32_t j = 0; j < dataSetCount; ++j )
+            {
+                const uint32_t rawReportCount = static_cast<uint32_t>( rawData[j].size() / rawReportSize );
+                const uint32_t first          = rawReportCount / portionCount * i;
+                const uint32_t end            = lastDataPortion ? rawReportCount : rawReportCount / portionCount * ( i + 1 );
+
+                portions[j]     = rawData[j].data() + static_cast<size_t>( first ) * rawReportSize;
+                portionSizes[j] = ( end - first ) * rawReportSize;
+            }
+
+            // Size of the aggregated raw data is returned for zero size
+            uint32_t aggregatedSize = 0;
+
+            if( context.AggregateData( portions.data(), portionSizes.data(), nullptr, &aggregatedSize, lastDataPortion ) != CC_OK )
+            {
+                return false;
+            }
+
+            aggregatedRawData.resize( aggregatedSize );
+
+            if( aggregatedSize != 0 &&
+                context.AggregateData( portions.data(), portionSizes.data(), aggregatedRawData.data(), &aggregatedSize, lastDataPortion ) != CC_OK )
+            {
+                return false;
+            }
+
+            out.insert( out.end(), aggregatedRawData.begin(), aggregatedRawData.begin() + aggregatedSize );
+        }
+
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Returns the time window in ns from the first to the last raw report.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTimeWindowLatest GetRawDataTimeWindow( const std::vector<uint8_t>& rawData, uint32_t rawReportSize, uint64_t gpuTimestampFrequency )
+    {
+        uint64_t firstTicks = 0;
+        uint64_t lastTicks  = 0;
+
+        memcpy( &firstTicks, rawData.data() + TEST_TIMESTAMP_OFFSET, sizeof( uint64_t ) );
+        memcpy( &lastTicks, rawData.data() + rawData.size() - rawReportSize + TEST_TIMESTAMP_OFFSET, sizeof( uint64_t ) );
+
+        return { firstTicks * TEST_NS_PER_SECOND / gpuTimestampFrequency, lastTicks * TEST_NS_PER_SECOND / gpuTimestampFrequency };
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Aggregation fused with calculation has to give the same reports as
+    //     aggregation followed by calculation of the aggregated reports. More
+    //     aggregated reports are created than are calculated at once when fused.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTestResult TestFusedCalculation( IMetricSetLatest& metricSet, const std::vector<uint8_t>& rawData, uint64_t gpuTimestampFrequency )
+    {
+        const uint32_t rawReportSize       = metricSet.GetParams()->RawReportSize;
+        const uint64_t nsAggregationWindow = TEST_AGGREGATION_WINDOW_TICKS * TEST_NS_PER_SECOND / gpuTimestampFrequency;
+
+        // Without time windows only a single aggregation window is calculated
+        TTimeWindowLatest timeWindow = GetRawDataTimeWindow( rawData, rawReportSize, gpuTimestampFrequency );
+
+        ICalculationContextLatest* fusedContext   = CreateCalculationContext( metricSet, &timeWindow, 1, nsAggregationWindow );
+        ICalculationContextLatest* twoStepContext = CreateCalculationContext( metricSet, &timeWindow, 1, nsAggregationWindow );
+
+        std::vector<TTypedValue_1_0> fused;
+        std::vector<TTypedValue_1_0> twoStep;
+
+        const bool isEqual =
+            fusedContext != nullptr &&
+            twoStepContext != nullptr &&
+            AggregateAndCalculate( *fusedContext, rawData, rawReportSize, 3, true, fused ) &&
+            AggregateAndCalculate( *twoStepContext, rawData, rawReportSize, 3, false, twoStep ) &&
+            fused.size() == twoStep.size() &&
+            AreValuesEqual( fused.data(), twoStep.data(), static_cast<uint32_t>( fused.size() ) );
+
+        DestroyCalculationContext( fusedContext );
+        DestroyCalculationContext( twoStepContext );
+
+        return isEqual ? TEST_RESULT_PASSED : TEST_RESULT_FAILED;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Returns true if metrics or information of the metric set use the previous
+    //     calculated report, which continues across windows of a calculation context.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    bool UsesPrevMetrics( IMetricSetLatest& metricSet )
+    {
+        auto usesPrevMetric = []( IEquationLatest* equation )
+        {
+            for( uint32_t i = 0; equation != nullptr && i < equation->GetEquationElementsCount(); ++i )
+            {
+                if( equation->GetEquationElement( i )->Type == EQUATION_ELEM_PREV_METRIC_SYMBOL )
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        };
+
+        for( uint32_t i = 0; i < metricSet.GetParams()->MetricsCount; ++i )
+        {
+            const TMetricParamsLatest* params = metricSet.GetMetric( i )->GetParams();
+
+            if( usesPrevMetric( params->IoReadEquation ) || usesPrevMetric( params->NormEquation ) || usesPrevMetric( params->MaxValueEquation ) )
+            {
+                return true;
+            }
+        }
+
+        for( uint32_t i = 0; i < metricSet.GetParams()->InformationCount; ++i )
+        {
+            if( usesPrevMetric( metricSet.GetInformation( i )->GetParams()->IoReadEquation ) )
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Overlapping time windows in no particular order, swept in one calculation
+    //     context, have to give the same reports as a calculation context per window,
+    //     in the order of the windows.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTestResult TestWindowSweep( IMetricSetLatest& metricSet, const std::vector<uint8_t>& rawData, uint64_t gpuTimestampFrequency )
+    {
+        if( UsesPrevMetrics( metricSet ) )
+        {
+            return TEST_RESULT_SKIPPED;
+        }
+
+        const uint32_t          rawReportSize = metricSet.GetParams()->RawReportSize;
+        const TTimeWindowLatest dataWindow    = GetRawDataTimeWindow( rawData, rawReportSize, gpuTimestampFrequency );
+
+        const uint64_t first = dataWindow.Start;
+        const uint64_t span  = dataWindow.End - dataWindow.Start;
+
+        // The second and the last window are the same
+        TTimeWindowLatest timeWindows[] = {
+            { first + span * 8 / 20, first + span * 14 / 20 },
+            { first + span * 2 / 20, first + span * 10 / 20 },
+            { first + span * 4 / 20, first + span * 6 / 20 },
+            { first + span * 12 / 20, first + span * 19 / 20 },
+            { first + span * 2 / 20, first + span * 10 / 20 },
+        };
+
+        const uint64_t nsAggregationWindow = span / 50;
+
+        std::vector<TTypedValue_1_0> swept;
+        std::vector<TTypedValue_1_0> perWindow;
+        std::vector<TTypedValue_1_0> window;
+
+        ICalculationContextLatest* context = CreateCalculationContext( metricSet, timeWindows, static_cast<uint32_t>( std::size( timeWindows ) ), nsAggregationWindow );
+        bool                       isEqual = context != nullptr && AggregateAndCalculate( *context, rawData, rawReportSize, 3, false, swept );
+
+        DestroyCalculationContext( context );
+
+        for( auto& timeWindow : timeWindows )
+        {
+            context = isEqual ? CreateCalculationContext( metricSet, &timeWindow, 1, nsAggregationWindow ) : nullptr;
+            isEqual = context != nullptr && AggregateAndCalculate( *context, rawData, rawReportSize, 3, false, window );
+
+            DestroyCalculationContext( context );
+
+            perWindow.insert( perWindow.end(), window.begin(), window.end() );
+        }
+
+        isEqual = isEqual &&
+            swept.size() == perWindow.size() &&
+            AreValuesEqual( swept.data(), perWindow.data(), static_cast<uint32_t>( swept.size() ) );
+
+        return isEqual ? TEST_RESULT_PASSED : TEST_RESULT_FAILED;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Aggregation of data sets with interleaved reports on the worker pool has
+    //     to give the same aggregated raw reports, byte for byte, as on the calling
+    //     thread. Covers aggregation windows, overlapping time windows of the window
+    //     sweep and the timer mode, so all the reports are timer ones.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTestResult TestParallelAggregation( IMetricSetLatest& metricSet, const std::vector<uint8_t>& rawData, uint64_t gpuTimestampFrequency )
+    {
+        const uint32_t rawReportSize = metricSet.GetParams()->RawReportSize;
+
+        std::vector<std::vector<uint8_t>> dataSets( TEST_THREAD_COUNT, rawData );
+
+        for( uint32_t i = 0; i < TEST_THREAD_COUNT; ++i )
+        {
+            if( i > 0 )
+            {
+                dataSets[i] = CreateRawData( rawReportSize, TEST_REPORT_COUNT, 1000, 1 + i );
+            }
+            for( size_t j = 0; j < dataSets[i].size(); j += rawReportSize )
+            {
+                memcpy( dataSets[i].data() + j, &TEST_REPORT_ID_TIMER, sizeof( uint64_t ) );
+            }
+        }
+
+        TTimeWindowLatest dataWindow = GetRawDataTimeWindow( rawData, rawReportSize, gpuTimestampFrequency );
+
+        const uint64_t first = dataWindow.Start;
+        const uint64_t span  = dataWindow.End - dataWindow.Start;
+
+        TTimeWindowLatest sweptWindows[] = {
+            { first + span * 8 / 20, first + span * 14 / 20 },
+            { first + span * 2 / 20, first + span * 10 / 20 },
+            { first + span * 12 / 20, first + span * 19 / 20 },
+        };
+
+        struct SAggregation
+        {
+            TTimeWindowLatest* TimeWindows;
+            uint32_t           TimeWindowCount;
+            uint64_t           NsAggregationWindow;
+        } aggregations[] = {
+            { &dataWindow, 1, TEST_AGGREGATION_WINDOW_TICKS * TEST_NS_PER_SECOND / gpuTimestampFrequency },
+            { sweptWindows, static_cast<uint32_t>( std::size( sweptWindows ) ), span / 1000 },
+            { nullptr, 0, 0 },
+        };
+
+        bool isEqual = true;
+
+        for( const auto& aggregation : aggregations )
+        {
+            std::vector<uint8_t> aggregated[2];
+
+            for( uint32_t i = 0; i < 2 && isEqual; ++i )
+            {
+                ICalculationContextLatest* context = CreateCalculationContext( metricSet, aggregation.TimeWindows, aggregation.TimeWindowCount, aggregation.NsAggregationWindow, TEST_THREAD_COUNT );
+
+                isEqual = context != nullptr &&
+                    context->SetCalculationThreadCount( i == 0 ? 1 : TEST_THREAD_COUNT ) == CC_OK &&
+                    AggregateDataSets( *context, dataSets, rawReportSize, 3, aggregated[i] );
+
+                DestroyCalculationContext( context );
+            }
+
+            isEqual = isEqual &&
+                !aggregated[0].empty() &&
+                aggregated[0] == aggregated[1];
+        }
+
+        return isEqual ? TEST_RESULT_PASSED : TEST_RESULT_FAILED;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Returns the first IoStream metric set of the metrics device with metrics
+    //     and a raw report large enough for the synthetic report header.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    IMetricSetLatest* GetIoStreamMetricSet( IMetricsDeviceLatest& device )
+    {
+        for( uint32_t i = 0; i < device.GetParams()->ConcurrentGroupsCount; ++i )
+        {
+            IConcurrentGroupLatest* group = device.GetConcurrentGroup( i );
+
+            for( uint32_t j = 0; j < group->GetParams()->MetricSetsCount; ++j )
+            {
+                IMetricSetLatest* metricSet = static_cast<IMetricSetLatest*>( group->GetMetricSet( j ) );
+
+                if( ( metricSet->GetParams()->ApiMask & API_TYPE_IOSTREAM ) == 0 ||
+                    metricSet->SetApiFiltering( API_TYPE_IOSTREAM ) != CC_OK )
+                {
+                    continue;
+                }
+
+                const TMetricSetParamsLatest* params = metricSet->GetParams();
+
+                if( params->MetricsCount > 0 && params->RawReportSize > TEST_HEADER_SIZE && params->RawReportSize % sizeof( uint64_t ) == 0 )
+                {
+                    return metricSet;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+} // namespace
+
+namespace MetricsDiscoveryInternal
+{
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricsDeviceTest
+    //
+    // Description:
+    //     Sets the platform of an offline metrics device, which is detected from
+    //     the adapter of an online metrics device.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    class CMetricsDeviceTest
+    {
+    public:
+        static void SetPlatformIndex( CMetricsDevice& device, uint32_t platformIndex )
+        {
+            device.m_platformIndex = platformIndex;
+        }
+    };
+} // namespace MetricsDiscoveryInternal
+
+int main( int argc, char* argv[] )
+{
+    CAdapter                adapter;
+    CDriverInterfaceOffline driverInterface;
+    CMetricsDevice          device( adapter, driverInterface, 0, true );
+    CSymbolSet&             symbolSet = device.GetSymbolSet();
+
+    CMetricsDeviceTest::SetPlatformIndex( device, TEST_PLATFORM_INDEX );
+
+    // Global symbols as detected on a device, the offline driver interface
+    // doesn't detect any, so the metric tree keeps these values
+    symbolSet.AddSymbolUINT32( "EuCoresTotalCount", 64, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "EuThreadsCount", 8, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "VectorEngineTotalCount", 64, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "VectorEnginePerXeCoreCount", 8, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "VectorEngineThreadsCount", 8, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "XeCoreTotalCount", 8, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "SliceTotalCount", 1, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "SamplersTotalCount", 8, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "GtSliceMask", 0x1, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "GtXeCoreMask", 0xff, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "GpuMinFrequencyMHz", 400, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "GpuMaxFrequencyMHz", 2000, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT64( "GpuTimestampFrequency", TEST_GPU_TIMESTAMP_FREQUENCY, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT64( "MaxTimestamp", device.ConvertGpuTimestampToNs( UINT64_MAX, TEST_GPU_TIMESTAMP_FREQUENCY ), SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolBOOL( "PavpDisabled", true, SYMBOL_TYPE_IMMEDIATE );
+
+    // Metric tree of the platform, as created by CAdapter::OpenMetricsDevice
+    if( CreateMetricTree( &device ) != CC_OK )
+    {
+        printf( "metric tree not created\n" );
+        return 1;
+    }
+
+    IMetricSetLatest* metricSet = GetIoStreamMetricSet( device );
+    int               result    = TEST_SKIPPED;
+
+    if( metricSet != nullptr )
+    {
+        const uint32_t             rawReportSize = metricSet->GetParams()->RawReportSize;
+        const std::vector<uint8_t> rawData       = CreateRawData( rawReportSize, TEST_REPORT_COUNT, 1000, 1 );
+
+        if( argc > 1 && strcmp( argv[1], "--benchmark" ) == 0 )
+        {
+            printf( "metric set: %s\n", metricSet->GetParams()->SymbolName );
+
+            BenchmarkKernels( *metricSet, rawData );
+            return 0;
+        }
+
+        const char* resultNames[] = { "passed", "FAILED", "skipped" };
+
+        struct STest
+        {
+            const char* Name;
+            TTestResult Result;
+        } tests[] = {
+            { "chunked calculation", TestChunkedCalculation( *metricSet, rawData ) },
+            { "stream calculation", TestStreamCalculation( *metricSet, rawData ) },
+            { "kernel calculation", TestKernelCalculation( *metricSet, rawData ) },
+            { "overlapping calculation", TestOverlappingCalculation( *metricSet, rawData ) },
+            { "range index", TestRangeIndex( *metricSet, rawData ) },
+            { "range index wrap", TestRangeIndexWrap( *metricSet ) },
+            { "fused calculation", TestFusedCalculation( *metricSet, rawData, TEST_GPU_TIMESTAMP_FREQUENCY ) },
+            { "window sweep", TestWindowSweep( *metricSet, rawData, TEST_GPU_TIMESTAMP_FREQUENCY ) },
+            { "parallel aggregation", TestParallelAggregation( *metricSet, rawData, TEST_GPU_TIMESTAMP_FREQUENCY ) },
+            { "context filtering", TestContextFiltering( *metricSet, rawData ) },
+        };
+
+        printf( "metric set: %s\n", metricSet->GetParams()->SymbolName );
+
+        result = 0;
+        for( const auto& test : tests )
+        {
+            printf( "%-24s %s\n", test.Name, resultNames[test.Result] );
+
+            if( test.Result == TEST_RESULT_FAILED )
+            {
+                result = 1;
+            }
+        }
+    }
+    else
+    {
+        printf( "no IoStream metric set, skipped\n" );
+    }
+
+    return result;
+}
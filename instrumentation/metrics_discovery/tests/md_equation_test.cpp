@@ -0,0 +1,1034 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2026 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+//     File Name:  md_equation_test.cpp
+
+//     Abstract:   Test of compiled equation evaluation. Equations are parsed on an offline
+//                 metrics device with immediate global symbols and calculated on synthetic
+//                 raw reports. Every evaluation path has to give the same results as
+//                 the reference evaluation of equation elements, also with global symbols
+//                 aggregated across devices. Delta kernels of every
+//                 instruction set level supported by the CPU have to give the same deltas
+//                 as the delta functions of the calculator.
+
+#include "md_metrics_calculator.h"
+#include "md_driver_ifc.h"
+#include "md_driver_ifc_offline.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace MetricsDiscovery;
+using namespace MetricsDiscoveryInternal;
+
+namespace
+{
+    constexpr uint32_t TEST_RAW_REPORT_SIZE  = 0x200;
+    constexpr uint32_t TEST_RAW_REPORT_COUNT = 256;
+    constexpr uint32_t TEST_DIVISOR_OFFSET   = 0x0c;
+    constexpr uint32_t TEST_SELF_OFFSET      = 0x1f8;
+    constexpr uint32_t TEST_DELTA_COUNT      = 37; // Covers SIMD kernel tails
+
+    typedef enum ETestResult
+    {
+        TEST_RESULT_PASSED,
+        TEST_RESULT_FAILED,
+    } TTestResult;
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Creates raw reports filled with random values. A dword used as a divisor
+    //     is 0 in every fourth report.
+    //
+    // Input:
+    //     uint32_t seed - random generator seed
+    //
+    // Output:
+    //     std::vector<uint8_t> - raw reports
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    std::vector<uint8_t> CreateRawData( uint32_t seed )
+    {
+        std::mt19937_64      random( seed );
+        std::vector<uint8_t> rawData( TEST_RAW_REPORT_SIZE * TEST_RAW_REPORT_COUNT, 0 );
+
+        for( size_t i = 0; i < rawData.size(); i += sizeof( uint64_t ) )
+        {
+            const uint64_t value = random();
+            memcpy( rawData.data() + i, &value, sizeof( uint64_t ) );
+        }
+
+        for( size_t i = 0; i < TEST_RAW_REPORT_COUNT; i += 4 )
+        {
+            memset( rawData.data() + i * TEST_RAW_REPORT_SIZE + TEST_DIVISOR_OFFSET, 0, sizeof( uint32_t ) );
+        }
+
+        return rawData;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Compares typed values. Floats are compared bitwise, as all evaluation paths
+    //     have to calculate them the same.
+    //
+    // Input:
+    //     const TTypedValue_1_0& left  - calculated value
+    //     const TTypedValue_1_0& right - calculated value
+    //
+    // Output:
+    //     bool - true if values are equal
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    bool IsValueEqual( const TTypedValue_1_0& left, const TTypedValue_1_0& right )
+    {
+        if( left.ValueType != right.ValueType )
+        {
+            return false;
+        }
+
+        switch( left.ValueType )
+        {
+            case VALUE_TYPE_UINT32:
+                return left.ValueUInt32 == right.ValueUInt32;
+
+            case VALUE_TYPE_FLOAT:
+                return memcmp( &left.ValueFloat, &right.ValueFloat, sizeof( float ) ) == 0;
+
+            case VALUE_TYPE_BOOL:
+                return left.ValueBool == right.ValueBool;
+
+            default:
+                return left.ValueUInt64 == right.ValueUInt64;
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Reports a value mismatch.
+    //
+    // Input:
+    //     const char*            path     - evaluation path
+    //     const char*            equation - equation string
+    //     const TTypedValue_1_0& value    - calculated value
+    //     const TTypedValue_1_0& expected - reference value
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void PrintMismatch( const char* path, const char* equation, const TTypedValue_1_0& value, const TTypedValue_1_0& expected )
+    {
+        printf( "%s mismatch: \"%s\", type %u value 0x%llx, expected type %u value 0x%llx\n",
+            path,
+            equation,
+            value.ValueType,
+            static_cast<unsigned long long>( value.ValueUInt64 ),
+            expected.ValueType,
+            static_cast<unsigned long long>( expected.ValueUInt64 ) );
+    }
+} // namespace
+
+namespace MetricsDiscoveryInternal
+{
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricsCalculatorTest
+    //
+    // Description:
+    //     Calculates equations with the evaluation paths of the metrics calculator
+    //     and with the reference evaluation of equation elements.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    class CMetricsCalculatorTest
+    {
+    public:
+        CMetricsCalculatorTest( CMetricsDevice& device )
+            : m_device( device )
+            , m_symbols( device )
+            , m_calculator( m_symbols )
+        {
+        }
+
+        CMetricsCalculatorTest( std::vector<std::reference_wrapper<CMetricsDevice>> devices )
+            : m_device( devices[0] )
+            , m_symbols( devices )
+            , m_calculator( m_symbols )
+        {
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculatorTest
+        //
+        // Method:
+        //     CalculateReference
+        //
+        // Description:
+        //     Calculates equation elements on a stack of typed values, the way
+        //     equations were calculated before they were compiled. Local counters
+        //     and metrics aren't resolved without a metric set, so they are 0.
+        //     Global symbols are looked up by name, aggregated across devices if they are.
+        //
+        // Input:
+        //     CEquation&             equation  - equation to calculate
+        //     const uint8_t*         rawReport - (IN) single raw report
+        //     const TTypedValue_1_0& self      - value of $Self
+        //
+        // Output:
+        //     TTypedValue_1_0 - output value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        TTypedValue_1_0 CalculateReference( CEquation& equation, const uint8_t* rawReport, const TTypedValue_1_0& self )
+        {
+            std::vector<TTypedValue_1_0> stack;
+
+            for( const auto& element : equation.GetElementsVector() )
+            {
+                TTypedValue_1_0 value = {};
+                value.ValueType       = VALUE_TYPE_UINT64;
+
+                const uint8_t* data = rawReport + element.ReadParams.ByteOffset;
+                uint32_t       dword = 0;
+
+                switch( element.Type )
+                {
+                    case EQUATION_ELEM_OPERATION:
+                    {
+                        const TTypedValue_1_0 valueLast = stack.back();
+                        stack.pop_back();
+                        const TTypedValue_1_0 valuePrev = stack.back();
+                        stack.pop_back();
+
+                        value = CMetricsCalculator::CalculateEquationElemOperation( element.Operation, valuePrev, valueLast );
+                        break;
+                    }
+
+                    case EQUATION_ELEM_RD_UINT8:
+                        value.ValueUInt64 = *data;
+                        break;
+
+                    case EQUATION_ELEM_RD_UINT16:
+                        value.ValueUInt64 = *reinterpret_cast<const uint16_t*>( data );
+                        break;
+
+                    case EQUATION_ELEM_RD_UINT32:
+                        value.ValueUInt64 = *reinterpret_cast<const uint32_t*>( data );
+                        break;
+
+                    case EQUATION_ELEM_RD_UINT64:
+                        value.ValueUInt64 = *reinterpret_cast<const uint64_t*>( data );
+                        break;
+
+                    case EQUATION_ELEM_RD_40BIT_CNTR:
+                        value.ValueUInt64 = *reinterpret_cast<const uint32_t*>( data ) |
+                            ( static_cast<uint64_t>( rawReport[element.ReadParams.ByteOffsetExt] ) << 32 );
+                        break;
+
+                    case EQUATION_ELEM_RD_BITFIELD:
+                        dword             = *reinterpret_cast<const uint32_t*>( data );
+                        value.ValueUInt64 = ( dword >> element.ReadParams.BitOffset ) & ( ( 1ULL << element.ReadParams.BitsCount ) - 1 );
+                        break;
+
+                    case EQUATION_ELEM_IMM_UINT64:
+                        value.ValueUInt64 = element.ImmediateUInt64;
+                        break;
+
+                    case EQUATION_ELEM_IMM_FLOAT:
+                        value.ValueFloat = element.ImmediateFloat;
+                        value.ValueType  = VALUE_TYPE_FLOAT;
+                        break;
+
+                    case EQUATION_ELEM_GLOBAL_SYMBOL:
+                        if( auto symbolValue = m_symbols.GetAggregatedSymbolValue( element.SymbolName );
+                            symbolValue )
+                        {
+                            value = *symbolValue;
+                        }
+                        else
+                        {
+                            value = *m_device.GetGlobalSymbolValueByName( element.SymbolName );
+                        }
+                        break;
+
+                    case EQUATION_ELEM_SELF_COUNTER_VALUE:
+                        value = self;
+                        break;
+
+                    default:
+                        value.ValueUInt64 = 0;
+                        break;
+                }
+
+                stack.push_back( value );
+            }
+
+            return stack.back();
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculatorTest
+        //
+        // Method:
+        //     CalculateRead
+        //
+        // Description:
+        //     Calculates a read equation the way the calculator does, with the validated
+        //     evaluation or with the checked one.
+        //
+        // Input:
+        //     CEquation&     equation  - read equation to calculate
+        //     const uint8_t* rawReport - (IN) single raw report
+        //
+        // Output:
+        //     TTypedValue_1_0 - output value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        TTypedValue_1_0 CalculateRead( CEquation& equation, const uint8_t* rawReport )
+        {
+            return m_calculator.CalculateReadEquation( equation, rawReport );
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculatorTest
+        //
+        // Method:
+        //     BindSymbols
+        //
+        // Description:
+        //     Binds an equation copy to the global symbols of the calculator, the way
+        //     calculation plans are bound to symbols aggregated across devices.
+        //
+        // Input:
+        //     CEquation& equation - (IN/OUT) equation copy to bind
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        void BindSymbols( CEquation& equation )
+        {
+            equation.BindGlobalSymbols( m_symbols );
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculatorTest
+        //
+        // Method:
+        //     CalculateProgram
+        //
+        // Description:
+        //     Calculates a validated program of the given type. Specialized programs
+        //     are calculated on raw values, mixed programs on typed values.
+        //
+        // Input:
+        //     const std::vector<TEquationInstruction>& program     - validated program
+        //     TEquationProgramType                     programType - program type to calculate with
+        //     const uint8_t*                           rawReport   - (IN) single raw report
+        //     const TTypedValue_1_0&                   self        - value of $Self
+        //
+        // Output:
+        //     TTypedValue_1_0 - output value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        TTypedValue_1_0 CalculateProgram( const std::vector<TEquationInstruction>& program, TEquationProgramType programType, const uint8_t* rawReport, const TTypedValue_1_0& self )
+        {
+            return m_calculator.CalculateValidatedProgram( program, programType, m_stack, [&]( const TEquationInstruction& instruction )
+                { return GetOperand( instruction, rawReport, self ); } );
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculatorTest
+        //
+        // Method:
+        //     CalculateBatch
+        //
+        // Description:
+        //     Calculates a validated equation for a batch of reports.
+        //
+        // Input:
+        //     CEquation&             equation    - equation to calculate
+        //     const uint8_t*         rawData     - (IN) raw reports
+        //     const TTypedValue_1_0* selfValues  - values of $Self, one for each report
+        //     uint32_t               reportCount - reports count
+        //     TTypedValue_1_0*       outValues   - (OUT) output values
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        void CalculateBatch( CEquation& equation, const uint8_t* rawData, const TTypedValue_1_0* selfValues, uint32_t reportCount, TTypedValue_1_0* outValues )
+        {
+            m_calculator.CalculateProgramBatch( equation, reportCount, outValues, 1, [&]( const TEquationInstruction& instruction, uint32_t j )
+                { return GetOperand( instruction, rawData + j * TEST_RAW_REPORT_SIZE, selfValues[j] ); } );
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculatorTest
+        //
+        // Method:
+        //     CalculateDelta
+        //
+        // Description:
+        //     Calculates a delta function of two values.
+        //
+        // Input:
+        //     TDeltaFunction_1_0 deltaFunction - delta function
+        //     uint64_t           lastValue     - last (next) value
+        //     uint64_t           previousValue - previous value
+        //
+        // Output:
+        //     uint64_t - delta value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        uint64_t CalculateDelta( TDeltaFunction_1_0 deltaFunction, uint64_t lastValue, uint64_t previousValue )
+        {
+            TTypedValue_1_0 typedValueLast = {};
+            TTypedValue_1_0 typedValuePrev = {};
+
+            typedValueLast.ValueType   = VALUE_TYPE_UINT64;
+            typedValueLast.ValueUInt64 = lastValue;
+            typedValuePrev.ValueType   = VALUE_TYPE_UINT64;
+            typedValuePrev.ValueUInt64 = previousValue;
+
+            return m_calculator.CalculateDeltaFunction( deltaFunction, typedValueLast, typedValuePrev ).ValueUInt64;
+        }
+
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculatorTest
+        //
+        // Method:
+        //     GetKernelBitsCount
+        //
+        // Description:
+        //     Returns bits count the delta kernels are called with for a delta function.
+        //
+        // Input:
+        //     TDeltaFunction_1_0 deltaFunction - DELTA_N_BITS or DELTA_NS_TIME delta function
+        //
+        // Output:
+        //     uint32_t - counters bits count
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        uint32_t GetKernelBitsCount( TDeltaFunction_1_0 deltaFunction )
+        {
+            return m_calculator.GetReadDeltaFunction( deltaFunction ).BitsCount;
+        }
+
+    private:
+        //////////////////////////////////////////////////////////////////////////////
+        //
+        // Class:
+        //     CMetricsCalculatorTest
+        //
+        // Method:
+        //     GetOperand
+        //
+        // Description:
+        //     Returns operand value of a read or normalization equation.
+        //
+        // Input:
+        //     const TEquationInstruction& instruction - operand instruction
+        //     const uint8_t*              rawReport   - (IN) single raw report
+        //     const TTypedValue_1_0&      self        - value of $Self
+        //
+        // Output:
+        //     TTypedValue_1_0 - operand value
+        //
+        //////////////////////////////////////////////////////////////////////////////
+        TTypedValue_1_0 GetOperand( const TEquationInstruction& instruction, const uint8_t* rawReport, const TTypedValue_1_0& self )
+        {
+            if( CMetricsCalculator::READ_INSTRUCTIONS & ( 1U << instruction.Code ) )
+            {
+                return m_calculator.GetReadEquationOperand( instruction, rawReport );
+            }
+
+            TTypedValue_1_0 deltaValue = self;
+            return m_calculator.GetNormalizationEquationOperand( instruction, &deltaValue, nullptr, 0 );
+        }
+
+    private:
+        CMetricsDevice&    m_device;
+        CCalculatorSymbols m_symbols;
+        CMetricsCalculator m_calculator;
+        CEquationStack     m_stack;
+    };
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CReportKernelsTest
+    //
+    // Description:
+    //     Calculates deltas with the kernels of the given level instead of
+    //     the detected one.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    class CReportKernelsTest
+    {
+    public:
+        static void CalculateDeltas( TReportKernelLevel level, const uint8_t* last, const uint8_t* prev, uint32_t count, uint32_t elemSize, uint32_t bitsCount, uint64_t* outDeltas )
+        {
+            CReportKernels::CalculateDeltas( level, last, prev, count, elemSize, bitsCount, outDeltas );
+        }
+    };
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Class:
+    //     CMetricsDeviceTest
+    //
+    // Description:
+    //     Sets the platform of an offline metrics device, which selects
+    //     DELTA_NS_TIME bits count.
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    class CMetricsDeviceTest
+    {
+    public:
+        static void SetPlatformIndex( CMetricsDevice& device, uint32_t platformIndex )
+        {
+            device.m_platformIndex = platformIndex;
+        }
+    };
+} // namespace MetricsDiscoveryInternal
+
+namespace
+{
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Creates an equation summing dwords of a raw report, with all the operands
+    //     pushed before the operations, so the stack is as deep as operands count.
+    //
+    // Input:
+    //     uint32_t operandCount - operands count
+    //
+    // Output:
+    //     std::string - equation string
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    std::string CreateDeepEquation( uint32_t operandCount )
+    {
+        std::string equation;
+
+        for( uint32_t i = 0; i < operandCount; ++i )
+        {
+            equation += "dw@" + std::to_string( i * sizeof( uint32_t ) ) + " ";
+        }
+
+        for( uint32_t i = 1; i < operandCount; ++i )
+        {
+            equation += ( i + 1 < operandCount ) ? "UADD " : "UADD";
+        }
+
+        return equation;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Tests equations as deep as the inline evaluation stack and deeper.
+    //     The deeper equation isn't validated, but has to be calculated with
+    //     the checked evaluation instead of being rejected.
+    //
+    // Input:
+    //     CMetricsDevice&             device  - offline metrics device
+    //     const std::vector<uint8_t>& rawData - raw reports
+    //
+    // Output:
+    //     TTestResult - test result
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTestResult TestStackDepth( CMetricsDevice& device, const std::vector<uint8_t>& rawData )
+    {
+        CMetricsCalculatorTest test( device );
+        TTypedValue_1_0        self = {};
+
+        for( const uint32_t depth : { CEquation::MAX_STACK_DEPTH, CEquation::MAX_STACK_DEPTH + 1 } )
+        {
+            const std::string equationString = CreateDeepEquation( depth );
+            CEquation         equation( device );
+
+            if( !equation.ParseEquationString( equationString.c_str() ) || equation.GetMaxStackDepth() != depth )
+            {
+                printf( "equation of stack depth %u not parsed\n", depth );
+                return TEST_RESULT_FAILED;
+            }
+
+            if( equation.IsValidatedProgram( ~0U ) != ( depth <= CEquation::MAX_STACK_DEPTH ) )
+            {
+                printf( "equation of stack depth %u validated incorrectly\n", depth );
+                return TEST_RESULT_FAILED;
+            }
+
+            for( uint32_t i = 0; i < TEST_RAW_REPORT_COUNT; ++i )
+            {
+                const uint8_t*        rawReport = rawData.data() + i * TEST_RAW_REPORT_SIZE;
+                const TTypedValue_1_0 expected  = test.CalculateReference( equation, rawReport, self );
+                const TTypedValue_1_0 value     = test.CalculateRead( equation, rawReport );
+
+                if( !IsValueEqual( value, expected ) )
+                {
+                    PrintMismatch( "read equation", equationString.c_str(), value, expected );
+                    return TEST_RESULT_FAILED;
+                }
+            }
+        }
+
+        return TEST_RESULT_PASSED;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Tests compiled programs of equations taken from generated metric sets,
+    //     and of equations with type promotions and division by zero. The inferred
+    //     program type is checked. Unfolded and constant folded programs are
+    //     calculated with their specialized type, with the mixed type evaluation
+    //     and for a batch of reports. All results have to be the same as the
+    //     reference. $Self is an integer in even reports and a float in odd ones.
+    //
+    // Input:
+    //     CMetricsDevice&             device  - offline metrics device
+    //     const std::vector<uint8_t>& rawData - raw reports
+    //
+    // Output:
+    //     TTestResult - test result
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTestResult TestEquationPrograms( CMetricsDevice& device, const std::vector<uint8_t>& rawData )
+    {
+        const struct STestEquation
+        {
+            const char*          Equation;
+            TEquationProgramType ProgramType;
+        } testEquations[] = {
+            // Read equations of generated metric sets
+            { "dw@0x04 1000000000 UMUL $GpuTimestampFrequency UDIV", EQUATION_PROGRAM_TYPE_UINT64 },
+            { "qw@0x08", EQUATION_PROGRAM_TYPE_MIXED },
+            { "rd40@0x2c:0xa7 rd40@0x30:0xa8 FADD rd40@0x34:0xa9 FADD rd40@0x38:0xaa FADD", EQUATION_PROGRAM_TYPE_FLOAT },
+            { "qw@0x48 qw@0x50 FADD qw@0x58 FADD qw@0x60 FADD", EQUATION_PROGRAM_TYPE_FLOAT },
+            { "8 qw@0x88 qw@0x90 FADD qw@0x98 FADD qw@0xa0 FADD FMUL $EuThreadsCount FDIV", EQUATION_PROGRAM_TYPE_FLOAT },
+            { "qw@0x1a8 qw@0x1a0 UADD qw@0x198 UADD qw@0x190 UADD", EQUATION_PROGRAM_TYPE_UINT64 },
+            { "dw@0xfc dw@0xf8 UADD dw@0xf4 UADD dw@0xf0 UADD", EQUATION_PROGRAM_TYPE_UINT64 },
+            { "dw@0x0 0x1ff AND 16666 UMUL 1000 UDIV", EQUATION_PROGRAM_TYPE_UINT64 },
+            // Normalization and availability equations of generated metric sets
+            { "$Self 4 UMUL", EQUATION_PROGRAM_TYPE_UINT64 },
+            { "64 $Self UMUL", EQUATION_PROGRAM_TYPE_UINT64 },
+            { "$Self 0 UGT", EQUATION_PROGRAM_TYPE_MIXED },
+            { "$GpuCoreClocks 128 UMUL $EuDualSubslicesTotalCount UMUL", EQUATION_PROGRAM_TYPE_UINT64 },
+            { "$GpuCoreClocks 1000 UMUL $$GpuTime UDIV", EQUATION_PROGRAM_TYPE_UINT64 },
+            { "100 $GpuCoreClocks 500 UMAX 5000 UMIN 500 USUB 45 UDIV USUB", EQUATION_PROGRAM_TYPE_UINT64 },
+            { "$XveFpuEmActive $FpuActive $EmActive FADD $EmActive FSUB FDIV 1 FADD", EQUATION_PROGRAM_TYPE_FLOAT },
+            { "$GtSliceMask 3 0 2 UMUL << AND", EQUATION_PROGRAM_TYPE_UINT64 },
+            { "$GtDualSubsliceMask 16 AND", EQUATION_PROGRAM_TYPE_UINT64 },
+            // Boolean values promoted to integers
+            { "$PavpDisabled 3 UMUL", EQUATION_PROGRAM_TYPE_UINT64 },
+            { "dw@0x10 dw@0x14 UGT 5 UMUL", EQUATION_PROGRAM_TYPE_MIXED },
+            // Division by zero
+            { "qw@0x08 dw@0x0c UDIV", EQUATION_PROGRAM_TYPE_UINT64 },
+            { "7 0 UDIV $Self UADD", EQUATION_PROGRAM_TYPE_UINT64 },
+            { "dw@0x18 dw@0x0c FDIV", EQUATION_PROGRAM_TYPE_FLOAT },
+            { "$Self 0.5 FMUL 2.0 FDIV", EQUATION_PROGRAM_TYPE_FLOAT },
+            // Bitfield
+            { "bm@0x1c:4:12 dw@0x20 USUB", EQUATION_PROGRAM_TYPE_UINT64 },
+        };
+
+        CMetricsCalculatorTest       test( device );
+        std::vector<TTypedValue_1_0> selfValues( TEST_RAW_REPORT_COUNT );
+        std::vector<TTypedValue_1_0> expected( TEST_RAW_REPORT_COUNT );
+        std::vector<TTypedValue_1_0> batchValues( TEST_RAW_REPORT_COUNT );
+
+        for( uint32_t i = 0; i < TEST_RAW_REPORT_COUNT; ++i )
+        {
+            const uint8_t* rawReport = rawData.data() + i * TEST_RAW_REPORT_SIZE;
+            const uint32_t self      = *reinterpret_cast<const uint32_t*>( rawReport + TEST_SELF_OFFSET );
+
+            if( i % 2 == 0 )
+            {
+                selfValues[i].ValueUInt64 = self;
+                selfValues[i].ValueType   = VALUE_TYPE_UINT64;
+            }
+            else
+            {
+                selfValues[i].ValueFloat = static_cast<float>( self ) / 3.0f;
+                selfValues[i].ValueType  = VALUE_TYPE_FLOAT;
+            }
+        }
+
+        for( const auto& testEquation : testEquations )
+        {
+            CEquation equation( device );
+
+            if( !equation.ParseEquationString( testEquation.Equation ) || !equation.IsValidatedProgram( ~0U ) )
+            {
+                printf( "equation not compiled: \"%s\"\n", testEquation.Equation );
+                return TEST_RESULT_FAILED;
+            }
+
+            if( equation.GetProgramType() != testEquation.ProgramType )
+            {
+                printf( "equation program type %u, expected %u: \"%s\"\n", equation.GetProgramType(), testEquation.ProgramType, testEquation.Equation );
+                return TEST_RESULT_FAILED;
+            }
+
+            const struct SProgram
+            {
+                const char*                              Name;
+                const std::vector<TEquationInstruction>& Program;
+                TEquationProgramType                     ProgramType;
+            } programs[] = {
+                { "unfolded", equation.GetProgram(), equation.GetProgramType() },
+                { "unfolded mixed", equation.GetProgram(), EQUATION_PROGRAM_TYPE_MIXED },
+                { "folded", equation.GetOptimizedProgram(), equation.GetOptimizedProgramType() },
+                { "folded mixed", equation.GetOptimizedProgram(), EQUATION_PROGRAM_TYPE_MIXED },
+            };
+
+            for( uint32_t i = 0; i < TEST_RAW_REPORT_COUNT; ++i )
+            {
+                const uint8_t* rawReport = rawData.data() + i * TEST_RAW_REPORT_SIZE;
+
+                expected[i] = test.CalculateReference( equation, rawReport, selfValues[i] );
+
+                for( const auto& program : programs )
+                {
+                    const TTypedValue_1_0 value = test.CalculateProgram( program.Program, program.ProgramType, rawReport, selfValues[i] );
+
+                    if( !IsValueEqual( value, expected[i] ) )
+                    {
+                        PrintMismatch( program.Name, testEquation.Equation, value, expected[i] );
+                        return TEST_RESULT_FAILED;
+                    }
+                }
+            }
+
+            for( uint32_t i = 0; i < TEST_RAW_REPORT_COUNT; i += MD_CALCULATION_BATCH_SIZE )
+            {
+                const uint32_t reportCount = ( std::min )( TEST_RAW_REPORT_COUNT - i, static_cast<uint32_t>( MD_CALCULATION_BATCH_SIZE ) );
+
+                test.CalculateBatch( equation, rawData.data() + i * TEST_RAW_REPORT_SIZE, selfValues.data() + i, reportCount, batchValues.data() + i );
+            }
+
+            for( uint32_t i = 0; i < TEST_RAW_REPORT_COUNT; ++i )
+            {
+                if( !IsValueEqual( batchValues[i], expected[i] ) )
+                {
+                    PrintMismatch( "batch", testEquation.Equation, batchValues[i], expected[i] );
+                    return TEST_RESULT_FAILED;
+                }
+            }
+        }
+
+        return TEST_RESULT_PASSED;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Tests equations bound to global symbols aggregated across two devices,
+    //     the same device twice, so counts are doubled. Symbols of bound programs
+    //     have to be folded, aggregated or not, so they aren't looked up per report. Bound programs have to give the same results as
+    //     the reference calculated with aggregated symbols, for single reports
+    //     and for a batch of reports.
+    //
+    // Input:
+    //     CMetricsDevice&             device  - offline metrics device
+    //     const std::vector<uint8_t>& rawData - raw reports
+    //
+    // Output:
+    //     TTestResult - test result
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTestResult TestAggregatedSymbols( CMetricsDevice& device, const std::vector<uint8_t>& rawData )
+    {
+        const char* testEquations[] = {
+            "dw@0x04 1000000000 UMUL $GpuTimestampFrequency UDIV",
+            "8 qw@0x88 qw@0x90 FADD FMUL $EuThreadsCount FDIV",
+            "$GpuCoreClocks 128 UMUL $EuDualSubslicesTotalCount UMUL",
+            "$EuCoresTotalCount",
+            "$GtSliceMask 3 AND", // Symbol of the first device
+        };
+
+        std::vector<std::reference_wrapper<CMetricsDevice>> devices = { device, device };
+
+        CMetricsCalculatorTest       test( devices );
+        std::vector<TTypedValue_1_0> selfValues( TEST_RAW_REPORT_COUNT );
+        std::vector<TTypedValue_1_0> batchValues( TEST_RAW_REPORT_COUNT );
+
+        for( const auto& testEquation : testEquations )
+        {
+            CEquation equation( device );
+
+            if( !equation.ParseEquationString( testEquation ) || !equation.IsValidatedProgram( ~0U ) )
+            {
+                printf( "equation not compiled: \"%s\"\n", testEquation );
+                return TEST_RESULT_FAILED;
+            }
+
+            CEquation boundEquation( equation );
+            test.BindSymbols( boundEquation );
+
+            for( const auto& instruction : boundEquation.GetOptimizedProgram() )
+            {
+                if( instruction.Code == EQUATION_INSTR_GLOBAL_SYMBOL || instruction.Code == EQUATION_INSTR_GLOBAL_SYMBOL_DYNAMIC )
+                {
+                    printf( "global symbol not folded: \"%s\"\n", testEquation );
+                    return TEST_RESULT_FAILED;
+                }
+            }
+
+            for( uint32_t i = 0; i < TEST_RAW_REPORT_COUNT; ++i )
+            {
+                const uint8_t*        rawReport = rawData.data() + i * TEST_RAW_REPORT_SIZE;
+                const TTypedValue_1_0 expected  = test.CalculateReference( equation, rawReport, selfValues[i] );
+                const TTypedValue_1_0 value     = test.CalculateRead( boundEquation, rawReport );
+
+                if( !IsValueEqual( value, expected ) )
+                {
+                    PrintMismatch( "aggregated", testEquation, value, expected );
+                    return TEST_RESULT_FAILED;
+                }
+            }
+
+            test.CalculateBatch( boundEquation, rawData.data(), selfValues.data(), MD_CALCULATION_BATCH_SIZE, batchValues.data() );
+
+            for( uint32_t i = 0; i < MD_CALCULATION_BATCH_SIZE; ++i )
+            {
+                const TTypedValue_1_0 expected = test.CalculateReference( equation, rawData.data() + i * TEST_RAW_REPORT_SIZE, selfValues[i] );
+
+                if( !IsValueEqual( batchValues[i], expected ) )
+                {
+                    PrintMismatch( "aggregated batch", testEquation, batchValues[i], expected );
+                    return TEST_RESULT_FAILED;
+                }
+            }
+        }
+
+        // Counts are summed across devices
+        CEquation equation( device );
+        equation.ParseEquationString( "$EuCoresTotalCount" );
+        test.BindSymbols( equation );
+
+        const auto& program = equation.GetOptimizedProgram();
+
+        if( program.size() != 1 || program[0].Code != EQUATION_INSTR_IMMEDIATE || program[0].Value.ValueUInt32 != 2 * device.GetGlobalSymbolValueByName( "EuCoresTotalCount" )->ValueUInt32 )
+        {
+            printf( "global symbol not aggregated: \"$EuCoresTotalCount\"\n" );
+            return TEST_RESULT_FAILED;
+        }
+
+        return TEST_RESULT_PASSED;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Stores a counter value in an array of 32 or 64 bit counters.
+    //
+    // Input:
+    //     std::vector<uint8_t>& counters - counters
+    //     uint32_t              index    - counter index
+    //     uint32_t              elemSize - single counter size in bytes, 4 or 8
+    //     uint64_t              value    - counter value
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void StoreCounter( std::vector<uint8_t>& counters, uint32_t index, uint32_t elemSize, uint64_t value )
+    {
+        if( elemSize == sizeof( uint32_t ) )
+        {
+            const uint32_t value32 = static_cast<uint32_t>( value );
+            memcpy( counters.data() + index * elemSize, &value32, sizeof( uint32_t ) );
+        }
+        else
+        {
+            memcpy( counters.data() + index * elemSize, &value, sizeof( uint64_t ) );
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Tests delta kernels of every level supported by the CPU against
+    //     CMetricsCalculator::CalculateDeltaFunction. DELTA_NS_TIME is calculated
+    //     with bits count of a 32 bit and of a 56 bit timestamp platform, as read
+    //     kernels are matched with it. Counters are wrapped, unwrapped and equal,
+    //     the first one wraps from its maximum to 0.
+    //
+    // Input:
+    //     CMetricsDevice& device - offline metrics device
+    //
+    // Output:
+    //     TTestResult - test result
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    TTestResult TestDeltaKernels( CMetricsDevice& device )
+    {
+        struct SDeltaCase
+        {
+            TDeltaFunctionType FunctionType;
+            uint32_t           BitsCount;
+            uint32_t           ElemSize;
+            uint32_t           PlatformIndex;
+        } deltaCases[] = {
+            { DELTA_N_BITS, 32, sizeof( uint32_t ), GENERATION_TGL },
+            { DELTA_N_BITS, 32, sizeof( uint64_t ), GENERATION_TGL },
+            { DELTA_N_BITS, 40, sizeof( uint64_t ), GENERATION_TGL },
+            { DELTA_N_BITS, 56, sizeof( uint64_t ), GENERATION_TGL },
+            { DELTA_N_BITS, 64, sizeof( uint32_t ), GENERATION_TGL },
+            { DELTA_N_BITS, 64, sizeof( uint64_t ), GENERATION_TGL },
+            { DELTA_N_BITS, 65, sizeof( uint64_t ), GENERATION_TGL },
+            { DELTA_N_BITS, 100, sizeof( uint32_t ), GENERATION_TGL },
+            { DELTA_NS_TIME, 0, sizeof( uint32_t ), GENERATION_TGL },
+            { DELTA_NS_TIME, 0, sizeof( uint64_t ), GENERATION_TGL },
+            { DELTA_NS_TIME, 0, sizeof( uint64_t ), GENERATION_LNL },
+        };
+
+        const uint32_t         platformIndex = device.GetPlatformIndex();
+        const uint32_t         kernelLevel   = CReportKernels::GetKernelLevel();
+        CMetricsCalculatorTest calculator( device );
+        std::mt19937_64        random( 2 );
+        std::vector<uint8_t>   last( TEST_DELTA_COUNT * sizeof( uint64_t ) );
+        std::vector<uint8_t>   prev( TEST_DELTA_COUNT * sizeof( uint64_t ) );
+        std::vector<uint64_t>  deltas( TEST_DELTA_COUNT );
+        TTestResult            result = TEST_RESULT_PASSED;
+
+        for( const auto& deltaCase : deltaCases )
+        {
+            CMetricsDeviceTest::SetPlatformIndex( device, deltaCase.PlatformIndex );
+
+            TDeltaFunction_1_0 deltaFunction;
+            deltaFunction.FunctionType = deltaCase.FunctionType;
+            deltaFunction.BitsCount    = deltaCase.BitsCount;
+
+            const uint32_t bitsCount   = calculator.GetKernelBitsCount( deltaFunction );
+            const uint32_t counterBits = std::min( bitsCount, deltaCase.ElemSize * 8 );
+            const uint64_t counterMask = ( counterBits < 64 ) ? ( 1ULL << counterBits ) - 1 : ~0ULL;
+
+            for( uint32_t i = 0; i < TEST_DELTA_COUNT; ++i )
+            {
+                const uint64_t value1 = random() & counterMask;
+                const uint64_t value2 = random() & counterMask;
+
+                switch( i % 3 )
+                {
+                    case 0:
+                        StoreCounter( last, i, deltaCase.ElemSize, std::min( value1, value2 ) ); // Wrapped
+                        StoreCounter( prev, i, deltaCase.ElemSize, ( i == 0 ) ? counterMask : std::max( value1, value2 ) );
+                        break;
+
+                    case 1:
+                        StoreCounter( last, i, deltaCase.ElemSize, std::max( value1, value2 ) );
+                        StoreCounter( prev, i, deltaCase.ElemSize, std::min( value1, value2 ) );
+                        break;
+
+                    default:
+                        StoreCounter( last, i, deltaCase.ElemSize, value1 );
+                        StoreCounter( prev, i, deltaCase.ElemSize, value1 );
+                        break;
+                }
+            }
+
+            StoreCounter( last, 0, deltaCase.ElemSize, 0 );
+
+            for( uint32_t level = REPORT_KERNEL_LEVEL_SCALAR; level <= kernelLevel; ++level )
+            {
+                CReportKernelsTest::CalculateDeltas( static_cast<TReportKernelLevel>( level ), last.data(), prev.data(), TEST_DELTA_COUNT, deltaCase.ElemSize, bitsCount, deltas.data() );
+
+                for( uint32_t i = 0; i < TEST_DELTA_COUNT; ++i )
+                {
+                    uint64_t lastValue = 0;
+                    uint64_t prevValue = 0;
+                    memcpy( &lastValue, last.data() + i * deltaCase.ElemSize, deltaCase.ElemSize );
+                    memcpy( &prevValue, prev.data() + i * deltaCase.ElemSize, deltaCase.ElemSize );
+
+                    const uint64_t expected = calculator.CalculateDelta( deltaFunction, lastValue, prevValue );
+
+                    if( deltas[i] != expected )
+                    {
+                        printf( "delta kernel mismatch: level %u, function %u, bits %u, element size %u, counter %u, delta 0x%llx, expected 0x%llx\n",
+                            level,
+                            deltaCase.FunctionType,
+                            bitsCount,
+                            deltaCase.ElemSize,
+                            i,
+                            static_cast<unsigned long long>( deltas[i] ),
+                            static_cast<unsigned long long>( expected ) );
+
+                        result = TEST_RESULT_FAILED;
+                        break;
+                    }
+                }
+            }
+        }
+
+        CMetricsDeviceTest::SetPlatformIndex( device, platformIndex );
+
+        return result;
+    }
+} // namespace
+
+int main()
+{
+    CAdapter                adapter;
+    CDriverInterfaceOffline driverInterface;
+    CMetricsDevice          device( adapter, driverInterface, 0, true );
+    CSymbolSet&             symbolSet = device.GetSymbolSet();
+
+    // Global symbols as detected on a device
+    symbolSet.AddSymbolUINT32( "EuCoresTotalCount", 96, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "EuThreadsCount", 7, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "EuDualSubslicesTotalCount", 6, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "GtSliceMask", 0x1, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT32( "GtDualSubsliceMask", 0x3f, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolUINT64( "GpuTimestampFrequency", 19200000, SYMBOL_TYPE_IMMEDIATE );
+    symbolSet.AddSymbolBOOL( "PavpDisabled", true, SYMBOL_TYPE_IMMEDIATE );
+
+    // Symbols are added after the device is created, aggregated symbols are enumerated
+    device.GetParams()->GlobalSymbolsCount = symbolSet.GetSymbolCount();
+
+    const std::vector<uint8_t> rawData = CreateRawData( 1 );
+
+    const char* resultNames[] = { "passed", "FAILED" };
+
+    struct STest
+    {
+        const char* Name;
+        TTestResult Result;
+    } tests[] = {
+        { "stack depth", TestStackDepth( device, rawData ) },
+        { "equation programs", TestEquationPrograms( device, rawData ) },
+        { "aggregated symbols", TestAggregatedSymbols( device, rawData ) },
+        { "delta kernels", TestDeltaKernels( device ) },
+    };
+
+    int result = 0;
+    for( const auto& test : tests )
+    {
+        printf( "%-24s %s\n", test.Name, resultNames[test.Result] );
+
+        if( test.Result == TEST_RESULT_FAILED )
+        {
+            result = 1;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,539 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2026 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+//     File Name:  md_report_kernels_test.cpp
+
+//     Abstract:   Test of raw report SIMD kernels. Kernels of every instruction set
+//                 level supported by the CPU are compared with the scalar kernels.
+//                 Counter interpolation is compared with the previous double based
+//                 interpolation. With --benchmark interpolation of the reports of
+//                 2, 4 and 8 data sets is timed for both, and on a worker pool with
+//                 a barrier at each aggregation window boundary or at each batch of
+//                 windows.
+
+#include "md_report_kernels.h"
+#include "md_worker_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace MetricsDiscoveryInternal;
+
+namespace
+{
+    constexpr uint32_t TEST_COUNTER_COUNT         = 37; // Covers SIMD kernel tails
+    constexpr uint32_t TEST_INTERPOLATION_COUNT   = 4096;
+    constexpr uint32_t TEST_HEADER_SIZE           = 4 * sizeof( uint64_t );
+    constexpr uint32_t TEST_TIMESTAMP_OFFSET      = 1 * sizeof( uint64_t );
+    constexpr uint32_t TEST_GPU_TICKS_OFFSET      = 3 * sizeof( uint64_t );
+    constexpr uint32_t TEST_PEC_COUNT             = 64; // OA_REPORT_TYPE_640B_PEC64LL_NOA16
+    constexpr uint32_t TEST_NOA_COUNT             = 16;
+    constexpr uint32_t TEST_PEC_SIZE              = TEST_PEC_COUNT * sizeof( uint64_t );
+    constexpr uint32_t TEST_RAW_REPORT_SIZE       = 640;
+    constexpr uint32_t TEST_BENCHMARK_WINDOWS     = 200000;
+    constexpr uint32_t TEST_BENCHMARK_MAX_DATASET = 8;
+    constexpr uint32_t TEST_BENCHMARK_BATCH_SIZE  = 256; // MD_AGGREGATION_BATCH_REPORT_COUNT
+
+    volatile uint64_t g_benchmarkChecksum = 0; // Keeps benchmarked calculations from being optimized out
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Returns interpolation point of the timestamp between two report timestamps,
+    //     as calculated by CCalculationContext::Interpolate before Q32 kernels.
+    //
+    // Input:
+    //     uint64_t timestamp     - interpolated timestamp
+    //     uint64_t timestampPrev - timestamp of the previous report
+    //     uint64_t timestampLast - timestamp of the last report
+    //
+    // Output:
+    //     double - interpolation point, not clamped
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    double GetReferenceAlpha( uint64_t timestamp, uint64_t timestampPrev, uint64_t timestampLast )
+    {
+        return ( timestampLast != timestampPrev )
+            ? static_cast<double>( timestamp - timestampPrev ) / static_cast<double>( timestampLast - timestampPrev )
+            : 1.0;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Interpolates a counter with double alpha, as calculated by
+    //     CCalculationContext::Interpolate before Q32 kernels.
+    //
+    // Input:
+    //     TCounter valuePrev - counter of the previous report
+    //     TCounter valueLast - counter of the last report
+    //     double   alpha     - interpolation point
+    //
+    // Output:
+    //     TCounter - interpolated counter
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <typename TCounter>
+    TCounter InterpolateReference( TCounter valuePrev, TCounter valueLast, double alpha )
+    {
+        return ( valueLast >= valuePrev )
+            ? valuePrev + static_cast<TCounter>( ( valueLast - valuePrev ) * alpha )
+            : valuePrev + static_cast<TCounter>( ( valueLast + ( std::numeric_limits<TCounter>::max() - valuePrev + 1 ) ) * alpha ); // Handle overflow case
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Checks interpolated counters against the double based interpolation.
+    //     The kernel rounds down with Q32 alpha, so it may be lower by at most
+    //     ( last - prev ) / 2^32 + 1, i.e. by one for 32 bit counters. 64 bit
+    //     deltas above 2^53 aren't exact in double, so the reference may also be
+    //     lower by ( last - prev ) / 2^52 + 1. Timestamps outside of the reports
+    //     are clamped, so the previous or the last counters are expected.
+    //
+    // Input:
+    //     const std::vector<TCounter>& prev          - counters of the previous report
+    //     const std::vector<TCounter>& last          - counters of the last report
+    //     const std::vector<TCounter>& interpolated  - counters interpolated by the kernel
+    //     uint64_t                     timestamp     - interpolated timestamp
+    //     uint64_t                     timestampPrev - timestamp of the previous report
+    //     uint64_t                     timestampLast - timestamp of the last report
+    //
+    // Output:
+    //     bool - true if all the counters are within the bound
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <typename TCounter>
+    bool CheckInterpolation( const std::vector<TCounter>& prev, const std::vector<TCounter>& last, const std::vector<TCounter>& interpolated, uint64_t timestamp, uint64_t timestampPrev, uint64_t timestampLast )
+    {
+        const double alpha = GetReferenceAlpha( timestamp, timestampPrev, timestampLast );
+
+        for( size_t j = 0; j < prev.size(); ++j )
+        {
+            const uint64_t delta    = static_cast<TCounter>( last[j] - prev[j] );
+            TCounter       expected = 0;
+            uint64_t       maxLower = 0;
+            uint64_t       maxUpper = 0;
+
+            if( timestampLast <= timestampPrev || timestamp >= timestampLast )
+            {
+                expected = last[j];
+            }
+            else if( timestamp <= timestampPrev )
+            {
+                expected = prev[j];
+            }
+            else
+            {
+                expected = InterpolateReference( prev[j], last[j], alpha );
+                maxLower = ( delta >> 32 ) + 1;
+                maxUpper = ( sizeof( TCounter ) == sizeof( uint64_t ) ) ? ( delta >> 52 ) + 1 : 0;
+            }
+
+            const TCounter lower = static_cast<TCounter>( expected - interpolated[j] );
+            const TCounter upper = static_cast<TCounter>( interpolated[j] - expected );
+
+            if( lower > maxLower && upper > maxUpper )
+            {
+                printf( "interpolation mismatch: prev 0x%llx, last 0x%llx, timestamp %llu (%llu, %llu), value 0x%llx, expected 0x%llx\n",
+                    static_cast<unsigned long long>( prev[j] ),
+                    static_cast<unsigned long long>( last[j] ),
+                    static_cast<unsigned long long>( timestamp ),
+                    static_cast<unsigned long long>( timestampPrev ),
+                    static_cast<unsigned long long>( timestampLast ),
+                    static_cast<unsigned long long>( interpolated[j] ),
+                    static_cast<unsigned long long>( expected ) );
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Interpolates random counters of the given size with the selected kernels and
+    //     checks them against the double based interpolation. Deltas of every size are
+    //     used, counters of the last report wrap, timestamps are also placed outside
+    //     of the reports and reports with equal timestamps are used.
+    //
+    // Input:
+    //     uint32_t seed - random generator seed
+    //
+    // Output:
+    //     bool - true if the test passed
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    template <typename TCounter>
+    bool TestInterpolation( uint32_t seed )
+    {
+        std::mt19937_64       random( seed );
+        std::vector<TCounter> prev( TEST_COUNTER_COUNT );
+        std::vector<TCounter> last( TEST_COUNTER_COUNT );
+        std::vector<TCounter> interpolated( TEST_COUNTER_COUNT );
+
+        // Reference casts of products above the counter range are undefined, so 64 bit deltas are limited
+        constexpr uint32_t maxDeltaBits = ( sizeof( TCounter ) == sizeof( uint64_t ) ) ? 62 : 32;
+
+        for( uint32_t i = 0; i < TEST_INTERPOLATION_COUNT; ++i )
+        {
+            for( uint32_t j = 0; j < TEST_COUNTER_COUNT; ++j )
+            {
+                const uint32_t deltaBits = 1 + static_cast<uint32_t>( random() % maxDeltaBits );
+                const uint64_t delta     = ( deltaBits < 64 ) ? random() & ( ( 1ULL << deltaBits ) - 1 ) : random();
+
+                // Previous counters near the maximum wrap in the last report
+                prev[j] = ( j % 4 == 0 ) ? static_cast<TCounter>( std::numeric_limits<TCounter>::max() - random() % 1000 ) : static_cast<TCounter>( random() );
+                last[j] = static_cast<TCounter>( prev[j] + static_cast<TCounter>( delta ) );
+            }
+            last[TEST_COUNTER_COUNT - 1] = static_cast<TCounter>( prev[TEST_COUNTER_COUNT - 1] + ( std::numeric_limits<TCounter>::max() >> 2 ) );
+
+            const uint64_t timestampPrev = random() % ( 1ULL << 48 );
+            const uint64_t span          = ( i % 16 == 0 ) ? 0 : 1 + random() % ( ( i % 2 ) ? 1000 : ( 1ULL << 40 ) );
+            const uint64_t timestampLast = timestampPrev + span;
+            uint64_t       timestamp     = timestampPrev + ( span ? random() % ( span + 1 ) : 0 );
+
+            switch( i % 8 )
+            {
+                case 0:
+                    timestamp = timestampPrev - 1 - random() % 100; // Before the previous report
+                    break;
+                case 1:
+                    timestamp = timestampLast + 1 + random() % 100; // After the last report
+                    break;
+                default:
+                    break;
+            }
+
+            const uint64_t alphaQ32 = CReportKernels::GetInterpolationAlpha( timestamp, timestampPrev, timestampLast );
+
+            CReportKernels::InterpolateCounters(
+                reinterpret_cast<const uint8_t*>( prev.data() ),
+                reinterpret_cast<const uint8_t*>( last.data() ),
+                TEST_COUNTER_COUNT,
+                sizeof( TCounter ),
+                alphaQ32,
+                reinterpret_cast<uint8_t*>( interpolated.data() ) );
+
+            if( !CheckInterpolation( prev, last, interpolated, timestamp, timestampPrev, timestampLast ) )
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Interpolates GpuTicks, PEC and NOA counters of a 640B_PEC64LL_NOA16 report
+    //     with the selected Q32 kernels, as in CCalculationContext::Interpolate.
+    //
+    // Input:
+    //     const uint8_t* prev      - previous raw report
+    //     const uint8_t* last      - last raw report
+    //     uint64_t       timestamp - interpolated timestamp
+    //     uint8_t*       out       - (OUT) interpolated raw report
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void InterpolateReport( const uint8_t* prev, const uint8_t* last, uint64_t timestamp, uint8_t* out )
+    {
+        uint64_t timestampPrev = 0;
+        uint64_t timestampLast = 0;
+
+        std::memcpy( &timestampPrev, prev + TEST_TIMESTAMP_OFFSET, sizeof( uint64_t ) );
+        std::memcpy( &timestampLast, last + TEST_TIMESTAMP_OFFSET, sizeof( uint64_t ) );
+
+        const uint64_t alphaQ32 = CReportKernels::GetInterpolationAlpha( timestamp, timestampPrev, timestampLast );
+
+        CReportKernels::InterpolateCounters( prev + TEST_GPU_TICKS_OFFSET, last + TEST_GPU_TICKS_OFFSET, 1, sizeof( uint64_t ), alphaQ32, out + TEST_GPU_TICKS_OFFSET );
+        CReportKernels::InterpolateCounters( prev + TEST_HEADER_SIZE, last + TEST_HEADER_SIZE, TEST_PEC_COUNT, sizeof( uint64_t ), alphaQ32, out + TEST_HEADER_SIZE );
+        CReportKernels::InterpolateCounters( prev + TEST_HEADER_SIZE + TEST_PEC_SIZE, last + TEST_HEADER_SIZE + TEST_PEC_SIZE, TEST_NOA_COUNT, sizeof( uint32_t ), alphaQ32, out + TEST_HEADER_SIZE + TEST_PEC_SIZE );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Interpolates GpuTicks, PEC and NOA counters of a 640B_PEC64LL_NOA16 report
+    //     with double alpha, as in CCalculationContext::Interpolate before Q32 kernels.
+    //
+    // Input:
+    //     const uint8_t* prev      - previous raw report
+    //     const uint8_t* last      - last raw report
+    //     uint64_t       timestamp - interpolated timestamp
+    //     uint8_t*       out       - (OUT) interpolated raw report
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void InterpolateReportReference( const uint8_t* prev, const uint8_t* last, uint64_t timestamp, uint8_t* out )
+    {
+        const uint64_t timestampPrev = *reinterpret_cast<const uint64_t*>( prev + TEST_TIMESTAMP_OFFSET );
+        const uint64_t timestampLast = *reinterpret_cast<const uint64_t*>( last + TEST_TIMESTAMP_OFFSET );
+        const double   alpha         = GetReferenceAlpha( timestamp, timestampPrev, timestampLast );
+
+        *reinterpret_cast<uint64_t*>( out + TEST_GPU_TICKS_OFFSET ) = InterpolateReference(
+            *reinterpret_cast<const uint64_t*>( prev + TEST_GPU_TICKS_OFFSET ),
+            *reinterpret_cast<const uint64_t*>( last + TEST_GPU_TICKS_OFFSET ),
+            alpha );
+
+        for( uint32_t m = 0; m < TEST_PEC_COUNT; ++m )
+        {
+            const uint32_t offset = TEST_HEADER_SIZE + m * sizeof( uint64_t );
+
+            *reinterpret_cast<uint64_t*>( out + offset ) = InterpolateReference( *reinterpret_cast<const uint64_t*>( prev + offset ), *reinterpret_cast<const uint64_t*>( last + offset ), alpha );
+        }
+
+        for( uint32_t m = 0; m < TEST_NOA_COUNT; ++m )
+        {
+            const uint32_t offset = TEST_HEADER_SIZE + TEST_PEC_SIZE + m * sizeof( uint32_t );
+
+            *reinterpret_cast<uint32_t*>( out + offset ) = InterpolateReference( *reinterpret_cast<const uint32_t*>( prev + offset ), *reinterpret_cast<const uint32_t*>( last + offset ), alpha );
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Times interpolation of one report per data set at each of the aggregation
+    //     window boundaries, as done by CCalculationContext::Interpolate, and prints
+    //     time per window boundary of the Q32 kernels and of the double reference.
+    //
+    // Input:
+    //     uint32_t dataSetCount - data set count
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void BenchmarkInterpolation( uint32_t dataSetCount )
+    {
+        std::mt19937_64      random( dataSetCount );
+        std::vector<uint8_t> prev( static_cast<size_t>( TEST_RAW_REPORT_SIZE ) * dataSetCount );
+        std::vector<uint8_t> last( static_cast<size_t>( TEST_RAW_REPORT_SIZE ) * dataSetCount );
+        std::vector<uint8_t> out( static_cast<size_t>( TEST_RAW_REPORT_SIZE ) * dataSetCount );
+
+        for( size_t j = 0; j < prev.size(); j += sizeof( uint32_t ) )
+        {
+            const uint32_t valuePrev = static_cast<uint32_t>( random() );
+            const uint32_t valueLast = valuePrev + static_cast<uint32_t>( random() % 100000 );
+
+            std::memcpy( &prev[j], &valuePrev, sizeof( uint32_t ) );
+            std::memcpy( &last[j], &valueLast, sizeof( uint32_t ) );
+        }
+        for( uint32_t i = 0; i < dataSetCount; ++i )
+        {
+            const uint64_t timestampPrev = 1000000 + i;
+            const uint64_t timestampLast = timestampPrev + 1000;
+
+            std::memcpy( &prev[static_cast<size_t>( i ) * TEST_RAW_REPORT_SIZE + TEST_TIMESTAMP_OFFSET], &timestampPrev, sizeof( uint64_t ) );
+            std::memcpy( &last[static_cast<size_t>( i ) * TEST_RAW_REPORT_SIZE + TEST_TIMESTAMP_OFFSET], &timestampLast, sizeof( uint64_t ) );
+        }
+
+        auto measure = [&]( void ( *interpolate )( const uint8_t*, const uint8_t*, uint64_t, uint8_t* ) )
+        {
+            uint64_t   checksum = 0;
+            const auto start    = std::chrono::steady_clock::now();
+
+            for( uint32_t window = 0; window < TEST_BENCHMARK_WINDOWS; ++window )
+            {
+                const uint64_t timestamp = 1000000 + 8 + window % 990;
+
+                for( uint32_t i = 0; i < dataSetCount; ++i )
+                {
+                    const size_t offset = static_cast<size_t>( i ) * TEST_RAW_REPORT_SIZE;
+
+                    interpolate( &prev[offset], &last[offset], timestamp, &out[offset] );
+                }
+
+                checksum += out[TEST_HEADER_SIZE + window % TEST_PEC_SIZE];
+            }
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+            g_benchmarkChecksum = g_benchmarkChecksum + checksum;
+
+            return elapsed.count() / TEST_BENCHMARK_WINDOWS;
+        };
+
+        const double kernelNs    = measure( InterpolateReport );
+        const double referenceNs = measure( InterpolateReportReference );
+
+        printf( "interpolation, %u data sets: %8.1f ns per window, double reference %8.1f ns\n", dataSetCount, kernelNs, referenceNs );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////
+    //
+    // Description:
+    //     Times per data set work at each aggregation window boundary run serially,
+    //     run on a worker pool with a thread per data set, as a barrier at each
+    //     window boundary would do, and run on the worker pool once per batch of
+    //     windows, as CCalculationContext::AggregateQueuedReports does. Prints time
+    //     per window boundary of all of them. Interpolation of one report per data
+    //     set stands for the per window work.
+    //
+    // Input:
+    //     uint32_t dataSetCount - data set count
+    //
+    //////////////////////////////////////////////////////////////////////////////
+    void BenchmarkWindowBarrier( uint32_t dataSetCount )
+    {
+        std::mt19937_64      random( dataSetCount );
+        std::vector<uint8_t> prev( static_cast<size_t>( TEST_RAW_REPORT_SIZE ) * dataSetCount );
+        std::vector<uint8_t> last( static_cast<size_t>( TEST_RAW_REPORT_SIZE ) * dataSetCount );
+        std::vector<uint8_t> out( static_cast<size_t>( TEST_RAW_REPORT_SIZE ) * dataSetCount );
+        std::vector<uint8_t> batchOut( static_cast<size_t>( TEST_RAW_REPORT_SIZE ) * dataSetCount * dataSetCount );
+        CWorkerPool          workerPool;
+        uint64_t             timestamp        = 0;
+        uint32_t             firstWindow      = 0;
+        uint32_t             batchWindowCount = 0;
+
+        for( size_t j = 0; j < prev.size(); ++j )
+        {
+            prev[j] = static_cast<uint8_t>( random() );
+            last[j] = static_cast<uint8_t>( prev[j] + random() % 16 );
+        }
+        for( uint32_t i = 0; i < dataSetCount; ++i )
+        {
+            const uint64_t timestampPrev = 1000000 + i;
+            const uint64_t timestampLast = timestampPrev + 1000;
+
+            std::memcpy( &prev[static_cast<size_t>( i ) * TEST_RAW_REPORT_SIZE + TEST_TIMESTAMP_OFFSET], &timestampPrev, sizeof( uint64_t ) );
+            std::memcpy( &last[static_cast<size_t>( i ) * TEST_RAW_REPORT_SIZE + TEST_TIMESTAMP_OFFSET], &timestampLast, sizeof( uint64_t ) );
+        }
+
+        const std::function<void( uint32_t )> interpolateDataSet = [&]( uint32_t index )
+        {
+            const size_t offset = static_cast<size_t>( index ) * TEST_RAW_REPORT_SIZE;
+
+            InterpolateReport( &prev[offset], &last[offset], timestamp, &out[offset] );
+        };
+
+        // A task per thread, each interpolating a contiguous range of the batch windows to its own reports
+        const std::function<void( uint32_t )> interpolateWindows = [&]( uint32_t task )
+        {
+            const uint32_t first   = firstWindow + batchWindowCount * task / dataSetCount;
+            const uint32_t end     = firstWindow + batchWindowCount * ( task + 1 ) / dataSetCount;
+            uint8_t*       taskOut = &batchOut[static_cast<size_t>( task ) * dataSetCount * TEST_RAW_REPORT_SIZE];
+
+            for( uint32_t window = first; window < end; ++window )
+            {
+                const uint64_t windowTimestamp = 1000000 + 8 + window % 990;
+
+                for( uint32_t i = 0; i < dataSetCount; ++i )
+                {
+                    const size_t offset = static_cast<size_t>( i ) * TEST_RAW_REPORT_SIZE;
+
+                    InterpolateReport( &prev[offset], &last[offset], windowTimestamp, taskOut + offset );
+                }
+            }
+        };
+
+        auto measureBatches = [&]()
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            for( firstWindow = 0; firstWindow < TEST_BENCHMARK_WINDOWS; firstWindow += batchWindowCount )
+            {
+                batchWindowCount = ( std::min )( TEST_BENCHMARK_BATCH_SIZE, TEST_BENCHMARK_WINDOWS - firstWindow );
+
+                workerPool.Run( dataSetCount, interpolateWindows );
+            }
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+            g_benchmarkChecksum = g_benchmarkChecksum + batchOut[TEST_HEADER_SIZE];
+
+            return elapsed.count() / TEST_BENCHMARK_WINDOWS;
+        };
+
+        auto measure = [&]( bool useWorkerPool )
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            for( uint32_t window = 0; window < TEST_BENCHMARK_WINDOWS; ++window )
+            {
+                timestamp = 1000000 + 8 + window % 990;
+
+                if( useWorkerPool )
+                {
+                    workerPool.Run( dataSetCount, interpolateDataSet );
+                }
+                else
+                {
+                    for( uint32_t i = 0; i < dataSetCount; ++i )
+                    {
+                        interpolateDataSet( i );
+                    }
+                }
+            }
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+            g_benchmarkChecksum = g_benchmarkChecksum + out[TEST_HEADER_SIZE];
+
+            return elapsed.count() / TEST_BENCHMARK_WINDOWS;
+        };
+
+        const uint32_t threadCount = workerPool.Start( dataSetCount );
+        const double   serialNs    = measure( false );
+        const double   poolNs      = measure( true );
+        const double   batchNs     = measureBatches();
+
+        printf( "window barrier, %u data sets: %8.1f ns per window, worker pool of %u threads %8.1f ns, batches of %u windows %8.1f ns\n", dataSetCount, serialNs, threadCount, poolNs, TEST_BENCHMARK_BATCH_SIZE, batchNs );
+    }
+} // namespace
+
+int main( int argc, char* argv[] )
+{
+    const TReportKernelLevel kernelLevel = CReportKernels::GetKernelLevel();
+    const char*              levelNames[REPORT_KERNEL_LEVEL_LAST] = { "scalar", "SSE4.2", "AVX2" };
+    int                      result                              = 0;
+
+    if( argc > 1 && std::strcmp( argv[1], "--benchmark" ) == 0 )
+    {
+        printf( "%-8s report kernels, %u hardware threads\n", levelNames[kernelLevel], std::thread::hardware_concurrency() );
+
+        for( uint32_t dataSetCount = 2; dataSetCount <= TEST_BENCHMARK_MAX_DATASET; dataSetCount *= 2 )
+        {
+            BenchmarkInterpolation( dataSetCount );
+        }
+        for( uint32_t dataSetCount = 2; dataSetCount <= TEST_BENCHMARK_MAX_DATASET; dataSetCount *= 2 )
+        {
+            BenchmarkWindowBarrier( dataSetCount );
+        }
+
+        return 0;
+    }
+
+    for( uint32_t level = REPORT_KERNEL_LEVEL_SCALAR; level <= kernelLevel; ++level )
+    {
+        const bool passed = CReportKernels::SelfTest( static_cast<TReportKernelLevel>( level ) );
+
+        printf( "%-8s report kernels: %s\n", levelNames[level], passed ? "passed" : "FAILED" );
+
+        if( !passed )
+        {
+            result = 1;
+        }
+    }
+
+    const bool interpolationPassed = TestInterpolation<uint32_t>( 1 ) && TestInterpolation<uint64_t>( 2 );
+
+    printf( "%-8s interpolation:  %s\n", levelNames[kernelLevel], interpolationPassed ? "passed" : "FAILED" );
+
+    if( !interpolationPassed )
+    {
+        result = 1;
+    }
+
+    return result;
+}